@@ -41,6 +41,8 @@
 #include "puppet.h"
 #include "body.h"
 #include "motion.h"
+#include "geNameIndex.h"
+#include "geThread.h"
 
 /* to do:
 		need to utilize extbox module rather than hard coding vector corners of boxes
@@ -78,6 +80,7 @@ typedef struct geActor_Def
 	
 	int32				 MotionCount;
 	geMotion		   **MotionArray;
+	geNameIndex			*MotionIndex;			// Motions by name when added, NULL to search the array
 
 	int32				 RefCount;				// this is the number of owners.
 
@@ -90,12 +93,22 @@ int geActor_RefCount    = 0;
 int geActor_DefCount    = 0;
 int geActor_DefRefCount = 0;
 
+	// bumped whenever any actor is reposed or has its bounding box changed.  The world uses
+	// this to tell if the actor boxes it has cached for collision are still good.
+	// Actors on different threads can bump it at once, so it only goes through geAtomic_.
+static volatile int32 geActor_ChangeGeneration = 0;
+
 	// returns number of actors that are currently created.
 GENESISAPI int GENESISCC geActor_GetCount(void)
 {
 	return geActor_Count;
 }
 
+uint32 GENESISCC geActor_GetChangeGeneration(void)
+{
+	return (uint32)geAtomic_Get(&geActor_ChangeGeneration);
+}
+
 GENESISAPI geBoolean GENESISCC geActor_IsValid(const geActor *A)
 {
 	if (A==NULL)
@@ -177,6 +190,7 @@ GENESISAPI geActor_Def *GENESISCC geActor_DefCreate(void)
 	Ad->Body				= NULL;
 	Ad->MotionCount			= 0;
 	Ad->MotionArray			= NULL;
+	Ad->MotionIndex			= geNameIndex_Create(0, GE_TRUE);	// Not fatal if NULL, names just get searched
 	Ad->ValidityCheck		= Ad;
 	Ad->RefCount            = 0;
 	geActor_DefCount++;
@@ -310,6 +324,7 @@ GENESISAPI geBoolean GENESISCC geActor_DefDestroy(geActor_Def **pActorDefinition
 		}
 				
 	Ad->MotionCount = 0;
+	geNameIndex_Destroy( &(Ad->MotionIndex) );
 
 	geRam_Free(*pActorDefinition);
 	*pActorDefinition = NULL;
@@ -400,6 +415,22 @@ GENESISAPI geVFile *geActor_DefGetFileContext(const geActor_Def *A)
 
 
 
+static void GENESISCC geActor_DefIndexMotion(geActor_Def *Ad, int Index)
+{
+	const char *Name;
+
+	if (Ad->MotionIndex == NULL)
+		return;
+
+	Name = geMotion_GetName(Ad->MotionArray[Index]);
+	if (Name == NULL)
+		return;		// can't be found by name anyway
+
+	// first motion with a name wins, like the search
+	if (geNameIndex_Add(Ad->MotionIndex, Name, Ad->MotionArray[Index]) == GE_FALSE)
+		geNameIndex_Destroy( &(Ad->MotionIndex) );
+}
+
 GENESISAPI geBoolean GENESISCC geActor_AddMotion(geActor_Def *Ad, geMotion *NewMotion, int *Index)
 {
 	geMotion **NewMArray;
@@ -422,6 +453,7 @@ GENESISAPI geBoolean GENESISCC geActor_AddMotion(geActor_Def *Ad, geMotion *NewM
 	Ad->MotionArray = NewMArray;
 
 	Ad->MotionArray[Ad->MotionCount]= NewMotion;
+	geActor_DefIndexMotion(Ad, Ad->MotionCount);
 	Ad->MotionCount++;
 	*Index = Ad->MotionCount;
 	return GE_TRUE;
@@ -432,6 +464,7 @@ GENESISAPI void GENESISCC geActor_ClearPose(geActor *A, const geXForm3d *Transfo
 	assert( geActor_IsValid(A) != GE_FALSE );
 	assert ( (Transform==NULL) || (geXForm3d_IsOrthonormal(Transform) != GE_FALSE) );
 	gePose_Clear( A->Pose ,Transform);
+	geAtomic_Add(&geActor_ChangeGeneration, 1);
 }
 
 GENESISAPI void GENESISCC geActor_SetPose(geActor *A, const geMotion *M, 
@@ -442,6 +475,7 @@ GENESISAPI void GENESISCC geActor_SetPose(geActor *A, const geMotion *M,
 	assert ( (Transform==NULL) || (geXForm3d_IsOrthonormal(Transform) != GE_FALSE) );
 
 	gePose_SetMotion( A->Pose,M,Time,Transform);
+	geAtomic_Add(&geActor_ChangeGeneration, 1);
 }
 
 GENESISAPI void GENESISCC geActor_BlendPose(geActor *A, const geMotion *M, 
@@ -455,6 +489,7 @@ GENESISAPI void GENESISCC geActor_BlendPose(geActor *A, const geMotion *M,
 
 	gePose_BlendMotion( A->Pose,M,Time,Transform,
 						BlendAmount,A->BlendingType);
+	geAtomic_Add(&geActor_ChangeGeneration, 1);
 }
 
 
@@ -479,8 +514,23 @@ GENESISAPI geMotion *GENESISCC geActor_GetMotionByName(const geActor_Def *Ad, co
 {
 	int i;
 	const char *TestName;
+	geMotion *M;
 	assert( geActor_DefIsValid(Ad) != GE_FALSE );
 	assert( Name != NULL );
+
+	// motions can be renamed after they are added, so check the hit,
+	// and fall back to the search on a miss
+	if (Ad->MotionIndex != NULL)
+		{
+			M = (geMotion *)geNameIndex_Find(Ad->MotionIndex, Name);
+			if (M != NULL)
+				{
+					TestName = geMotion_GetName(M);
+					if (TestName != NULL && strcmp(TestName,Name)==0)
+						return M;
+				}
+		}
+
 	for (i=0; i<Ad->MotionCount; i++)
 		{
 			TestName = geMotion_GetName(Ad->MotionArray[i]);
@@ -670,6 +720,7 @@ GENESISAPI geActor_Def *GENESISCC geActor_DefCreateFromFile(geVFile *pFile)
 					if (Ad->MotionArray[i] == NULL)
 						{	geErrorLog_Add( ERR_ACTOR_FILE_READ , NULL);	goto CreateError;}
 					geVFile_Close(SubFile);
+					geActor_DefIndexMotion(Ad, i);
 				}
 		}
 	else
@@ -969,6 +1020,7 @@ GENESISAPI geBoolean GENESISCC geActor_SetExtBox(geActor *A,
 	
 	A->BoundingBoxMinCorner = ExtBox->Min;
 	A->BoundingBoxMaxCorner = ExtBox->Max;
+	geAtomic_Add(&geActor_ChangeGeneration, 1);
 	
 	if (geActor_GetBoneIndex(A,CenterOnThisNamedBone,&(A->BoundingBoxCenterBoneIndex))==GE_FALSE)
 		{
@@ -1148,6 +1200,7 @@ GENESISAPI geBoolean GENESISCC geActor_Attach( geActor *Slave,  const char *Slav
 			return GE_FALSE;
 		}
 	
+	geAtomic_Add(&geActor_ChangeGeneration, 1);
 	return gePose_Attach(   Slave->Pose,   SlaveBoneIndex,
 							Master->Pose, MasterBoneIndex, 
 							Attachment);
@@ -1159,6 +1212,7 @@ GENESISAPI void GENESISCC geActor_Detach(geActor *A)
 	assert( geActor_IsValid(A) != GE_FALSE);
 
 	gePose_Detach( A->Pose );
+	geAtomic_Add(&geActor_ChangeGeneration, 1);
 }
 
 
@@ -1200,6 +1254,7 @@ GENESISAPI geBoolean GENESISCC geActor_SetBoneAttachment(geActor *A,
 		}
 	
 	gePose_SetJointAttachment(A->Pose,BoneIndex, Attachment);
+	geAtomic_Add(&geActor_ChangeGeneration, 1);
 	return GE_TRUE;
 }
 
@@ -1385,6 +1440,7 @@ GENESISAPI geBoolean GENESISCC geActor_AnimationStep(geActor *A, geFloat DeltaTi
 		}
 
 	gePose_SetMotion( A->Pose, M, 0.0f, NULL );
+	geAtomic_Add(&geActor_ChangeGeneration, 1);
 	geMotion_SetupEventIterator(M,-DeltaTime,0.0f);
 
 	return GE_TRUE;
@@ -1467,6 +1523,7 @@ GENESISAPI geBoolean GENESISCC geActor_AnimationStepBoneOptimized(geActor *A, ge
 		}
 
 	gePose_SetMotionForABone( A->Pose, M, 0.0f, NULL, A->StepBoneIndex );
+	geAtomic_Add(&geActor_ChangeGeneration, 1);
 	geMotion_SetupEventIterator(M,-DeltaTime,0.0f);
 
 	return GE_TRUE;
@@ -1480,6 +1537,7 @@ GENESISAPI geBoolean GENESISCC geActor_AnimationTestStep(geActor *A, geFloat Del
 	assert( DeltaTime >= 0.0f );
 
 	gePose_SetMotion( A->Pose, A->CueMotion , DeltaTime, NULL );
+	geAtomic_Add(&geActor_ChangeGeneration, 1);
 
 	return GE_TRUE;
 }
@@ -1516,6 +1574,7 @@ GENESISAPI geBoolean GENESISCC geActor_AnimationTestStepBoneOptimized(geActor *A
 				}
 		}
 	gePose_SetMotionForABone( A->Pose, A->CueMotion , DeltaTime, NULL,A->StepBoneIndex );
+	geAtomic_Add(&geActor_ChangeGeneration, 1);
 
 	return GE_TRUE;
 }
@@ -1679,6 +1738,7 @@ GENESISAPI void GENESISCC geActor_SetScale(geActor *A, geFloat ScaleX,geFloat Sc
 		
 	geVec3d_Set(&S,ScaleX,ScaleY,ScaleZ);
 	gePose_SetScale(A->Pose,&S);
+	geAtomic_Add(&geActor_ChangeGeneration, 1);
 }
 
 
@@ -1742,6 +1802,7 @@ geBoolean GENESISCC geActor_RenderPrep( geActor *A, geWorld *World)
 		
 		A->BoundingBoxMinCorner = EB.Min;
 		A->BoundingBoxMaxCorner = EB.Max;
+		geAtomic_Add(&geActor_ChangeGeneration, 1);
 	}
 	
 	return GE_TRUE;
@@ -1799,6 +1860,40 @@ geBoolean GENESISCC geActor_Render(const geActor *A, geEngine *Engine, geWorld *
 	return GE_TRUE;
 }
 
+geBoolean GENESISCC geActor_ReserveRender(const geActor *A)
+{
+	assert( geActor_IsValid(A) != GE_FALSE );
+	assert( A->Puppet != NULL );
+
+	return gePuppet_ReserveRender(A->Puppet);
+}
+
+geBoolean GENESISCC geActor_PrepareRender(const geActor *A, const geCamera *Camera)
+{
+	assert( geActor_IsValid(A) != GE_FALSE );
+	assert( A->Puppet != NULL );
+
+	// same box test as geActor_Render, but no error log: this may be called from a worker thread
+	if (A->RenderHintExtBoxEnabled)
+		{
+			geBoolean Enabled;
+			geExtBox Box;
+			if (geActor_GetRenderHintExtBox(A, &Box, &Enabled)==GE_FALSE)
+				{
+					return GE_FALSE;
+				}
+			return gePuppet_PrepareRender( A->Puppet, A->Pose, Camera, &Box );
+		}
+	return gePuppet_PrepareRender( A->Puppet, A->Pose, Camera, NULL );
+}
+
+const gePose *GENESISCC geActor_GetAttachRoot(const geActor *A, int *Depth)
+{
+	assert( geActor_IsValid(A) != GE_FALSE );
+
+	return gePose_GetAttachRoot(A->Pose, Depth);
+}
+
 GENESISAPI int GENESISCC geActor_GetMaterialCount(const geActor *A)
 {
 	assert( geActor_IsValid(A) != GE_FALSE );
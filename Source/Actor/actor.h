@@ -306,6 +306,9 @@ GENESISAPI void GENESISCC geActor_GetPosition( const geActor *A, geVec3d *Pos );
 
 // GENESIS_PRIVATE_APIS
 
+	// Changes whenever any actor is reposed or gets a new bounding box (see geActor_GetExtBox)
+uint32 GENESISCC geActor_GetChangeGeneration(void);
+
 #ifdef GE_WORLD_H
 	// Prepares the geActor for rendering and posing.  Call Once once the actor is fully created.
 	// Must be called prior to render/pose/setworldtransform 
@@ -314,6 +317,14 @@ geBoolean GENESISCC geActor_RenderPrep( geActor *A, geWorld *World);
 	// Draws the geActor.  (RenderPrep must be called first)
 geBoolean GENESISCC geActor_RenderThroughFrustum(const geActor *A, geEngine *Engine, geWorld *World, geCamera *Camera, Frustum_Info *FInfo);
 geBoolean GENESISCC geActor_Render(const geActor *A, geEngine *Engine, geWorld *World, geCamera *Camera);
+
+	// Skinning ahead of geActor_Render, so the world can skin its visible actors in parallel.
+	// ReserveRender is not thread safe.  PrepareRender can run for several actors at once as 
+	// long as they have different attachment roots (GetAttachRoot), and does nothing if the
+	// actor isn't on screen.  Render then uses the prepared skin if the camera hasn't changed.
+geBoolean GENESISCC geActor_ReserveRender(const geActor *A);
+geBoolean GENESISCC geActor_PrepareRender(const geActor *A, const geCamera *Camera);
+const struct gePose *GENESISCC geActor_GetAttachRoot(const geActor *A, int *Depth);
 #endif
 
 // GENESIS_PUBLIC_APIS
@@ -23,6 +23,8 @@
 #include <assert.h>//assert()
 #include <math.h>  //fabs()
 #include <stdio.h> //sscanf
+#include <stdlib.h> //qsort()
+#include <string.h> //memset()
 
 #include "body.h"
 #include "body._h"
@@ -671,6 +673,27 @@ static geBoolean GENESISCC geBody_AddToFaces( geBody *B, geBody_Triangle *F, int
 			
 
 
+	// drops the generated levels, the highest level is all that's left
+static void GENESISCC geBody_FreeLevelsOfDetail(geBody *B)
+{
+	int i;
+
+	for (i=GE_BODY_HIGHEST_LOD+1; i<GE_BODY_NUMBER_OF_LOD; i++)
+		{
+			if (B->SkinFaces[i].FaceArray != NULL)
+				{
+					geRam_Free(B->SkinFaces[i].FaceArray);
+					B->SkinFaces[i].FaceArray = NULL;
+				}
+			B->SkinFaces[i].FaceCount = 0;
+		}
+	for (i=0; i<B->XSkinVertexCount; i++)
+		B->XSkinVertexArray[i].LevelOfDetailMask &= (GE_BODY_HIGHEST_LOD_MASK | GE_BODY_BBOX_LOD_MASK);
+	for (i=0; i<B->SkinNormalCount; i++)
+		B->SkinNormalArray[i].LevelOfDetailMask &= (GE_BODY_HIGHEST_LOD_MASK | GE_BODY_BBOX_LOD_MASK);
+	B->LevelsOfDetail = 1;
+}
+
 geBoolean GENESISCC geBody_AddFace(	geBody *B,
 	const geVec3d *Vertex1, const geVec3d *Normal1, 
 		geFloat U1, geFloat V1, int BoneIndex1,
@@ -730,6 +753,10 @@ geBoolean GENESISCC geBody_AddFace(	geBody *B,
 		}
 
 	F.MaterialIndex = (geBody_Index)MaterialIndex;
+	if (B->LevelsOfDetail > 1)
+		{	// generated from the old faces
+			geBody_FreeLevelsOfDetail(B);
+		}
 	if (geBody_AddToFaces( B, &F, GE_BODY_HIGHEST_LOD ) == GE_FALSE)
 		{	// error already recorded
 			return GE_FALSE;
@@ -896,15 +923,615 @@ geBoolean GENESISCC geBody_AddBone( geBody *B,
 
 
 
+//-----------------------------------------------------------------------------------
+//	Level of detail generation
+//
+//	The lower levels are built from the highest one by repeatedly collapsing the
+//	vertex that costs least (quadric error, measured in the rest pose) into one of
+//	its neighbours.  Skin vertices are attached to exactly one bone, so a vertex is
+//	only ever collapsed into a vertex on the same bone: every vertex that survives
+//	keeps its original bone and position, and no new vertices are made.  The levels
+//	just use fewer of the XSkinVertexArray entries (see LevelOfDetailMask).
+//-----------------------------------------------------------------------------------
+
+	// fraction of the highest level's faces to keep in each level
+static const geFloat geBody_LevelOfDetailFaces[GE_BODY_NUMBER_OF_LOD] = { 1.0f, 0.5f, 0.25f, 0.125f };
+
+#define GE_BODY_LOD_UV_WEIGHT	(0.01f)		// cost of moving across uv space, relative to the body size squared
+
+typedef struct geBody_Quadric
+{
+	double A2,AB,AC,AD,B2,BC,BD,C2,CD,D2;
+} geBody_Quadric;
+
+typedef struct geBody_LODBuilder
+{
+	const geBody		 *B;
+	int					  VertexCount;
+	int					  FaceCount;
+	int					  AliveFaces;
+	geVec3d				 *Points;		// rest pose position of each skin vertex
+	geBody_Quadric		 *Quadrics;
+	int32				 *FaceVtx;		// current vertices of each face (3 per face)
+	uint8				 *FaceDead;
+	int32				 *CornerHead;	// per vertex: first corner (Face*3+k) using it
+	int32				 *CornerTail;
+	int32				 *CornerNext;	// per corner
+	uint8				 *Locked;		// open edge or material border: never moved
+	uint8				 *Dead;			// collapsed into another vertex
+	int32				 *Target;		// best vertex to collapse into, -1 = none
+	double				 *Cost;
+	int32				 *Stamp;		// bumped whenever Target/Cost change
+
+	int32				  HeapCount;	// min heap of (Cost,Vertex,Stamp), stale entries are skipped
+	int32				  HeapMax;
+	double				 *HeapCost;
+	int32				 *HeapVertex;
+	int32				 *HeapStamp;
+
+	double				  UVScale;
+} geBody_LODBuilder;
+
+geBoolean GENESISCC geBody_GetRestPoints(const geBody *B, geVec3d *Points)
+{
+	geXForm3d *BoneXF;
+	int i;
+
+	assert( B != NULL );
+	assert( Points != NULL );
+
+	if (B->XSkinVertexCount == 0)
+		return GE_TRUE;
+
+	BoneXF = GE_RAM_ALLOCATE_ARRAY(geXForm3d, (B->BoneCount>0) ? B->BoneCount : 1);
+	if (BoneXF == NULL)
+		{
+			geErrorLog_Add(ERR_BODY_ENOMEM, NULL);
+			return GE_FALSE;
+		}
+
+	for (i=0; i<B->BoneCount; i++)
+		{
+			const geBody_Bone *Bone = &(B->BoneArray[i]);
+			if ((Bone->ParentBoneIndex == GE_BODY_NO_PARENT_BONE) || (Bone->ParentBoneIndex >= i))
+				{
+					BoneXF[i] = Bone->AttachmentMatrix;
+				}
+			else
+				{
+					geXForm3d_Multiply(&(BoneXF[Bone->ParentBoneIndex]),&(Bone->AttachmentMatrix),&(BoneXF[i]));
+				}
+		}
+
+	for (i=0; i<B->XSkinVertexCount; i++)
+		{
+			const geBody_XSkinVertex *SV = &(B->XSkinVertexArray[i]);
+			assert( SV->BoneIndex < B->BoneCount );
+			geXForm3d_Transform(&(BoneXF[SV->BoneIndex]),&(SV->XPoint),&(Points[i]));
+		}
+
+	geRam_Free(BoneXF);
+	return GE_TRUE;
+}
+
+static void GENESISCC geBody_QuadricAdd(geBody_Quadric *Q, const geBody_Quadric *Add)
+{
+	Q->A2 += Add->A2;  Q->AB += Add->AB;  Q->AC += Add->AC;  Q->AD += Add->AD;
+	Q->B2 += Add->B2;  Q->BC += Add->BC;  Q->BD += Add->BD;
+	Q->C2 += Add->C2;  Q->CD += Add->CD;
+	Q->D2 += Add->D2;
+}
+
+static double GENESISCC geBody_QuadricEvaluate(const geBody_Quadric *Q1, const geBody_Quadric *Q2, const geVec3d *P)
+{
+	double X=P->X, Y=P->Y, Z=P->Z;
+	double Error;
+
+	Error =   (Q1->A2 + Q2->A2)*X*X + 2.0*(Q1->AB + Q2->AB)*X*Y + 2.0*(Q1->AC + Q2->AC)*X*Z + 2.0*(Q1->AD + Q2->AD)*X
+			+ (Q1->B2 + Q2->B2)*Y*Y + 2.0*(Q1->BC + Q2->BC)*Y*Z + 2.0*(Q1->BD + Q2->BD)*Y
+			+ (Q1->C2 + Q2->C2)*Z*Z + 2.0*(Q1->CD + Q2->CD)*Z
+			+ (Q1->D2 + Q2->D2);
+	return (Error > 0.0) ? Error : 0.0;
+}
+
+static void GENESISCC geBody_FaceNormal(const geVec3d *P0, const geVec3d *P1, const geVec3d *P2, geVec3d *Normal)
+{
+	geVec3d E1,E2;
+	geVec3d_Subtract(P1,P0,&E1);
+	geVec3d_Subtract(P2,P0,&E2);
+	geVec3d_CrossProduct(&E1,&E2,Normal);
+}
+
+static void GENESISCC geBody_LODHeapPush(geBody_LODBuilder *L, int32 Vertex)
+{
+	int32 i;
+
+	if (L->HeapCount >= L->HeapMax)
+		{
+			int32 NewMax = L->HeapMax * 2;
+			double *NewCost;
+			int32 *NewVertex,*NewStamp;
+
+			NewCost   = GE_RAM_REALLOC_ARRAY(L->HeapCost,   double, NewMax);
+			if (NewCost != NULL)
+				L->HeapCost = NewCost;
+			NewVertex = GE_RAM_REALLOC_ARRAY(L->HeapVertex, int32,  NewMax);
+			if (NewVertex != NULL)
+				L->HeapVertex = NewVertex;
+			NewStamp  = GE_RAM_REALLOC_ARRAY(L->HeapStamp,  int32,  NewMax);
+			if (NewStamp != NULL)
+				L->HeapStamp = NewStamp;
+			if ((NewCost == NULL) || (NewVertex == NULL) || (NewStamp == NULL))
+				return;		// vertex just won't be collapsed
+			L->HeapMax = NewMax;
+		}
+
+	i = L->HeapCount++;
+	while (i > 0)
+		{
+			int32 Parent = (i-1)/2;
+			if (L->HeapCost[Parent] <= L->Cost[Vertex])
+				break;
+			L->HeapCost[i]   = L->HeapCost[Parent];
+			L->HeapVertex[i] = L->HeapVertex[Parent];
+			L->HeapStamp[i]  = L->HeapStamp[Parent];
+			i = Parent;
+		}
+	L->HeapCost[i]   = L->Cost[Vertex];
+	L->HeapVertex[i] = Vertex;
+	L->HeapStamp[i]  = L->Stamp[Vertex];
+}
+
+static int32 GENESISCC geBody_LODHeapPop(geBody_LODBuilder *L)
+{
+	while (L->HeapCount > 0)
+		{
+			int32 Vertex = L->HeapVertex[0];
+			int32 Stamp  = L->HeapStamp[0];
+			double LastCost;
+			int32 LastVertex,LastStamp;
+			int32 i;
+
+			L->HeapCount--;
+			LastCost   = L->HeapCost[L->HeapCount];
+			LastVertex = L->HeapVertex[L->HeapCount];
+			LastStamp  = L->HeapStamp[L->HeapCount];
+			i = 0;
+			for (;;)
+				{
+					int32 Child = i*2+1;
+					if (Child >= L->HeapCount)
+						break;
+					if ((Child+1 < L->HeapCount) && (L->HeapCost[Child+1] < L->HeapCost[Child]))
+						Child++;
+					if (LastCost <= L->HeapCost[Child])
+						break;
+					L->HeapCost[i]   = L->HeapCost[Child];
+					L->HeapVertex[i] = L->HeapVertex[Child];
+					L->HeapStamp[i]  = L->HeapStamp[Child];
+					i = Child;
+				}
+			L->HeapCost[i]   = LastCost;
+			L->HeapVertex[i] = LastVertex;
+			L->HeapStamp[i]  = LastStamp;
+
+			if ((L->Dead[Vertex] == 0) && (L->Stamp[Vertex] == Stamp) && (L->Target[Vertex] >= 0))
+				return Vertex;
+		}
+	return -1;
+}
+
+	// GE_FALSE if moving U onto V would flip (or flatten) any face around U
+static geBoolean GENESISCC geBody_LODCollapseIsValid(const geBody_LODBuilder *L, int32 U, int32 V)
+{
+	int32 Corner;
+
+	for (Corner = L->CornerHead[U]; Corner >= 0; Corner = L->CornerNext[Corner])
+		{
+			int32 Face = Corner/3;
+			const int32 *FV = &(L->FaceVtx[Face*3]);
+			geVec3d Old,New;
+			const geVec3d *P[3];
+			int k;
+
+			if (L->FaceDead[Face])
+				continue;
+			if ((FV[0] == V) || (FV[1] == V) || (FV[2] == V))
+				continue;		// this one goes away
+
+			for (k=0; k<3; k++)
+				P[k] = &(L->Points[FV[k]]);
+			geBody_FaceNormal(P[0],P[1],P[2],&Old);
+			for (k=0; k<3; k++)
+				if (FV[k] == U)
+					P[k] = &(L->Points[V]);
+			geBody_FaceNormal(P[0],P[1],P[2],&New);
+
+			if (geVec3d_DotProduct(&Old,&New) <= 0.0f)
+				return GE_FALSE;
+		}
+	return GE_TRUE;
+}
+
+static void GENESISCC geBody_LODEvaluate(geBody_LODBuilder *L, int32 U)
+{
+	const geBody_XSkinVertex *SU = &(L->B->XSkinVertexArray[U]);
+	int32 Corner;
+
+	L->Target[U] = -1;
+	L->Cost[U]   = 0.0;
+	L->Stamp[U]++;
+
+	if (L->Dead[U] || L->Locked[U])
+		return;
+
+	for (Corner = L->CornerHead[U]; Corner >= 0; Corner = L->CornerNext[Corner])
+		{
+			int32 Face = Corner/3;
+			int k;
+
+			if (L->FaceDead[Face])
+				continue;
+
+			for (k=0; k<3; k++)
+				{
+					int32 V = L->FaceVtx[Face*3+k];
+					const geBody_XSkinVertex *SV = &(L->B->XSkinVertexArray[V]);
+					double Cost,DU,DV;
+
+					if ((V == U) || (V == L->Target[U]))
+						continue;
+					if (SV->BoneIndex != SU->BoneIndex)
+						continue;		// keep the skin on the bones it was built for
+
+					DU = SV->XU - SU->XU;
+					DV = SV->XV - SU->XV;
+					Cost = geBody_QuadricEvaluate(&(L->Quadrics[U]),&(L->Quadrics[V]),&(L->Points[V]))
+							+ (DU*DU + DV*DV) * L->UVScale;
+
+					if ((L->Target[U] >= 0) && (Cost >= L->Cost[U]))
+						continue;
+					if (geBody_LODCollapseIsValid(L,U,V) == GE_FALSE)
+						continue;
+
+					L->Target[U] = V;
+					L->Cost[U]   = Cost;
+				}
+		}
+
+	if (L->Target[U] >= 0)
+		geBody_LODHeapPush(L,U);
+}
+
+static void GENESISCC geBody_LODCollapse(geBody_LODBuilder *L, int32 U)
+{
+	int32 V = L->Target[U];
+	int32 Corner;
+
+	assert( V >= 0 );
+
+	geBody_QuadricAdd(&(L->Quadrics[V]),&(L->Quadrics[U]));
+
+	for (Corner = L->CornerHead[U]; Corner >= 0; Corner = L->CornerNext[Corner])
+		{
+			int32 Face = Corner/3;
+			int32 *FV = &(L->FaceVtx[Face*3]);
+
+			L->FaceVtx[Corner] = V;
+			if (L->FaceDead[Face])
+				continue;
+			if ((FV[0] == FV[1]) || (FV[1] == FV[2]) || (FV[0] == FV[2]))
+				{
+					L->FaceDead[Face] = 1;
+					L->AliveFaces--;
+				}
+		}
+
+	// V inherits U's corners
+	if (L->CornerHead[U] >= 0)
+		{
+			if (L->CornerHead[V] >= 0)
+				L->CornerNext[L->CornerTail[V]] = L->CornerHead[U];
+			else
+				L->CornerHead[V] = L->CornerHead[U];
+			L->CornerTail[V] = L->CornerTail[U];
+		}
+	L->CornerHead[U] = -1;
+	L->Dead[U] = 1;
+	geBody_LODEvaluate(L,U);
+
+	// V and everything around it may have a new best collapse
+	geBody_LODEvaluate(L,V);
+	for (Corner = L->CornerHead[V]; Corner >= 0; Corner = L->CornerNext[Corner])
+		{
+			int32 Face = Corner/3;
+			int k;
+			if (L->FaceDead[Face])
+				continue;
+			for (k=0; k<3; k++)
+				if (L->FaceVtx[Face*3+k] != V)
+					geBody_LODEvaluate(L,L->FaceVtx[Face*3+k]);
+		}
+}
+
+static int GENESISCC geBody_LODEdgeCompare(const void *a, const void *b)
+{
+	const int32 *E1 = (const int32 *)a;
+	const int32 *E2 = (const int32 *)b;
+	if (E1[0] != E2[0])
+		return (E1[0] < E2[0]) ? -1 : 1;
+	if (E1[1] != E2[1])
+		return (E1[1] < E2[1]) ? -1 : 1;
+	return 0;
+}
+
+static geBoolean GENESISCC geBody_LODLockBorders(geBody_LODBuilder *L)
+{
+	const geBody_Triangle *T = L->B->SkinFaces[GE_BODY_HIGHEST_LOD].FaceArray;
+	int32 *Edges,*Material;
+	int32 i,j,Count;
+
+	// open edges: used by only one face.  (uv seams show up as these too)
+	Edges = GE_RAM_ALLOCATE_ARRAY(int32, L->FaceCount*3*2);
+	Material = GE_RAM_ALLOCATE_ARRAY(int32, L->VertexCount);
+	if ((Edges == NULL) || (Material == NULL))
+		{
+			if (Edges != NULL)
+				geRam_Free(Edges);
+			if (Material != NULL)
+				geRam_Free(Material);
+			geErrorLog_Add(ERR_BODY_ENOMEM, NULL);
+			return GE_FALSE;
+		}
+
+	for (i=0; i<L->FaceCount; i++)
+		{
+			for (j=0; j<3; j++)
+				{
+					int32 A = T[i].VtxIndex[j];
+					int32 B = T[i].VtxIndex[(j+1)%3];
+					Edges[(i*3+j)*2+0] = (A<B) ? A : B;
+					Edges[(i*3+j)*2+1] = (A<B) ? B : A;
+				}
+		}
+	Count = L->FaceCount*3;
+	qsort(Edges, Count, sizeof(int32)*2, geBody_LODEdgeCompare);
+	for (i=0; i<Count; i=j)
+		{
+			for (j=i+1; (j<Count) && (geBody_LODEdgeCompare(&(Edges[i*2]),&(Edges[j*2])) == 0); j++)
+				;
+			if (j-i == 1)
+				{
+					L->Locked[Edges[i*2+0]] = 1;
+					L->Locked[Edges[i*2+1]] = 1;
+				}
+		}
+
+	// vertices shared by faces of different materials
+	for (i=0; i<L->VertexCount; i++)
+		Material[i] = -1;
+	for (i=0; i<L->FaceCount; i++)
+		{
+			for (j=0; j<3; j++)
+				{
+					int32 V = T[i].VtxIndex[j];
+					if (Material[V] == -1)
+						Material[V] = T[i].MaterialIndex;
+					else if (Material[V] != T[i].MaterialIndex)
+						L->Locked[V] = 1;
+				}
+		}
+
+	geRam_Free(Material);
+	geRam_Free(Edges);
+	return GE_TRUE;
+}
+
+static void GENESISCC geBody_LODBuilderFree(geBody_LODBuilder *L)
+{
+	if (L->Points)		geRam_Free(L->Points);
+	if (L->Quadrics)	geRam_Free(L->Quadrics);
+	if (L->FaceVtx)		geRam_Free(L->FaceVtx);
+	if (L->FaceDead)	geRam_Free(L->FaceDead);
+	if (L->CornerHead)	geRam_Free(L->CornerHead);
+	if (L->CornerTail)	geRam_Free(L->CornerTail);
+	if (L->CornerNext)	geRam_Free(L->CornerNext);
+	if (L->Locked)		geRam_Free(L->Locked);
+	if (L->Dead)		geRam_Free(L->Dead);
+	if (L->Target)		geRam_Free(L->Target);
+	if (L->Cost)		geRam_Free(L->Cost);
+	if (L->Stamp)		geRam_Free(L->Stamp);
+	if (L->HeapCost)	geRam_Free(L->HeapCost);
+	if (L->HeapVertex)	geRam_Free(L->HeapVertex);
+	if (L->HeapStamp)	geRam_Free(L->HeapStamp);
+}
+
+static geBoolean GENESISCC geBody_LODBuilderInit(geBody_LODBuilder *L, const geBody *B)
+{
+	const geBody_Triangle *T;
+	geVec3d Mins,Maxs,Size;
+	int32 i,j,V,F;
+
+	memset(L,0,sizeof(*L));
+	L->B = B;
+	L->VertexCount = V = B->XSkinVertexCount;
+	L->FaceCount   = F = B->SkinFaces[GE_BODY_HIGHEST_LOD].FaceCount;
+	L->AliveFaces  = F;
+	L->HeapMax     = V + 16;
+
+	L->Points     = GE_RAM_ALLOCATE_ARRAY(geVec3d,        V);
+	L->Quadrics   = GE_RAM_ALLOCATE_ARRAY(geBody_Quadric, V);
+	L->FaceVtx    = GE_RAM_ALLOCATE_ARRAY(int32,          F*3);
+	L->FaceDead   = GE_RAM_ALLOCATE_ARRAY(uint8,          F);
+	L->CornerHead = GE_RAM_ALLOCATE_ARRAY(int32,          V);
+	L->CornerTail = GE_RAM_ALLOCATE_ARRAY(int32,          V);
+	L->CornerNext = GE_RAM_ALLOCATE_ARRAY(int32,          F*3);
+	L->Locked     = GE_RAM_ALLOCATE_ARRAY(uint8,          V);
+	L->Dead       = GE_RAM_ALLOCATE_ARRAY(uint8,          V);
+	L->Target     = GE_RAM_ALLOCATE_ARRAY(int32,          V);
+	L->Cost       = GE_RAM_ALLOCATE_ARRAY(double,         V);
+	L->Stamp      = GE_RAM_ALLOCATE_ARRAY(int32,          V);
+	L->HeapCost   = GE_RAM_ALLOCATE_ARRAY(double,         L->HeapMax);
+	L->HeapVertex = GE_RAM_ALLOCATE_ARRAY(int32,          L->HeapMax);
+	L->HeapStamp  = GE_RAM_ALLOCATE_ARRAY(int32,          L->HeapMax);
+
+	if (   !L->Points || !L->Quadrics || !L->FaceVtx || !L->FaceDead || !L->CornerHead 
+		|| !L->CornerTail || !L->CornerNext || !L->Locked || !L->Dead || !L->Target 
+		|| !L->Cost || !L->Stamp || !L->HeapCost || !L->HeapVertex || !L->HeapStamp)
+		{
+			geErrorLog_Add(ERR_BODY_ENOMEM, NULL);
+			return GE_FALSE;
+		}
+
+	if (geBody_GetRestPoints(B,L->Points) == GE_FALSE)
+		return GE_FALSE;
+
+	memset(L->Quadrics, 0, sizeof(geBody_Quadric) * V);
+	memset(L->FaceDead, 0, F);
+	memset(L->Locked,   0, V);
+	memset(L->Dead,     0, V);
+	memset(L->Stamp,    0, sizeof(int32) * V);
+	for (i=0; i<V; i++)
+		{
+			L->CornerHead[i] = -1;
+			L->CornerTail[i] = -1;
+			L->Target[i]     = -1;
+		}
+
+	geVec3d_Set(&Mins, GE_BODY_REALLY_BIG_NUMBER, GE_BODY_REALLY_BIG_NUMBER, GE_BODY_REALLY_BIG_NUMBER);
+	geVec3d_Set(&Maxs,-GE_BODY_REALLY_BIG_NUMBER,-GE_BODY_REALLY_BIG_NUMBER,-GE_BODY_REALLY_BIG_NUMBER);
+	for (i=0; i<V; i++)
+		{
+			const geVec3d *P = &(L->Points[i]);
+			if (P->X < Mins.X) Mins.X = P->X;
+			if (P->Y < Mins.Y) Mins.Y = P->Y;
+			if (P->Z < Mins.Z) Mins.Z = P->Z;
+			if (P->X > Maxs.X) Maxs.X = P->X;
+			if (P->Y > Maxs.Y) Maxs.Y = P->Y;
+			if (P->Z > Maxs.Z) Maxs.Z = P->Z;
+		}
+	geVec3d_Subtract(&Maxs,&Mins,&Size);
+	L->UVScale = GE_BODY_LOD_UV_WEIGHT * geVec3d_DotProduct(&Size,&Size);
+
+	for (i=0,T=B->SkinFaces[GE_BODY_HIGHEST_LOD].FaceArray; i<F; i++,T++)
+		{
+			geVec3d Normal;
+			geFloat Area;
+
+			for (j=0; j<3; j++)
+				{
+					int32 Vtx = T->VtxIndex[j];
+					int32 Corner = i*3+j;
+					L->FaceVtx[Corner] = Vtx;
+					L->CornerNext[Corner] = -1;
+					if (L->CornerHead[Vtx] < 0)
+						L->CornerHead[Vtx] = Corner;
+					else
+						L->CornerNext[L->CornerTail[Vtx]] = Corner;
+					L->CornerTail[Vtx] = Corner;
+				}
+
+			if ((T->VtxIndex[0] == T->VtxIndex[1]) || (T->VtxIndex[1] == T->VtxIndex[2]) || (T->VtxIndex[0] == T->VtxIndex[2]))
+				{
+					L->FaceDead[i] = 1;
+					L->AliveFaces--;
+					continue;
+				}
+
+			// area weighted plane quadric
+			geBody_FaceNormal(&(L->Points[T->VtxIndex[0]]),&(L->Points[T->VtxIndex[1]]),&(L->Points[T->VtxIndex[2]]),&Normal);
+			Area = geVec3d_Normalize(&Normal);
+			if (Area > 0.0f)
+				{
+					geBody_Quadric Q;
+					double A = Normal.X, B = Normal.Y, C = Normal.Z;
+					double D = -geVec3d_DotProduct(&Normal,&(L->Points[T->VtxIndex[0]]));
+					double W = Area * 0.5;
+
+					Q.A2 = W*A*A;  Q.AB = W*A*B;  Q.AC = W*A*C;  Q.AD = W*A*D;
+					Q.B2 = W*B*B;  Q.BC = W*B*C;  Q.BD = W*B*D;
+					Q.C2 = W*C*C;  Q.CD = W*C*D;
+					Q.D2 = W*D*D;
+					for (j=0; j<3; j++)
+						geBody_QuadricAdd(&(L->Quadrics[T->VtxIndex[j]]),&Q);
+				}
+		}
+
+	return geBody_LODLockBorders(L);
+}
+
 geBoolean GENESISCC geBody_ComputeLevelsOfDetail( geBody *B ,int Levels)
 {
+	geBody_LODBuilder L;
+	int Lod;
+
 	assert( B != NULL);
 	assert( Levels >= 0 );
 	assert( Levels < GE_BODY_NUMBER_OF_LOD );
 	assert( geBody_IsValid(B) != GE_FALSE );
-	#pragma message ("LOD code goes here:")
-	B->LevelsOfDetail = GE_BODY_HIGHEST_LOD_MASK; // Levels
-	Levels;
+
+	geBody_FreeLevelsOfDetail(B);
+
+	if ((Levels == 0) || (B->SkinFaces[GE_BODY_HIGHEST_LOD].FaceCount == 0))
+		return GE_TRUE;
+
+	if (geBody_LODBuilderInit(&L,B) == GE_FALSE)
+		{
+			geBody_LODBuilderFree(&L);
+			return GE_FALSE;
+		}
+
+	{
+		int32 i;
+		for (i=0; i<L.VertexCount; i++)
+			geBody_LODEvaluate(&L,i);
+	}
+
+	for (Lod=GE_BODY_HIGHEST_LOD+1; Lod<=Levels; Lod++)
+		{
+			geBody_TriangleList *FL = &(B->SkinFaces[Lod]);
+			const geBody_Triangle *T;
+			int32 TargetFaces,i,j;
+			int32 U;
+
+			TargetFaces = (int32)(L.FaceCount * geBody_LevelOfDetailFaces[Lod]);
+			while (L.AliveFaces > TargetFaces)
+				{
+					U = geBody_LODHeapPop(&L);
+					if (U < 0)
+						break;			// nothing left that can go
+					geBody_LODCollapse(&L,U);
+				}
+
+			FL->FaceArray = GE_RAM_ALLOCATE_ARRAY(geBody_Triangle, (L.AliveFaces>0) ? L.AliveFaces : 1);
+			if (FL->FaceArray == NULL)
+				{
+					geErrorLog_Add(ERR_BODY_ENOMEM, NULL);
+					geBody_LODBuilderFree(&L);
+					geBody_FreeLevelsOfDetail(B);
+					return GE_FALSE;
+				}
+
+			// same order as the highest level, so they stay sorted by material
+			FL->FaceCount = 0;
+			for (i=0,T=B->SkinFaces[GE_BODY_HIGHEST_LOD].FaceArray; i<L.FaceCount; i++,T++)
+				{
+					geBody_Triangle *D;
+					if (L.FaceDead[i])
+						continue;
+					D = &(FL->FaceArray[FL->FaceCount++]);
+					*D = *T;
+					for (j=0; j<3; j++)
+						{
+							D->VtxIndex[j] = (geBody_Index)L.FaceVtx[i*3+j];
+							B->XSkinVertexArray[D->VtxIndex[j]].LevelOfDetailMask |= (1<<Lod);
+							B->SkinNormalArray[D->NormalIndex[j]].LevelOfDetailMask |= (1<<Lod);
+						}
+				}
+			B->LevelsOfDetail = Lod+1;
+		}
+
+	geBody_LODBuilderFree(&L);
 	return GE_TRUE;
 }	
 
@@ -1068,6 +1695,10 @@ geBody *GENESISCC geBody_CreateFromFile(geVFile *pFile)
 
 	if (geBody_ReadGeometry(B,SubFile)==GE_FALSE)
 		{	geErrorLog_Add( ERR_BODY_FILE_READ , NULL);	goto CreateError;}
+	if (B->LevelsOfDetail < GE_BODY_NUMBER_OF_LOD)
+		{	// older files only have the highest detail.  If this fails that's all that gets drawn
+			geBody_ComputeLevelsOfDetail(B,GE_BODY_NUMBER_OF_LOD-1);
+		}
 	geVFile_Close(SubFile);
 
 	BitmapDirectory = geVFile_Open(VFile,GE_BODY_BITMAP_DIRECTORY_NAME, 
@@ -20,9 +20,11 @@
 /*                                                                                      */
 /****************************************************************************************/
 #include <assert.h>						//assert()
+#include <string.h>						//memcmp()
 
 #include "body._h"
 #include "bodyinst.h"
+#include "skinsimd.h"
 #include "RAM.H"
 #include "Errorlog.h"
 #include "strblock.h"
@@ -35,6 +37,12 @@ typedef struct geBodyInst
 	geBodyInst_Geometry		 ExportGeometry;
 	int						 LastLevelOfDetail;
 	geBodyInst_Index		 FaceCount;
+	geFloat					 Radius;			// of the skin in the rest pose, for picking a level of detail
+
+	// set by geBodyInst_PrepareGeometry, used up by the next geBodyInst_GetGeometry
+	const geCamera			*PreparedCamera;
+	geXForm3d				 PreparedCameraXForm;
+	int						 PreparedLevelOfDetail;
 } geBodyInst;
 
 
@@ -61,6 +69,8 @@ geBodyInst *GENESISCC geBodyInst_Create(const geBody *B)
 	geBodyInst *BI;
 	assert( B != NULL );
 	assert( geBody_IsValid(B) != GE_FALSE );
+
+	geSkin_Init();
 	
 	BI = GE_RAM_ALLOCATE_STRUCT(geBodyInst);
 	if (BI == NULL)
@@ -84,6 +94,35 @@ geBodyInst *GENESISCC geBodyInst_Create(const geBody *B)
 
 	BI->LastLevelOfDetail   = -1;
 	BI->FaceCount =  0;
+	BI->PreparedCamera = NULL;
+
+	BI->Radius = 0.0f;
+	if (B->XSkinVertexCount > 0)
+		{
+			geVec3d *Points;
+			Points = GE_RAM_ALLOCATE_ARRAY(geVec3d, B->XSkinVertexCount);
+			if (Points != NULL)
+				{
+					if (geBody_GetRestPoints(B,Points) != GE_FALSE)
+						{
+							geVec3d Mins,Maxs;
+							int i;
+							Mins = Maxs = Points[0];
+							for (i=1; i<B->XSkinVertexCount; i++)
+								{
+									if (Points[i].X < Mins.X) Mins.X = Points[i].X;
+									if (Points[i].Y < Mins.Y) Mins.Y = Points[i].Y;
+									if (Points[i].Z < Mins.Z) Mins.Z = Points[i].Z;
+									if (Points[i].X > Maxs.X) Maxs.X = Points[i].X;
+									if (Points[i].Y > Maxs.Y) Maxs.Y = Points[i].Y;
+									if (Points[i].Z > Maxs.Z) Maxs.Z = Points[i].Z;
+								}
+							BI->Radius = geVec3d_DistanceBetween(&Mins,&Maxs) * 0.5f;
+						}
+					geRam_Free(Points);
+				}
+			// else it just always gets the highest level of detail
+		}
 
 	return BI;
 }
@@ -183,152 +222,119 @@ static geBodyInst_Geometry *GENESISCC geBodyInst_GetGeometryPrep(
 					return NULL;
 				}
 			BI->FaceCount = B->SkinFaces[GE_BODY_HIGHEST_LOD].FaceCount;
+			BI->LastLevelOfDetail = -1;
 		}
 	return G;
 }
 
-const geBodyInst_Geometry *GENESISCC geBodyInst_GetGeometry(
-	const geBodyInst *BI, 
+static geBoolean GENESISCC geBodyInst_IsPrepped(const geBodyInst *BI)
+{
+	const geBody *B = BI->BodyTemplate;
+	const geBodyInst_Geometry *G = &(BI->ExportGeometry);
+
+	return (   (G->SkinVertexCount == B->XSkinVertexCount)
+			&& (G->NormalCount == B->SkinNormalCount)
+			&& (BI->FaceCount == B->SkinFaces[GE_BODY_HIGHEST_LOD].FaceCount) );
+}
+
+	// transforms the skin into G.  Doesn't allocate or log errors, so this is safe
+	// to run for different body instances at the same time.
+static void GENESISCC geBodyInst_Skin(
+	geBodyInst *BI,
+	geBodyInst_Geometry *G,
 	const geVec3d *ScaleVector,
-	const geXFArray *BoneTransformArray,
+	const geXForm3d *BoneXFArray,
 	int LevelOfDetail,
 	const geCamera *Camera)
 {
-	geBodyInst_Geometry *G;
 	const geBody *B;
-	geXForm3d *BoneXFArray;
-	int      BoneXFCount;
 	geBody_Index BoneIndex;
 
-	geBoolean GottaUpdateFaces = GE_FALSE;
-	assert( BI != NULL );
-	assert( BoneTransformArray != NULL );
-	assert( geBody_IsValid(BI->BodyTemplate) != GE_FALSE );
-	
-	G = geBodyInst_GetGeometryPrep((geBodyInst *)BI,LevelOfDetail);
-	if (G == NULL)
-		{
-			return NULL;
-		}
-		
-
 	B = BI->BodyTemplate;
 
-	BoneXFArray = geXFArray_GetElements(BoneTransformArray,&BoneXFCount);
-	if ( BoneXFArray == NULL)
+	if (LevelOfDetail >= B->LevelsOfDetail)
 		{
-			geErrorLog_Add(ERR_BODY_BONEXFARRAY, NULL);
-			return NULL;
-		}
-	if (BoneXFCount != B->BoneCount)
-		{	
-			geErrorLog_Add(ERR_BODY_BONEXFARRAY, NULL);
-			return NULL;
+			LevelOfDetail = B->LevelsOfDetail - 1;
 		}
 
-
 	{	
-		int i,LevelOfDetailBit;
-	
+		int i,j,LevelOfDetailBit;
+		geCamera_Projection Projection;
+		geBody_XSkinVertex *S;
+		geBodyInst_SkinVertex  *D;
+
+		LevelOfDetailBit = 1 << LevelOfDetail;
+		geVec3d_Set(&(G->Maxs), -GE_BODY_REALLY_BIG_NUMBER, -GE_BODY_REALLY_BIG_NUMBER, -GE_BODY_REALLY_BIG_NUMBER );
+		geVec3d_Set(&(G->Mins), GE_BODY_REALLY_BIG_NUMBER, GE_BODY_REALLY_BIG_NUMBER, GE_BODY_REALLY_BIG_NUMBER );
+
 		if (Camera != NULL)
 			{
-				// transform and project all appropriate points
-				geBody_XSkinVertex *S;
-				geBodyInst_SkinVertex  *D;
-				LevelOfDetailBit = 1 << LevelOfDetail;
-				BoneIndex = -1;  // S->BoneIndex won't ever be this.
-				geVec3d_Set(&(G->Maxs), -GE_BODY_REALLY_BIG_NUMBER, -GE_BODY_REALLY_BIG_NUMBER, -GE_BODY_REALLY_BIG_NUMBER );
-				geVec3d_Set(&(G->Mins), GE_BODY_REALLY_BIG_NUMBER, GE_BODY_REALLY_BIG_NUMBER, GE_BODY_REALLY_BIG_NUMBER );
-				for (i=B->XSkinVertexCount,S=B->XSkinVertexArray,D=G->SkinVertexArray; 
-					 i>0; 
-					 i--,S++,D++)
-					{
-						geXForm3d ObjectToCamera;
-						if (S->BoneIndex!=BoneIndex)
-							{ //Keep XSkinVertexArray sorted by BoneIndex for best performance
-								BoneIndex = S->BoneIndex;
-								geXForm3d_Multiply(		geCamera_GetCameraSpaceXForm(Camera), 
-														&(BoneXFArray[BoneIndex]),
-														&ObjectToCamera);
-								geBodyInst_PostScale(&ObjectToCamera,ScaleVector,&ObjectToCamera);
-							}
-						if ( S->LevelOfDetailMask && LevelOfDetailBit )
-							{
-								geVec3d *VecDestPtr = &(D->SVPoint);
-								geXForm3d_Transform(  &(ObjectToCamera),
-													&(S->XPoint),VecDestPtr);
-								#ifdef ONE_OVER_Z_PIPELINE
-								geCamera_ProjectZ( Camera, VecDestPtr, VecDestPtr);
-								#else
-								geCamera_Project( Camera, VecDestPtr, VecDestPtr);
-								#endif
-								D->SVU = S->XU;
-								D->SVV = S->XV;
-								if (VecDestPtr->X > G->Maxs.X ) G->Maxs.X = VecDestPtr->X;
-								if (VecDestPtr->X < G->Mins.X ) G->Mins.X = VecDestPtr->X;
-								if (VecDestPtr->Y > G->Maxs.Y ) G->Maxs.Y = VecDestPtr->Y;
-								if (VecDestPtr->Y < G->Mins.Y ) G->Mins.Y = VecDestPtr->Y;
-								if (VecDestPtr->Z > G->Maxs.Z ) G->Maxs.Z = VecDestPtr->Z;
-								if (VecDestPtr->Z < G->Mins.Z ) G->Mins.Z = VecDestPtr->Z;
-								D->ReferenceBoneIndex=BoneIndex;
-							}
-					}
+				geCamera_GetProjection(Camera, &Projection);
+				#ifdef ONE_OVER_Z_PIPELINE
+				Projection.ZScale = 1.0f;		// flipped to 1/Z below
+				#endif
 			}
-		else
+
+		// transform (and project) all appropriate points, one run of vertices per bone.
+		// XSkinVertexArray is sorted by BoneIndex, so the runs are long.
+		S = B->XSkinVertexArray;
+		D = G->SkinVertexArray;
+		for (i=0; i<B->XSkinVertexCount; i=j)
 			{
-				// transform all appropriate points
-				geBody_XSkinVertex *S;
-				geBodyInst_SkinVertex  *D;
-				LevelOfDetailBit = 1 << LevelOfDetail;
-				BoneIndex = -1;  // S->BoneIndex won't ever be this.
-				geVec3d_Set(&(G->Maxs), -GE_BODY_REALLY_BIG_NUMBER, -GE_BODY_REALLY_BIG_NUMBER, -GE_BODY_REALLY_BIG_NUMBER );
-				geVec3d_Set(&(G->Mins), GE_BODY_REALLY_BIG_NUMBER, GE_BODY_REALLY_BIG_NUMBER, GE_BODY_REALLY_BIG_NUMBER );
-				
-				for (i=B->XSkinVertexCount,S=B->XSkinVertexArray,D=G->SkinVertexArray; 
-					 i>0; 
-					 i--,S++,D++)
+				geXForm3d ObjectToView;
+
+				BoneIndex = S[i].BoneIndex;
+				for (j=i+1; j<B->XSkinVertexCount && S[j].BoneIndex == BoneIndex; j++)
+					;
+
+				if (Camera != NULL)
+					{
+						geXForm3d_Multiply(		geCamera_GetCameraSpaceXForm(Camera), 
+												&(BoneXFArray[BoneIndex]),
+												&ObjectToView);
+						geBodyInst_PostScale(&ObjectToView,ScaleVector,&ObjectToView);
+					}
+				else
 					{
-						geXForm3d ObjectToWorld;
-						if (S->BoneIndex!=BoneIndex)
-							{ //Keep XSkinVertexArray sorted by BoneIndex for best performance
-								BoneIndex = S->BoneIndex;
-								geBodyInst_PostScale(&BoneXFArray[BoneIndex],ScaleVector,&ObjectToWorld);
-
-							}
-						if ( S->LevelOfDetailMask && LevelOfDetailBit )
-							{
-								geVec3d *VecDestPtr = &(D->SVPoint);
-								geXForm3d_Transform(  &(ObjectToWorld),
-													&(S->XPoint),VecDestPtr);
-								D->SVU = S->XU;
-								D->SVV = S->XV;
-								if (VecDestPtr->X > G->Maxs.X ) G->Maxs.X = VecDestPtr->X;
-								if (VecDestPtr->X < G->Mins.X ) G->Mins.X = VecDestPtr->X;
-								if (VecDestPtr->Y > G->Maxs.Y ) G->Maxs.Y = VecDestPtr->Y;
-								if (VecDestPtr->Y < G->Mins.Y ) G->Mins.Y = VecDestPtr->Y;
-								if (VecDestPtr->Z > G->Maxs.Z ) G->Maxs.Z = VecDestPtr->Z;
-								if (VecDestPtr->Z < G->Mins.Z ) G->Mins.Z = VecDestPtr->Z;
-								D->ReferenceBoneIndex=BoneIndex;
-							}
+						geBodyInst_PostScale(&BoneXFArray[BoneIndex],ScaleVector,&ObjectToView);
 					}
+
+				geSkin_TransformVertices(&ObjectToView, (Camera != NULL) ? &Projection : NULL,
+										 S + i, D + i, j - i, LevelOfDetailBit,
+										 &(G->Mins), &(G->Maxs));
 			}
 
+		#ifdef ONE_OVER_Z_PIPELINE
+		if (Camera != NULL)
 			{
-				geBody_Normal *S;
-				geVec3d *D;
-				// rotate all appropriate normals
-				for (i=B->SkinNormalCount,S=B->SkinNormalArray,D=G->NormalArray;
-					 i>0; 
-					 i--,S++,D++)
+				geFloat MinZ = G->Mins.Z;
+
+				for (i=0; i<B->XSkinVertexCount; i++)
 					{
-						if ( S->LevelOfDetailMask && LevelOfDetailBit )
-							{
-								geXForm3d_Rotate(&(BoneXFArray[S->BoneIndex]),
-											   &(S->Normal),D);
-							}
+						if ( S[i].LevelOfDetailMask & LevelOfDetailBit )
+							D[i].SVPoint.Z = 1.0f / D[i].SVPoint.Z;
+					}
+				if (G->Maxs.Z > 0.0f)
+					{	// Z is clamped positive, so 1/Z just swaps the ends
+						G->Mins.Z = 1.0f / G->Maxs.Z;
+						G->Maxs.Z = 1.0f / MinZ;
 					}
 			}
+		#endif
 
+		{
+			geBody_Normal *N = B->SkinNormalArray;
+
+			// rotate all appropriate normals, again one run per bone
+			for (i=0; i<B->SkinNormalCount; i=j)
+				{
+					BoneIndex = N[i].BoneIndex;
+					for (j=i+1; j<B->SkinNormalCount && N[j].BoneIndex == BoneIndex; j++)
+						;
+					geSkin_RotateNormals(&(BoneXFArray[BoneIndex]), N + i, G->NormalArray + i,
+										 j - i, LevelOfDetailBit);
+				}
+		}
 	}
 
 
@@ -357,13 +363,131 @@ const geBodyInst_Geometry *GENESISCC geBodyInst_GetGeometry(
 						D++;
 					}
 			}
-		assert( ((uint32)D) - ((uint32)G->FaceList) == (uint32)(G->FaceListSize) );
 		G->FaceCount = Count;
-		((geBodyInst *)BI)->LastLevelOfDetail = LevelOfDetail;
+		G->FaceListSize = sizeof(geBody_Index) * Count * GE_BODYINST_FACELIST_SIZE_FOR_TRIANGLE;
+		assert( (int32)((D - G->FaceList) * sizeof(geBody_Index)) == G->FaceListSize );
+		BI->LastLevelOfDetail = LevelOfDetail;
 	}
+}
+
+static const geXForm3d *GENESISCC geBodyInst_GetBoneXFArray(const geBodyInst *BI, const geXFArray *BoneTransformArray)
+{
+	geXForm3d *BoneXFArray;
+	int      BoneXFCount;
+
+	BoneXFArray = geXFArray_GetElements(BoneTransformArray,&BoneXFCount);
+	if ( BoneXFArray == NULL)
+		{
+			return NULL;
+		}
+	if (BoneXFCount != BI->BodyTemplate->BoneCount)
+		{	
+			return NULL;
+		}
+	return BoneXFArray;
+}
+
+const geBodyInst_Geometry *GENESISCC geBodyInst_GetGeometry(
+	const geBodyInst *BI, 
+	const geVec3d *ScaleVector,
+	const geXFArray *BoneTransformArray,
+	int LevelOfDetail,
+	const geCamera *Camera)
+{
+	geBodyInst_Geometry *G;
+	const geXForm3d *BoneXFArray;
+	const geCamera *PreparedCamera;
+
+	assert( BI != NULL );
+	assert( BoneTransformArray != NULL );
+	assert( geBody_IsValid(BI->BodyTemplate) != GE_FALSE );
+	
+	PreparedCamera = BI->PreparedCamera;
+	((geBodyInst *)BI)->PreparedCamera = NULL;
 
+	G = geBodyInst_GetGeometryPrep((geBodyInst *)BI,LevelOfDetail);
+	if (G == NULL)
+		{
+			return NULL;
+		}
 
+	if (   (Camera != NULL)
+		&& (PreparedCamera == Camera)
+		&& (BI->PreparedLevelOfDetail == LevelOfDetail)
+		&& (memcmp(&(BI->PreparedCameraXForm),geCamera_GetCameraSpaceXForm(Camera),sizeof(geXForm3d)) == 0) )
+		{
+			// already skinned for this view by geBodyInst_PrepareGeometry
+			return G;
+		}
+
+	BoneXFArray = geBodyInst_GetBoneXFArray(BI,BoneTransformArray);
+	if ( BoneXFArray == NULL)
+		{
+			geErrorLog_Add(ERR_BODY_BONEXFARRAY, NULL);
+			return NULL;
+		}
+
+	geBodyInst_Skin((geBodyInst *)BI,G,ScaleVector,BoneXFArray,LevelOfDetail,Camera);
 
 	return G;
 }	
 
+int GENESISCC geBodyInst_GetLevelsOfDetail(const geBodyInst *BI)
+{
+	assert( BI != NULL );
+	return BI->BodyTemplate->LevelsOfDetail;
+}
+
+geFloat GENESISCC geBodyInst_GetRadius(const geBodyInst *BI)
+{
+	assert( BI != NULL );
+	return BI->Radius;
+}
+
+geBoolean GENESISCC geBodyInst_ReserveGeometry(geBodyInst *BI)
+{
+	assert( BI != NULL );
+	assert( geBody_IsValid(BI->BodyTemplate) != GE_FALSE );
+
+	BI->PreparedCamera = NULL;
+	if (geBodyInst_GetGeometryPrep(BI,GE_BODY_HIGHEST_LOD) == NULL)
+		{
+			return GE_FALSE;
+		}
+	return GE_TRUE;
+}
+
+geBoolean GENESISCC geBodyInst_PrepareGeometry(
+	geBodyInst *BI, 
+	const geVec3d *ScaleVector,
+	const geXFArray *BoneTransformArray,
+	int LevelOfDetail,
+	const geCamera *Camera)
+{
+	const geXForm3d *BoneXFArray;
+
+	assert( BI != NULL );
+	assert( BoneTransformArray != NULL );
+	assert( Camera != NULL );
+
+	BI->PreparedCamera = NULL;
+
+	if (geBodyInst_IsPrepped(BI) == GE_FALSE)
+		{
+			return GE_FALSE;
+		}
+
+	BoneXFArray = geBodyInst_GetBoneXFArray(BI,BoneTransformArray);
+	if ( BoneXFArray == NULL)
+		{
+			return GE_FALSE;
+		}
+
+	geBodyInst_Skin(BI,&(BI->ExportGeometry),ScaleVector,BoneXFArray,LevelOfDetail,Camera);
+
+	BI->PreparedCamera        = Camera;
+	BI->PreparedCameraXForm   = *geCamera_GetCameraSpaceXForm(Camera);
+	BI->PreparedLevelOfDetail = LevelOfDetail;
+	return GE_TRUE;
+}
+
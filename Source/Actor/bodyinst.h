@@ -119,6 +119,23 @@ const geBodyInst_Geometry *GENESISCC geBodyInst_GetGeometry(
 								int LevelOfDetail,
 								const geCamera *Camera);
 
+	// Levels of detail available (LevelOfDetail passed to GetGeometry is clamped to this), and
+	// the rough size of the skin, to choose between them
+int GENESISCC geBodyInst_GetLevelsOfDetail(const geBodyInst *BI);
+geFloat GENESISCC geBodyInst_GetRadius(const geBodyInst *BI);
+
+	// Skinning ahead of time, so several body instances can be skinned in parallel:
+	// ReserveGeometry allocates the export buffers (not thread safe, call it first).
+	// PrepareGeometry then skins into them without allocating or logging errors, and the
+	// next GetGeometry for the same camera view returns that result instead of skinning again.
+geBoolean GENESISCC geBodyInst_ReserveGeometry(geBodyInst *BI);
+geBoolean GENESISCC geBodyInst_PrepareGeometry( 
+								geBodyInst *BI,
+								const geVec3d *Scale,
+								const geXFArray *BoneXformArray,
+								int LevelOfDetail,
+								const geCamera *Camera);
+
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,711 @@
+/*******************************************************************************
+Copyright © 2024 Mark E. Sowden <hogsy@oldtimes-software.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************/
+
+
+
+#include <assert.h>
+#include <math.h>
+#include <string.h>
+
+#include "RAM.H"
+#include "Errorlog.h"
+#include "tkarray.h"
+#include "motclip.h"
+
+#define GE_MOTIONCLIP_FILE_TAG		(0x50494C43)		// 'CLIP'
+#define GE_MOTIONCLIP_FILE_VERSION	(0x0100)
+
+#define GE_MOTIONCLIP_ROTATION_ANIMATED		(1)
+#define GE_MOTIONCLIP_TRANSLATION_ANIMATED	(2)
+#define GE_MOTIONCLIP_LOOPED				(4)
+
+#define GE_MOTIONCLIP_ROTATION_KEY_SIZE		(3)			// uint16s
+#define GE_MOTIONCLIP_TRANSLATION_KEY_SIZE	(3)
+
+#define GE_MOTIONCLIP_ROTATION_TOLERANCE	(0.00001f)	// below this a channel counts as constant
+#define GE_MOTIONCLIP_TRANSLATION_TOLERANCE	(0.00001f)
+#define GE_MOTIONCLIP_EXTENT_TOLERANCE		(0.0001f)
+
+#define GE_MOTIONCLIP_SQRT1_2	(0.70710678f)
+#define GE_MOTIONCLIP_SQRT2		(1.41421356f)
+
+typedef struct geMotionClip_Track
+{
+	geQuaternion	Rotation;		// the rotation, when it's constant
+	geVec3d			Translation;	// the translation when it's constant, otherwise the bottom of its range
+	geVec3d			Scale;			// size of one translation step
+	int32			Flags;
+	int32			Offset;			// where this track's keys start in a frame (uint16s)
+} geMotionClip_Track;
+
+typedef struct geMotionClip
+{
+	int32				 TrackCount;
+	int32				 FrameCount;
+	int32				 FrameSize;		// uint16s per frame
+	geFloat				 StartTime;
+	geFloat				 EndTime;
+	geFloat				 FrameTime;		// seconds between frames
+	geMotionClip_Track	*Tracks;
+	uint16				*Frames;
+} geMotionClip;
+
+typedef struct
+{
+	uint32	Tag;
+	uint32	Version;
+	int32	TrackCount;
+	int32	FrameCount;
+	int32	FrameSize;
+	geFloat	StartTime;
+	geFloat	EndTime;
+	geFloat	FrameTime;
+} geMotionClip_FileHeader;
+
+
+static geMotionClip *GENESISCC geMotionClip_Allocate(int TrackCount, int FrameCount, int FrameSize)
+{
+	geMotionClip *C;
+
+	C = (geMotionClip *)geRam_Allocate(	sizeof(geMotionClip) 
+										+ sizeof(geMotionClip_Track) * TrackCount
+										+ sizeof(uint16) * FrameCount * FrameSize );
+	if (C == NULL)
+		{
+			geErrorLog_Add(ERR_MOTION_CREATE_ENOMEM, NULL);
+			return NULL;
+		}
+
+	C->TrackCount = TrackCount;
+	C->FrameCount = FrameCount;
+	C->FrameSize  = FrameSize;
+	C->Tracks     = (geMotionClip_Track *)(C + 1);
+	C->Frames     = (uint16 *)(C->Tracks + TrackCount);
+	return C;
+}
+
+void GENESISCC geMotionClip_Destroy(geMotionClip **PC)
+{
+	assert( PC != NULL );
+	assert( *PC != NULL );
+
+	geRam_Free(*PC);
+	*PC = NULL;
+}
+
+//=====================================================================================
+//	Key packing
+//=====================================================================================
+
+	// smallest three: drop the largest component (made positive), and keep the 
+	// other three in [-1/sqrt(2), 1/sqrt(2)] with 15 bits each.  The index of the 
+	// dropped one goes in the top bits of the first two words.
+static void GENESISCC geMotionClip_PackRotation(const geQuaternion *Q, uint16 *Out)
+{
+	geFloat C[4];
+	geFloat Length;
+	int i,j,Largest;
+
+	C[0] = Q->W;  C[1] = Q->X;  C[2] = Q->Y;  C[3] = Q->Z;
+
+	Length = (geFloat)sqrt(C[0]*C[0] + C[1]*C[1] + C[2]*C[2] + C[3]*C[3]);
+	if (Length < 0.000001f)
+		{
+			C[0] = 1.0f;  C[1] = C[2] = C[3] = 0.0f;
+			Length = 1.0f;
+		}
+
+	Largest = 0;
+	for (i=1; i<4; i++)
+		{
+			if (fabs(C[i]) > fabs(C[Largest]))
+				Largest = i;
+		}
+	if (C[Largest] < 0.0f)
+		Length = -Length;
+
+	for (i=0, j=0; i<4; i++)
+		{
+			int Value;
+
+			if (i == Largest)
+				continue;
+
+			Value = (int)floor(((C[i] / Length) * GE_MOTIONCLIP_SQRT1_2 + 0.5f) * 32767.0f + 0.5f);
+			if (Value < 0)		Value = 0;
+			if (Value > 32767)	Value = 32767;
+			Out[j++] = (uint16)Value;
+		}
+
+	Out[0] |= (uint16)((Largest & 1) << 15);
+	Out[1] |= (uint16)((Largest >> 1) << 15);
+}
+
+static void GENESISCC geMotionClip_UnpackRotation(const uint16 *In, geFloat *C)
+{
+	int Largest;
+	geFloat A,B,D,Rest;
+
+	#define UNPACK(x)	((((geFloat)((x) & 0x7FFF) * (1.0f / 32767.0f)) - 0.5f) * GE_MOTIONCLIP_SQRT2)
+
+	Largest = (In[0] >> 15) | ((In[1] >> 15) << 1);
+	A = UNPACK(In[0]);
+	B = UNPACK(In[1]);
+	D = UNPACK(In[2]);
+	Rest = 1.0f - A*A - B*B - D*D;
+	Rest = (Rest > 0.0f) ? (geFloat)sqrt(Rest) : 0.0f;
+
+	#undef UNPACK
+
+	switch (Largest)
+		{
+			case (0): C[0] = Rest;  C[1] = A;     C[2] = B;     C[3] = D;     break;
+			case (1): C[0] = A;     C[1] = Rest;  C[2] = B;     C[3] = D;     break;
+			case (2): C[0] = A;     C[1] = B;     C[2] = Rest;  C[3] = D;     break;
+			default:  C[0] = A;     C[1] = B;     C[2] = D;     C[3] = Rest;  break;
+		}
+}
+
+//=====================================================================================
+//	Sampling
+//=====================================================================================
+
+	// finds the frame before Time and how far Time is towards the next one
+static void GENESISCC geMotionClip_Locate(const geMotionClip *C, geFloat Time, geBoolean Looped, int *Frame, geFloat *T)
+{
+	geFloat Length,F;
+
+	*Frame = 0;
+	*T     = 0.0f;
+
+	if (C->FrameCount < 2)
+		return;
+
+	Length = C->EndTime - C->StartTime;
+	Time  -= C->StartTime;
+
+	if (Looped != GE_FALSE)
+		{
+			if (Length < GE_TKA_TIME_TOLERANCE)
+				return;
+			Time = (geFloat)fmod(Time, Length);
+			if (Time < 0.0f)
+				Time += Length;
+		}
+
+	if (Time <= 0.0f)
+		return;
+
+	F = Time / C->FrameTime;
+	*Frame = (int)F;
+	if (*Frame >= C->FrameCount - 1)
+		{
+			*Frame = C->FrameCount - 2;
+			*T     = 1.0f;
+			return;
+		}
+	*T = F - (geFloat)*Frame;
+}
+
+static void GENESISCC geMotionClip_BlendRotation(const uint16 *KA, const uint16 *KB, geFloat T, geQuaternion *Q)
+{
+	geFloat A[4],B[4];
+	geFloat Dot,Length;
+
+	geMotionClip_UnpackRotation(KA, A);
+	if (T <= 0.0f)
+		{
+			geQuaternion_Set(Q, A[0], A[1], A[2], A[3]);
+			return;
+		}
+	geMotionClip_UnpackRotation(KB, B);
+
+	// q == -q, so go the short way round
+	Dot = A[0]*B[0] + A[1]*B[1] + A[2]*B[2] + A[3]*B[3];
+	if (Dot < 0.0f)
+		{
+			B[0] = -B[0];  B[1] = -B[1];  B[2] = -B[2];  B[3] = -B[3];
+		}
+
+	A[0] += T * (B[0] - A[0]);
+	A[1] += T * (B[1] - A[1]);
+	A[2] += T * (B[2] - A[2]);
+	A[3] += T * (B[3] - A[3]);
+
+	Length = A[0]*A[0] + A[1]*A[1] + A[2]*A[2] + A[3]*A[3];
+	Length = (Length > 0.0f) ? 1.0f / (geFloat)sqrt(Length) : 1.0f;
+	geQuaternion_Set(Q, A[0]*Length, A[1]*Length, A[2]*Length, A[3]*Length);
+}
+
+void GENESISCC geMotionClip_SampleTracks(const geMotionClip *C, int First, int Count, geFloat Time, 
+										geQuaternion *Rotations, geVec3d *Translations)
+{
+	int LoopFrame,ClampFrame;
+	geFloat LoopT,ClampT;
+	const geMotionClip_Track *Track;
+	int i;
+
+	assert( C != NULL );
+	assert( First >= 0 );
+	assert( First + Count <= C->TrackCount );
+	assert( Rotations != NULL );
+	assert( Translations != NULL );
+
+	geMotionClip_Locate(C, Time, GE_TRUE,  &LoopFrame,  &LoopT);
+	geMotionClip_Locate(C, Time, GE_FALSE, &ClampFrame, &ClampT);
+
+	for (i=0, Track=&(C->Tracks[First]); i<Count; i++, Track++, Rotations++, Translations++)
+		{
+			const uint16 *KA,*KB;
+			geFloat T;
+
+			if (Track->Flags & GE_MOTIONCLIP_LOOPED)
+				{
+					KA = C->Frames + LoopFrame * C->FrameSize + Track->Offset;
+					T  = LoopT;
+				}
+			else
+				{
+					KA = C->Frames + ClampFrame * C->FrameSize + Track->Offset;
+					T  = ClampT;
+				}
+			KB = KA + C->FrameSize;
+
+			if (Track->Flags & GE_MOTIONCLIP_ROTATION_ANIMATED)
+				{
+					geMotionClip_BlendRotation(KA, KB, T, Rotations);
+					KA += GE_MOTIONCLIP_ROTATION_KEY_SIZE;
+					KB += GE_MOTIONCLIP_ROTATION_KEY_SIZE;
+				}
+			else
+				{
+					*Rotations = Track->Rotation;
+				}
+
+			if (Track->Flags & GE_MOTIONCLIP_TRANSLATION_ANIMATED)
+				{
+					Translations->X = Track->Translation.X + Track->Scale.X * ((geFloat)KA[0] + T * ((geFloat)KB[0] - (geFloat)KA[0]));
+					Translations->Y = Track->Translation.Y + Track->Scale.Y * ((geFloat)KA[1] + T * ((geFloat)KB[1] - (geFloat)KA[1]));
+					Translations->Z = Track->Translation.Z + Track->Scale.Z * ((geFloat)KA[2] + T * ((geFloat)KB[2] - (geFloat)KA[2]));
+				}
+			else
+				{
+					*Translations = Track->Translation;
+				}
+		}
+}
+
+void GENESISCC geMotionClip_SampleTrack(const geMotionClip *C, int Track, geFloat Time, 
+										geQuaternion *Rotation, geVec3d *Translation)
+{
+	geMotionClip_SampleTracks(C, Track, 1, Time, Rotation, Translation);
+}
+
+int GENESISCC geMotionClip_GetTrackCount(const geMotionClip *C)
+{
+	assert( C != NULL );
+	return C->TrackCount;
+}
+
+geBoolean GENESISCC geMotionClip_GetTimeExtents(const geMotionClip *C, geFloat *StartTime, geFloat *EndTime)
+{
+	assert( C != NULL );
+	assert( StartTime != NULL );
+	assert( EndTime != NULL );
+
+	*StartTime = C->StartTime;
+	*EndTime   = C->EndTime;
+	return GE_TRUE;
+}
+
+int32 GENESISCC geMotionClip_GetSize(const geMotionClip *C)
+{
+	assert( C != NULL );
+	return	sizeof(geMotionClip) 
+			+ sizeof(geMotionClip_Track) * C->TrackCount
+			+ sizeof(uint16) * C->FrameCount * C->FrameSize;
+}
+
+//=====================================================================================
+//	Building from paths
+//=====================================================================================
+
+	// a looping path wraps at its own channel extents, so they have to match the clip's
+static geBoolean GENESISCC geMotionClip_LoopFits(const gePath *P, geFloat StartTime, geFloat EndTime)
+{
+	static const int Channels[2] = { GE_PATH_ROTATION_CHANNEL, GE_PATH_TRANSLATION_CHANNEL };
+	int i;
+
+	for (i=0; i<2; i++)
+		{
+			int Count;
+			geFloat First,Last;
+			geXForm3d Dummy;
+
+			Count = gePath_GetKeyframeCount(P, Channels[i]);
+			if (Count < 2)
+				continue;
+
+			gePath_GetKeyframe(P, 0,       Channels[i], &First, &Dummy);
+			gePath_GetKeyframe(P, Count-1, Channels[i], &Last,  &Dummy);
+			if (	fabs(First - StartTime) > GE_MOTIONCLIP_EXTENT_TOLERANCE ||
+					fabs(Last  - EndTime)   > GE_MOTIONCLIP_EXTENT_TOLERANCE )
+				return GE_FALSE;
+		}
+	return GE_TRUE;
+}
+
+	// samples one path at every frame, and works out which channels move
+static void GENESISCC geMotionClip_SamplePath(const geMotionClip *C, const gePath *P, 
+											geQuaternion *R, geVec3d *T, geMotionClip_Track *Track)
+{
+	geVec3d Min,Max;
+	int f;
+
+	for (f=0; f<C->FrameCount; f++)
+		{
+			geFloat Time = C->StartTime + C->FrameTime * (geFloat)f;
+			if (f == C->FrameCount - 1)
+				Time = C->EndTime;
+			gePath_SampleChannels(P, Time, &(R[f]), &(T[f]));
+		}
+
+	Track->Flags    = gePath_IsLooped(P) ? GE_MOTIONCLIP_LOOPED : 0;
+	Track->Rotation = R[0];
+	geVec3d_Clear(&(Track->Scale));
+
+	for (f=1; f<C->FrameCount; f++)
+		{
+			geFloat Sign;
+			geQuaternion Q;
+
+			Q = R[f];
+			Sign = ((Q.W*R[0].W + Q.X*R[0].X + Q.Y*R[0].Y + Q.Z*R[0].Z) < 0.0f) ? -1.0f : 1.0f;
+			if (	fabs(Q.W*Sign - R[0].W) > GE_MOTIONCLIP_ROTATION_TOLERANCE ||
+					fabs(Q.X*Sign - R[0].X) > GE_MOTIONCLIP_ROTATION_TOLERANCE ||
+					fabs(Q.Y*Sign - R[0].Y) > GE_MOTIONCLIP_ROTATION_TOLERANCE ||
+					fabs(Q.Z*Sign - R[0].Z) > GE_MOTIONCLIP_ROTATION_TOLERANCE )
+				{
+					Track->Flags |= GE_MOTIONCLIP_ROTATION_ANIMATED;
+					break;
+				}
+		}
+
+	Min = Max = T[0];
+	for (f=1; f<C->FrameCount; f++)
+		{
+			if (T[f].X < Min.X) Min.X = T[f].X;
+			if (T[f].Y < Min.Y) Min.Y = T[f].Y;
+			if (T[f].Z < Min.Z) Min.Z = T[f].Z;
+			if (T[f].X > Max.X) Max.X = T[f].X;
+			if (T[f].Y > Max.Y) Max.Y = T[f].Y;
+			if (T[f].Z > Max.Z) Max.Z = T[f].Z;
+		}
+
+	Track->Translation = Min;
+	if (	Max.X - Min.X > GE_MOTIONCLIP_TRANSLATION_TOLERANCE ||
+			Max.Y - Min.Y > GE_MOTIONCLIP_TRANSLATION_TOLERANCE ||
+			Max.Z - Min.Z > GE_MOTIONCLIP_TRANSLATION_TOLERANCE )
+		{
+			Track->Flags |= GE_MOTIONCLIP_TRANSLATION_ANIMATED;
+			Track->Scale.X = (Max.X - Min.X) / 65535.0f;
+			Track->Scale.Y = (Max.Y - Min.Y) / 65535.0f;
+			Track->Scale.Z = (Max.Z - Min.Z) / 65535.0f;
+		}
+	else
+		{
+			Track->Translation = T[0];
+		}
+}
+
+static uint16 GENESISCC geMotionClip_PackValue(geFloat Value, geFloat Min, geFloat Scale)
+{
+	int Step;
+
+	if (Scale <= 0.0f)
+		return 0;
+	Step = (int)floor((Value - Min) / Scale + 0.5f);
+	if (Step < 0)		Step = 0;
+	if (Step > 65535)	Step = 65535;
+	return (uint16)Step;
+}
+
+geMotionClip *GENESISCC geMotionClip_CreateFromPaths(gePath **Paths, int PathCount, geFloat SampleRate)
+{
+	geMotionClip Layout;
+	geMotionClip *C = NULL;
+	geMotionClip_Track *Tracks = NULL;
+	geQuaternion *R = NULL;
+	geVec3d *T = NULL;
+	geFloat Start,End;
+	int i,f,Found,FrameSize;
+
+	assert( Paths != NULL || PathCount == 0 );
+
+	if (SampleRate <= 0.0f)
+		SampleRate = GE_MOTIONCLIP_DEFAULT_RATE;
+
+	Found = 0;
+	for (i=0; i<PathCount; i++)
+		{
+			if (gePath_GetTimeExtents(Paths[i], &Start, &End) != GE_FALSE)
+				{
+					if (Found++ == 0)
+						{
+							Layout.StartTime = Start;
+							Layout.EndTime   = End;
+						}
+					else
+						{
+							Layout.StartTime = MIN(Layout.StartTime, Start);
+							Layout.EndTime   = MAX(Layout.EndTime, End);
+						}
+				}
+		}
+	if (Found == 0)
+		return NULL;		// nothing to pack
+
+	for (i=0; i<PathCount; i++)
+		{
+			if (gePath_IsLooped(Paths[i]) && !geMotionClip_LoopFits(Paths[i], Layout.StartTime, Layout.EndTime))
+				return NULL;
+		}
+
+	if (Layout.EndTime - Layout.StartTime > GE_TKA_TIME_TOLERANCE)
+		{
+			Layout.FrameCount = (int)ceil((Layout.EndTime - Layout.StartTime) * SampleRate - 0.001f) + 1;
+			if (Layout.FrameCount < 2)
+				Layout.FrameCount = 2;
+			Layout.FrameTime  = (Layout.EndTime - Layout.StartTime) / (geFloat)(Layout.FrameCount - 1);
+		}
+	else
+		{
+			Layout.FrameCount = 1;
+			Layout.FrameTime  = 0.0f;
+		}
+
+	Tracks = GE_RAM_ALLOCATE_ARRAY(geMotionClip_Track, PathCount > 0 ? PathCount : 1);
+	R      = GE_RAM_ALLOCATE_ARRAY(geQuaternion, Layout.FrameCount);
+	T      = GE_RAM_ALLOCATE_ARRAY(geVec3d, Layout.FrameCount);
+	if (Tracks == NULL || R == NULL || T == NULL)
+		{
+			geErrorLog_Add(ERR_MOTION_CREATE_ENOMEM, NULL);
+			goto Done;
+		}
+
+	// first pass finds out which channels move, and their ranges
+	FrameSize = 0;
+	for (i=0; i<PathCount; i++)
+		{
+			geMotionClip_SamplePath(&Layout, Paths[i], R, T, &(Tracks[i]));
+			if (Layout.FrameCount < 2)
+				Tracks[i].Flags &= ~(GE_MOTIONCLIP_ROTATION_ANIMATED | GE_MOTIONCLIP_TRANSLATION_ANIMATED);
+
+			Tracks[i].Offset = FrameSize;
+			if (Tracks[i].Flags & GE_MOTIONCLIP_ROTATION_ANIMATED)
+				FrameSize += GE_MOTIONCLIP_ROTATION_KEY_SIZE;
+			if (Tracks[i].Flags & GE_MOTIONCLIP_TRANSLATION_ANIMATED)
+				FrameSize += GE_MOTIONCLIP_TRANSLATION_KEY_SIZE;
+		}
+
+	C = geMotionClip_Allocate(PathCount, Layout.FrameCount, FrameSize);
+	if (C == NULL)
+		goto Done;
+
+	C->StartTime = Layout.StartTime;
+	C->EndTime   = Layout.EndTime;
+	C->FrameTime = Layout.FrameTime;
+	if (PathCount > 0)
+		memcpy(C->Tracks, Tracks, sizeof(geMotionClip_Track) * PathCount);
+
+	// second pass packs the keys, interleaved by frame
+	for (i=0; i<PathCount; i++)
+		{
+			const geMotionClip_Track *Track = &(C->Tracks[i]);
+			geMotionClip_Track Dummy;
+
+			if (!(Track->Flags & (GE_MOTIONCLIP_ROTATION_ANIMATED | GE_MOTIONCLIP_TRANSLATION_ANIMATED)))
+				continue;
+
+			geMotionClip_SamplePath(C, Paths[i], R, T, &Dummy);
+			for (f=0; f<C->FrameCount; f++)
+				{
+					uint16 *Key = C->Frames + f * C->FrameSize + Track->Offset;
+
+					if (Track->Flags & GE_MOTIONCLIP_ROTATION_ANIMATED)
+						{
+							geMotionClip_PackRotation(&(R[f]), Key);
+							Key += GE_MOTIONCLIP_ROTATION_KEY_SIZE;
+						}
+					if (Track->Flags & GE_MOTIONCLIP_TRANSLATION_ANIMATED)
+						{
+							Key[0] = geMotionClip_PackValue(T[f].X, Track->Translation.X, Track->Scale.X);
+							Key[1] = geMotionClip_PackValue(T[f].Y, Track->Translation.Y, Track->Scale.Y);
+							Key[2] = geMotionClip_PackValue(T[f].Z, Track->Translation.Z, Track->Scale.Z);
+						}
+				}
+		}
+
+Done:
+	if (Tracks != NULL)
+		geRam_Free(Tracks);
+	if (R != NULL)
+		geRam_Free(R);
+	if (T != NULL)
+		geRam_Free(T);
+	return C;
+}
+
+//=====================================================================================
+//	Unpacking
+//=====================================================================================
+
+gePath *GENESISCC geMotionClip_CreatePath(const geMotionClip *C, int Track)
+{
+	const geMotionClip_Track *T;
+	gePath *P;
+	int f;
+
+	assert( C != NULL );
+	assert( Track >= 0 );
+	assert( Track < C->TrackCount );
+
+	T = &(C->Tracks[Track]);
+
+	P = gePath_Create(GE_PATH_INTERPOLATE_LINEAR, GE_PATH_INTERPOLATE_SLERP, 
+					(T->Flags & GE_MOTIONCLIP_LOOPED) ? GE_TRUE : GE_FALSE);
+	if (P == NULL)
+		{
+			geErrorLog_Add(ERR_MOTION_CREATE_ENOMEM, NULL);
+			return NULL;
+		}
+
+	// one key per frame, straight from the frame (no wrapping at the end of a loop)
+	for (f=0; f<C->FrameCount; f++)
+		{
+			const uint16 *Key = C->Frames + f * C->FrameSize + T->Offset;
+			geQuaternion Rotation;
+			geXForm3d Transform;
+			geFloat Time;
+
+			if (T->Flags & GE_MOTIONCLIP_ROTATION_ANIMATED)
+				{
+					geMotionClip_BlendRotation(Key, Key, 0.0f, &Rotation);
+					Key += GE_MOTIONCLIP_ROTATION_KEY_SIZE;
+				}
+			else
+				{
+					Rotation = T->Rotation;
+				}
+			geQuaternion_ToMatrix(&Rotation, &Transform);
+
+			if (T->Flags & GE_MOTIONCLIP_TRANSLATION_ANIMATED)
+				{
+					Transform.Translation.X = T->Translation.X + T->Scale.X * (geFloat)Key[0];
+					Transform.Translation.Y = T->Translation.Y + T->Scale.Y * (geFloat)Key[1];
+					Transform.Translation.Z = T->Translation.Z + T->Scale.Z * (geFloat)Key[2];
+				}
+			else
+				{
+					Transform.Translation = T->Translation;
+				}
+
+			Time = C->StartTime + C->FrameTime * (geFloat)f;
+			if (f == C->FrameCount - 1)
+				Time = C->EndTime;
+
+			if (gePath_InsertKeyframe(P, GE_PATH_ALL_CHANNELS, Time, &Transform) == GE_FALSE)
+				{
+					geErrorLog_Add(ERR_MOTION_CREATE_ENOMEM, NULL);
+					gePath_Destroy(&P);
+					return NULL;
+				}
+		}
+	return P;
+}
+
+//=====================================================================================
+//	Files
+//=====================================================================================
+
+geMotionClip *GENESISCC geMotionClip_CreateFromFile(geVFile *F)
+{
+	geMotionClip_FileHeader Header;
+	geMotionClip *C;
+
+	assert( F != NULL );
+
+	if (geVFile_Read(F, &Header, sizeof(Header)) == GE_FALSE)
+		{
+			geErrorLog_Add(ERR_MOTION_FILE_READ, NULL);
+			return NULL;
+		}
+	if (	Header.Tag != GE_MOTIONCLIP_FILE_TAG || Header.Version != GE_MOTIONCLIP_FILE_VERSION ||
+			Header.TrackCount < 0 || Header.FrameCount < 1 || Header.FrameSize < 0 )
+		{
+			geErrorLog_Add(ERR_MOTION_FILE_PARSE, NULL);
+			return NULL;
+		}
+
+	C = geMotionClip_Allocate(Header.TrackCount, Header.FrameCount, Header.FrameSize);
+	if (C == NULL)
+		return NULL;
+
+	C->StartTime = Header.StartTime;
+	C->EndTime   = Header.EndTime;
+	C->FrameTime = Header.FrameTime;
+
+	if (	geVFile_Read(F, C->Tracks, sizeof(geMotionClip_Track) * C->TrackCount) == GE_FALSE ||
+			geVFile_Read(F, C->Frames, sizeof(uint16) * C->FrameCount * C->FrameSize) == GE_FALSE )
+		{
+			geErrorLog_Add(ERR_MOTION_FILE_READ, NULL);
+			geMotionClip_Destroy(&C);
+			return NULL;
+		}
+	return C;
+}
+
+geBoolean GENESISCC geMotionClip_WriteToBinaryFile(const geMotionClip *C, geVFile *F)
+{
+	geMotionClip_FileHeader Header;
+
+	assert( C != NULL );
+	assert( F != NULL );
+
+	Header.Tag        = GE_MOTIONCLIP_FILE_TAG;
+	Header.Version    = GE_MOTIONCLIP_FILE_VERSION;
+	Header.TrackCount = C->TrackCount;
+	Header.FrameCount = C->FrameCount;
+	Header.FrameSize  = C->FrameSize;
+	Header.StartTime  = C->StartTime;
+	Header.EndTime    = C->EndTime;
+	Header.FrameTime  = C->FrameTime;
+
+	if (	geVFile_Write(F, &Header, sizeof(Header)) == GE_FALSE ||
+			geVFile_Write(F, C->Tracks, sizeof(geMotionClip_Track) * C->TrackCount) == GE_FALSE ||
+			geVFile_Write(F, C->Frames, sizeof(uint16) * C->FrameCount * C->FrameSize) == GE_FALSE )
+		{
+			geErrorLog_Add(ERR_MOTION_FILE_WRITE, NULL);
+			return GE_FALSE;
+		}
+	return GE_TRUE;
+}
@@ -0,0 +1,79 @@
+/*******************************************************************************
+Copyright © 2024 Mark E. Sowden <hogsy@oldtimes-software.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************/
+
+
+
+#ifndef GE_MOTCLIP_H
+#define GE_MOTCLIP_H
+
+#include "BASETYPE.H"
+#include "VEC3D.H"
+#include "quatern.h"
+#include "path.h"
+#include "vfile.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//=====================================================================================
+//	Packed motion clips
+//
+//	A clip holds every path of a leaf motion resampled at a fixed rate.  Each frame 
+//	stores the keys of all animated tracks next to each other: rotations as three 
+//	15 bit components (the largest one is rebuilt), translations as 16 bits per axis 
+//	inside a per track range.  Tracks that don't move keep one value and no keys.
+//
+//	Sampling a whole skeleton reads two frames front to back, with no searching and
+//	no interpolation callbacks.  Rotations are blended with a normalized lerp, which
+//	is close enough to the path's slerp/squad at animation rates.
+//=====================================================================================
+
+typedef struct geMotionClip geMotionClip;
+
+#define GE_MOTIONCLIP_DEFAULT_RATE	(30.0f)		// frames per second
+
+// Returns NULL if a path can't be represented (a looping path with its own extents)
+geMotionClip	*GENESISCC geMotionClip_CreateFromPaths(gePath **Paths, int PathCount, geFloat SampleRate);
+void			 GENESISCC geMotionClip_Destroy(geMotionClip **PC);
+
+int				 GENESISCC geMotionClip_GetTrackCount(const geMotionClip *C);
+geBoolean		 GENESISCC geMotionClip_GetTimeExtents(const geMotionClip *C, geFloat *StartTime, geFloat *EndTime);
+int32			 GENESISCC geMotionClip_GetSize(const geMotionClip *C);	// bytes
+
+void			 GENESISCC geMotionClip_SampleTrack(const geMotionClip *C, int Track, geFloat Time, 
+													geQuaternion *Rotation, geVec3d *Translation);
+// Samples tracks [First, First+Count) in one pass
+void			 GENESISCC geMotionClip_SampleTracks(const geMotionClip *C, int First, int Count, geFloat Time, 
+													geQuaternion *Rotations, geVec3d *Translations);
+
+// Rebuilds a path from a track, with a key per frame.  The caller owns it.
+gePath			*GENESISCC geMotionClip_CreatePath(const geMotionClip *C, int Track);
+
+geMotionClip	*GENESISCC geMotionClip_CreateFromFile(geVFile *F);
+geBoolean		 GENESISCC geMotionClip_WriteToBinaryFile(const geMotionClip *C, geVFile *F);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
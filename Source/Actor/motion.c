@@ -35,6 +35,10 @@
 #include "motion.h"
 #include "tkevents.h"
 #include "strblock.h"
+#include "motclip.h"
+#include "geThread.h"
+#define GE_POSECACHE_PRIVATE
+#include "posecache.h"
 
 #pragma warning(disable : 4201)		// we're using nameless structures
 
@@ -52,7 +56,8 @@ typedef struct geMotion_Leaf
 	int32		NameChecksum;	// checksum based on names and list order
 	geTKEvents *Events;
 	geStrBlock *NameArray;
-	gePath	  **PathArray;
+	gePath	  **PathArray;		// for a packed motion, only built when a path is asked for
+	geMotionClip *Clip;			// the packed paths
 } geMotion_Leaf;
 
 
@@ -138,6 +143,7 @@ static geBoolean GENESISCC geMotion_InitNodeAsLeaf(geMotion *M,geBoolean SetupSt
 	M->Leaf.PathCount     = 0;
 	M->Leaf.Events        = NULL;
 	M->Leaf.PathArray     = NULL;
+	M->Leaf.Clip          = NULL;
 	M->Leaf.NameChecksum  = 0;
 	if ((M->MaintainNames != GE_FALSE) && (SetupStringBlock!=GE_FALSE))
 		{
@@ -246,6 +252,8 @@ GENESISAPI void GENESISCC geMotion_Destroy(geMotion **PM)
 			return;
 		}
 
+	gePoseCache_RemoveMotion(M);
+
 	if (M->Name != NULL)
 		{
 			geRam_Free(M->Name);
@@ -285,17 +293,21 @@ GENESISAPI void GENESISCC geMotion_Destroy(geMotion **PM)
 						assert( Test != GE_FALSE );
 						Test;
 					}
-				for (i=0; i< M->Leaf.PathCount; i++)
-					{
-						assert( M->Leaf.PathArray[i] );
-						gePath_Destroy( &( M->Leaf.PathArray[i] ) );
-						M->Leaf.PathArray[i] = NULL;
-					}
 				if (M->Leaf.PathArray!=NULL)
 					{
+						for (i=0; i< M->Leaf.PathCount; i++)
+							{
+								assert( M->Leaf.PathArray[i] );
+								gePath_Destroy( &( M->Leaf.PathArray[i] ) );
+								M->Leaf.PathArray[i] = NULL;
+							}
 						geRam_Free(M->Leaf.PathArray);
 						M->Leaf.PathArray = NULL;
 					}
+				if (M->Leaf.Clip != NULL)
+					{
+						geMotionClip_Destroy( &(M->Leaf.Clip) );
+					}
 				M->Leaf.PathCount = 0;
 				if ( M->Leaf.Events != NULL )
 					{
@@ -330,6 +342,11 @@ GENESISAPI geBoolean GENESISCC geMotion_AddPath(geMotion *M,
 				geErrorLog_Add(ERR_MOTION_ADDPATH_ENOMEM, NULL);	//FIXME!
 				return GE_FALSE;
 			case (MOTION_NODE_LEAF):
+				if (M->Leaf.Clip != NULL)
+					{	// packed motions are read only
+						geErrorLog_Add(ERR_MOTION_ADDPATH_PATH, NULL);
+						return GE_FALSE;
+					}
 				break;
 			default:
 				assert(0);
@@ -428,7 +445,7 @@ GENESISAPI geBoolean GENESISCC geMotion_HasNames(const geMotion *M)
 	return M->MaintainNames;
 }
 
-GENESISAPI gePath * GENESISCC geMotion_GetPathNamed(const geMotion *M,const char *Name)
+int GENESISCC geMotion_GetPathIndexNamed(const geMotion *M,const char *Name)
 {
 	int i;
 
@@ -437,7 +454,7 @@ GENESISAPI gePath * GENESISCC geMotion_GetPathNamed(const geMotion *M,const char
 	
 	if (M->NodeType != MOTION_NODE_LEAF)
 		{	// not an error condition.
-			return NULL;
+			return -1;
 		}
 			
 	assert( M->Leaf.PathCount >=0 );
@@ -450,12 +467,24 @@ GENESISAPI gePath * GENESISCC geMotion_GetPathNamed(const geMotion *M,const char
 						{
 							if ( strcmp(Name,geStrBlock_GetString(M->Leaf.NameArray,i))==0 )
 								{
-									return M->Leaf.PathArray[i];
+									return i;
 								}
 						}
 				}
 		}
-	return NULL;
+	return -1;
+}
+
+GENESISAPI gePath * GENESISCC geMotion_GetPathNamed(const geMotion *M,const char *Name)
+{
+	int i;
+
+	i = geMotion_GetPathIndexNamed(M, Name);
+	if (i < 0)
+		{
+			return NULL;
+		}
+	return geMotion_GetPath(M, i);
 }
 			
 
@@ -542,6 +571,11 @@ GENESISAPI void GENESISCC geMotion_SampleChannels(const geMotion *M, int PathInd
 				{
 					gePath *P;
 					assert( ( PathIndex >=0 ) && ( PathIndex < M->Leaf.PathCount ) );
+					if (M->Leaf.Clip != NULL)
+						{
+							geMotionClip_SampleTrack(M->Leaf.Clip,PathIndex,Time,Rotation,Translation);
+							break;
+						}
 					P= M->Leaf.PathArray[PathIndex];
 					assert( P != NULL );
 					gePath_SampleChannels(P,Time,Rotation,Translation);
@@ -642,13 +676,13 @@ GENESISAPI geBoolean GENESISCC geMotion_SampleChannelsNamed(const geMotion *M, c
 				break;
 			case (MOTION_NODE_LEAF):
 				{
-					gePath *P;
-					P = geMotion_GetPathNamed(M, PathName);
-					if (P == NULL)
+					int Index;
+					Index = geMotion_GetPathIndexNamed(M, PathName);
+					if (Index < 0)
 						{
 							return GE_FALSE;
 						}
-					gePath_SampleChannels(P,Time,Rotation,Translation);
+					geMotion_SampleChannels(M,Index,Time,Rotation,Translation);
 					AnyChannels = GE_TRUE;
 				}
 				break;
@@ -659,6 +693,52 @@ GENESISAPI geBoolean GENESISCC geMotion_SampleChannelsNamed(const geMotion *M, c
 }		
 
 
+static volatile int32 geMotion_UnpackLock = 0;
+
+	// packed motions sample from the clip, the paths are only rebuilt for callers that
+	// want a gePath.  Sampling doesn't look at them, so they are only built once, here.
+static gePath * GENESISCC geMotion_GetPackedPath(const geMotion *M,int Index)
+{
+	geMotion_Leaf *Leaf;
+	gePath *P = NULL;
+	int i;
+
+	Leaf = (geMotion_Leaf *)&(M->Leaf);		// the paths are a cache, M doesn't change
+
+	geSpinLock_Lock(&geMotion_UnpackLock);
+
+	if (Leaf->PathArray == NULL && Leaf->PathCount > 0)
+		{
+			gePath **PathArray;
+
+			PathArray = GE_RAM_ALLOCATE_ARRAY(gePath*, Leaf->PathCount);
+			if (PathArray == NULL)
+				{
+					geErrorLog_Add(ERR_MOTION_CREATE_ENOMEM, NULL);
+					goto Done;
+				}
+			for (i=0; i<Leaf->PathCount; i++)
+				{
+					PathArray[i] = geMotionClip_CreatePath(Leaf->Clip, i);
+					if (PathArray[i] == NULL)
+						{
+							while (i-- > 0)
+								gePath_Destroy(&(PathArray[i]));
+							geRam_Free(PathArray);
+							goto Done;
+						}
+				}
+			Leaf->PathArray = PathArray;
+		}
+
+	if (Leaf->PathArray != NULL)
+		P = Leaf->PathArray[Index];
+
+Done:
+	geSpinLock_Unlock(&geMotion_UnpackLock);
+	return P;
+}
+
 GENESISAPI gePath * GENESISCC geMotion_GetPath(const geMotion *M,int Index)
 {
 	assert( M != NULL );
@@ -673,12 +753,15 @@ GENESISAPI gePath * GENESISCC geMotion_GetPath(const geMotion *M,int Index)
 	assert( Index <= M->Leaf.PathCount );
 	assert( Index >= 0 );
 
+	if (M->Leaf.Clip != NULL)
+		{	// packed
+			return geMotion_GetPackedPath(M, Index);
+		}
 	return M->Leaf.PathArray[Index];
 }
 
 GENESISAPI const char * GENESISCC geMotion_GetNameOfPath(const geMotion *M, int Index)
 {
-	gePath *P;
 	assert( M != NULL );
 
 	if (M->NodeType!=MOTION_NODE_LEAF)
@@ -690,8 +773,7 @@ GENESISAPI const char * GENESISCC geMotion_GetNameOfPath(const geMotion *M, int
 			return NULL;
 		}
 
-	P = geMotion_GetPath(M,Index);
-	if (P==NULL)
+	if (Index < 0 || Index >= M->Leaf.PathCount)
 		{
 			return NULL;
 		}
@@ -766,6 +848,12 @@ GENESISAPI geBoolean GENESISCC geMotion_GetTimeExtents(const geMotion *M,gePath_
 				break;			
 			case (MOTION_NODE_LEAF):
 				found = 0;
+				if (M->Leaf.Clip != NULL)
+					{
+						if (geMotionClip_GetTimeExtents(M->Leaf.Clip,StartTime,EndTime)!=GE_FALSE)
+							found++;
+						break;
+					}
 				for (i=0; i<M->Leaf.PathCount; i++)
 					{
 						if (gePath_GetTimeExtents(M->Leaf.PathArray[i],&Start,&End)!=GE_FALSE)
@@ -1474,6 +1562,11 @@ GENESISAPI geBoolean GENESISCC geMotion_GetNextEvent(
 #define MOTION_BIN_FILE_TYPE 0x424E544D 	// 'MTNB'
 #define MOTION_FILE_VERSION 0x00F0			// Restrict version to 16 bits
 
+// geMotion_BinaryFileLeafHeader Flags
+#define MOTION_LEAF_EVENTS_FLAG    (1)
+#define MOTION_LEAF_NAMEARRAY_FLAG (2)
+#define MOTION_LEAF_CLIP_FLAG      (4)		// Packed into a geMotionClip instead of a PathArray
+
 
 #define MOTION_NAME_ID			"NameID"
 #define MOTION_MAINTAINNAMES_ID "MaintainNames"
@@ -1710,6 +1803,12 @@ static geBoolean GENESISCC geMotion_WriteLeaf(const geMotion *M, geVFile *pFile)
 	assert( M->NodeType == MOTION_NODE_LEAF);
 	assert( geMotion_IsValid(M) != GE_FALSE );
 
+	if (M->Leaf.Clip != NULL)
+		{	// packed clips only go in binary files
+			geErrorLog_Add( ERR_MOTION_FILE_WRITE , NULL); 
+			return GE_FALSE; 
+		}
+
 	if (M->Leaf.Events == NULL)
 		flag = GE_FALSE;
 	else
@@ -1891,7 +1990,7 @@ static geBoolean GENESISCC geMotion_ReadBinaryLeaf(geMotion *M, geVFile *pFile)
 		}
 	M->Leaf.NameChecksum = Header.NameChecksum;
 	
-	if (Header.Flags & 0x1)
+	if (Header.Flags & MOTION_LEAF_EVENTS_FLAG)
 		{
 			M->Leaf.Events = geTKEvents_CreateFromFile(pFile);
 			if (M->Leaf.Events == NULL )
@@ -1905,7 +2004,7 @@ static geBoolean GENESISCC geMotion_ReadBinaryLeaf(geMotion *M, geVFile *pFile)
 			M->Leaf.Events = NULL;
 		}
 
-	if (Header.Flags & 0x2)
+	if (Header.Flags & MOTION_LEAF_NAMEARRAY_FLAG)
 		{
 			M->Leaf.NameArray = geStrBlock_CreateFromFile(pFile);
 			if (M->Leaf.NameArray == NULL)
@@ -1920,6 +2019,24 @@ static geBoolean GENESISCC geMotion_ReadBinaryLeaf(geMotion *M, geVFile *pFile)
 		}
 
 	M->Leaf.PathCount = 0;
+
+	if (Header.Flags & MOTION_LEAF_CLIP_FLAG)
+		{
+			M->Leaf.Clip = geMotionClip_CreateFromFile(pFile);
+			if (M->Leaf.Clip == NULL)
+				{
+					geErrorLog_Add( ERR_MOTION_FILE_READ , NULL); 
+					return GE_FALSE; 
+				}
+			if (geMotionClip_GetTrackCount(M->Leaf.Clip) != Header.PathCount)
+				{
+					geErrorLog_Add( ERR_MOTION_FILE_PARSE , NULL); 
+					return GE_FALSE; 
+				}
+			M->Leaf.PathCount = Header.PathCount;
+			return GE_TRUE;
+		}
+
 	M->Leaf.PathArray = geRam_Allocate( Header.PathCount * sizeof(gePath*) );
 
 	if ( M->Leaf.PathArray == NULL )
@@ -2037,9 +2154,6 @@ static geBoolean GENESISCC geMotion_WriteBinaryLeaf(const geMotion *M, geVFile *
 	int i;
 	geMotion_BinaryFileLeafHeader Header;
 
-	#define MOTION_LEAF_EVENTS_FLAG    (1)
-	#define MOTION_LEAF_NAMEARRAY_FLAG (2)
-
 	assert( M != NULL );
 	assert( pFile != NULL );
 	assert( M->NodeType == MOTION_NODE_LEAF);
@@ -2058,6 +2172,11 @@ static geBoolean GENESISCC geMotion_WriteBinaryLeaf(const geMotion *M, geVFile *
 		{
 			Header.Flags |= MOTION_LEAF_NAMEARRAY_FLAG;
 		}
+
+	if (M->Leaf.Clip != NULL)
+		{
+			Header.Flags |= MOTION_LEAF_CLIP_FLAG;
+		}
 		
 		
 	if (geVFile_Write(pFile, &Header, sizeof(geMotion_BinaryFileLeafHeader)) == GE_FALSE)
@@ -2086,6 +2205,16 @@ static geBoolean GENESISCC geMotion_WriteBinaryLeaf(const geMotion *M, geVFile *
 				}
 		}
 
+	if (Header.Flags & MOTION_LEAF_CLIP_FLAG)
+		{
+			if (geMotionClip_WriteToBinaryFile(M->Leaf.Clip,pFile) == GE_FALSE)
+				{
+					geErrorLog_Add( ERR_MOTION_FILE_WRITE , NULL); 
+					return GE_FALSE; 
+				}
+			return GE_TRUE;
+		}
+
 	for (i=0; i<M->Leaf.PathCount; i++)
 		{
 			if (gePath_WriteToBinaryFile(M->Leaf.PathArray[i],pFile) == GE_FALSE)
@@ -2185,3 +2314,76 @@ GENESISAPI geBoolean GENESISCC geMotion_WriteToBinaryFile(const geMotion *M,geVF
 		}
 	return GE_TRUE;
 }
+
+
+GENESISAPI geBoolean GENESISCC geMotion_Pack(geMotion *M, geFloat SampleRate)
+{
+	geMotionClip *Clip;
+	int i;
+
+	assert( M != NULL );
+	assert( geMotion_IsValid(M) != GE_FALSE );
+
+	if (M->NodeType != MOTION_NODE_LEAF)
+		{	// compound motions blend their sub motions, those can be packed by themselves
+			return GE_FALSE;
+		}
+	if (M->Leaf.Clip != NULL)
+		{
+			return GE_TRUE;
+		}
+
+	Clip = geMotionClip_CreateFromPaths(M->Leaf.PathArray,M->Leaf.PathCount,SampleRate);
+	if (Clip == NULL)
+		{
+			return GE_FALSE;
+		}
+
+	gePoseCache_RemoveMotion(M);
+
+	for (i=0; i< M->Leaf.PathCount; i++)
+		{
+			gePath_Destroy( &( M->Leaf.PathArray[i] ) );
+		}
+	if (M->Leaf.PathArray != NULL)
+		{
+			geRam_Free(M->Leaf.PathArray);
+			M->Leaf.PathArray = NULL;
+		}
+	M->Leaf.Clip = Clip;
+	return GE_TRUE;
+}
+
+GENESISAPI geBoolean GENESISCC geMotion_IsPacked(const geMotion *M)
+{
+	assert( M != NULL );
+	assert( geMotion_IsValid(M) != GE_FALSE );
+
+	if (M->NodeType != MOTION_NODE_LEAF)
+		{
+			return GE_FALSE;
+		}
+	return (M->Leaf.Clip != NULL) ? GE_TRUE : GE_FALSE;
+}
+
+void GENESISCC geMotion_SampleChannelRange(const geMotion *M, int First, int Count, geFloat Time, 
+							geQuaternion *Rotations, geVec3d *Translations)
+{
+	int i;
+
+	assert( M != NULL );
+	assert( geMotion_IsValid(M) != GE_FALSE );
+	assert( Rotations != NULL );
+	assert( Translations != NULL );
+
+	if (M->NodeType == MOTION_NODE_LEAF && M->Leaf.Clip != NULL)
+		{
+			geMotionClip_SampleTracks(M->Leaf.Clip,First,Count,Time,Rotations,Translations);
+			return;
+		}
+
+	for (i=0; i<Count; i++)
+		{
+			geMotion_SampleChannels(M,First+i,Time,&(Rotations[i]),&(Translations[i]));
+		}
+}
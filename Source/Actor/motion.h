@@ -172,6 +172,19 @@ GENESISAPI geMotion *GENESISCC geMotion_CreateFromFile(geVFile *f);
 GENESISAPI geBoolean GENESISCC geMotion_WriteToFile(const geMotion *M, geVFile *f);
 GENESISAPI geBoolean GENESISCC geMotion_WriteToBinaryFile(const geMotion *M,geVFile *pFile);
 
+	// Packs the paths of a single motion into a clip sampled SampleRate times a second 
+	// (<= 0 for the default).  The paths are released, and no paths can be added.  _GetPath
+	// rebuilds them from the clip the first time it's called, with a key per sample.  Binary files keep the packed form, text files can't hold it.
+	// Returns GE_FALSE and leaves M alone if it can't be packed.
+GENESISAPI geBoolean GENESISCC geMotion_Pack(geMotion *M, geFloat SampleRate);
+GENESISAPI geBoolean GENESISCC geMotion_IsPacked(const geMotion *M);
+
+	// Samples paths [First, First+Count) in one go.  Fastest on packed motions.
+void GENESISCC geMotion_SampleChannelRange(const geMotion *M, int First, int Count, geFloat Time, 
+							geQuaternion *Rotations, geVec3d *Translations);
+	// Returns -1 if there is no path called Name
+int GENESISCC geMotion_GetPathIndexNamed(const geMotion *M, const char *Name);
+
 #ifdef __cplusplus
 }
 #endif
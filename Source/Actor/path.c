@@ -914,6 +914,13 @@ void GENESISCC gePath_SampleChannels(const gePath *P, gePath_TimeType Time, geQu
 }
 
 
+geBoolean GENESISCC gePath_IsLooped(const gePath *P)
+{
+	assert( P != NULL );
+	return P->Looped ? GE_TRUE : GE_FALSE;
+}
+
+
 GENESISAPI geBoolean GENESISCC gePath_GetTimeExtents(const gePath *P, gePath_TimeType *StartTime, gePath_TimeType *EndTime)
 	// returns false and times are unchanged if there is no extent (no keys)
 {
@@ -120,6 +120,8 @@ void GENESISCC gePath_SampleChannels(
 	// returns a rotation and a translation for the path at 'Time'
 	// p is not const because information is cached in p for next sample
 
+geBoolean GENESISCC gePath_IsLooped(const gePath *P);
+
 GENESISAPI geBoolean GENESISCC gePath_OffsetTimes(gePath *P, 
 	int StartingIndex, int ChannelMask, geFloat TimeOffset );
 		// slides all samples in path starting with StartingIndex down by TimeOffset
@@ -28,8 +28,13 @@
 #include "Errorlog.h"
 #include "pose.h"
 #include "strblock.h"
+#include "geNameIndex.h"
+
+#define GE_POSECACHE_PRIVATE
+#include "posecache.h"
 
 #define GE_POSE_STARTING_JOINT_COUNT (1)
+#define GE_POSE_SAMPLE_BATCH (32)		// joints sampled at once by name-matched motions
 
 
 /* this object maintains a hierarchy of joints.
@@ -64,6 +69,7 @@ typedef struct gePose
 	int32			  NameChecksum;	// checksum based on joint names and list order
 	geBoolean		  Touched;		// if any joint has been touched & needs recomputation	
 	geStrBlock		 *JointNames;
+	geNameIndex		 *JointIndex;	// joint number+1 by name, NULL to search JointNames
 	geVec3d			  Scale;		// current scaling. Used for scaling motion samples
 
 	geBoolean		  Slave;			// if pose is 'slaved' to parent -vs- attached.
@@ -185,6 +191,7 @@ gePose *GENESISCC gePose_Create(void)
 	P->JointCount = 0;
 	P->OnlyThisJoint = GE_POSE_ROOT_JOINT-1;		
 	P->JointNames = geStrBlock_Create();
+	P->JointIndex = geNameIndex_Create(0, GE_TRUE);	// not fatal if NULL, names just get searched
 	P->Touched = GE_FALSE;
 	if ( P->JointNames == NULL )
 		{
@@ -211,6 +218,7 @@ gePose *GENESISCC gePose_Create(void)
 		{
 			if (P->JointNames != NULL)
 				geStrBlock_Destroy(&(P->JointNames));
+			geNameIndex_Destroy(&(P->JointIndex));
 			if (P->JointArray != NULL)
 				geRam_Free(P->JointArray);
 			geRam_Free(P);
@@ -226,6 +234,7 @@ void GENESISCC gePose_Destroy(gePose **PP)
 	assert( (*PP)->JointNames != NULL );
 	assert( geStrBlock_GetCount((*PP)->JointNames) == (*PP)->JointCount );
 	geStrBlock_Destroy( &( (*PP)->JointNames ) );
+	geNameIndex_Destroy( &( (*PP)->JointIndex ) );
 	if ((*PP)->TransformArray!=NULL)
 		{
 			geXFArray_Destroy(&( (*PP)->TransformArray) );
@@ -349,6 +358,21 @@ void GENESISCC gePose_Detach(gePose *P)
 	gePose_InitializeJoint(&(P->RootJoint),GE_POSE_ROOT_JOINT,NULL);
 }
 
+const gePose *GENESISCC gePose_GetAttachRoot(const gePose *P, int *Depth)
+{
+	int D=0;
+	assert( P != NULL );
+
+	while (P->Parent != NULL)
+		{
+			P = P->Parent;
+			D++;
+		}
+	if (Depth != NULL)
+		*Depth = D;
+	return P;
+}
+
 
 static geBoolean GENESISCC gePose_TransformCompare(const geXForm3d *T1, const geXForm3d *T2)
 {
@@ -508,6 +532,15 @@ geBoolean GENESISCC gePose_FindNamedJointIndex(const gePose *P, const char *Join
 	if (JointName == NULL )
 		return GE_FALSE;
 
+	if (P->JointIndex != NULL)
+		{
+			i = (int)(intptr_t)geNameIndex_Find(P->JointIndex, JointName);
+			if (i == 0)
+				return GE_FALSE;
+			*Index = i-1;
+			return GE_TRUE;
+		}
+
 	for (i=0; i<P->JointCount; i++)
 		{
 			const char *NthName = geStrBlock_GetString(P->JointNames,i);
@@ -586,6 +619,13 @@ geBoolean GENESISCC gePose_AddJoint(
 
 	*JointIndex = JointCount;
 
+	// duplicate names keep the first joint, like the search.
+	if (P->JointIndex != NULL)
+		{
+			if (geNameIndex_Add(P->JointIndex, (JointName==NULL)?"":JointName, (void *)(intptr_t)(JointCount+1))==GE_FALSE)
+				geNameIndex_Destroy(&(P->JointIndex));
+		}
+
 	P->NameChecksum = geStrBlock_GetChecksum( P->JointNames );
 	return GE_TRUE;
 }
@@ -709,6 +749,48 @@ void GENESISCC gePose_Clear(gePose *P,const geXForm3d *Transform)
 	P->Touched = GE_TRUE;
 }	
 
+typedef struct
+{
+	const gePose	*Pose;
+	const geMotion	*Motion;
+	geBoolean		 NameBinding;
+} gePose_CacheFillContext;
+
+	// samples the unscaled local channels of every joint, for the pose cache
+static void GENESISCC gePose_FillCacheEntry(gePoseCache_Entry *E, geFloat Time, void *Context)
+{
+	const gePose_CacheFillContext *C = (const gePose_CacheFillContext *)Context;
+	int i;
+
+	assert( E->JointCount == C->Pose->JointCount );
+
+	if (C->NameBinding == GE_FALSE)
+		{
+			geMotion_SampleChannelRange(C->Motion,0,E->JointCount,Time,E->Rotation,E->Translation);
+			for (i=0; i<E->JointCount; i++)
+				E->Sampled[i] = GE_TRUE;
+			return;
+		}
+
+	for (i=0; i<E->JointCount; i++)
+		{
+			E->Sampled[i] = geMotion_SampleChannelsNamed(C->Motion,
+				geStrBlock_GetString(C->Pose->JointNames,i),
+				Time,&(E->Rotation[i]),&(E->Translation[i]));
+		}
+}
+
+static const gePoseCache_Entry *GENESISCC gePose_GetCacheEntry(const gePose *P, const geMotion *M, 
+							geFloat *Time, geBoolean NameBinding)
+{
+	gePose_CacheFillContext C;
+
+	C.Pose        = P;
+	C.Motion      = M;
+	C.NameBinding = NameBinding;
+	return gePoseCache_Get(M,Time,P->NameChecksum,P->JointCount,gePose_FillCacheEntry,&C);
+}
+
 void GENESISCC gePose_SetMotion(gePose *P, const geMotion *M, geFloat Time,
 							const geXForm3d *Transform)
 {
@@ -716,6 +798,7 @@ void GENESISCC gePose_SetMotion(gePose *P, const geMotion *M, geFloat Time,
 	int i;
 	gePose_Joint *J;
 	geXForm3d RootTransform;
+	const gePoseCache_Entry *Cached;
 	
 	assert( P != NULL );
 
@@ -761,6 +844,50 @@ void GENESISCC gePose_SetMotion(gePose *P, const geMotion *M, geFloat Time,
 		NameBinding = GE_TRUE;
 
 	P->Touched = GE_TRUE;
+
+	Cached = gePose_GetCacheEntry(P,M,&Time,NameBinding);
+	if (Cached != NULL)
+		{
+			for (i=0, J=&(P->JointArray[0]); i<P->JointCount; i++,J++)
+				{
+					if (Cached->Sampled[i] == GE_FALSE)
+						continue;
+					J->LocalRotation    = Cached->Rotation[i];
+					J->LocalTranslation = Cached->Translation[i];
+					J->Touched = GE_TRUE;
+					J->LocalTranslation.X *= P->Scale.X;
+					J->LocalTranslation.Y *= P->Scale.Y;
+					J->LocalTranslation.Z *= P->Scale.Z;
+				}
+			return;
+		}
+
+	if (NameBinding == GE_FALSE)
+		{	// the motion's paths line up with the joints, so sample them a batch at a time
+			geQuaternion R[GE_POSE_SAMPLE_BATCH];
+			geVec3d      T[GE_POSE_SAMPLE_BATCH];
+			int First,Count,k;
+
+			for (First=0; First<P->JointCount; First+=Count)
+				{
+					Count = P->JointCount - First;
+					if (Count > GE_POSE_SAMPLE_BATCH)
+						Count = GE_POSE_SAMPLE_BATCH;
+
+					geMotion_SampleChannelRange(M,First,Count,Time,R,T);
+					for (k=0, J=&(P->JointArray[First]); k<Count; k++,J++)
+						{
+							J->LocalRotation    = R[k];
+							J->LocalTranslation = T[k];
+							J->Touched = GE_TRUE;
+							J->LocalTranslation.X *= P->Scale.X;
+							J->LocalTranslation.Y *= P->Scale.Y;
+							J->LocalTranslation.Z *= P->Scale.Z;
+						}
+				}
+			return;
+		}
+
 	#pragma message("could optimize this by looping two ways (min(jointcount,pathcount))")
 	for (i=0, J=&(P->JointArray[0]); i<P->JointCount; i++,J++)
 		{
@@ -899,6 +1026,7 @@ void GENESISCC gePose_BlendMotion(
 	geQuaternion R1;
 	geVec3d      T1;
 	geXForm3d    RootTransform;
+	const gePoseCache_Entry *Cached;
 	
 	assert( P != NULL );
 	//assert( M != NULL );  // M can be NULL
@@ -965,11 +1093,20 @@ void GENESISCC gePose_BlendMotion(
 	
 	P->Touched = GE_TRUE;
 
+	Cached = gePose_GetCacheEntry(P,M,&Time,NameBinding);
+
 	for (i=0, J=&(P->JointArray[0]); i<P->JointCount; i++,J++)
 		{
 			//gePath *JointPath;
 							
-			if (NameBinding == GE_FALSE)
+			if (Cached != NULL)
+				{
+					if (Cached->Sampled[i] == GE_FALSE)
+						continue;
+					R1 = Cached->Rotation[i];
+					T1 = Cached->Translation[i];
+				}
+			else if (NameBinding == GE_FALSE)
 				{
 					geMotion_SampleChannels(M,i,Time,&R1,&T1);
 					//JointPath = geMotion_GetPath(M,i);
@@ -1098,13 +1235,11 @@ int GENESISCC gePose_AccumulateCoverage(gePose *P, const geMotion *M, geBoolean
 
 	for (i=0, J=&(P->JointArray[0]); i<P->JointCount; i++,J++)
 		{
-			gePath *JointPath;
 			if (J->Covered == GE_FALSE)
 				{
 					if (NameBinding == GE_TRUE)
 						{
-							JointPath = geMotion_GetPathNamed(M, geStrBlock_GetString(P->JointNames,i));
-							if (JointPath == NULL)
+							if (geMotion_GetPathIndexNamed(M, geStrBlock_GetString(P->JointNames,i)) < 0)
 								continue;
 						}
 					if (QueryOnly == GE_FALSE)
@@ -150,6 +150,11 @@ geBoolean GENESISCC gePose_Attach(gePose *Slave, int SlaveBoneIndex,
 
 void GENESISCC gePose_Detach(gePose *P);
 
+	// returns the top of P's attachment chain (P itself if it isn't attached), and how many
+	//  attachments up it is.  Updating any pose in a chain touches every pose above it, so
+	//  poses with the same root can't be updated at the same time.
+const gePose *GENESISCC gePose_GetAttachRoot(const gePose *P, int *Depth);
+
 	// a pose can also maintain a record of which joints are touched by a given motion.
 	// these funtions set,clear and query the record.
 	// ClearCoverage clears the coverage flag for all joints 
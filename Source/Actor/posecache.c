@@ -0,0 +1,225 @@
+/*******************************************************************************
+Copyright © 2024 Mark E. Sowden <hogsy@oldtimes-software.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************/
+
+
+
+#include <assert.h>
+#include <math.h>
+
+#include "RAM.H"
+#include "geThread.h"
+
+#define GE_POSECACHE_PRIVATE
+#include "posecache.h"
+
+#define GE_POSECACHE_HASH_SIZE		(256)		// power of two
+#define GE_POSECACHE_MAX_ENTRIES	(1024)		// per flush
+
+static geFloat				gePoseCache_TimeStep = 0.0f;
+static volatile int32		gePoseCache_Lock = 0;
+static gePoseCache_Entry	*gePoseCache_Hash[GE_POSECACHE_HASH_SIZE];
+static gePoseCache_Stats	gePoseCache_Counters;
+
+static uint32 GENESISCC gePoseCache_HashKey(const geMotion *M, int32 Bucket, int32 NameChecksum)
+{
+	uint32 Key;
+
+	Key  = (uint32)((size_t)M >> 4);
+	Key ^= (uint32)Bucket * 2654435761u;
+	Key ^= (uint32)NameChecksum * 40503u;
+	Key ^= Key >> 15;
+	return Key & (GE_POSECACHE_HASH_SIZE - 1);
+}
+
+static void GENESISCC gePoseCache_FreeAll(void)
+{
+	int i;
+
+	for (i=0; i<GE_POSECACHE_HASH_SIZE; i++)
+		{
+			while (gePoseCache_Hash[i] != NULL)
+				{
+					gePoseCache_Entry *E = gePoseCache_Hash[i];
+					gePoseCache_Hash[i] = E->Next;
+					geRam_Free(E);
+				}
+		}
+	gePoseCache_Counters.Entries = 0;
+}
+
+//=====================================================================================
+//	gePoseCache_SetTimeStep
+//=====================================================================================
+GENESISAPI void GENESISCC gePoseCache_SetTimeStep(geFloat TimeStep)
+{
+	geSpinLock_Lock(&gePoseCache_Lock);
+	if (TimeStep < 0.0f)
+		TimeStep = 0.0f;
+	if (TimeStep != gePoseCache_TimeStep)
+		{
+			// the buckets change size, so nothing in there is any good
+			gePoseCache_FreeAll();
+			gePoseCache_TimeStep = TimeStep;
+		}
+	geSpinLock_Unlock(&gePoseCache_Lock);
+}
+
+//=====================================================================================
+//	gePoseCache_GetTimeStep
+//=====================================================================================
+GENESISAPI geFloat GENESISCC gePoseCache_GetTimeStep(void)
+{
+	return gePoseCache_TimeStep;
+}
+
+//=====================================================================================
+//	gePoseCache_Flush
+//=====================================================================================
+GENESISAPI void GENESISCC gePoseCache_Flush(void)
+{
+	geSpinLock_Lock(&gePoseCache_Lock);
+	gePoseCache_FreeAll();
+	gePoseCache_Counters.Hits   = 0;
+	gePoseCache_Counters.Misses = 0;
+	geSpinLock_Unlock(&gePoseCache_Lock);
+}
+
+//=====================================================================================
+//	gePoseCache_GetStats
+//=====================================================================================
+GENESISAPI void GENESISCC gePoseCache_GetStats(gePoseCache_Stats *Stats)
+{
+	assert( Stats != NULL );
+
+	geSpinLock_Lock(&gePoseCache_Lock);
+	*Stats = gePoseCache_Counters;
+	geSpinLock_Unlock(&gePoseCache_Lock);
+}
+
+//=====================================================================================
+//	gePoseCache_Get
+//=====================================================================================
+gePoseCache_Entry *GENESISCC gePoseCache_Get(	const geMotion *M, 
+												geFloat *Time, 
+												int32 NameChecksum, 
+												int JointCount,
+												gePoseCache_FillCB Fill, 
+												void *Context)
+{
+	gePoseCache_Entry *E;
+	geFloat Step;
+	int32 Bucket;
+	uint32 Key;
+
+	assert( M != NULL );
+	assert( Time != NULL );
+	assert( Fill != NULL );
+
+	Step = gePoseCache_TimeStep;
+	if (Step <= 0.0f || JointCount <= 0)
+		return NULL;
+
+	Bucket = (int32)floor(*Time / Step);
+	*Time  = (geFloat)Bucket * Step;
+	Key    = gePoseCache_HashKey(M, Bucket, NameChecksum);
+
+	geSpinLock_Lock(&gePoseCache_Lock);
+
+	for (E=gePoseCache_Hash[Key]; E!=NULL; E=E->Next)
+		{
+			if (	E->Motion == M && E->Bucket == Bucket && 
+					E->NameChecksum == NameChecksum && E->JointCount == JointCount)
+				{
+					gePoseCache_Counters.Hits++;
+					geSpinLock_Unlock(&gePoseCache_Lock);
+					return E;
+				}
+		}
+
+	gePoseCache_Counters.Misses++;
+
+	if (gePoseCache_Counters.Entries >= GE_POSECACHE_MAX_ENTRIES)
+		{
+			geSpinLock_Unlock(&gePoseCache_Lock);
+			return NULL;
+		}
+
+	// one block for the entry and its channels
+	E = (gePoseCache_Entry *)geRam_Allocate( sizeof(gePoseCache_Entry) 
+							+ JointCount * (sizeof(geQuaternion) + sizeof(geVec3d) + sizeof(geBoolean)) );
+	if (E == NULL)
+		{	// not an error: the caller just samples by itself
+			geSpinLock_Unlock(&gePoseCache_Lock);
+			return NULL;
+		}
+
+	E->Motion       = M;
+	E->Bucket       = Bucket;
+	E->NameChecksum = NameChecksum;
+	E->JointCount   = JointCount;
+	E->Rotation     = (geQuaternion *)(E + 1);
+	E->Translation  = (geVec3d *)(E->Rotation + JointCount);
+	E->Sampled      = (geBoolean *)(E->Translation + JointCount);
+
+	Fill(E, *Time, Context);
+
+	E->Next = gePoseCache_Hash[Key];
+	gePoseCache_Hash[Key] = E;
+	gePoseCache_Counters.Entries++;
+
+	geSpinLock_Unlock(&gePoseCache_Lock);
+	return E;
+}
+
+//=====================================================================================
+//	gePoseCache_RemoveMotion
+//=====================================================================================
+void GENESISCC gePoseCache_RemoveMotion(const geMotion *M)
+{
+	int i;
+
+	// the entry count is only stable under the lock: another thread may be filling one
+	geSpinLock_Lock(&gePoseCache_Lock);
+	if (gePoseCache_Counters.Entries == 0)
+		{
+			geSpinLock_Unlock(&gePoseCache_Lock);
+			return;
+		}
+
+	for (i=0; i<GE_POSECACHE_HASH_SIZE; i++)
+		{
+			gePoseCache_Entry **Link = &(gePoseCache_Hash[i]);
+			while (*Link != NULL)
+				{
+					gePoseCache_Entry *E = *Link;
+					if (E->Motion == M)
+						{
+							*Link = E->Next;
+							geRam_Free(E);
+							gePoseCache_Counters.Entries--;
+						}
+					else
+						Link = &(E->Next);
+				}
+		}
+	geSpinLock_Unlock(&gePoseCache_Lock);
+}
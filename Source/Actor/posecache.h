@@ -0,0 +1,101 @@
+/*******************************************************************************
+Copyright © 2024 Mark E. Sowden <hogsy@oldtimes-software.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************/
+
+
+
+#ifndef GE_POSECACHE_H
+#define GE_POSECACHE_H
+
+#include "BASETYPE.H"
+#include "VEC3D.H"
+#include "quatern.h"
+#include "motion.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//=====================================================================================
+//	Shared pose cache
+//
+//	Crowds tend to play the same motion at the same time.  When the cache is on, 
+//	gePose samples a motion at the start of a time bucket and keeps the unscaled local 
+//	joint channels, keyed by the motion, the bucket and the skeleton (the joint name 
+//	checksum, the same one geBody_GetBoneNameChecksum gives).  Any other pose with that 
+//	skeleton asking for the same motion in the same bucket just copies them.
+//
+//	The cache is off by default.  Entries only live until the next gePoseCache_Flush, 
+//	which the engine calls every frame; flush it yourself after editing a motion.
+//=====================================================================================
+
+typedef struct gePoseCache_Stats
+{
+	int32	Hits;
+	int32	Misses;
+	int32	Entries;
+} gePoseCache_Stats;
+
+// TimeStep is the size of a time bucket in seconds, <= 0 turns the cache off
+GENESISAPI void		GENESISCC gePoseCache_SetTimeStep(geFloat TimeStep);
+GENESISAPI geFloat	GENESISCC gePoseCache_GetTimeStep(void);
+
+// Drops every entry and restarts the counters
+GENESISAPI void		GENESISCC gePoseCache_Flush(void);
+GENESISAPI void		GENESISCC gePoseCache_GetStats(gePoseCache_Stats *Stats);
+
+#ifdef GE_POSECACHE_PRIVATE
+
+typedef struct gePoseCache_Entry
+{
+	const geMotion		*Motion;
+	int32				 Bucket;
+	int32				 NameChecksum;
+	int					 JointCount;
+	geQuaternion		*Rotation;
+	geVec3d				*Translation;
+	geBoolean			*Sampled;			// GE_FALSE when the motion has no path for that joint
+	struct gePoseCache_Entry *Next;
+} gePoseCache_Entry;
+
+// Fills the channels of a new entry at Time, for a pose with JointCount joints
+typedef void (GENESISCC *gePoseCache_FillCB)(gePoseCache_Entry *Entry, geFloat Time, void *Context);
+
+// Returns NULL when the cache is off or full, then sample as usual.  While the cache is 
+// on *Time is always moved to the start of its bucket, so a pose looks the same whether 
+// or not it got an entry.  Entries stay valid until the next flush.
+gePoseCache_Entry	*GENESISCC gePoseCache_Get(	const geMotion *M, 
+												geFloat *Time, 
+												int32 NameChecksum, 
+												int JointCount,
+												gePoseCache_FillCB Fill, 
+												void *Context);
+
+// Forgets every entry of a motion that is going away
+void				 GENESISCC gePoseCache_RemoveMotion(const geMotion *M);
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
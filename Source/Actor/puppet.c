@@ -469,45 +469,45 @@ static int GENESISCC gePuppet_PrepLights(const gePuppet *P,
 	assert( LP );
 
 	L = (World->LightInfo);
+	if (P->MaxDynamicLightsToUse <= 0)
+		return 0;
+
+	// keep the closest MaxDynamicLightsToUse lights, sorted by distance (squared)
 	for (i=0,cnt=0; i<MAX_DYNAMIC_LIGHTS; i++)
 		{
 			if (L->DynamicLights[i].Active)
 				{
 					geVec3d *Position = &(L->DynamicLights[i].Pos);
 					geVec3d Normal;
+					geFloat Distance;
 
 					geVec3d_Subtract(Position,ReferencePoint,&Normal);
 
-					LP[cnt].Distance =	Normal.X * Normal.X + 
-										Normal.Y * Normal.Y +
-										Normal.Z * Normal.Z;
-					if (LP[cnt].Distance < L->DynamicLights[i].Radius*L->DynamicLights[i].Radius)
+					Distance =	Normal.X * Normal.X + 
+								Normal.Y * Normal.Y +
+								Normal.Z * Normal.Z;
+					if (Distance >= L->DynamicLights[i].Radius*L->DynamicLights[i].Radius)
+						continue;
+
+					for (j=cnt; j>0 && LP[j-1].Distance > Distance; j--)
 						{
-							LP[cnt].Color.Red = L->DynamicLights[i].Color.r;
-							LP[cnt].Color.Green = L->DynamicLights[i].Color.g;
-							LP[cnt].Color.Blue = L->DynamicLights[i].Color.b;
-							LP[cnt].Radius = L->DynamicLights[i].Radius;
-							LP[cnt].Normal = Normal;
-							cnt++;
+							if (j < P->MaxDynamicLightsToUse)
+								LP[j] = LP[j-1];
 						}
+					if (j >= P->MaxDynamicLightsToUse)
+						continue;
+
+					LP[j].Distance = Distance;
+					LP[j].Color.Red = L->DynamicLights[i].Color.r;
+					LP[j].Color.Green = L->DynamicLights[i].Color.g;
+					LP[j].Color.Blue = L->DynamicLights[i].Color.b;
+					LP[j].Radius = L->DynamicLights[i].Radius;
+					LP[j].Normal = Normal;
+					if (cnt < P->MaxDynamicLightsToUse)
+						cnt++;
 				}
 		}
 
-	// sort dynamic lights by distance (squared)
-	for (i=0; i<cnt; i++)
-		for (j=0; j<cnt-1; j++)
-			{
-				if (LP[j].Distance > LP[j+1].Distance)
-					{
-						gePuppet_Light Swap = LP[j];
-						LP[j] = LP[j+1];
-						LP[j+1] = Swap;
-					}
-			}
-
-	if (cnt > P->MaxDynamicLightsToUse)
-		cnt = P->MaxDynamicLightsToUse;
-
 	// go back and finish setting up closest lights
 	for (i=0; i<cnt; i++)
 		{
@@ -744,6 +744,7 @@ static void GENESISCC gePuppet_DrawShadow(const gePuppet *P,
 		geWorld_Model	*Model;
 		Mesh_RenderQ	*Mesh;
 		geActor         *Actor;
+		Trace_Context	TraceCtx;
 
 			
 		GFXNodes = (World)->CurrentBSP->BSPData.GFXNodes;
@@ -755,7 +756,8 @@ static void GENESISCC gePuppet_DrawShadow(const gePuppet *P,
 		Pos2.Y -= 30000.0f;
 
 		// Get shadow hit plane impact point
-		GoodImpact = Trace_WorldCollisionExact(World, 
+		Trace_SetupIntersect(World, &TraceCtx);
+		GoodImpact = Trace_WorldCollisionExact(&TraceCtx, World, 
 									&Pos1,&Pos2,GE_COLLIDE_MODELS,&Impact,&Plane,&Model,&Mesh,&Actor,0, NULL, NULL);
 
 	}
@@ -982,6 +984,58 @@ static void GENESISCC gePuppet_DrawShadow(const gePuppet *P,
 
 int32		NumClips;
 
+	// screen height (in pixels) the body has to be under to use each lower level of detail
+static const geFloat gePuppet_LevelOfDetailPixels[GE_BODY_NUMBER_OF_LOD] = { 0.0f, 160.0f, 80.0f, 40.0f };
+
+	// picks a level of detail from how big the body is on screen
+static int GENESISCC gePuppet_ChooseLevelOfDetail(const gePuppet *P, 
+							const geXFArray *JointTransforms,
+							const geVec3d *Scale,
+							const geCamera *Camera)
+{
+	int			Levels,Lod,Count,i;
+	const geXForm3d	*XF;
+	geVec3d		Center;
+	geFloat		Radius,MaxScale,Z,Pixels;
+
+	assert( P );
+	assert( Camera );
+
+	Levels = geBodyInst_GetLevelsOfDetail(P->BodyInstance);
+	if (Levels <= 1)
+		return GE_BODY_HIGHEST_LOD;
+
+	MaxScale = (geFloat)fabs(Scale->X);
+	if ((geFloat)fabs(Scale->Y) > MaxScale) MaxScale = (geFloat)fabs(Scale->Y);
+	if ((geFloat)fabs(Scale->Z) > MaxScale) MaxScale = (geFloat)fabs(Scale->Z);
+	Radius = geBodyInst_GetRadius(P->BodyInstance) * MaxScale;
+	if (Radius <= 0.0f)
+		return GE_BODY_HIGHEST_LOD;
+
+	// the middle of the skeleton is close enough to the middle of the skin
+	XF = geXFArray_GetElements(JointTransforms,&Count);
+	if ((XF == NULL) || (Count <= 0))
+		return GE_BODY_HIGHEST_LOD;
+	geVec3d_Clear(&Center);
+	for (i=0; i<Count; i++)
+		geVec3d_Add(&Center,&(XF[i].Translation),&Center);
+	geVec3d_Scale(&Center,1.0f/(geFloat)Count,&Center);
+
+	geXForm3d_Transform(geCamera_GetCameraSpaceXForm(Camera),&Center,&Center);
+	Z = -Center.Z;
+	if (Z <= Radius)
+		return GE_BODY_HIGHEST_LOD;		// close enough to be inside it
+
+	Pixels = 2.0f * Radius * geCamera_GetScale(Camera) / Z;
+
+	for (Lod=GE_BODY_HIGHEST_LOD; Lod+1<Levels; Lod++)
+		{
+			if (Pixels >= gePuppet_LevelOfDetailPixels[Lod+1])
+				break;
+		}
+	return Lod;
+}
+
 geBoolean GENESISCC gePuppet_RenderThroughFrustum(const gePuppet *P, 
 						const gePose *Joints, 
 						const geExtBox *Box, 
@@ -1003,10 +1057,9 @@ geBoolean GENESISCC gePuppet_RenderThroughFrustum(const gePuppet *P,
 
 	JointTransforms = gePose_GetAllJointTransforms(Joints);
 
-	#pragma message ("Level of detail hacked:")
-
 	gePose_GetScale(Joints,&Scale);
-	G = geBodyInst_GetGeometry(P->BodyInstance, &Scale, JointTransforms, 0, NULL);
+	G = geBodyInst_GetGeometry(P->BodyInstance, &Scale, JointTransforms, 
+				gePuppet_ChooseLevelOfDetail(P, JointTransforms, &Scale, Camera), NULL);
 
 	// Setup clip flags...
 	ClipFlags = 0xffff;
@@ -1266,6 +1319,105 @@ int Puppet_AverageIndex = 0;
 #endif
 
 
+#define BACK_EDGE (1.0f)
+
+	// transform and project the box to the screen, then check extents of that projection
+	//  against the clipping rect
+static geBoolean GENESISCC gePuppet_TestBoxVisible(	const geCamera *Camera, 
+							const geRect *ClippingRect, 
+							const geExtBox *TestBox)
+{
+	geVec3d				BoxCorners[8];
+	const geXForm3d		*ObjectToCamera;
+	geVec3d				Maxs,Mins;
+	int					i;
+	geBoolean			ZFarEnable;
+	geFloat				ZFar;
+
+	#define BIG_NUMBER (99e9f)  
+
+	BoxCorners[0] = TestBox->Min;
+	BoxCorners[1] = BoxCorners[0];  BoxCorners[1].X = TestBox->Max.X;
+	BoxCorners[2] = BoxCorners[0];  BoxCorners[2].Y = TestBox->Max.Y;
+	BoxCorners[3] = BoxCorners[0];  BoxCorners[3].Z = TestBox->Max.Z;
+	BoxCorners[4] = TestBox->Max;
+	BoxCorners[5] = BoxCorners[4];  BoxCorners[5].X = TestBox->Min.X;
+	BoxCorners[6] = BoxCorners[4];  BoxCorners[6].Y = TestBox->Min.Y;
+	BoxCorners[7] = BoxCorners[4];  BoxCorners[7].Z = TestBox->Min.Z;
+
+	ObjectToCamera = geCamera_GetCameraSpaceXForm(Camera);
+	assert( ObjectToCamera );
+
+	geVec3d_Set(&Maxs,-BIG_NUMBER,-BIG_NUMBER,-BIG_NUMBER);
+	geVec3d_Set(&Mins, BIG_NUMBER, BIG_NUMBER, BIG_NUMBER);
+	for (i=0; i<8; i++)
+		{
+			geVec3d V;
+			geXForm3d_Transform(  ObjectToCamera,&(BoxCorners[i]),&(BoxCorners[i]));
+			geCamera_Project(  Camera,&(BoxCorners[i]),&V);
+			if (V.X > Maxs.X ) Maxs.X = V.X;
+			if (V.X < Mins.X ) Mins.X = V.X;
+			if (V.Y > Maxs.Y ) Maxs.Y = V.Y;
+			if (V.Y < Mins.Y ) Mins.Y = V.Y;
+			if (V.Z > Maxs.Z ) Maxs.Z = V.Z;
+			if (V.Z < Mins.Z ) Mins.Z = V.Z;
+		}
+
+	if (   (Maxs.X < ClippingRect->Left) 
+		|| (Mins.X > ClippingRect->Right)
+		|| (Maxs.Y < ClippingRect->Top) 
+		|| (Mins.Y > ClippingRect->Bottom)
+		|| (Maxs.Z < BACK_EDGE))
+		{
+			// not gonna draw: box is not visible.
+			return GE_FALSE;
+		}
+
+	// Reject against ZFar clipplane if enabled...
+	geCamera_GetFarClipPlane(Camera, &ZFarEnable, &ZFar);
+
+	if (ZFarEnable)
+	{
+		if (Mins.Z > ZFar)
+			return GE_FALSE;				// Beyond ZFar ClipPlane
+	}
+	return GE_TRUE;
+}
+
+geBoolean GENESISCC gePuppet_ReserveRender(const gePuppet *P)
+{
+	assert( P );
+	return geBodyInst_ReserveGeometry(P->BodyInstance);
+}
+
+geBoolean GENESISCC gePuppet_PrepareRender(	const gePuppet *P, 
+							const gePose *Joints,
+							const geCamera *Camera, 
+							const geExtBox *TestBox)
+{
+	const geXFArray *JointTransforms;
+	geVec3d Scale;
+
+	assert( P      );
+	assert( Joints );
+	assert( Camera );
+
+	if (TestBox != NULL)
+	{
+		geRect ClippingRect;
+
+		geCamera_GetClippingRect(Camera,&ClippingRect);
+		if (gePuppet_TestBoxVisible(Camera,&ClippingRect,TestBox) == GE_FALSE)
+			return GE_FALSE;		// gePuppet_Render won't draw it either
+	}
+
+	JointTransforms = gePose_GetAllJointTransforms(Joints);
+
+	gePose_GetScale(Joints,&Scale);
+	return geBodyInst_PrepareGeometry(P->BodyInstance, &Scale, JointTransforms, 
+				gePuppet_ChooseLevelOfDetail(P, JointTransforms, &Scale, Camera), Camera);
+}
+
 geBoolean GENESISCC gePuppet_Render(	const gePuppet *P, 
 							const gePose *Joints,
 							geEngine *Engine, 
@@ -1280,7 +1432,6 @@ geBoolean GENESISCC gePuppet_Render(	const gePuppet *P,
 	#endif
 	geRect ClippingRect;
 	geBoolean Clipping = GE_TRUE;
-	#define BACK_EDGE (1.0f)
 
 	const geBodyInst_Geometry *G;
 	assert( P      );
@@ -1299,62 +1450,8 @@ geBoolean GENESISCC gePuppet_Render(	const gePuppet *P,
 	if (TestBox != NULL)
 	{
 		// see if the test box is visible on the screen.  If not: don't draw actor.
-		// (transform and project it to the screen, then check extents of that projection
-		//  against the clipping rect)
-		geVec3d				BoxCorners[8];
-		const geXForm3d		*ObjectToCamera;
-		geVec3d				Maxs,Mins;
-		int					i;
-		geBoolean			ZFarEnable;
-		geFloat				ZFar;
-
-		#define BIG_NUMBER (99e9f)  
-
-		BoxCorners[0] = TestBox->Min;
-		BoxCorners[1] = BoxCorners[0];  BoxCorners[1].X = TestBox->Max.X;
-		BoxCorners[2] = BoxCorners[0];  BoxCorners[2].Y = TestBox->Max.Y;
-		BoxCorners[3] = BoxCorners[0];  BoxCorners[3].Z = TestBox->Max.Z;
-		BoxCorners[4] = TestBox->Max;
-		BoxCorners[5] = BoxCorners[4];  BoxCorners[5].X = TestBox->Min.X;
-		BoxCorners[6] = BoxCorners[4];  BoxCorners[6].Y = TestBox->Min.Y;
-		BoxCorners[7] = BoxCorners[4];  BoxCorners[7].Z = TestBox->Min.Z;
-
-		ObjectToCamera = geCamera_GetCameraSpaceXForm(Camera);
-		assert( ObjectToCamera );
-
-		geVec3d_Set(&Maxs,-BIG_NUMBER,-BIG_NUMBER,-BIG_NUMBER);
-		geVec3d_Set(&Mins, BIG_NUMBER, BIG_NUMBER, BIG_NUMBER);
-		for (i=0; i<8; i++)
-			{
-				geVec3d V;
-				geXForm3d_Transform(  ObjectToCamera,&(BoxCorners[i]),&(BoxCorners[i]));
-				geCamera_Project(  Camera,&(BoxCorners[i]),&V);
-				if (V.X > Maxs.X ) Maxs.X = V.X;
-				if (V.X < Mins.X ) Mins.X = V.X;
-				if (V.Y > Maxs.Y ) Maxs.Y = V.Y;
-				if (V.Y < Mins.Y ) Mins.Y = V.Y;
-				if (V.Z > Maxs.Z ) Maxs.Z = V.Z;
-				if (V.Z < Mins.Z ) Mins.Z = V.Z;
-			}
-
-		if (   (Maxs.X < ClippingRect.Left) 
-			|| (Mins.X > ClippingRect.Right)
-			|| (Maxs.Y < ClippingRect.Top) 
-			|| (Mins.Y > ClippingRect.Bottom)
-			|| (Maxs.Z < BACK_EDGE))
-			{
-				// not gonna draw: box is not visible.
-				return GE_TRUE;
-			}
-
-			// Reject against ZFar clipplane if enabled...
-			geCamera_GetFarClipPlane(Camera, &ZFarEnable, &ZFar);
-
-			if (ZFarEnable)
-			{
-				if (Mins.Z > ZFar)
-					return GE_TRUE;				// Beyond ZFar ClipPlane
-			}
+		if (gePuppet_TestBoxVisible(Camera,&ClippingRect,TestBox) == GE_FALSE)
+			return GE_TRUE;
 	}
 
 	Engine->DebugInfo.NumActors++;
@@ -1368,9 +1465,9 @@ geBoolean GENESISCC gePuppet_Render(	const gePuppet *P,
 		
 	JointTransforms = gePose_GetAllJointTransforms(Joints);
 
-	#pragma message ("Level of detail hacked:")
 	gePose_GetScale(Joints,&Scale);
-	G = geBodyInst_GetGeometry(P->BodyInstance, &Scale, JointTransforms, 0,Camera);
+	G = geBodyInst_GetGeometry(P->BodyInstance, &Scale, JointTransforms, 
+				gePuppet_ChooseLevelOfDetail(P, JointTransforms, &Scale, Camera), Camera);
 
 	if ( G == NULL )
 		{
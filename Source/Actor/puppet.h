@@ -58,6 +58,15 @@ geBoolean GENESISCC gePuppet_Render(const gePuppet *P,
 					const geCamera *Camera, 
 					geExtBox *Box);
 
+	// Skins the puppet for Camera ahead of gePuppet_Render (see geBodyInst_PrepareGeometry).
+	// ReserveRender must be called first, from one thread.  PrepareRender can then run for
+	// several puppets at once, as long as their poses don't share an attachment root.
+geBoolean GENESISCC gePuppet_ReserveRender(const gePuppet *P);
+geBoolean GENESISCC gePuppet_PrepareRender(const gePuppet *P,
+					const gePose *Joints,
+					const geCamera *Camera, 
+					const geExtBox *Box);
+
 int GENESISCC gePuppet_GetMaterialCount( gePuppet *P );
 geBoolean GENESISCC gePuppet_GetMaterial( gePuppet *P, int MaterialIndex,
 									geBitmap **Bitmap, 
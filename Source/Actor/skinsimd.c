@@ -0,0 +1,456 @@
+/*******************************************************************************
+Copyright © 2024 Mark E. Sowden <hogsy@oldtimes-software.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************/
+
+
+
+#include <assert.h>
+#include <stddef.h>
+
+#include "skinsimd.h"
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+	#define GE_SKIN_X86
+	#if defined(_MSC_VER)
+		#include <intrin.h>
+		#define GE_SKIN_TARGET(x)
+	#else
+		#include <cpuid.h>
+		#define GE_SKIN_TARGET(x)	__attribute__((target(x)))
+	#endif
+	#include <immintrin.h>
+#endif
+
+// The vector kernels move a point and the u after it with one 16 byte load/store
+typedef char geSkin_CheckXSkinVertex[(offsetof(geBody_XSkinVertex, XU) == offsetof(geBody_XSkinVertex, XPoint) + 12) ? 1 : -1];
+typedef char geSkin_CheckSkinVertex[(offsetof(geBodyInst_SkinVertex, SVU) == offsetof(geBodyInst_SkinVertex, SVPoint) + 12) ? 1 : -1];
+typedef char geSkin_CheckNormal[(sizeof(geBody_Normal) >= 16) ? 1 : -1];
+
+typedef void (GENESISCC *geSkin_TransformFunc)(const geXForm3d *XF, const geCamera_Projection *Projection,
+						const geBody_XSkinVertex *S, geBodyInst_SkinVertex *D, int Count, int LevelOfDetailBit,
+						geVec3d *Mins, geVec3d *Maxs);
+typedef void (GENESISCC *geSkin_RotateFunc)(const geXForm3d *XF, const geBody_Normal *S, geVec3d *D, int Count, int LevelOfDetailBit);
+
+typedef struct
+{
+	const char				*Name;
+	geSkin_TransformFunc	Transform;
+	geSkin_RotateFunc		Rotate;
+} geSkin_Kernel;
+
+//=====================================================================================
+//	Plain C
+//=====================================================================================
+static void GENESISCC geSkin_TransformC(const geXForm3d *XF, const geCamera_Projection *Projection,
+						const geBody_XSkinVertex *S, geBodyInst_SkinVertex *D, int Count, int LevelOfDetailBit,
+						geVec3d *Mins, geVec3d *Maxs)
+{
+	for (; Count>0; Count--, S++, D++)
+	{
+		geVec3d		*V;
+
+		if (!(S->LevelOfDetailMask & LevelOfDetailBit))
+			continue;
+
+		V = &(D->SVPoint);
+		geXForm3d_Transform(XF, &(S->XPoint), V);
+
+		if (Projection)
+		{
+			geFloat	Z, ScaleOverZ;
+
+			Z = -V->Z;
+			if (Z < Projection->MinimumZ)
+				Z = Projection->MinimumZ;
+			ScaleOverZ = Projection->Scale / Z;
+
+			V->X = (V->X * ScaleOverZ) + Projection->XCenter;
+			V->Y = Projection->YCenter - (V->Y * ScaleOverZ);
+			V->Z = Z * Projection->ZScale;
+		}
+
+		D->SVU = S->XU;
+		D->SVV = S->XV;
+		D->ReferenceBoneIndex = S->BoneIndex;
+
+		if (V->X > Maxs->X) Maxs->X = V->X;
+		if (V->X < Mins->X) Mins->X = V->X;
+		if (V->Y > Maxs->Y) Maxs->Y = V->Y;
+		if (V->Y < Mins->Y) Mins->Y = V->Y;
+		if (V->Z > Maxs->Z) Maxs->Z = V->Z;
+		if (V->Z < Mins->Z) Mins->Z = V->Z;
+	}
+}
+
+static void GENESISCC geSkin_RotateC(const geXForm3d *XF, const geBody_Normal *S, geVec3d *D, int Count, int LevelOfDetailBit)
+{
+	for (; Count>0; Count--, S++, D++)
+	{
+		if (S->LevelOfDetailMask & LevelOfDetailBit)
+			geXForm3d_Rotate(XF, &(S->Normal), D);
+	}
+}
+
+#ifdef GE_SKIN_X86
+
+//=====================================================================================
+//	SSE2, 4 at a time
+//=====================================================================================
+GE_SKIN_TARGET("sse2")
+static void GENESISCC geSkin_TransformSSE2(const geXForm3d *XF, const geCamera_Projection *Projection,
+						const geBody_XSkinVertex *S, geBodyInst_SkinVertex *D, int Count, int LevelOfDetailBit,
+						geVec3d *Mins, geVec3d *Maxs)
+{
+	__m128	AX = _mm_set1_ps(XF->AX), AY = _mm_set1_ps(XF->AY), AZ = _mm_set1_ps(XF->AZ);
+	__m128	BX = _mm_set1_ps(XF->BX), BY = _mm_set1_ps(XF->BY), BZ = _mm_set1_ps(XF->BZ);
+	__m128	CX = _mm_set1_ps(XF->CX), CY = _mm_set1_ps(XF->CY), CZ = _mm_set1_ps(XF->CZ);
+	__m128	TX = _mm_set1_ps(XF->Translation.X), TY = _mm_set1_ps(XF->Translation.Y), TZ = _mm_set1_ps(XF->Translation.Z);
+	__m128	Big = _mm_set1_ps(GE_BODY_REALLY_BIG_NUMBER), NegBig = _mm_set1_ps(-GE_BODY_REALLY_BIG_NUMBER);
+	__m128	MinX = Big, MinY = Big, MinZ = Big;
+	__m128	MaxX = NegBig, MaxY = NegBig, MaxZ = NegBig;
+	__m128i	Bit = _mm_set1_epi32(LevelOfDetailBit), Zero = _mm_setzero_si128();
+	float	Out[4];
+
+	for (; Count>=4; Count-=4, S+=4, D+=4)
+	{
+		__m128	X = _mm_loadu_ps(&S[0].XPoint.X);		// X Y Z U of each vertex
+		__m128	Y = _mm_loadu_ps(&S[1].XPoint.X);
+		__m128	Z = _mm_loadu_ps(&S[2].XPoint.X);
+		__m128	U = _mm_loadu_ps(&S[3].XPoint.X);
+		__m128	PX, PY, PZ, Mask;
+		int		k;
+
+		_MM_TRANSPOSE4_PS(X, Y, Z, U);
+
+		PX = _mm_add_ps(_mm_add_ps(_mm_mul_ps(X, AX), _mm_mul_ps(Y, AY)), _mm_add_ps(_mm_mul_ps(Z, AZ), TX));
+		PY = _mm_add_ps(_mm_add_ps(_mm_mul_ps(X, BX), _mm_mul_ps(Y, BY)), _mm_add_ps(_mm_mul_ps(Z, BZ), TY));
+		PZ = _mm_add_ps(_mm_add_ps(_mm_mul_ps(X, CX), _mm_mul_ps(Y, CY)), _mm_add_ps(_mm_mul_ps(Z, CZ), TZ));
+
+		if (Projection)
+		{
+			__m128	Dist = _mm_max_ps(_mm_sub_ps(_mm_setzero_ps(), PZ), _mm_set1_ps(Projection->MinimumZ));
+			__m128	ScaleOverZ = _mm_div_ps(_mm_set1_ps(Projection->Scale), Dist);
+
+			PX = _mm_add_ps(_mm_mul_ps(PX, ScaleOverZ), _mm_set1_ps(Projection->XCenter));
+			PY = _mm_sub_ps(_mm_set1_ps(Projection->YCenter), _mm_mul_ps(PY, ScaleOverZ));
+			PZ = _mm_mul_ps(Dist, _mm_set1_ps(Projection->ZScale));
+		}
+
+		Mask = _mm_castsi128_ps(_mm_cmpgt_epi32(_mm_and_si128(_mm_set_epi32(S[3].LevelOfDetailMask, S[2].LevelOfDetailMask, 
+												S[1].LevelOfDetailMask, S[0].LevelOfDetailMask), Bit), Zero));
+
+		MinX = _mm_min_ps(MinX, _mm_or_ps(_mm_and_ps(Mask, PX), _mm_andnot_ps(Mask, Big)));
+		MinY = _mm_min_ps(MinY, _mm_or_ps(_mm_and_ps(Mask, PY), _mm_andnot_ps(Mask, Big)));
+		MinZ = _mm_min_ps(MinZ, _mm_or_ps(_mm_and_ps(Mask, PZ), _mm_andnot_ps(Mask, Big)));
+		MaxX = _mm_max_ps(MaxX, _mm_or_ps(_mm_and_ps(Mask, PX), _mm_andnot_ps(Mask, NegBig)));
+		MaxY = _mm_max_ps(MaxY, _mm_or_ps(_mm_and_ps(Mask, PY), _mm_andnot_ps(Mask, NegBig)));
+		MaxZ = _mm_max_ps(MaxZ, _mm_or_ps(_mm_and_ps(Mask, PZ), _mm_andnot_ps(Mask, NegBig)));
+
+		// Back to one vertex per register, U rides along into SVU
+		_MM_TRANSPOSE4_PS(PX, PY, PZ, U);
+		_mm_storeu_ps(&D[0].SVPoint.X, PX);
+		_mm_storeu_ps(&D[1].SVPoint.X, PY);
+		_mm_storeu_ps(&D[2].SVPoint.X, PZ);
+		_mm_storeu_ps(&D[3].SVPoint.X, U);
+
+		for (k=0; k< 4; k++)
+		{
+			D[k].SVV = S[k].XV;
+			D[k].ReferenceBoneIndex = S[k].BoneIndex;
+		}
+	}
+
+	#define GE_SKIN_REDUCE(Vec, Dst, Cmp)									\
+		_mm_storeu_ps(Out, Vec);											\
+		for (k=0; k< 4; k++) if (Out[k] Cmp Dst) Dst = Out[k];
+
+	{
+		int	k;
+		GE_SKIN_REDUCE(MinX, Mins->X, <)
+		GE_SKIN_REDUCE(MinY, Mins->Y, <)
+		GE_SKIN_REDUCE(MinZ, Mins->Z, <)
+		GE_SKIN_REDUCE(MaxX, Maxs->X, >)
+		GE_SKIN_REDUCE(MaxY, Maxs->Y, >)
+		GE_SKIN_REDUCE(MaxZ, Maxs->Z, >)
+	}
+
+	geSkin_TransformC(XF, Projection, S, D, Count, LevelOfDetailBit, Mins, Maxs);
+}
+
+GE_SKIN_TARGET("sse2")
+static void GENESISCC geSkin_RotateSSE2(const geXForm3d *XF, const geBody_Normal *S, geVec3d *D, int Count, int LevelOfDetailBit)
+{
+	__m128	AX = _mm_set1_ps(XF->AX), AY = _mm_set1_ps(XF->AY), AZ = _mm_set1_ps(XF->AZ);
+	__m128	BX = _mm_set1_ps(XF->BX), BY = _mm_set1_ps(XF->BY), BZ = _mm_set1_ps(XF->BZ);
+	__m128	CX = _mm_set1_ps(XF->CX), CY = _mm_set1_ps(XF->CY), CZ = _mm_set1_ps(XF->CZ);
+
+	for (; Count>=4; Count-=4, S+=4, D+=4)
+	{
+		__m128	X = _mm_loadu_ps(&S[0].Normal.X);		// The 4th float is the mask and bone, never used
+		__m128	Y = _mm_loadu_ps(&S[1].Normal.X);
+		__m128	Z = _mm_loadu_ps(&S[2].Normal.X);
+		__m128	W = _mm_loadu_ps(&S[3].Normal.X);
+		__m128	RX, RY, RZ;
+		int		k;
+
+		_MM_TRANSPOSE4_PS(X, Y, Z, W);
+
+		RX = _mm_add_ps(_mm_add_ps(_mm_mul_ps(X, AX), _mm_mul_ps(Y, AY)), _mm_mul_ps(Z, AZ));
+		RY = _mm_add_ps(_mm_add_ps(_mm_mul_ps(X, BX), _mm_mul_ps(Y, BY)), _mm_mul_ps(Z, BZ));
+		RZ = _mm_add_ps(_mm_add_ps(_mm_mul_ps(X, CX), _mm_mul_ps(Y, CY)), _mm_mul_ps(Z, CZ));
+		W = _mm_setzero_ps();
+
+		_MM_TRANSPOSE4_PS(RX, RY, RZ, W);
+
+		// geVec3d is 12 bytes, so store 8 + 4
+		{
+			__m128	Rows[4];
+			Rows[0] = RX; Rows[1] = RY; Rows[2] = RZ; Rows[3] = W;
+			for (k=0; k< 4; k++)
+			{
+				if (!(S[k].LevelOfDetailMask & LevelOfDetailBit))
+					continue;
+				_mm_storel_pi((__m64*)&D[k].X, Rows[k]);
+				_mm_store_ss(&D[k].Z, _mm_movehl_ps(Rows[k], Rows[k]));
+			}
+		}
+	}
+
+	geSkin_RotateC(XF, S, D, Count, LevelOfDetailBit);
+}
+
+//=====================================================================================
+//	AVX2 + FMA, 8 at a time
+//=====================================================================================
+GE_SKIN_TARGET("avx2,fma")
+static void GENESISCC geSkin_TransformAVX2(const geXForm3d *XF, const geCamera_Projection *Projection,
+						const geBody_XSkinVertex *S, geBodyInst_SkinVertex *D, int Count, int LevelOfDetailBit,
+						geVec3d *Mins, geVec3d *Maxs)
+{
+	__m256	AX = _mm256_set1_ps(XF->AX), AY = _mm256_set1_ps(XF->AY), AZ = _mm256_set1_ps(XF->AZ);
+	__m256	BX = _mm256_set1_ps(XF->BX), BY = _mm256_set1_ps(XF->BY), BZ = _mm256_set1_ps(XF->BZ);
+	__m256	CX = _mm256_set1_ps(XF->CX), CY = _mm256_set1_ps(XF->CY), CZ = _mm256_set1_ps(XF->CZ);
+	__m256	TX = _mm256_set1_ps(XF->Translation.X), TY = _mm256_set1_ps(XF->Translation.Y), TZ = _mm256_set1_ps(XF->Translation.Z);
+	__m256	Big = _mm256_set1_ps(GE_BODY_REALLY_BIG_NUMBER), NegBig = _mm256_set1_ps(-GE_BODY_REALLY_BIG_NUMBER);
+	__m256	MinX = Big, MinY = Big, MinZ = Big;
+	__m256	MaxX = NegBig, MaxY = NegBig, MaxZ = NegBig;
+	__m256i	Bit = _mm256_set1_epi32(LevelOfDetailBit), Zero = _mm256_setzero_si256();
+	float	Out[8];
+	int		k;
+
+	for (; Count>=8; Count-=8, S+=8, D+=8)
+	{
+		__m128	X0 = _mm_loadu_ps(&S[0].XPoint.X), Y0 = _mm_loadu_ps(&S[1].XPoint.X);
+		__m128	Z0 = _mm_loadu_ps(&S[2].XPoint.X), U0 = _mm_loadu_ps(&S[3].XPoint.X);
+		__m128	X1 = _mm_loadu_ps(&S[4].XPoint.X), Y1 = _mm_loadu_ps(&S[5].XPoint.X);
+		__m128	Z1 = _mm_loadu_ps(&S[6].XPoint.X), U1 = _mm_loadu_ps(&S[7].XPoint.X);
+		__m256	X, Y, Z, PX, PY, PZ, Mask;
+
+		_MM_TRANSPOSE4_PS(X0, Y0, Z0, U0);
+		_MM_TRANSPOSE4_PS(X1, Y1, Z1, U1);
+
+		X = _mm256_insertf128_ps(_mm256_castps128_ps256(X0), X1, 1);
+		Y = _mm256_insertf128_ps(_mm256_castps128_ps256(Y0), Y1, 1);
+		Z = _mm256_insertf128_ps(_mm256_castps128_ps256(Z0), Z1, 1);
+
+		PX = _mm256_fmadd_ps(X, AX, _mm256_fmadd_ps(Y, AY, _mm256_fmadd_ps(Z, AZ, TX)));
+		PY = _mm256_fmadd_ps(X, BX, _mm256_fmadd_ps(Y, BY, _mm256_fmadd_ps(Z, BZ, TY)));
+		PZ = _mm256_fmadd_ps(X, CX, _mm256_fmadd_ps(Y, CY, _mm256_fmadd_ps(Z, CZ, TZ)));
+
+		if (Projection)
+		{
+			__m256	Dist = _mm256_max_ps(_mm256_sub_ps(_mm256_setzero_ps(), PZ), _mm256_set1_ps(Projection->MinimumZ));
+			__m256	ScaleOverZ = _mm256_div_ps(_mm256_set1_ps(Projection->Scale), Dist);
+
+			PX = _mm256_fmadd_ps(PX, ScaleOverZ, _mm256_set1_ps(Projection->XCenter));
+			PY = _mm256_fnmadd_ps(PY, ScaleOverZ, _mm256_set1_ps(Projection->YCenter));
+			PZ = _mm256_mul_ps(Dist, _mm256_set1_ps(Projection->ZScale));
+		}
+
+		Mask = _mm256_castsi256_ps(_mm256_cmpgt_epi32(_mm256_and_si256(_mm256_set_epi32(
+						S[7].LevelOfDetailMask, S[6].LevelOfDetailMask, S[5].LevelOfDetailMask, S[4].LevelOfDetailMask,
+						S[3].LevelOfDetailMask, S[2].LevelOfDetailMask, S[1].LevelOfDetailMask, S[0].LevelOfDetailMask), Bit), Zero));
+
+		MinX = _mm256_min_ps(MinX, _mm256_blendv_ps(Big, PX, Mask));
+		MinY = _mm256_min_ps(MinY, _mm256_blendv_ps(Big, PY, Mask));
+		MinZ = _mm256_min_ps(MinZ, _mm256_blendv_ps(Big, PZ, Mask));
+		MaxX = _mm256_max_ps(MaxX, _mm256_blendv_ps(NegBig, PX, Mask));
+		MaxY = _mm256_max_ps(MaxY, _mm256_blendv_ps(NegBig, PY, Mask));
+		MaxZ = _mm256_max_ps(MaxZ, _mm256_blendv_ps(NegBig, PZ, Mask));
+
+		X0 = _mm256_castps256_ps128(PX);  X1 = _mm256_extractf128_ps(PX, 1);
+		Y0 = _mm256_castps256_ps128(PY);  Y1 = _mm256_extractf128_ps(PY, 1);
+		Z0 = _mm256_castps256_ps128(PZ);  Z1 = _mm256_extractf128_ps(PZ, 1);
+
+		_MM_TRANSPOSE4_PS(X0, Y0, Z0, U0);
+		_MM_TRANSPOSE4_PS(X1, Y1, Z1, U1);
+
+		_mm_storeu_ps(&D[0].SVPoint.X, X0);
+		_mm_storeu_ps(&D[1].SVPoint.X, Y0);
+		_mm_storeu_ps(&D[2].SVPoint.X, Z0);
+		_mm_storeu_ps(&D[3].SVPoint.X, U0);
+		_mm_storeu_ps(&D[4].SVPoint.X, X1);
+		_mm_storeu_ps(&D[5].SVPoint.X, Y1);
+		_mm_storeu_ps(&D[6].SVPoint.X, Z1);
+		_mm_storeu_ps(&D[7].SVPoint.X, U1);
+
+		for (k=0; k< 8; k++)
+		{
+			D[k].SVV = S[k].XV;
+			D[k].ReferenceBoneIndex = S[k].BoneIndex;
+		}
+	}
+
+	#define GE_SKIN_REDUCE8(Vec, Dst, Cmp)									\
+		_mm256_storeu_ps(Out, Vec);											\
+		for (k=0; k< 8; k++) if (Out[k] Cmp Dst) Dst = Out[k];
+
+	GE_SKIN_REDUCE8(MinX, Mins->X, <)
+	GE_SKIN_REDUCE8(MinY, Mins->Y, <)
+	GE_SKIN_REDUCE8(MinZ, Mins->Z, <)
+	GE_SKIN_REDUCE8(MaxX, Maxs->X, >)
+	GE_SKIN_REDUCE8(MaxY, Maxs->Y, >)
+	GE_SKIN_REDUCE8(MaxZ, Maxs->Z, >)
+
+	// Mixing 256 and 128 bit code costs a transition on some CPUs
+	_mm256_zeroupper();
+
+	geSkin_TransformSSE2(XF, Projection, S, D, Count, LevelOfDetailBit, Mins, Maxs);
+}
+
+//=====================================================================================
+//	CPU checks
+//=====================================================================================
+static geBoolean geSkin_HasSSE2(void)
+{
+#if defined(_M_X64) || defined(__x86_64__)
+	return GE_TRUE;
+#elif defined(_MSC_VER)
+	int	Info[4];
+	__cpuid(Info, 1);
+	return (Info[3] & (1<<26)) ? GE_TRUE : GE_FALSE;
+#else
+	unsigned int	A, B, C, D;
+	if (!__get_cpuid(1, &A, &B, &C, &D))
+		return GE_FALSE;
+	return (D & (1<<26)) ? GE_TRUE : GE_FALSE;
+#endif
+}
+
+static geBoolean geSkin_HasAVX2(void)
+{
+#if defined(_MSC_VER)
+	int	Info[4];
+
+	__cpuid(Info, 0);
+	if (Info[0] < 7)
+		return GE_FALSE;
+
+	__cpuid(Info, 1);
+	// OSXSAVE, AVX, FMA
+	if (!(Info[2] & (1<<27)) || !(Info[2] & (1<<28)) || !(Info[2] & (1<<12)))
+		return GE_FALSE;
+	// The OS saves the ymm registers
+	if ((_xgetbv(0) & 6) != 6)
+		return GE_FALSE;
+
+	__cpuidex(Info, 7, 0);
+	return (Info[1] & (1<<5)) ? GE_TRUE : GE_FALSE;
+#else
+	__builtin_cpu_init();
+	return (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) ? GE_TRUE : GE_FALSE;
+#endif
+}
+
+#endif	// GE_SKIN_X86
+
+static const geSkin_Kernel geSkin_KernelC = { "C", geSkin_TransformC, geSkin_RotateC };
+#ifdef GE_SKIN_X86
+static const geSkin_Kernel geSkin_KernelSSE2 = { "SSE2", geSkin_TransformSSE2, geSkin_RotateSSE2 };
+static const geSkin_Kernel geSkin_KernelAVX2 = { "AVX2", geSkin_TransformAVX2, geSkin_RotateSSE2 };
+#endif
+
+static const geSkin_Kernel *geSkin_Current = &geSkin_KernelC;
+static geBoolean geSkin_Initialized = GE_FALSE;
+
+//=====================================================================================
+//	geSkin_Init
+//=====================================================================================
+void GENESISCC geSkin_Init(void)
+{
+	if (geSkin_Initialized)
+		return;
+
+	geSkin_Current = &geSkin_KernelC;
+
+#ifdef GE_SKIN_X86
+	if (geSkin_HasAVX2())
+		geSkin_Current = &geSkin_KernelAVX2;
+	else if (geSkin_HasSSE2())
+		geSkin_Current = &geSkin_KernelSSE2;
+#endif
+
+	geSkin_Initialized = GE_TRUE;
+}
+
+//=====================================================================================
+//	geSkin_GetKernelName
+//=====================================================================================
+const char *GENESISCC geSkin_GetKernelName(void)
+{
+	return geSkin_Current->Name;
+}
+
+//=====================================================================================
+//	geSkin_TransformVertices
+//=====================================================================================
+void GENESISCC geSkin_TransformVertices(	const geXForm3d *XF, 
+											const geCamera_Projection *Projection,
+											const geBody_XSkinVertex *S, 
+											geBodyInst_SkinVertex *D, 
+											int Count, 
+											int LevelOfDetailBit,
+											geVec3d *Mins, geVec3d *Maxs)
+{
+	assert( XF != NULL );
+	assert( S != NULL || Count == 0 );
+	assert( D != NULL || Count == 0 );
+	assert( Mins != NULL );
+	assert( Maxs != NULL );
+
+	geSkin_Current->Transform(XF, Projection, S, D, Count, LevelOfDetailBit, Mins, Maxs);
+}
+
+//=====================================================================================
+//	geSkin_RotateNormals
+//=====================================================================================
+void GENESISCC geSkin_RotateNormals(	const geXForm3d *XF, 
+										const geBody_Normal *S, 
+										geVec3d *D, 
+										int Count, 
+										int LevelOfDetailBit)
+{
+	assert( XF != NULL );
+	assert( S != NULL || Count == 0 );
+	assert( D != NULL || Count == 0 );
+
+	geSkin_Current->Rotate(XF, S, D, Count, LevelOfDetailBit);
+}
@@ -0,0 +1,72 @@
+/*******************************************************************************
+Copyright © 2024 Mark E. Sowden <hogsy@oldtimes-software.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************/
+
+
+
+#ifndef GE_SKINSIMD_H
+#define GE_SKINSIMD_H
+
+#include "BASETYPE.H"
+#include "XFORM3D.H"
+#include "Camera.h"
+#include "body._h"
+#include "bodyinst.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//=====================================================================================
+//	Skinning kernels for geBodyInst
+//
+//	The vertices of a body are sorted by bone, so skinning is a run of vertices that
+//	all get the same transform.  The kernels do 4 (SSE2) or 8 (AVX2) vertices at a
+//	time, picked at runtime for the CPU, with a plain C version for everything else.
+//=====================================================================================
+
+// Picks the kernels.  Call once before skinning, from one thread.
+void		GENESISCC geSkin_Init(void);
+const char	*GENESISCC geSkin_GetKernelName(void);
+
+// Transforms Count vertices by XF into D, and projects them if Projection isn't NULL 
+// (like geCamera_Project).  Only vertices with LevelOfDetailBit set in their mask widen 
+// Mins/Maxs.  The others may be written to D too.
+void		GENESISCC geSkin_TransformVertices(	const geXForm3d *XF, 
+												const geCamera_Projection *Projection,
+												const geBody_XSkinVertex *S, 
+												geBodyInst_SkinVertex *D, 
+												int Count, 
+												int LevelOfDetailBit,
+												geVec3d *Mins, geVec3d *Maxs);
+
+// Rotates Count normals by XF into D, same rules as above.
+void		GENESISCC geSkin_RotateNormals(		const geXForm3d *XF, 
+												const geBody_Normal *S, 
+												geVec3d *D, 
+												int Count, 
+												int LevelOfDetailBit);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
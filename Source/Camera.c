@@ -188,6 +188,21 @@ float GENESISCC geCamera_GetScale(const geCamera *Camera)
 	return Camera->Scale;
 }
 
+//=====================================================================================
+//	geCamera_GetProjection
+//=====================================================================================
+void GENESISCC geCamera_GetProjection(const geCamera *Camera, geCamera_Projection *Projection)
+{
+	assert( Camera != NULL );
+	assert( Projection != NULL );
+
+	Projection->Scale    = Camera->Scale;
+	Projection->XCenter  = Camera->XCenter;
+	Projection->YCenter  = Camera->YCenter;
+	Projection->ZScale   = Camera->ZScale;
+	Projection->MinimumZ = CAMERA_MINIMUM_PROJECTION_DISTANCE;
+}
+
 //=====================================================================================
 //	geCamera_SetAttributes
 //=====================================================================================
@@ -36,6 +36,16 @@ extern "C" {
 //================================================================================
 typedef struct geCamera geCamera;
 
+// What geCamera_Project does, for code that projects many points at once
+typedef struct geCamera_Projection
+{
+	geFloat		Scale;
+	geFloat		XCenter;
+	geFloat		YCenter;
+	geFloat		ZScale;
+	geFloat		MinimumZ;					// Closer points are projected as if they were this far
+} geCamera_Projection;
+
 
 //================================================================================
 //	Function ProtoTypes
@@ -49,6 +59,7 @@ GENESISAPI void GENESISCC geCamera_GetFarClipPlane(const geCamera *Camera, geBoo
 GENESISAPI void GENESISCC geCamera_GetClippingRect(const geCamera *Camera, geRect *Rect);
 void GENESISCC geCamera_GetWidthHeight(const geCamera *Camera,geFloat *Width,geFloat *Height);
 float GENESISCC geCamera_GetScale(const geCamera *Camera);
+void GENESISCC geCamera_GetProjection(const geCamera *Camera, geCamera_Projection *Projection);
 GENESISAPI void GENESISCC geCamera_SetAttributes(geCamera *Camera, geFloat Fov, const geRect *Rect);
 void geCamera_FillDriverInfo(geCamera *Camera);
 GENESISAPI void GENESISCC geCamera_ScreenPointToWorld (	const geCamera	*Camera,
@@ -116,9 +116,9 @@ typedef void *HINSTANCE;
 #endif
 
 #define DRV_VERSION_MAJOR		100			// Genesis 1.0
-#define DRV_VERSION_MINOR		3			// >= 3.0 added fog
+#define DRV_VERSION_MINOR		5			// >= 3.0 added fog, >= 4.0 added RenderBatch, >= 5.0 added static worlds
 #define DRV_VMAJS				"100"
-#define DRV_VMINS				"3"
+#define DRV_VMINS				"5"
 
 #ifndef US_TYPEDEFS
 #define US_TYPEDEFS
@@ -400,6 +400,66 @@ typedef geBoolean DRIVERCC RENDER_G_POLY(DRV_TLVertex *Pnts, S32 NumPoints, U32
 typedef geBoolean DRIVERCC RENDER_W_POLY(DRV_TLVertex *Pnts, S32 NumPoints, geRDriver_THandle *THandle, DRV_TexInfo *TexInfo, DRV_LInfo *LInfo, U32 Flags);
 typedef geBoolean DRIVERCC RENDER_MT_POLY(DRV_TLVertex *Pnts, S32 NumPoints, geRDriver_THandle *THandle, U32 Flags);
 
+// Batched rendering
+//	The engine records a frame's polys as commands, and hands them over in runs
+//	that share a command type, THandle, lightmap and flags.  Commands with the same
+//	state that arrive next to each other may be drawn with a single state setup.
+//	Order-dependent commands (alpha, flush, no z) are never reordered.
+#define DRV_CMD_GOURAUD_POLY		0
+#define DRV_CMD_WORLD_POLY			1
+#define DRV_CMD_MISC_TEXTURE_POLY	2
+
+typedef struct
+{
+	U32					Type;						// DRV_CMD_*
+	U32					Flags;						// DRV_RENDER_*
+	geRDriver_THandle	*THandle;					// NULL for gouraud polys
+	DRV_LInfo			*LInfo;						// World polys only, may be NULL
+	DRV_TexInfo			TexInfo;					// World polys only
+	S32					FirstVert;					// Into the Verts array of the batch
+	S32					NumPoints;
+} DRV_RenderCmd;
+
+typedef geBoolean DRIVERCC RENDER_BATCH(DRV_RenderCmd *Cmds, S32 NumCmds, DRV_TLVertex *Verts);
+
+// Static world geometry
+//	Faces that never move relative to their model (no wavy, sky, mirror or trans
+//	faces) are handed to the driver once when the world is attached, in model space.
+//	Each frame the engine then only sends the indices of the visible faces of a model
+//	together with the model->camera xform, and the driver transforms, clips and
+//	projects them itself (the same way geCamera_Project does).
+typedef struct
+{
+	float	x,y,z;						// Model space
+	float	u,v;						// Same texture coords as the DRV_TLVertex of the face
+	float	r,g,b;						// Gouraud colour (255 for lit faces)
+} DRV_WorldVertex;
+
+typedef struct
+{
+	S32					FirstVert;					// Into the Verts array, a convex fan
+	S32					NumVerts;
+	geRDriver_THandle	*THandle;
+	DRV_TexInfo			TexInfo;
+	DRV_LInfo			*LInfo;						// NULL if the face has no lightmap
+	U32					Flags;						// DRV_RENDER_*
+} DRV_WorldFace;
+
+typedef struct
+{
+	geXForm3d	XForm;							// Model space -> camera space
+	float		Scale;							// Projection, see geCamera_Project
+	float		XCenter, YCenter;
+	float		ZScale;
+	float		Left, Top, Right, Bottom;		// Clipping rect, inclusive
+} DRV_WorldView;
+
+typedef struct DRV_World DRV_World;
+
+typedef DRV_World *DRIVERCC WORLD_CREATE(const DRV_WorldFace *Faces, S32 NumFaces, const DRV_WorldVertex *Verts, S32 NumVerts);
+typedef geBoolean DRIVERCC WORLD_DESTROY(DRV_World *World);
+typedef geBoolean DRIVERCC WORLD_RENDER(DRV_World *World, const S32 *Faces, S32 NumFaces, const DRV_WorldView *View);
+
 typedef geBoolean DRIVERCC DRAW_DECAL(geRDriver_THandle *THandle, geWinRect *SRect, int32 x, int32 y);
 
 typedef geBoolean DRIVERCC SCREEN_SHOT(const char *Name);
@@ -489,6 +549,14 @@ typedef struct
 
 	// Temp hack global
 	GInfo				*GlobalInfo;
+
+	// Optional (>= 4.0), NULL if the driver wants the polys one at a time
+	RENDER_BATCH		*RenderBatch;
+
+	// Optional (>= 5.0), all NULL if the driver wants every world face as a TL poly
+	WORLD_CREATE		*World_Create;
+	WORLD_DESTROY		*World_Destroy;
+	WORLD_RENDER		*World_Render;
 } DRV_Driver;
 
 typedef geBoolean DRV_Hook(DRV_Driver **Hook);
@@ -0,0 +1,542 @@
+/*******************************************************************************
+Copyright © 2024 Mark E. Sowden <hogsy@oldtimes-software.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************/
+
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "GMain.h"
+#include "GLIDEDRV.H"
+#include "GAtlas.h"
+#include "Render.h"
+
+#define GATLAS_PAGE_SIZE     1024
+#define GATLAS_MAX_PAGES     16
+#define GATLAS_BORDER        1 // Edge texels are repeated around each lightmap, so filtering never reads a neighbour
+#define GATLAS_MAX_LMAP_SIZE 32
+
+// One step of the skyline, the lowest free row over [X, X + Width)
+typedef struct
+{
+	int32 X, Y;
+	int32 Width;
+} GAtlas_Node;
+
+typedef struct
+{
+	GLuint       Texture;
+	GAtlas_Node *Nodes;
+	int32        NumNodes;
+	int32        NumLightmaps;// The skyline starts over when this gets back to 0
+} GAtlas_Page;
+
+static GAtlas_Page Pages[ GATLAS_MAX_PAGES ];
+static int32       NumPages;
+static int32       PageSize;
+static float       OneOverPageSize;
+
+static int32     BoundPage = GATLAS_NO_PAGE;
+static geBoolean PageEnabled;
+
+//==========================================================================================
+//	GAtlas_ResetPage
+//==========================================================================================
+static void GAtlas_ResetPage( GAtlas_Page *Page )
+{
+	Page->NumNodes = 1;
+	Page->Nodes[ 0 ].X = 0;
+	Page->Nodes[ 0 ].Y = 0;
+	Page->Nodes[ 0 ].Width = PageSize;
+	Page->NumLightmaps = 0;
+}
+
+//==========================================================================================
+//	GAtlas_BindTexture
+//	Pages live on the second TMU, so binding one never disturbs the world texture
+//==========================================================================================
+static void GAtlas_BindTexture( int32 Page )
+{
+	if ( Page == BoundPage )
+		return;
+
+	glActiveTexture( GL_TEXTURE1 );
+	glBindTexture( GL_TEXTURE_2D, Pages[ Page ].Texture );
+	glActiveTexture( GL_TEXTURE0 );
+
+	BoundPage = Page;
+}
+
+//==========================================================================================
+//	GAtlas_CreatePage
+//==========================================================================================
+static int32 GAtlas_CreatePage( void )
+{
+	GAtlas_Page *Page;
+
+	if ( NumPages >= GATLAS_MAX_PAGES )
+		return GATLAS_NO_PAGE;
+
+	if ( !PageSize )
+	{
+		GLint MaxSize;
+
+		glGetIntegerv( GL_MAX_TEXTURE_SIZE, &MaxSize );
+
+		PageSize = ( MaxSize < GATLAS_PAGE_SIZE ) ? MaxSize : GATLAS_PAGE_SIZE;
+		OneOverPageSize = 1.0f / ( float ) PageSize;
+	}
+
+	Page = &Pages[ NumPages ];
+
+	// A node is at least a texel wide, plus one for the insert before the shrink
+	Page->Nodes = ( GAtlas_Node * ) malloc( sizeof( GAtlas_Node ) * ( PageSize + 1 ) );
+
+	if ( !Page->Nodes )
+		return GATLAS_NO_PAGE;
+
+	GAtlas_ResetPage( Page );
+
+	glGenTextures( 1, &Page->Texture );
+
+	BoundPage = GATLAS_NO_PAGE;
+	GAtlas_BindTexture( NumPages );
+
+	glActiveTexture( GL_TEXTURE1 );
+	glTexImage2D( GL_TEXTURE_2D, 0, GL_RGB8, PageSize, PageSize, 0, GL_RGB, GL_UNSIGNED_BYTE, NULL );
+	glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR );
+	glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR );
+	glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE );
+	glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE );
+	glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0 );
+	glActiveTexture( GL_TEXTURE0 );
+
+	return NumPages++;
+}
+
+//==========================================================================================
+//	GAtlas_Fit
+//	Returns the row a Width x Height rect would sit on, starting at node Index, or -1
+//==========================================================================================
+static int32 GAtlas_Fit( const GAtlas_Page *Page, int32 Index, int32 Width, int32 Height )
+{
+	const GAtlas_Node *Node;
+	int32              y, Left;
+
+	Node = &Page->Nodes[ Index ];
+
+	if ( Node->X + Width > PageSize )
+		return -1;
+
+	y = 0;
+
+	for ( Left = Width; Left > 0; Node++ )
+	{
+		assert( Node < Page->Nodes + Page->NumNodes );
+
+		if ( Node->Y > y )
+			y = Node->Y;
+
+		if ( y + Height > PageSize )
+			return -1;
+
+		Left -= Node->Width;
+	}
+
+	return y;
+}
+
+//==========================================================================================
+//	GAtlas_Insert
+//	Bottom-left skyline, lowest row first, then the tightest node
+//==========================================================================================
+static geBoolean GAtlas_Insert( GAtlas_Page *Page, int32 Width, int32 Height, int32 *X, int32 *Y )
+{
+	GAtlas_Node *Nodes;
+	int32        i, y, Best, BestY, BestWidth;
+
+	Nodes = Page->Nodes;
+	Best = -1;
+	BestY = PageSize;
+	BestWidth = PageSize + 1;
+
+	for ( i = 0; i < Page->NumNodes; i++ )
+	{
+		y = GAtlas_Fit( Page, i, Width, Height );
+
+		if ( y < 0 )
+			continue;
+
+		if ( y < BestY || ( y == BestY && Nodes[ i ].Width < BestWidth ) )
+		{
+			Best = i;
+			BestY = y;
+			BestWidth = Nodes[ i ].Width;
+		}
+	}
+
+	if ( Best < 0 )
+		return GE_FALSE;
+
+	*X = Nodes[ Best ].X;
+	*Y = BestY;
+
+	// The rect becomes a new step of the skyline
+	memmove( &Nodes[ Best + 1 ], &Nodes[ Best ], sizeof( GAtlas_Node ) * ( Page->NumNodes - Best ) );
+	Page->NumNodes++;
+
+	Nodes[ Best ].Y = BestY + Height;
+	Nodes[ Best ].Width = Width;
+
+	// Cut back the steps it now covers
+	for ( i = Best + 1; i < Page->NumNodes; )
+	{
+		int32 Shrink = Nodes[ i - 1 ].X + Nodes[ i - 1 ].Width - Nodes[ i ].X;
+
+		if ( Shrink <= 0 )
+			break;
+
+		Nodes[ i ].X += Shrink;
+		Nodes[ i ].Width -= Shrink;
+
+		if ( Nodes[ i ].Width > 0 )
+			break;
+
+		memmove( &Nodes[ i ], &Nodes[ i + 1 ], sizeof( GAtlas_Node ) * ( Page->NumNodes - i - 1 ) );
+		Page->NumNodes--;
+	}
+
+	// Merge steps that ended up on the same row
+	for ( i = 0; i < Page->NumNodes - 1; )
+	{
+		if ( Nodes[ i ].Y != Nodes[ i + 1 ].Y )
+		{
+			i++;
+			continue;
+		}
+
+		Nodes[ i ].Width += Nodes[ i + 1 ].Width;
+
+		memmove( &Nodes[ i + 1 ], &Nodes[ i + 2 ], sizeof( GAtlas_Node ) * ( Page->NumNodes - i - 2 ) );
+		Page->NumNodes--;
+	}
+
+	return GE_TRUE;
+}
+
+//==========================================================================================
+//	GAtlas_Place
+//==========================================================================================
+static geBoolean GAtlas_Place( geRDriver_THandle *THandle )
+{
+	int32 i, Width, Height, x, y;
+
+	Width = THandle->Width + GATLAS_BORDER * 2;
+	Height = THandle->Height + GATLAS_BORDER * 2;
+
+	for ( i = 0; i < NumPages; i++ )
+	{
+		if ( GAtlas_Insert( &Pages[ i ], Width, Height, &x, &y ) )
+			break;
+	}
+
+	if ( i == NumPages )
+	{
+		if ( GAtlas_CreatePage() != i || !GAtlas_Insert( &Pages[ i ], Width, Height, &x, &y ) )
+			return GE_FALSE;
+	}
+
+	Pages[ i ].NumLightmaps++;
+
+	THandle->AtlasPage = i;
+	THandle->AtlasX = x + GATLAS_BORDER;
+	THandle->AtlasY = y + GATLAS_BORDER;
+	THandle->Flags |= THANDLE_UPDATE;// Nothing in the rect yet
+
+	return GE_TRUE;
+}
+
+//==========================================================================================
+//	GAtlas_CompareHeights
+//	Tallest first, it's what keeps the skyline flat
+//==========================================================================================
+static int GAtlas_CompareHeights( const void *a, const void *b )
+{
+	const geRDriver_THandle *THandle1 = *( const geRDriver_THandle ** ) a;
+	const geRDriver_THandle *THandle2 = *( const geRDriver_THandle ** ) b;
+
+	if ( THandle1->Height != THandle2->Height )
+		return THandle2->Height - THandle1->Height;
+	if ( THandle1->Width != THandle2->Width )
+		return THandle2->Width - THandle1->Width;
+
+	return ( THandle1 < THandle2 ) ? -1 : 1;
+}
+
+//==========================================================================================
+//	GAtlas_PlacePending
+//	Packs every lightmap created since the last call.  The engine creates them all when a
+//	world is attached, so this normally only does any work once per world
+//==========================================================================================
+geBoolean GAtlas_PlacePending( void )
+{
+	geRDriver_THandle **Pending;
+	geRDriver_THandle  *THandle;
+	int32               i, NumPending;
+	geBoolean           Ret;
+
+	if ( !LMapsChanged )
+		return GE_TRUE;
+
+	LMapsChanged = GE_FALSE;
+
+	Pending = ( geRDriver_THandle ** ) malloc( sizeof( geRDriver_THandle * ) * MAX_TEXTURE_HANDLES );
+
+	if ( !Pending )
+	{
+		SetLastDrvError( DRV_ERROR_NO_MEMORY, "GLIDE_GAtlas_PlacePending:  Out of memory." );
+		return GE_FALSE;
+	}
+
+	NumPending = 0;
+
+	for ( i = 0, THandle = TextureHandles; i < MAX_TEXTURE_HANDLES; i++, THandle++ )
+	{
+		if ( !THandle->Active || !( THandle->PixelFormat.Flags & RDRIVER_PF_LIGHTMAP ) )
+			continue;
+
+		if ( THandle->AtlasPage == GATLAS_NO_PAGE )
+			Pending[ NumPending++ ] = THandle;
+	}
+
+	qsort( Pending, NumPending, sizeof( geRDriver_THandle * ), GAtlas_CompareHeights );
+
+	Ret = GE_TRUE;
+
+	for ( i = 0; i < NumPending; i++ )
+	{
+		if ( GAtlas_Place( Pending[ i ] ) )
+			continue;
+
+		// Whatever is left gets drawn without a lightmap
+		CacheInfo.CacheFull++;
+		SetLastDrvError( DRV_ERROR_GENERIC, "GLIDE_GAtlas_PlacePending:  Out of lightmap pages." );
+		Ret = GE_FALSE;
+		break;
+	}
+
+	free( Pending );
+
+	return Ret;
+}
+
+//==========================================================================================
+//	GAtlas_Remove
+//==========================================================================================
+void GAtlas_Remove( geRDriver_THandle *THandle )
+{
+	GAtlas_Page *Page;
+
+	if ( THandle->AtlasPage == GATLAS_NO_PAGE )
+		return;
+
+	assert( THandle->AtlasPage < NumPages );
+
+	Page = &Pages[ THandle->AtlasPage ];
+
+	assert( Page->NumLightmaps > 0 );
+
+	// Rects aren't given back one at a time, but a world's lightmaps all go together
+	if ( --Page->NumLightmaps == 0 )
+		GAtlas_ResetPage( Page );
+
+	THandle->AtlasPage = GATLAS_NO_PAGE;
+}
+
+//==========================================================================================
+//	GAtlas_GetPage
+//==========================================================================================
+int32 GAtlas_GetPage( const DRV_LInfo *LInfo )
+{
+	if ( !LInfo || !LInfo->THandle )
+		return GATLAS_NO_PAGE;
+
+	return LInfo->THandle->AtlasPage;
+}
+
+//==========================================================================================
+//	GAtlas_GetTexCoords
+//	Same mapping as the old per-lightmap textures, a texel is 16 units and (MinU - 8)
+//	lands on the corner of the first one, just moved into the lightmap's rect
+//==========================================================================================
+geBoolean GAtlas_GetTexCoords( const DRV_LInfo *LInfo, float u, float v, float *s, float *t )
+{
+	const geRDriver_THandle *THandle;
+
+	if ( GAtlas_GetPage( LInfo ) == GATLAS_NO_PAGE )
+		return GE_FALSE;
+
+	THandle = LInfo->THandle;
+
+	*s = ( ( float ) THandle->AtlasX + ( u - ( float ) LInfo->MinU + 8.0f ) * ( 1.0f / 16.0f ) ) * OneOverPageSize;
+	*t = ( ( float ) THandle->AtlasY + ( v - ( float ) LInfo->MinV + 8.0f ) * ( 1.0f / 16.0f ) ) * OneOverPageSize;
+
+	return GE_TRUE;
+}
+
+//==========================================================================================
+//	GAtlas_BindPage
+//	Modulates whatever is on TMU 0 with the page
+//==========================================================================================
+geBoolean GAtlas_BindPage( int32 Page )
+{
+	if ( Page == GATLAS_NO_PAGE || g_BoardInfo.NumTMU < 2 )
+	{
+		GAtlas_Unbind();
+		return GE_FALSE;
+	}
+
+	assert( Page < NumPages );
+
+	GAtlas_BindTexture( Page );
+
+	if ( !PageEnabled )
+	{
+		glActiveTexture( GL_TEXTURE1 );
+		glEnable( GL_TEXTURE_2D );
+		glTexEnvf( GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_MODULATE );
+		glActiveTexture( GL_TEXTURE0 );
+
+		PageEnabled = GE_TRUE;
+	}
+
+	return GE_TRUE;
+}
+
+//==========================================================================================
+//	GAtlas_Unbind
+//==========================================================================================
+void GAtlas_Unbind( void )
+{
+	if ( !PageEnabled )
+		return;
+
+	glActiveTexture( GL_TEXTURE1 );
+	glDisable( GL_TEXTURE_2D );
+	glActiveTexture( GL_TEXTURE0 );
+
+	PageEnabled = GE_FALSE;
+}
+
+//==========================================================================================
+//	GAtlas_Update
+//	Asks the engine for the lightmap, and copies it into its rect if it changed.  The
+//	lightmap's page must be bound
+//==========================================================================================
+void GAtlas_Update( DRV_LInfo *LInfo )
+{
+	static GLubyte     Temp[ ( GATLAS_MAX_LMAP_SIZE + GATLAS_BORDER * 2 ) * ( GATLAS_MAX_LMAP_SIZE + GATLAS_BORDER * 2 ) * 3 ];
+	geRDriver_THandle *THandle;
+	const GLubyte     *Bits;
+	GLubyte           *pTemp;
+	geBoolean          Dynamic;
+	int32              x, y, Width, Height;
+
+	THandle = LInfo->THandle;
+
+	if ( GAtlas_GetPage( LInfo ) == GATLAS_NO_PAGE )
+	{
+		CacheInfo.LMapMisses++;
+		return;
+	}
+
+	assert( THandle->AtlasPage == BoundPage );
+
+	Dynamic = GE_FALSE;
+
+	if ( GLIDEDRV.SetupLightmap )
+		GLIDEDRV.SetupLightmap( LInfo, &Dynamic );
+
+	if ( !Dynamic && !( THandle->Flags & THANDLE_UPDATE ) )
+		return;
+
+	Bits = ( const GLubyte * ) LInfo->RGBLight[ 0 ];
+
+	if ( !Bits )
+		return;
+
+	Width = LInfo->Width;
+	Height = LInfo->Height;
+
+	assert( Width <= GATLAS_MAX_LMAP_SIZE && Height <= GATLAS_MAX_LMAP_SIZE );
+
+	pTemp = Temp;
+
+	for ( y = -GATLAS_BORDER; y < Height + GATLAS_BORDER; y++ )
+	{
+		const GLubyte *pRow;
+
+		pRow = Bits + ( ( y < 0 ) ? 0 : ( y >= Height ) ? Height - 1 : y ) * Width * 3;
+
+		for ( x = -GATLAS_BORDER; x < Width + GATLAS_BORDER; x++, pTemp += 3 )
+		{
+			const GLubyte *pSrc = pRow + ( ( x < 0 ) ? 0 : ( x >= Width ) ? Width - 1 : x ) * 3;
+
+			pTemp[ 0 ] = pSrc[ 0 ];
+			pTemp[ 1 ] = pSrc[ 1 ];
+			pTemp[ 2 ] = pSrc[ 2 ];
+		}
+	}
+
+	glActiveTexture( GL_TEXTURE1 );
+	glPixelStorei( GL_UNPACK_ALIGNMENT, 1 );
+	glTexSubImage2D( GL_TEXTURE_2D, 0,
+	                 THandle->AtlasX - GATLAS_BORDER, THandle->AtlasY - GATLAS_BORDER,
+	                 Width + GATLAS_BORDER * 2, Height + GATLAS_BORDER * 2,
+	                 GL_RGB, GL_UNSIGNED_BYTE, Temp );
+	glPixelStorei( GL_UNPACK_ALIGNMENT, 4 );
+	glActiveTexture( GL_TEXTURE0 );
+
+	THandle->Flags &= ~THANDLE_UPDATE;
+}
+
+//==========================================================================================
+//	GAtlas_Shutdown
+//==========================================================================================
+void GAtlas_Shutdown( void )
+{
+	int32 i;
+
+	GAtlas_Unbind();
+
+	for ( i = 0; i < NumPages; i++ )
+	{
+		glDeleteTextures( 1, &Pages[ i ].Texture );
+		free( Pages[ i ].Nodes );
+	}
+
+	memset( Pages, 0, sizeof( Pages ) );
+
+	NumPages = 0;
+	PageSize = 0;
+	BoundPage = GATLAS_NO_PAGE;
+}
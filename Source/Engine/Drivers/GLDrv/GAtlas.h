@@ -0,0 +1,57 @@
+/*******************************************************************************
+Copyright © 2024 Mark E. Sowden <hogsy@oldtimes-software.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************/
+
+
+#ifndef GATLAS_H
+#define GATLAS_H
+
+#include "Dcommon.h"
+#include "GTHandle.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+	//============================================================================================
+	//	Lightmap atlas
+	//	Face lightmaps are packed into a few big pages (skyline, tallest first) when the
+	//	world is attached, instead of getting a texture each.  A lightmap is uploaded into
+	//	its rect the first time it's drawn, and again only when the engine says it changed.
+	//============================================================================================
+
+#define GATLAS_NO_PAGE ( -1 )
+
+	geBoolean GAtlas_PlacePending( void );
+	void      GAtlas_Remove( geRDriver_THandle *THandle );
+	geBoolean GAtlas_GetTexCoords( const DRV_LInfo *LInfo, float u, float v, float *s, float *t );
+	int32     GAtlas_GetPage( const DRV_LInfo *LInfo );
+	geBoolean GAtlas_BindPage( int32 Page );
+	void      GAtlas_Update( DRV_LInfo *LInfo );
+	void      GAtlas_Unbind( void );
+	void      GAtlas_Shutdown( void );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -26,6 +26,8 @@
 #include "GlideDrv.h"
 #include "GMain.h"
 #include "GTHandle.h"
+#include "GWorld.h"
+#include "Render.h"
 
 int WriteBMP( unsigned short *ScreenBuffer, const char *Name );
 
@@ -194,6 +196,8 @@ geBoolean GMain_Startup( DRV_DriverHook *Hook )
 void GMain_Shutdown( void )
 {
 	GTHandle_Shutdown();
+	Render_BatchShutdown();
+	GWorld_Shutdown();
 
 	// Resize the window to the size of the original size
 	MoveWindow( ClientWindow.hWnd, OldWindow.left, OldWindow.top, OldWindow.right, OldWindow.bottom, TRUE );
@@ -227,9 +231,16 @@ geBoolean GMain_InitGlideRegisters( void )
 	// Setup card register states
 	//
 
-	// fix up the z-buffer
+	// fix up the z-buffer (bigger is closer, so clear to 0)
+	//	This is for every poly, not just the static world.  The world VBO is drawn sorted by
+	//	texture and the TL polys of a model go out after it, so they can only land in front
+	//	of or behind each other if both test against the same 1/z buffer (Render_TLToClip
+	//	and GWorld_SetView give the same depth).  Decals set DRV_RENDER_NO_ZMASK, which
+	//	turns the test into GL_ALWAYS.
 	glDepthFunc( GL_GEQUAL );
 	glDepthMask( GL_TRUE );
+	glClearDepth( 0.0 );
+	glEnable( GL_DEPTH_TEST );
 
 	// Fixup the transparent color - alpha test
 	glDisable( GL_ALPHA_TEST );
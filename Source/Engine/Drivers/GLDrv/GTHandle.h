@@ -75,6 +75,10 @@ extern "C"
 
 		unsigned int Slot;// Current slot this handle is being textured with
 
+		int32 AtlasPage;// Lightmaps only, GATLAS_NO_PAGE until packed
+		int32 AtlasX;   // First texel of the lightmap in its page
+		int32 AtlasY;
+
 		uint8 Flags;
 	} geRDriver_THandle;
 
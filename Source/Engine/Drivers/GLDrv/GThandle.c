@@ -25,6 +25,7 @@
 #include <assert.h>
 
 #include "GTHandle.h"
+#include "GAtlas.h"
 #include "GMain.h"
 #include "GLIDEDRV.H"
 
@@ -111,6 +112,7 @@ void GTHandle_Shutdown(void)
 	GTHandle_FreeAllTextureHandles();
 	// Then free all the caches
 	GTHandle_FreeAllCaches();
+	GAtlas_Shutdown();
 
 	TexturesChanged = GE_FALSE;
 	LMapsChanged = GE_FALSE;
@@ -173,21 +175,24 @@ geRDriver_THandle *GTHandle_FindTextureHandle()
 //========================================================================================
 void GTHandle_FreeTextureHandle(geRDriver_THandle *THandle)
 {
-#if 0
 	assert(THandle);
 	assert(THandle->Active == GE_TRUE);
 
 	if (THandle->Data)
 		free(THandle->Data);
 
+	if (THandle->PixelFormat.Flags & RDRIVER_PF_LIGHTMAP)
+		GAtlas_Remove(THandle);
+
+#if 0
 	if (THandle->CacheType)
 	{
 		GCache_TypeDestroy(THandle->CacheType);
 		TexturesChanged = GE_TRUE;
 	}
+#endif
 
 	memset(THandle, 0, sizeof(geRDriver_THandle));
-#endif
 }
 
 //==================================================================================
@@ -195,7 +200,6 @@ void GTHandle_FreeTextureHandle(geRDriver_THandle *THandle)
 //==================================================================================
 void GTHandle_FreeAllTextureHandles(void)
 {
-#if 0
 	int32				i;
 	geRDriver_THandle	*pTHandle;
 
@@ -211,7 +215,6 @@ void GTHandle_FreeAllTextureHandles(void)
 		
 		GTHandle_FreeTextureHandle(pTHandle);
 	}
-#endif
 }
 
 //========================================================================================
@@ -360,6 +363,10 @@ geRDriver_THandle *CreateLightmapTexture(int32 Width, int32 Height, int32 NumMip
 
 	THandle->Width = Width;
 	THandle->Height = Height;
+	THandle->PixelFormat = *PixelFormat;
+
+	// Packed into the atlas along with the rest of the world's lightmaps
+	THandle->AtlasPage = GATLAS_NO_PAGE;
 
 #if 0
 	{
@@ -377,7 +384,7 @@ geRDriver_THandle *CreateLightmapTexture(int32 Width, int32 Height, int32 NumMip
 
  	THandle->OneOverLogSize_255 = 255.0f / Size;
 
-	TexturesChanged = GE_TRUE;
+	LMapsChanged = GE_TRUE;
 
 	return THandle;
 }
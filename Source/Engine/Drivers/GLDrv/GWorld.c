@@ -0,0 +1,513 @@
+/*******************************************************************************
+Copyright © 2024 Mark E. Sowden <hogsy@oldtimes-software.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************/
+
+
+#include <assert.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "GMain.h"
+#include "GLIDEDRV.H"
+#include "GAtlas.h"
+#include "GTHandle.h"
+#include "GWorld.h"
+#include "Render.h"
+
+typedef struct
+{
+	GLfloat x, y, z;
+	GLfloat s, t;
+	GLfloat ls, lt;// Into the face's lightmap page
+	GLfloat r, g, b, a;
+} GWorld_Vertex;
+
+// Faces that share a lightmap page, texture, lightmap use and flags, and are next to each other in the index buffer
+typedef struct
+{
+	int32              LMapPage;
+	geRDriver_THandle *THandle;
+	geBoolean          Lightmap;
+	U32                Flags;
+
+	int32 NumVisible;  // This frame
+	int32 FirstVisible;// Into DrawCounts/DrawOffsets
+} GWorld_Group;
+
+typedef struct
+{
+	int32      Group;
+	GLsizei    NumIndices;
+	uintptr_t  IndexOffset;// In bytes, into the index buffer
+	DRV_LInfo *LInfo;
+} GWorld_Face;
+
+struct DRV_World
+{
+	GLuint VertexBuffer;
+	GLuint IndexBuffer;
+
+	GWorld_Face *Faces;
+	int32        NumFaces;
+
+	GWorld_Group *Groups;
+	int32         NumGroups;
+};
+
+typedef struct
+{
+	int32              LMapPage;
+	geRDriver_THandle *THandle;
+	geBoolean          Lightmap;
+	U32                Flags;
+	int32              Face;
+} GWorld_SortKey;
+
+// Shared by all worlds, big enough for the biggest one
+static GLsizei            *DrawCounts;
+static const GLvoid      **DrawOffsets;
+static const GWorld_Face **DrawFaces;
+static int32               MaxDraws;
+
+//==========================================================================================
+//	GWorld_CompareKeys
+//==========================================================================================
+static int GWorld_CompareKeys( const void *a, const void *b )
+{
+	const GWorld_SortKey *Key1 = ( const GWorld_SortKey * ) a;
+	const GWorld_SortKey *Key2 = ( const GWorld_SortKey * ) b;
+
+	// Lightmap pages first, there are only a handful of them
+	if ( Key1->LMapPage != Key2->LMapPage )
+		return Key1->LMapPage - Key2->LMapPage;
+	if ( Key1->THandle != Key2->THandle )
+		return ( uintptr_t ) Key1->THandle < ( uintptr_t ) Key2->THandle ? -1 : 1;
+	if ( Key1->Lightmap != Key2->Lightmap )
+		return Key1->Lightmap - Key2->Lightmap;
+	if ( Key1->Flags != Key2->Flags )
+		return Key1->Flags < Key2->Flags ? -1 : 1;
+
+	return Key1->Face - Key2->Face;
+}
+
+//==========================================================================================
+//	GWorld_SameState
+//==========================================================================================
+static geBoolean GWorld_SameState( const GWorld_SortKey *Key1, const GWorld_SortKey *Key2 )
+{
+	return Key1->LMapPage == Key2->LMapPage && Key1->THandle == Key2->THandle && Key1->Lightmap == Key2->Lightmap && Key1->Flags == Key2->Flags;
+}
+
+//==========================================================================================
+//	GWorld_Free
+//==========================================================================================
+static void GWorld_Free( DRV_World *World )
+{
+	if ( World->VertexBuffer )
+		glDeleteBuffers( 1, &World->VertexBuffer );
+	if ( World->IndexBuffer )
+		glDeleteBuffers( 1, &World->IndexBuffer );
+
+	free( World->Faces );
+	free( World->Groups );
+	free( World );
+}
+
+//==========================================================================================
+//	GWorld_Create
+//==========================================================================================
+DRV_World *DRIVERCC GWorld_Create( const DRV_WorldFace *Faces, S32 NumFaces, const DRV_WorldVertex *Verts, S32 NumVerts )
+{
+	DRV_World      *World;
+	GWorld_SortKey *Keys;
+	GWorld_Vertex  *Vertices;
+	GLuint         *Indices, *pIndex;
+	int32           i, v, NumIndices;
+
+	assert( Faces != NULL );
+	assert( Verts != NULL );
+
+	// The lightmaps were all just created, so this is where they get packed.  Any that
+	//	don't fit are drawn without
+	GAtlas_PlacePending();
+
+	World = ( DRV_World * ) calloc( 1, sizeof( DRV_World ) );
+	Keys = ( GWorld_SortKey * ) malloc( sizeof( GWorld_SortKey ) * NumFaces );
+	Vertices = ( GWorld_Vertex * ) malloc( sizeof( GWorld_Vertex ) * NumVerts );
+
+	NumIndices = 0;
+
+	for ( i = 0; i < NumFaces; i++ )
+		NumIndices += ( Faces[ i ].NumVerts - 2 ) * 3;
+
+	Indices = ( GLuint * ) malloc( sizeof( GLuint ) * NumIndices );
+
+	if ( World )
+	{
+		World->Faces = ( GWorld_Face * ) malloc( sizeof( GWorld_Face ) * NumFaces );
+		World->Groups = ( GWorld_Group * ) malloc( sizeof( GWorld_Group ) * NumFaces );
+	}
+
+	if ( !World || !World->Faces || !World->Groups || !Keys || !Vertices || !Indices )
+	{
+		if ( World )
+			GWorld_Free( World );
+
+		free( Keys );
+		free( Vertices );
+		free( Indices );
+
+		SetLastDrvError( DRV_ERROR_NO_MEMORY, "GLIDE_WorldCreate:  Out of memory." );
+		return NULL;
+	}
+
+	World->NumFaces = NumFaces;
+
+	// Vertices stay in the engine's order, the uv's are final
+	for ( i = 0; i < NumFaces; i++ )
+	{
+		const DRV_WorldFace   *Face = &Faces[ i ];
+		const DRV_WorldVertex *pVert = &Verts[ Face->FirstVert ];
+		GWorld_Vertex         *pOut = &Vertices[ Face->FirstVert ];
+		float                  ScaleU, ScaleV, OneOverWidth, OneOverHeight;
+		int32                  LMapPage;
+
+		ScaleU = 1.0f / Face->TexInfo.DrawScaleU;
+		ScaleV = 1.0f / Face->TexInfo.DrawScaleV;
+		OneOverWidth = 1.0f / ( float ) Face->THandle->Width;
+		OneOverHeight = 1.0f / ( float ) Face->THandle->Height;
+		LMapPage = GAtlas_GetPage( Face->LInfo );
+
+		for ( v = 0; v < Face->NumVerts; v++, pVert++, pOut++ )
+		{
+			pOut->x = pVert->x;
+			pOut->y = pVert->y;
+			pOut->z = pVert->z;
+			pOut->s = ( pVert->u * ScaleU + Face->TexInfo.ShiftU ) * OneOverWidth;
+			pOut->t = ( pVert->v * ScaleV + Face->TexInfo.ShiftV ) * OneOverHeight;
+
+			if ( !GAtlas_GetTexCoords( Face->LInfo, pVert->u, pVert->v, &pOut->ls, &pOut->lt ) )
+				pOut->ls = pOut->lt = 0.0f;
+
+			pOut->r = pVert->r * ( 1.0f / 255.0f );
+			pOut->g = pVert->g * ( 1.0f / 255.0f );
+			pOut->b = pVert->b * ( 1.0f / 255.0f );
+			pOut->a = 1.0f;
+		}
+
+		Keys[ i ].LMapPage = LMapPage;
+		Keys[ i ].THandle = Face->THandle;
+		Keys[ i ].Lightmap = ( Face->LInfo != NULL );
+		Keys[ i ].Flags = Face->Flags;
+		Keys[ i ].Face = i;
+	}
+
+	// Indices are laid out by state, so the faces of a group are close together
+	qsort( Keys, NumFaces, sizeof( GWorld_SortKey ), GWorld_CompareKeys );
+
+	pIndex = Indices;
+	World->NumGroups = 0;
+
+	for ( i = 0; i < NumFaces; i++ )
+	{
+		const DRV_WorldFace *Face = &Faces[ Keys[ i ].Face ];
+		GWorld_Face         *pFace = &World->Faces[ Keys[ i ].Face ];
+
+		if ( !i || !GWorld_SameState( &Keys[ i - 1 ], &Keys[ i ] ) )
+		{
+			GWorld_Group *Group = &World->Groups[ World->NumGroups++ ];
+
+			Group->LMapPage = Keys[ i ].LMapPage;
+			Group->THandle = Keys[ i ].THandle;
+			Group->Lightmap = Keys[ i ].Lightmap;
+			Group->Flags = Keys[ i ].Flags;
+			Group->NumVisible = 0;
+			Group->FirstVisible = 0;
+		}
+
+		pFace->Group = World->NumGroups - 1;
+		pFace->NumIndices = ( Face->NumVerts - 2 ) * 3;
+		pFace->IndexOffset = ( uintptr_t ) ( pIndex - Indices ) * sizeof( GLuint );
+		pFace->LInfo = Face->LInfo;
+
+		for ( v = 2; v < Face->NumVerts; v++ )
+		{
+			*pIndex++ = Face->FirstVert;
+			*pIndex++ = Face->FirstVert + v - 1;
+			*pIndex++ = Face->FirstVert + v;
+		}
+	}
+
+	glGenBuffers( 1, &World->VertexBuffer );
+	glBindBuffer( GL_ARRAY_BUFFER, World->VertexBuffer );
+	glBufferData( GL_ARRAY_BUFFER, sizeof( GWorld_Vertex ) * NumVerts, Vertices, GL_STATIC_DRAW );
+	glBindBuffer( GL_ARRAY_BUFFER, 0 );
+
+	glGenBuffers( 1, &World->IndexBuffer );
+	glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, World->IndexBuffer );
+	glBufferData( GL_ELEMENT_ARRAY_BUFFER, sizeof( GLuint ) * NumIndices, Indices, GL_STATIC_DRAW );
+	glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, 0 );
+
+	free( Keys );
+	free( Vertices );
+	free( Indices );
+
+	if ( glGetError() != GL_NO_ERROR )
+	{
+		GWorld_Free( World );
+		SetLastDrvError( DRV_ERROR_GENERIC, "GLIDE_WorldCreate:  Could not create the world buffers." );
+		return NULL;
+	}
+
+	if ( NumFaces > MaxDraws )
+	{
+		GLsizei            *Counts;
+		const GLvoid      **Offsets;
+		const GWorld_Face **DFaces;
+
+		Counts = ( GLsizei * ) realloc( DrawCounts, sizeof( GLsizei ) * NumFaces );
+		if ( Counts )
+			DrawCounts = Counts;
+
+		Offsets = ( const GLvoid ** ) realloc( ( void * ) DrawOffsets, sizeof( GLvoid * ) * NumFaces );
+		if ( Offsets )
+			DrawOffsets = Offsets;
+
+		DFaces = ( const GWorld_Face ** ) realloc( ( void * ) DrawFaces, sizeof( GWorld_Face * ) * NumFaces );
+		if ( DFaces )
+			DrawFaces = DFaces;
+
+		if ( !Counts || !Offsets || !DFaces )
+		{
+			GWorld_Free( World );
+			SetLastDrvError( DRV_ERROR_NO_MEMORY, "GLIDE_WorldCreate:  Out of memory for the draw lists." );
+			return NULL;
+		}
+
+		MaxDraws = NumFaces;
+	}
+
+	return World;
+}
+
+//==========================================================================================
+//	GWorld_Destroy
+//==========================================================================================
+geBoolean DRIVERCC GWorld_Destroy( DRV_World *World )
+{
+	if ( World )
+		GWorld_Free( World );
+
+	return GE_TRUE;
+}
+
+//==========================================================================================
+//	GWorld_SetView
+//	Modelview is the model -> camera xform, projection does what geCamera_Project does,
+//	with depth = RENDER_NEAR_Z / distance (bigger is closer)
+//==========================================================================================
+static void GWorld_SetView( const DRV_WorldView *View )
+{
+	const geXForm3d *M = &View->XForm;
+	GLfloat          ModelView[ 16 ], Projection[ 16 ] = { 0.0f };
+	GLfloat          Width, Height;
+	GLint            Left, Bottom;
+
+	ModelView[ 0 ] = M->AX;
+	ModelView[ 1 ] = M->BX;
+	ModelView[ 2 ] = M->CX;
+	ModelView[ 3 ] = 0.0f;
+	ModelView[ 4 ] = M->AY;
+	ModelView[ 5 ] = M->BY;
+	ModelView[ 6 ] = M->CY;
+	ModelView[ 7 ] = 0.0f;
+	ModelView[ 8 ] = M->AZ;
+	ModelView[ 9 ] = M->BZ;
+	ModelView[ 10 ] = M->CZ;
+	ModelView[ 11 ] = 0.0f;
+	ModelView[ 12 ] = M->Translation.X;
+	ModelView[ 13 ] = M->Translation.Y;
+	ModelView[ 14 ] = M->Translation.Z;
+	ModelView[ 15 ] = 1.0f;
+
+	Width = ( GLfloat ) ClientWindow.Width;
+	Height = ( GLfloat ) ClientWindow.Height;
+
+	// Camera space looks down -z, w is the distance
+	Projection[ 0 ] = 2.0f * View->Scale / Width;
+	Projection[ 5 ] = 2.0f * View->Scale / Height;
+	Projection[ 8 ] = 1.0f - 2.0f * View->XCenter / Width;
+	Projection[ 9 ] = 2.0f * View->YCenter / Height - 1.0f;
+	Projection[ 10 ] = 1.0f;
+	Projection[ 11 ] = -1.0f;
+	Projection[ 14 ] = 2.0f * RENDER_NEAR_Z;
+
+	glMatrixMode( GL_MODELVIEW );
+	glLoadMatrixf( ModelView );
+	glMatrixMode( GL_PROJECTION );
+	glLoadMatrixf( Projection );
+
+	// The engine clipped TL polys to the camera rect, this does the same
+	Left = ( GLint ) View->Left;
+	Bottom = ClientWindow.Height - 1 - ( GLint ) View->Bottom;
+
+	glEnable( GL_SCISSOR_TEST );
+	glScissor( Left, Bottom, ( GLint ) View->Right - Left + 1, ( GLint ) View->Bottom - ( GLint ) View->Top + 1 );
+}
+
+//==========================================================================================
+//	GWorld_Render
+//==========================================================================================
+geBoolean DRIVERCC GWorld_Render( DRV_World *World, const S32 *Faces, S32 NumFaces, const DRV_WorldView *View )
+{
+	GWorld_Group *Group;
+	int32         i, First;
+
+	assert( World != NULL );
+	assert( View != NULL );
+	assert( NumFaces <= MaxDraws );
+
+	if ( NumFaces <= 0 )
+		return GE_TRUE;
+
+	// Bucket the visible faces by group, so each group is one draw
+	for ( i = 0; i < World->NumGroups; i++ )
+		World->Groups[ i ].NumVisible = 0;
+
+	for ( i = 0; i < NumFaces; i++ )
+	{
+		assert( Faces[ i ] >= 0 && Faces[ i ] < World->NumFaces );
+		World->Groups[ World->Faces[ Faces[ i ] ].Group ].NumVisible++;
+	}
+
+	for ( i = 0, First = 0, Group = World->Groups; i < World->NumGroups; i++, Group++ )
+	{
+		Group->FirstVisible = First;
+		First += Group->NumVisible;
+		Group->NumVisible = 0;
+	}
+
+	for ( i = 0; i < NumFaces; i++ )
+	{
+		const GWorld_Face *Face = &World->Faces[ Faces[ i ] ];
+		int32              Slot;
+
+		Group = &World->Groups[ Face->Group ];
+		Slot = Group->FirstVisible + Group->NumVisible++;
+
+		DrawCounts[ Slot ] = Face->NumIndices;
+		DrawOffsets[ Slot ] = ( const GLvoid * ) Face->IndexOffset;
+		DrawFaces[ Slot ] = Face;
+	}
+
+	GWorld_SetView( View );
+
+	glBindBuffer( GL_ARRAY_BUFFER, World->VertexBuffer );
+	glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, World->IndexBuffer );
+
+	glEnableClientState( GL_VERTEX_ARRAY );
+	glEnableClientState( GL_COLOR_ARRAY );
+	glEnableClientState( GL_TEXTURE_COORD_ARRAY );
+
+	glVertexPointer( 3, GL_FLOAT, sizeof( GWorld_Vertex ), ( const GLvoid * ) offsetof( GWorld_Vertex, x ) );
+	glTexCoordPointer( 2, GL_FLOAT, sizeof( GWorld_Vertex ), ( const GLvoid * ) offsetof( GWorld_Vertex, s ) );
+	glColorPointer( 4, GL_FLOAT, sizeof( GWorld_Vertex ), ( const GLvoid * ) offsetof( GWorld_Vertex, r ) );
+
+	glClientActiveTexture( GL_TEXTURE1 );
+	glEnableClientState( GL_TEXTURE_COORD_ARRAY );
+	glTexCoordPointer( 2, GL_FLOAT, sizeof( GWorld_Vertex ), ( const GLvoid * ) offsetof( GWorld_Vertex, ls ) );
+	glClientActiveTexture( GL_TEXTURE0 );
+
+	for ( i = 0, Group = World->Groups; i < World->NumGroups; i++, Group++ )
+	{
+		if ( !Group->NumVisible )
+			continue;
+
+		SetupTexture( Group->THandle );
+
+		if ( Group->Flags & DRV_RENDER_ALPHA )
+			Render_SetHardwareMode( RENDER_WORLD_TRANSPARENT_POLY_MODE, Group->Flags );
+		else if ( Group->Lightmap )
+			Render_SetHardwareMode( RENDER_WORLD_POLY_MODE, Group->Flags );
+		else
+			Render_SetHardwareMode( RENDER_WORLD_POLY_MODE_NO_LIGHTMAP, Group->Flags );
+
+		glActiveTexture( GL_TEXTURE0 );
+		glEnable( GL_TEXTURE_2D );
+
+		// The group's lightmaps share a page, so that's one bind, and only the ones that
+		//	changed get copied in
+		if ( Group->Lightmap && GAtlas_BindPage( Group->LMapPage ) )
+		{
+			int32 f;
+
+			for ( f = 0; f < Group->NumVisible; f++ )
+				GAtlas_Update( DrawFaces[ Group->FirstVisible + f ]->LInfo );
+		}
+		else
+		{
+			GAtlas_Unbind();
+
+			if ( Group->Lightmap )
+				CacheInfo.LMapMisses += Group->NumVisible;
+		}
+
+		glMultiDrawElements( GL_TRIANGLES, &DrawCounts[ Group->FirstVisible ], GL_UNSIGNED_INT, &DrawOffsets[ Group->FirstVisible ], Group->NumVisible );
+	}
+
+	GAtlas_Unbind();
+
+	glClientActiveTexture( GL_TEXTURE1 );
+	glDisableClientState( GL_TEXTURE_COORD_ARRAY );
+	glClientActiveTexture( GL_TEXTURE0 );
+
+	glDisableClientState( GL_TEXTURE_COORD_ARRAY );
+	glDisableClientState( GL_COLOR_ARRAY );
+	glDisableClientState( GL_VERTEX_ARRAY );
+
+	glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, 0 );
+	glBindBuffer( GL_ARRAY_BUFFER, 0 );
+
+	glDisable( GL_SCISSOR_TEST );
+
+	// Back to screen space for the TL polys
+	Render_SetScreenProjection();
+
+	GLIDEDRV.NumRenderedPolys += NumFaces;
+
+	return GE_TRUE;
+}
+
+//==========================================================================================
+//	GWorld_Shutdown
+//==========================================================================================
+void GWorld_Shutdown( void )
+{
+	free( DrawCounts );
+	free( ( void * ) DrawOffsets );
+	free( ( void * ) DrawFaces );
+
+	DrawCounts = NULL;
+	DrawOffsets = NULL;
+	DrawFaces = NULL;
+	MaxDraws = 0;
+}
@@ -0,0 +1,50 @@
+/*******************************************************************************
+Copyright © 2024 Mark E. Sowden <hogsy@oldtimes-software.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************/
+
+
+#ifndef GWORLD_H
+#define GWORLD_H
+
+#include "Dcommon.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+	//============================================================================================
+	//	Static world geometry
+	//	The faces live in one vertex buffer, with an index buffer sorted by lightmap page
+	//	and texture, so a frame is one glMultiDrawElements per texture over the visible
+	//	faces' ranges, with the transform and clipping done by GL.
+	//============================================================================================
+
+	DRV_World *DRIVERCC GWorld_Create( const DRV_WorldFace *Faces, S32 NumFaces, const DRV_WorldVertex *Verts, S32 NumVerts );
+	geBoolean DRIVERCC  GWorld_Destroy( DRV_World *World );
+	geBoolean DRIVERCC  GWorld_Render( DRV_World *World, const S32 *Faces, S32 NumFaces, const DRV_WorldView *View );
+	void                GWorld_Shutdown( void );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -27,6 +27,7 @@
 #include "GlideDrv.h"
 #include "GMain.h"
 #include "GTHandle.h"
+#include "GWorld.h"
 #include "Render.h"
 
 int32 LastError;
@@ -241,7 +242,13 @@ DRV_Driver GLIDEDRV =
 
                 NULL,// EngineSettings
                 NULL,// Init to NULL, engine SHOULD set this (SetupLightmap)
-                NULL // GlobalInfo
+                NULL,// GlobalInfo
+
+                Render_Batch,
+
+                GWorld_Create,
+                GWorld_Destroy,
+                GWorld_Render,
 };
 
 //================================================================================================
@@ -21,6 +21,7 @@
 /****************************************************************************************/
 #include <assert.h>
 #include <Math.h>
+#include <stdlib.h>
 
 #include "Render.h"
 #include "GMain.h"
@@ -71,6 +72,52 @@ uint32 CurrentLRU;
 
 extern geBoolean g_FogEnable;
 
+//==========================================================================================
+//	Render_SetScreenProjection
+//	TL verts come in as screen x/y, so clip space is just the window
+//==========================================================================================
+void Render_SetScreenProjection( void )
+{
+	GLfloat Matrix[ 16 ] = { 0.0f };
+
+	Matrix[ 0 ] = 2.0f / ( GLfloat ) ClientWindow.Width;
+	Matrix[ 5 ] = -2.0f / ( GLfloat ) ClientWindow.Height;
+	Matrix[ 10 ] = 1.0f;
+	Matrix[ 12 ] = -1.0f;
+	Matrix[ 13 ] = 1.0f;
+	Matrix[ 15 ] = 1.0f;
+
+	glViewport( 0, 0, ClientWindow.Width, ClientWindow.Height );
+
+	glMatrixMode( GL_MODELVIEW );
+	glLoadIdentity();
+	glMatrixMode( GL_PROJECTION );
+	glLoadMatrixf( Matrix );
+}
+
+//==========================================================================================
+//	Render_TLToClip
+//	Undoes the divide, so texture coords and colours are perspective correct.  The depth
+//	is RENDER_NEAR_Z / distance, the same as what the static world path ends up with
+//==========================================================================================
+static void Render_TLToClip( const DRV_TLVertex *Pnt, GLfloat *Out )
+{
+	float ZScale, w, d;
+
+	ZScale = GLIDEDRV.GlobalInfo ? GLIDEDRV.GlobalInfo->ZScale : 0.5f;
+
+	w = ( Pnt->z > 0.0f ) ? Pnt->z : 0.0001f;
+	d = RENDER_NEAR_Z * ZScale / w;
+
+	if ( d > 1.0f )
+		d = 1.0f;
+
+	Out[ 0 ] = Pnt->x * w;
+	Out[ 1 ] = Pnt->y * w;
+	Out[ 2 ] = ( d * 2.0f - 1.0f ) * w;
+	Out[ 3 ] = w;
+}
+
 //==========================================================================================
 //	Render_SetColorCombine
 //==========================================================================================
@@ -404,17 +451,15 @@ void Render_SetHardwareMode( int32 NewMode, uint32 NewFlags )
 geBoolean DRIVERCC Render_GouraudPoly( DRV_TLVertex *Pnts, int32 NumPoints, uint32 Flags )
 {
 	int32   i;
-	GLfloat vertex[ RENDER_MAX_PNTS ][ 6 ];
+	GLfloat vertex[ RENDER_MAX_PNTS ][ 7 ];
 
 	for ( i = 0; i < NumPoints; i++ )
 	{
-		vertex[ i ][ 0 ] = Pnts->x;
-		vertex[ i ][ 1 ] = Pnts->y;
-		vertex[ i ][ 2 ] = Pnts->z;
+		Render_TLToClip( Pnts, vertex[ i ] );
 
-		vertex[ i ][ 3 ] = Pnts->r;
-		vertex[ i ][ 4 ] = Pnts->g;
-		vertex[ i ][ 5 ] = Pnts->b;
+		vertex[ i ][ 4 ] = Pnts->r * ( 1.0f / 255.0f );
+		vertex[ i ][ 5 ] = Pnts->g * ( 1.0f / 255.0f );
+		vertex[ i ][ 6 ] = Pnts->b * ( 1.0f / 255.0f );
 
 		Pnts++;
 	}
@@ -424,8 +469,8 @@ geBoolean DRIVERCC Render_GouraudPoly( DRV_TLVertex *Pnts, int32 NumPoints, uint
 	glEnableClientState( GL_VERTEX_ARRAY );
 	glEnableClientState( GL_COLOR_ARRAY );
 
-	glVertexPointer( 3, GL_FLOAT, 0, vertex );
-	glColorPointer( 3, GL_FLOAT, 0, &vertex[ 0 ][ 3 ] );
+	glVertexPointer( 4, GL_FLOAT, sizeof( vertex[ 0 ] ), vertex );
+	glColorPointer( 3, GL_FLOAT, sizeof( vertex[ 0 ] ), &vertex[ 0 ][ 4 ] );
 
 	glDrawArrays( GL_POLYGON, 0, NumPoints );
 
@@ -453,10 +498,7 @@ geBoolean DRIVERCC Render_LinesPoly( DRV_TLVertex *Pnts, int32 NumPoints )
 		colors[ i ][ 2 ] = 1.0f;
 		colors[ i ][ 3 ] = 1.0f;
 
-		vertices[ i ][ 0 ] = Pnts->x;
-		vertices[ i ][ 1 ] = Pnts->y;
-		vertices[ i ][ 2 ] = Pnts->z;
-		vertices[ i ][ 3 ] = 1 / Pnts->z;
+		Render_TLToClip( Pnts, vertices[ i ] );
 
 		Pnts++;
 	}
@@ -739,15 +781,12 @@ geBoolean DRIVERCC Render_MiscTexturePoly( DRV_TLVertex *Pnts, int32 NumPoints,
 
 	for ( i = 0; i < NumPoints; i++ )
 	{
-		vertices[ i ][ 0 ] = pPnt->x;
-		vertices[ i ][ 1 ] = pPnt->y;
-		vertices[ i ][ 2 ] = pPnt->z;
-		vertices[ i ][ 3 ] = 1.0f / pPnt->z;
+		Render_TLToClip( pPnt, vertices[ i ] );
 
-		colors[ i ][ 0 ] = pPnt->r;
-		colors[ i ][ 1 ] = pPnt->g;
-		colors[ i ][ 2 ] = pPnt->b;
-		colors[ i ][ 3 ] = pPnt->a;
+		colors[ i ][ 0 ] = pPnt->r * ( 1.0f / 255.0f );
+		colors[ i ][ 1 ] = pPnt->g * ( 1.0f / 255.0f );
+		colors[ i ][ 2 ] = pPnt->b * ( 1.0f / 255.0f );
+		colors[ i ][ 3 ] = pPnt->a * ( 1.0f / 255.0f );
 
 		texCoords[ i ][ 0 ] = pPnt->u;
 		texCoords[ i ][ 1 ] = pPnt->v;
@@ -781,6 +820,255 @@ geBoolean DRIVERCC Render_MiscTexturePoly( DRV_TLVertex *Pnts, int32 NumPoints,
 	return TRUE;
 }
 
+//************************************************************************************
+//	Batched rendering
+//************************************************************************************
+static GLfloat *BatchVertices;
+static GLfloat *BatchColors;
+static GLfloat *BatchTexCoords;
+static int32    BatchMaxVerts;
+
+//==========================================================================================
+//	Render_BatchReserve
+//==========================================================================================
+static geBoolean Render_BatchReserve( int32 NumVerts )
+{
+	GLfloat *Vertices, *Colors, *TexCoords;
+	int32    Max;
+
+	if ( NumVerts <= BatchMaxVerts )
+		return GE_TRUE;
+
+	for ( Max = BatchMaxVerts ? BatchMaxVerts : 1024; Max < NumVerts; Max <<= 1 )
+		;
+
+	Vertices = ( GLfloat * ) realloc( BatchVertices, sizeof( GLfloat ) * 4 * Max );
+	if ( Vertices )
+		BatchVertices = Vertices;
+
+	Colors = ( GLfloat * ) realloc( BatchColors, sizeof( GLfloat ) * 4 * Max );
+	if ( Colors )
+		BatchColors = Colors;
+
+	TexCoords = ( GLfloat * ) realloc( BatchTexCoords, sizeof( GLfloat ) * 3 * Max );
+	if ( TexCoords )
+		BatchTexCoords = TexCoords;
+
+	if ( !Vertices || !Colors || !TexCoords )
+	{
+		SetLastDrvError( DRV_ERROR_NO_MEMORY, "GLIDE_RenderBatch:  Out of memory for the batch arrays." );
+		return GE_FALSE;
+	}
+
+	BatchMaxVerts = Max;
+
+	return GE_TRUE;
+}
+
+//==========================================================================================
+//	Render_BatchSameState
+//==========================================================================================
+static geBoolean Render_BatchSameState( const DRV_RenderCmd *Cmd1, const DRV_RenderCmd *Cmd2 )
+{
+	if ( Cmd1->Type != Cmd2->Type || Cmd1->Flags != Cmd2->Flags || Cmd1->THandle != Cmd2->THandle )
+		return GE_FALSE;
+
+	// World polys with and without a lightmap use different modes
+	if ( Cmd1->Type == DRV_CMD_WORLD_POLY && ( Cmd1->LInfo == NULL ) != ( Cmd2->LInfo == NULL ) )
+		return GE_FALSE;
+
+	return GE_TRUE;
+}
+
+//==========================================================================================
+//	Render_BatchRun
+//	Triangulates a run of commands with the same state into one set of arrays
+//==========================================================================================
+static geBoolean Render_BatchRun( DRV_RenderCmd *Cmds, int32 NumCmds, DRV_TLVertex *Verts )
+{
+	DRV_RenderCmd *Cmd;
+	DRV_TLVertex  *pPnts;
+	GLfloat       *pVertex, *pColor, *pTexCoord;
+	int32          i, p, v, NumVerts;
+	float          ScaleU, ScaleV, ShiftU, ShiftV, OneOverWidth, OneOverHeight, Alpha;
+
+	NumVerts = 0;
+
+	for ( i = 0; i < NumCmds; i++ )
+		NumVerts += ( Cmds[ i ].NumPoints - 2 ) * 3;
+
+	if ( !Render_BatchReserve( NumVerts ) )
+		return GE_FALSE;
+
+	pVertex = BatchVertices;
+	pColor = BatchColors;
+	pTexCoord = BatchTexCoords;
+
+	ScaleU = ScaleV = OneOverWidth = OneOverHeight = 1.0f;
+	ShiftU = ShiftV = 0.0f;
+
+	for ( i = 0, Cmd = Cmds; i < NumCmds; i++, Cmd++ )
+	{
+		pPnts = &Verts[ Cmd->FirstVert ];
+
+		if ( Cmd->Type == DRV_CMD_WORLD_POLY )
+		{
+			// World uv's are in texels, scaled by the face's draw scale
+			ScaleU = 1.0f / Cmd->TexInfo.DrawScaleU;
+			ScaleV = 1.0f / Cmd->TexInfo.DrawScaleV;
+			ShiftU = Cmd->TexInfo.ShiftU;
+			ShiftV = Cmd->TexInfo.ShiftV;
+			OneOverWidth = 1.0f / ( float ) Cmd->THandle->Width;
+			OneOverHeight = 1.0f / ( float ) Cmd->THandle->Height;
+		}
+
+		// Only misc polys have alpha per vertex
+		Alpha = ( Cmd->Type == DRV_CMD_WORLD_POLY ) ? pPnts->a : 255.0f;
+
+		// Fan the poly out into triangles
+		for ( p = 2; p < Cmd->NumPoints; p++ )
+		{
+			int32 Fan[ 3 ] = { 0, p - 1, p };
+
+			for ( v = 0; v < 3; v++ )
+			{
+				DRV_TLVertex *pPnt = &pPnts[ Fan[ v ] ];
+
+				Render_TLToClip( pPnt, pVertex );
+
+				pColor[ 0 ] = pPnt->r * ( 1.0f / 255.0f );
+				pColor[ 1 ] = pPnt->g * ( 1.0f / 255.0f );
+				pColor[ 2 ] = pPnt->b * ( 1.0f / 255.0f );
+
+				if ( Cmd->Type == DRV_CMD_MISC_TEXTURE_POLY )
+					pColor[ 3 ] = pPnt->a * ( 1.0f / 255.0f );
+				else
+					pColor[ 3 ] = Alpha * ( 1.0f / 255.0f );
+
+				if ( Cmd->Type == DRV_CMD_WORLD_POLY )
+				{
+					pTexCoord[ 0 ] = ( pPnt->u * ScaleU + ShiftU ) * OneOverWidth;
+					pTexCoord[ 1 ] = ( pPnt->v * ScaleV + ShiftV ) * OneOverHeight;
+				}
+				else
+				{
+					pTexCoord[ 0 ] = pPnt->u;
+					pTexCoord[ 1 ] = pPnt->v;
+				}
+				pTexCoord[ 2 ] = 1.0f;
+
+				pVertex += 4;
+				pColor += 4;
+				pTexCoord += 3;
+			}
+		}
+
+		GLIDEDRV.NumRenderedPolys++;
+	}
+
+	switch ( Cmds->Type )
+	{
+		case DRV_CMD_GOURAUD_POLY:
+			Render_SetHardwareMode( RENDER_MISC_GOURAD_POLY_MODE, Cmds->Flags );
+			break;
+
+		case DRV_CMD_WORLD_POLY:
+			SetupTexture( Cmds->THandle );
+
+			if ( Cmds->Flags & DRV_RENDER_ALPHA )
+				Render_SetHardwareMode( RENDER_WORLD_TRANSPARENT_POLY_MODE, Cmds->Flags );
+			else if ( Cmds->LInfo )
+				Render_SetHardwareMode( RENDER_WORLD_POLY_MODE, Cmds->Flags );
+			else
+				Render_SetHardwareMode( RENDER_WORLD_POLY_MODE_NO_LIGHTMAP, Cmds->Flags );
+			break;
+
+		case DRV_CMD_MISC_TEXTURE_POLY:
+			SetupTexture( Cmds->THandle );
+			Render_SetHardwareMode( RENDER_MISC_TEX_POLY_MODE, Cmds->Flags );
+			break;
+
+		default:
+			SetLastDrvError( DRV_ERROR_INVALID_PARMS, "GLIDE_RenderBatch:  Unknown command type." );
+			return GE_FALSE;
+	}
+
+	glEnableClientState( GL_VERTEX_ARRAY );
+	glEnableClientState( GL_COLOR_ARRAY );
+
+	glVertexPointer( 4, GL_FLOAT, 0, BatchVertices );
+	glColorPointer( 4, GL_FLOAT, 0, BatchColors );
+
+	if ( Cmds->Type != DRV_CMD_GOURAUD_POLY )
+	{
+		glEnableClientState( GL_TEXTURE_COORD_ARRAY );
+		glTexCoordPointer( 3, GL_FLOAT, 0, BatchTexCoords );
+		glEnable( GL_TEXTURE_2D );
+	}
+	else
+		glDisable( GL_TEXTURE_2D );
+
+	glDrawArrays( GL_TRIANGLES, 0, NumVerts );
+
+	glDisableClientState( GL_TEXTURE_COORD_ARRAY );
+	glDisableClientState( GL_COLOR_ARRAY );
+	glDisableClientState( GL_VERTEX_ARRAY );
+
+	return GE_TRUE;
+}
+
+//==========================================================================================
+//	Render_Batch
+//	The engine hands over the frame sorted by state, so each run is one state setup and
+//	one draw instead of one per poly
+//==========================================================================================
+geBoolean DRIVERCC Render_Batch( DRV_RenderCmd *Cmds, int32 NumCmds, DRV_TLVertex *Verts )
+{
+	int32 First, Last;
+
+	assert( Cmds != NULL );
+	assert( Verts != NULL );
+
+#ifdef ENABLE_WIREFRAME
+	if ( DoWireFrame )
+	{
+		for ( First = 0; First < NumCmds; First++ )
+			Render_LinesPoly( &Verts[ Cmds[ First ].FirstVert ], Cmds[ First ].NumPoints );
+
+		return TRUE;
+	}
+#endif
+
+	for ( First = 0; First < NumCmds; First = Last )
+	{
+		for ( Last = First + 1; Last < NumCmds; Last++ )
+		{
+			if ( !Render_BatchSameState( &Cmds[ First ], &Cmds[ Last ] ) )
+				break;
+		}
+
+		if ( !Render_BatchRun( &Cmds[ First ], Last - First, Verts ) )
+			return FALSE;
+	}
+
+	return TRUE;
+}
+
+//==========================================================================================
+//	Render_BatchShutdown
+//==========================================================================================
+void Render_BatchShutdown( void )
+{
+	free( BatchVertices );
+	free( BatchColors );
+	free( BatchTexCoords );
+
+	BatchVertices = NULL;
+	BatchColors = NULL;
+	BatchTexCoords = NULL;
+	BatchMaxVerts = 0;
+}
+
 geRDriver_THandle *OldPalHandle;
 
 //============================================================================================
@@ -861,21 +1149,33 @@ geBoolean DRIVERCC Render_DrawDecal( geRDriver_THandle *THandle, geWinRect *SRec
 		height = THandle->Height;
 	}
 
-	glBegin( GL_QUADS );
-
-	glVertex3i( x, y, 0 );
-	glColor3f( 1.0f, 0.0f, 0.0f );
-
-	glVertex3i( x + width, y, 0 );
-	glColor3f( 0.0f, 1.0f, 0.0f );
-
-	glVertex3i( x + width, y + height, 0 );
-	glColor3f( 1.0f, 0.0f, 0.0f );
-
-	glVertex3i( x, y + height, 0 );
-	glColor3f( 0.0f, 1.0f, 0.0f );
-
-	glEnd();
+	{
+		// Placeholder until decals are textured, one corner colour each
+		GLfloat vertices[ 4 ][ 4 ] = {
+		        { ( GLfloat ) x, ( GLfloat ) y, 1.0f, 1.0f },
+		        { ( GLfloat ) ( x + width ), ( GLfloat ) y, 1.0f, 1.0f },
+		        { ( GLfloat ) ( x + width ), ( GLfloat ) ( y + height ), 1.0f, 1.0f },
+		        { ( GLfloat ) x, ( GLfloat ) ( y + height ), 1.0f, 1.0f } };
+		GLfloat colors[ 4 ][ 3 ] = {
+		        { 1.0f, 0.0f, 0.0f },
+		        { 0.0f, 1.0f, 0.0f },
+		        { 1.0f, 0.0f, 0.0f },
+		        { 0.0f, 1.0f, 0.0f } };
+
+		Render_SetHardwareMode( RENDER_DECAL_MODE, DRV_RENDER_NO_ZMASK | DRV_RENDER_NO_ZWRITE );
+		Render_SetColorCombine( ColorCombine_Gouraud );
+
+		glEnableClientState( GL_VERTEX_ARRAY );
+		glEnableClientState( GL_COLOR_ARRAY );
+
+		glVertexPointer( 4, GL_FLOAT, 0, vertices );
+		glColorPointer( 3, GL_FLOAT, 0, colors );
+
+		glDrawArrays( GL_TRIANGLE_FAN, 0, 4 );
+
+		glDisableClientState( GL_COLOR_ARRAY );
+		glDisableClientState( GL_VERTEX_ARRAY );
+	}
 
 	return GE_TRUE;
 }
@@ -941,6 +1241,9 @@ geBoolean DRIVERCC BeginScene( geBoolean Clear, geBoolean ClearZ, geWinRect *Wor
 
 	GLIDEDRV.NumRenderedPolys = 0;
 
+	// The window may have changed size since the last scene
+	Render_SetScreenProjection();
+
 	CurrentLRU++;
 
 	return TRUE;
@@ -45,10 +45,15 @@ enum
 	RENDER_DECAL_MODE,
 };
 
+// Closest distance (in camera space) the static world is drawn at.  TL polys use
+//	the same depth mapping, so both z buffer against each other
+#define RENDER_NEAR_Z		1.0f
+
 extern uint32				PolyMode;
 extern DRV_CacheInfo		CacheInfo;
 
 //void TextureSource(GrChipID_t Tmu, FxU32 startAddress, FxU32 evenOdd, GrTexInfo  *info );
+void Render_SetScreenProjection(void);
 void Render_SetHardwareMode(int32 NewMode, uint32 NewFlags);
 geBoolean DRIVERCC Render_GouraudPoly(DRV_TLVertex *Pnts, int32 NumPoints, uint32 Flags);
 geBoolean DRIVERCC Render_LinesPoly(DRV_TLVertex *Pnts, int32 NumPoints);
@@ -56,6 +61,8 @@ geBoolean DRIVERCC Render_WorldPoly(DRV_TLVertex *Pnts, int32 NumPoints, geRDriv
 //void RenderLightmapPoly(GrVertex *vrtx, int32 NumPoints, DRV_LInfo *LInfo, geBoolean Dynamic, uint32 Flags);
 //void DownloadLightmap(DRV_LInfo *LInfo, int32 Wh, GCache_Slot *Slot, int32 LMapNum);
 geBoolean DRIVERCC Render_MiscTexturePoly(DRV_TLVertex *Pnts, int32 NumPoints, geRDriver_THandle *THandle, uint32 Flags);
+geBoolean DRIVERCC Render_Batch(DRV_RenderCmd *Cmds, int32 NumCmds, DRV_TLVertex *Verts);
+void Render_BatchShutdown(void);
 void SetupTexture(geRDriver_THandle *THandle);
 //GCache_Slot *SetupLMapTexture(geRDriver_THandle *THandle, DRV_LInfo *LInfo, geBoolean Dynamic, int32 LMapNum);
 geBoolean DRIVERCC Render_DrawDecal(geRDriver_THandle *THandle, geWinRect *SRect, int32 x, int32 y);
@@ -0,0 +1,939 @@
+/*******************************************************************************
+Copyright © 2024 Mark E. Sowden <hogsy@oldtimes-software.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************/
+
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "NullDrv.h"
+
+#define NULLDRV_RECORD_ENV	"NULLDRV_RECORD"
+
+NullDrv_Stats NullDrv_FrameStats;
+NullDrv_Stats NullDrv_TotalStats;
+
+// Copy of the last finished scene, FrameStats keeps collecting between scenes
+static NullDrv_Stats LastFrameStats;
+
+static int32  LastError;
+static char   LastErrorStr[ 255 ];
+static int32  SubDriver;
+static FILE  *RecordFile;
+
+static DRV_EngineSettings EngineSettings;
+static DRV_CacheInfo      CacheInfo;
+
+static geRDriver_PixelFormat PixelFormats[] =
+        {
+                {GE_PIXELFORMAT_8BIT,            RDRIVER_PF_3D | RDRIVER_PF_COMBINE_LIGHTMAP},
+                {GE_PIXELFORMAT_16BIT_4444_ARGB, RDRIVER_PF_3D | RDRIVER_PF_COMBINE_LIGHTMAP},
+                {GE_PIXELFORMAT_16BIT_565_RGB,   RDRIVER_PF_3D | RDRIVER_PF_COMBINE_LIGHTMAP},
+                {GE_PIXELFORMAT_8BIT,            RDRIVER_PF_3D                              },
+                {GE_PIXELFORMAT_16BIT_565_RGB,   RDRIVER_PF_2D | RDRIVER_PF_CAN_DO_COLORKEY },
+                {GE_PIXELFORMAT_16BIT_565_RGB,   RDRIVER_PF_LIGHTMAP                        },
+                {GE_PIXELFORMAT_32BIT_XRGB,      RDRIVER_PF_PALETTE                         },
+                {GE_PIXELFORMAT_16BIT_1555_ARGB, RDRIVER_PF_3D | RDRIVER_PF_COMBINE_LIGHTMAP},
+};
+
+#define NUM_PIXEL_FORMATS ( sizeof( PixelFormats ) / sizeof( geRDriver_PixelFormat ) )
+
+//====================================================================================
+//	BytesPerPel
+//	Only needs to cover the formats handed out above
+//====================================================================================
+static int32 BytesPerPel( gePixelFormat Format )
+{
+	switch ( Format )
+	{
+		case GE_PIXELFORMAT_8BIT:
+		case GE_PIXELFORMAT_8BIT_GRAY:
+			return 1;
+		case GE_PIXELFORMAT_16BIT_555_RGB:
+		case GE_PIXELFORMAT_16BIT_555_BGR:
+		case GE_PIXELFORMAT_16BIT_565_RGB:
+		case GE_PIXELFORMAT_16BIT_565_BGR:
+		case GE_PIXELFORMAT_16BIT_4444_ARGB:
+		case GE_PIXELFORMAT_16BIT_1555_ARGB:
+			return 2;
+		case GE_PIXELFORMAT_24BIT_RGB:
+		case GE_PIXELFORMAT_24BIT_BGR:
+			return 3;
+		default:
+			return 4;
+	}
+}
+
+//====================================================================================
+//	PelToXRGB
+//====================================================================================
+static uint32 PelToXRGB( const geRDriver_THandle *THandle, const uint8 *Pel )
+{
+	uint32 c, r, g, b;
+
+	switch ( THandle->PixelFormat.PixelFormat )
+	{
+		case GE_PIXELFORMAT_8BIT:
+			if ( THandle->PalHandle && THandle->PalHandle->Data[ 0 ] )
+				return ( ( const uint32 * ) THandle->PalHandle->Data[ 0 ] )[ *Pel ] & 0xFFFFFF;
+			return *Pel * 0x010101;
+
+		case GE_PIXELFORMAT_16BIT_565_RGB:
+			c = *( const uint16 * ) Pel;
+			r = ( c >> 11 ) & 31;
+			g = ( c >> 5 ) & 63;
+			b = c & 31;
+			return ( ( r << 3 ) << 16 ) | ( ( g << 2 ) << 8 ) | ( b << 3 );
+
+		case GE_PIXELFORMAT_16BIT_4444_ARGB:
+			c = *( const uint16 * ) Pel;
+			r = ( c >> 8 ) & 15;
+			g = ( c >> 4 ) & 15;
+			b = c & 15;
+			return ( ( r * 17 ) << 16 ) | ( ( g * 17 ) << 8 ) | ( b * 17 );
+
+		case GE_PIXELFORMAT_16BIT_1555_ARGB:
+			c = *( const uint16 * ) Pel;
+			r = ( c >> 10 ) & 31;
+			g = ( c >> 5 ) & 31;
+			b = c & 31;
+			return ( ( r << 3 ) << 16 ) | ( ( g << 3 ) << 8 ) | ( b << 3 );
+
+		default:
+			return *( const uint32 * ) Pel & 0xFFFFFF;
+	}
+}
+
+//====================================================================================
+//	THandleColor
+//	Average colour of the top mip, worked out the first time it is drawn with
+//====================================================================================
+static uint32 THandleColor( geRDriver_THandle *THandle )
+{
+	int32  i, Count, Bpp;
+	uint32 r, g, b, c;
+
+	if ( !THandle || !THandle->Data[ 0 ] )
+		return 0xFFFFFF;
+
+	if ( THandle->ColorValid )
+		return THandle->Color;
+
+	Bpp   = BytesPerPel( THandle->PixelFormat.PixelFormat );
+	Count = THandle->Width * THandle->Height;
+	r = g = b = 0;
+
+	for ( i = 0; i < Count; i++ )
+	{
+		c = PelToXRGB( THandle, THandle->Data[ 0 ] + i * Bpp );
+		r += ( c >> 16 ) & 255;
+		g += ( c >> 8 ) & 255;
+		b += c & 255;
+	}
+
+	if ( Count > 0 )
+		THandle->Color = ( ( r / Count ) << 16 ) | ( ( g / Count ) << 8 ) | ( b / Count );
+	else
+		THandle->Color = 0xFFFFFF;
+
+	THandle->ColorValid = GE_TRUE;
+
+	return THandle->Color;
+}
+
+//====================================================================================
+//	Driver setup
+//====================================================================================
+static geBoolean DRIVERCC DrvInit( DRV_DriverHook *Hook )
+{
+	const char *RecordName;
+
+	SubDriver = Hook->Driver;
+
+	memset( &NullDrv_FrameStats, 0, sizeof( NullDrv_FrameStats ) );
+	memset( &NullDrv_TotalStats, 0, sizeof( NullDrv_TotalStats ) );
+	memset( &LastFrameStats, 0, sizeof( LastFrameStats ) );
+
+	if ( SubDriver == NULLDRV_SUBDRIVER_RASTER )
+	{
+		if ( !NullRaster_Startup( Hook->Width, Hook->Height ) )
+		{
+			NullDrv_SetLastError( DRV_ERROR_NO_MEMORY, "NULL_DRV:  Could not allocate the framebuffer." );
+			return GE_FALSE;
+		}
+	}
+
+	RecordName = getenv( NULLDRV_RECORD_ENV );
+
+	if ( RecordName && RecordName[ 0 ] )
+	{
+		RecordFile = fopen( RecordName, "w" );
+
+		if ( RecordFile )
+			fprintf( RecordFile, "Scene,WorldPolys,GouraudPolys,MiscPolys,Decals,Vertices,THandleCreates,THandleDestroys,"
+			                     "THandleLocks,TextureUploadBytes,LightmapUploads,LightmapUploadBytes,Pixels,Batches,StateChanges,StaticFaces\n" );
+	}
+
+	return GE_TRUE;
+}
+
+static geBoolean DRIVERCC DrvShutdown( void )
+{
+	NullRaster_Shutdown();
+
+	if ( RecordFile )
+	{
+		fclose( RecordFile );
+		RecordFile = NULL;
+	}
+
+	return GE_TRUE;
+}
+
+static geBoolean DRIVERCC DrvResetAll( void )
+{
+	return GE_TRUE;
+}
+
+static geBoolean DRIVERCC DrvUpdateWindow( void )
+{
+	return GE_TRUE;
+}
+
+static geBoolean DRIVERCC DrvSetActive( geBoolean Active )
+{
+	return GE_TRUE;
+}
+
+static geBoolean DRIVERCC SetGamma( float Gamma )
+{
+	return GE_TRUE;
+}
+
+static geBoolean DRIVERCC GetGamma( float *Gamma )
+{
+	*Gamma = 1.0f;
+
+	return GE_TRUE;
+}
+
+static geBoolean DRIVERCC SetFogEnable( geBoolean Enable, float r, float g, float b, float Start, float End )
+{
+	return GE_TRUE;
+}
+
+//====================================================================================
+//	Enumeration
+//====================================================================================
+static geBoolean DRIVERCC EnumSubDrivers( DRV_ENUM_DRV_CB *Cb, void *Context )
+{
+	if ( !Cb( NULLDRV_SUBDRIVER_COUNT, "Null driver v" DRV_VMAJS "." DRV_VMINS ".", Context ) )
+		return GE_TRUE;
+
+	if ( !Cb( NULLDRV_SUBDRIVER_RASTER, "Null driver (raster) v" DRV_VMAJS "." DRV_VMINS ".", Context ) )
+		return GE_TRUE;
+
+	return GE_TRUE;
+}
+
+static geBoolean DRIVERCC EnumModes( int32 Driver, char *DriverName, DRV_ENUM_MODES_CB *Cb, void *Context )
+{
+	static const int32 Modes[][ 2 ] = {
+	        {320,  240 },
+	        {640,  480 },
+	        {800,  600 },
+	        {1024, 768 },
+	        {1280, 1024},
+	        {1920, 1080},
+	};
+	char  ModeName[ 25 ];
+	int32 i;
+
+	for ( i = 0; i < ( int32 ) ( sizeof( Modes ) / sizeof( Modes[ 0 ] ) ); i++ )
+	{
+		snprintf( ModeName, sizeof( ModeName ), "%dx%d", Modes[ i ][ 0 ], Modes[ i ][ 1 ] );
+
+		if ( !Cb( i, ModeName, Modes[ i ][ 0 ], Modes[ i ][ 1 ], Context ) )
+			break;
+	}
+
+	return GE_TRUE;
+}
+
+static geBoolean DRIVERCC EnumPixelFormats( DRV_ENUM_PFORMAT_CB *Cb, void *Context )
+{
+	int32 i;
+
+	for ( i = 0; i < ( int32 ) NUM_PIXEL_FORMATS; i++ )
+	{
+		if ( !Cb( &PixelFormats[ i ], Context ) )
+			return GE_TRUE;
+	}
+
+	return GE_TRUE;
+}
+
+//====================================================================================
+//	Texture handles
+//	Lightmaps never get any data (the engine hands those over through SetupLightmap),
+//	everything else keeps its mips in system memory so Lock works as usual
+//====================================================================================
+static geBoolean DRIVERCC THandle_Destroy( geRDriver_THandle *THandle );
+
+static geRDriver_THandle *DRIVERCC THandle_Create( int32 Width, int32 Height, int32 NumMipLevels, const geRDriver_PixelFormat *PixelFormat )
+{
+	geRDriver_THandle *THandle;
+	int32              i, Bpp;
+
+	THandle = ( geRDriver_THandle * ) calloc( 1, sizeof( geRDriver_THandle ) );
+
+	if ( !THandle )
+	{
+		NullDrv_SetLastError( DRV_ERROR_NO_MEMORY, "NULL_DRV:  Out of memory creating a texture handle." );
+		return NULL;
+	}
+
+	if ( NumMipLevels < 1 )
+		NumMipLevels = 1;
+	else if ( NumMipLevels > NULLDRV_MAX_MIP_LEVELS )
+		NumMipLevels = NULLDRV_MAX_MIP_LEVELS;
+
+	THandle->Active       = GE_TRUE;
+	THandle->Width        = Width;
+	THandle->Height       = Height;
+	THandle->NumMipLevels = NumMipLevels;
+	THandle->PixelFormat  = *PixelFormat;
+
+	if ( !( PixelFormat->Flags & RDRIVER_PF_LIGHTMAP ) )
+	{
+		Bpp = BytesPerPel( PixelFormat->PixelFormat );
+
+		for ( i = 0; i < NumMipLevels; i++ )
+		{
+			int32 w = Width >> i, h = Height >> i;
+
+			THandle->Data[ i ] = ( uint8 * ) calloc( 1, ( w > 0 ? w : 1 ) * ( h > 0 ? h : 1 ) * Bpp );
+
+			if ( !THandle->Data[ i ] )
+			{
+				THandle_Destroy( THandle );
+				NullDrv_SetLastError( DRV_ERROR_NO_MEMORY, "NULL_DRV:  Out of memory creating a texture handle." );
+				return NULL;
+			}
+		}
+	}
+
+	NullDrv_FrameStats.THandleCreates++;
+
+	return THandle;
+}
+
+static geBoolean DRIVERCC THandle_Destroy( geRDriver_THandle *THandle )
+{
+	int32 i;
+
+	assert( THandle );
+
+	for ( i = 0; i < NULLDRV_MAX_MIP_LEVELS; i++ )
+	{
+		if ( THandle->Data[ i ] )
+			free( THandle->Data[ i ] );
+	}
+
+	free( THandle );
+
+	NullDrv_FrameStats.THandleDestroys++;
+
+	return GE_TRUE;
+}
+
+static geBoolean DRIVERCC THandle_Lock( geRDriver_THandle *THandle, int32 MipLevel, void **Data )
+{
+	assert( THandle );
+
+	if ( MipLevel < 0 || MipLevel >= THandle->NumMipLevels || !THandle->Data[ MipLevel ] )
+	{
+		NullDrv_SetLastError( DRV_ERROR_INVALID_PARMS, "NULL_DRV:  Invalid texture lock." );
+		return GE_FALSE;
+	}
+
+	*Data = THandle->Data[ MipLevel ];
+
+	NullDrv_FrameStats.THandleLocks++;
+
+	return GE_TRUE;
+}
+
+static geBoolean DRIVERCC THandle_UnLock( geRDriver_THandle *THandle, int32 MipLevel )
+{
+	int32 w, h;
+
+	assert( THandle );
+
+	w = THandle->Width >> MipLevel;
+	h = THandle->Height >> MipLevel;
+
+	NullDrv_FrameStats.TextureUploadBytes += ( w > 0 ? w : 1 ) * ( h > 0 ? h : 1 ) * BytesPerPel( THandle->PixelFormat.PixelFormat );
+
+	if ( MipLevel == 0 )
+		THandle->ColorValid = GE_FALSE;
+
+	return GE_TRUE;
+}
+
+static geBoolean DRIVERCC THandle_SetPalette( geRDriver_THandle *THandle, geRDriver_THandle *PalHandle )
+{
+	assert( THandle );
+
+	THandle->PalHandle  = PalHandle;
+	THandle->ColorValid = GE_FALSE;
+
+	return GE_TRUE;
+}
+
+static geRDriver_THandle *DRIVERCC THandle_GetPalette( geRDriver_THandle *THandle )
+{
+	assert( THandle );
+
+	return THandle->PalHandle;
+}
+
+static geBoolean DRIVERCC THandle_GetInfo( geRDriver_THandle *THandle, int32 MipLevel, geRDriver_THandleInfo *Info )
+{
+	assert( THandle );
+
+	Info->Width       = THandle->Width >> MipLevel;
+	Info->Height      = THandle->Height >> MipLevel;
+	Info->Stride      = THandle->Width >> MipLevel;
+	Info->PixelFormat = THandle->PixelFormat;
+
+	if ( THandle->PixelFormat.Flags & RDRIVER_PF_CAN_DO_COLORKEY )
+	{
+		// Color keys are allways on for surfaces that support it, same as the other drivers
+		Info->Flags    = RDRIVER_THANDLE_HAS_COLORKEY;
+		Info->ColorKey = ( THandle->PixelFormat.Flags & RDRIVER_PF_PALETTE ) ? ( 1 << 16 ) : 1;
+	}
+	else
+	{
+		Info->Flags    = 0;
+		Info->ColorKey = 0;
+	}
+
+	return GE_TRUE;
+}
+
+//====================================================================================
+//	Scene management
+//====================================================================================
+static geBoolean DRIVERCC BeginScene( geBoolean Clear, geBoolean ClearZ, geWinRect *WorldRect )
+{
+	// Don't clear the frame stats here, so textures loaded between scenes
+	// are charged to the scene that follows them
+	NullDrv_FrameStats.Scenes = 1;
+	NULLDRV.NumRenderedPolys  = 0;
+
+	NullRaster_Clear( Clear, ClearZ );
+
+	return GE_TRUE;
+}
+
+static geBoolean DRIVERCC EndScene( void )
+{
+	int32 *Frame, *Total;
+	int32  i;
+
+	Frame = ( int32 * ) &NullDrv_FrameStats;
+	Total = ( int32 * ) &NullDrv_TotalStats;
+
+	for ( i = 0; i < ( int32 ) ( sizeof( NullDrv_Stats ) / sizeof( int32 ) ); i++ )
+		Total[ i ] += Frame[ i ];
+
+	if ( RecordFile )
+	{
+		fprintf( RecordFile, "%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d\n",
+		         NullDrv_TotalStats.Scenes,
+		         NullDrv_FrameStats.WorldPolys,
+		         NullDrv_FrameStats.GouraudPolys,
+		         NullDrv_FrameStats.MiscPolys,
+		         NullDrv_FrameStats.Decals,
+		         NullDrv_FrameStats.Vertices,
+		         NullDrv_FrameStats.THandleCreates,
+		         NullDrv_FrameStats.THandleDestroys,
+		         NullDrv_FrameStats.THandleLocks,
+		         NullDrv_FrameStats.TextureUploadBytes,
+		         NullDrv_FrameStats.LightmapUploads,
+		         NullDrv_FrameStats.LightmapUploadBytes,
+		         NullDrv_FrameStats.Pixels,
+		         NullDrv_FrameStats.Batches,
+		         NullDrv_FrameStats.StateChanges,
+		         NullDrv_FrameStats.StaticFaces );
+	}
+
+	LastFrameStats = NullDrv_FrameStats;
+	memset( &NullDrv_FrameStats, 0, sizeof( NullDrv_FrameStats ) );
+
+	return GE_TRUE;
+}
+
+static geBoolean DRIVERCC BeginWorld( void )
+{
+	return GE_TRUE;
+}
+
+static geBoolean DRIVERCC EndWorld( void )
+{
+	return GE_TRUE;
+}
+
+static geBoolean DRIVERCC BeginMeshes( void )
+{
+	return GE_TRUE;
+}
+
+static geBoolean DRIVERCC EndMeshes( void )
+{
+	return GE_TRUE;
+}
+
+static geBoolean DRIVERCC BeginModels( void )
+{
+	return GE_TRUE;
+}
+
+static geBoolean DRIVERCC EndModels( void )
+{
+	return GE_TRUE;
+}
+
+//====================================================================================
+//	Rendering
+//====================================================================================
+static geBoolean DRIVERCC RenderGouraudPoly( DRV_TLVertex *Pnts, S32 NumPoints, U32 Flags )
+{
+	NullDrv_FrameStats.GouraudPolys++;
+	NullDrv_FrameStats.Vertices += NumPoints;
+	NULLDRV.NumRenderedPolys++;
+
+	if ( NullRaster_Active() )
+		NullRaster_DrawPoly( Pnts, NumPoints, 0xFFFFFF, Flags );
+
+	return GE_TRUE;
+}
+
+static geBoolean DRIVERCC RenderWorldPoly( DRV_TLVertex *Pnts, S32 NumPoints, geRDriver_THandle *THandle, DRV_TexInfo *TexInfo, DRV_LInfo *LInfo, U32 Flags )
+{
+	NullDrv_FrameStats.WorldPolys++;
+	NullDrv_FrameStats.Vertices += NumPoints;
+	NULLDRV.NumRenderedPolys++;
+
+	if ( LInfo && NULLDRV.SetupLightmap )
+	{
+		geBoolean Dynamic = GE_FALSE;
+
+		// Call the engine to set this up, the same as a real driver would for a visible face
+		NULLDRV.SetupLightmap( LInfo, &Dynamic );
+
+		if ( Dynamic || ( LInfo->THandle && !LInfo->THandle->Uploaded ) )
+		{
+			NullDrv_FrameStats.LightmapUploads++;
+			NullDrv_FrameStats.LightmapUploadBytes += LInfo->Width * LInfo->Height * sizeof( DRV_RGB ) * ( LInfo->RGBLight[ 1 ] ? 2 : 1 );
+
+			if ( LInfo->THandle )
+				LInfo->THandle->Uploaded = GE_TRUE;
+		}
+	}
+
+	if ( NullRaster_Active() )
+		NullRaster_DrawPoly( Pnts, NumPoints, THandleColor( THandle ), Flags );
+
+	return GE_TRUE;
+}
+
+static geBoolean DRIVERCC RenderMiscTexturePoly( DRV_TLVertex *Pnts, S32 NumPoints, geRDriver_THandle *THandle, U32 Flags )
+{
+	NullDrv_FrameStats.MiscPolys++;
+	NullDrv_FrameStats.Vertices += NumPoints;
+	NULLDRV.NumRenderedPolys++;
+
+	if ( NullRaster_Active() )
+		NullRaster_DrawPoly( Pnts, NumPoints, THandleColor( THandle ), Flags );
+
+	return GE_TRUE;
+}
+
+static geBoolean DRIVERCC RenderBatch( DRV_RenderCmd *Cmds, S32 NumCmds, DRV_TLVertex *Verts )
+{
+	DRV_RenderCmd *Cmd, *Prev;
+	int32          i;
+
+	NullDrv_FrameStats.Batches++;
+
+	Prev = NULL;
+
+	for ( i = 0, Cmd = Cmds; i < NumCmds; i++, Cmd++ )
+	{
+		if ( !Prev || Prev->Type != Cmd->Type || Prev->Flags != Cmd->Flags || Prev->THandle != Cmd->THandle )
+			NullDrv_FrameStats.StateChanges++;
+
+		Prev = Cmd;
+
+		switch ( Cmd->Type )
+		{
+			case DRV_CMD_GOURAUD_POLY:
+				RenderGouraudPoly( &Verts[ Cmd->FirstVert ], Cmd->NumPoints, Cmd->Flags );
+				break;
+
+			case DRV_CMD_WORLD_POLY:
+				RenderWorldPoly( &Verts[ Cmd->FirstVert ], Cmd->NumPoints, Cmd->THandle, &Cmd->TexInfo, Cmd->LInfo, Cmd->Flags );
+				break;
+
+			case DRV_CMD_MISC_TEXTURE_POLY:
+				RenderMiscTexturePoly( &Verts[ Cmd->FirstVert ], Cmd->NumPoints, Cmd->THandle, Cmd->Flags );
+				break;
+
+			default:
+				NullDrv_SetLastError( DRV_ERROR_INVALID_PARMS, "NULL_DRV:  Unknown command in RenderBatch." );
+				return GE_FALSE;
+		}
+	}
+
+	return GE_TRUE;
+}
+
+//====================================================================================
+//	Static world geometry
+//====================================================================================
+#define NULLDRV_WORLD_NEAR_Z		1.0f		// Same near plane as the GL driver
+#define NULLDRV_WORLD_MAX_VERTS		64
+
+struct DRV_World
+{
+	DRV_WorldFace   *Faces;
+	int32            NumFaces;
+	DRV_WorldVertex *Verts;
+	int32            NumVerts;
+};
+
+static DRV_World *DRIVERCC World_Create( const DRV_WorldFace *Faces, S32 NumFaces, const DRV_WorldVertex *Verts, S32 NumVerts )
+{
+	DRV_World *World;
+
+	World = ( DRV_World * ) calloc( 1, sizeof( DRV_World ) );
+
+	if ( World )
+	{
+		World->Faces = ( DRV_WorldFace * ) malloc( sizeof( DRV_WorldFace ) * NumFaces );
+		World->Verts = ( DRV_WorldVertex * ) malloc( sizeof( DRV_WorldVertex ) * NumVerts );
+	}
+
+	if ( !World || !World->Faces || !World->Verts )
+	{
+		if ( World )
+		{
+			free( World->Faces );
+			free( World->Verts );
+			free( World );
+		}
+
+		NullDrv_SetLastError( DRV_ERROR_NO_MEMORY, "NULL_DRV:  Out of memory for the world." );
+		return NULL;
+	}
+
+	memcpy( World->Faces, Faces, sizeof( DRV_WorldFace ) * NumFaces );
+	memcpy( World->Verts, Verts, sizeof( DRV_WorldVertex ) * NumVerts );
+
+	World->NumFaces = NumFaces;
+	World->NumVerts = NumVerts;
+
+	return World;
+}
+
+static geBoolean DRIVERCC World_Destroy( DRV_World *World )
+{
+	if ( !World )
+		return GE_TRUE;
+
+	free( World->Faces );
+	free( World->Verts );
+	free( World );
+
+	return GE_TRUE;
+}
+
+//====================================================================================
+//	World_ClipNear
+//	Camera space, z is negative in front of the camera.  Returns the new count
+//====================================================================================
+static int32 World_ClipNear( const DRV_TLVertex *In, int32 NumIn, DRV_TLVertex *Out )
+{
+	const DRV_TLVertex *v1, *v2;
+	int32               i, NumOut;
+	float               d1, d2, t;
+
+	NumOut = 0;
+
+	for ( i = 0; i < NumIn; i++ )
+	{
+		v1 = &In[ i ];
+		v2 = &In[ ( i + 1 ) % NumIn ];
+
+		d1 = -v1->z - NULLDRV_WORLD_NEAR_Z;
+		d2 = -v2->z - NULLDRV_WORLD_NEAR_Z;
+
+		if ( d1 >= 0.0f )
+			Out[ NumOut++ ] = *v1;
+
+		if ( ( d1 >= 0.0f ) == ( d2 >= 0.0f ) )
+			continue;
+
+		t = d1 / ( d1 - d2 );
+
+		Out[ NumOut ].x = v1->x + ( v2->x - v1->x ) * t;
+		Out[ NumOut ].y = v1->y + ( v2->y - v1->y ) * t;
+		Out[ NumOut ].z = v1->z + ( v2->z - v1->z ) * t;
+		Out[ NumOut ].u = v1->u + ( v2->u - v1->u ) * t;
+		Out[ NumOut ].v = v1->v + ( v2->v - v1->v ) * t;
+		Out[ NumOut ].r = v1->r + ( v2->r - v1->r ) * t;
+		Out[ NumOut ].g = v1->g + ( v2->g - v1->g ) * t;
+		Out[ NumOut ].b = v1->b + ( v2->b - v1->b ) * t;
+		Out[ NumOut ].a = 255.0f;
+		NumOut++;
+	}
+
+	return NumOut;
+}
+
+static geBoolean DRIVERCC World_Render( DRV_World *World, const S32 *Faces, S32 NumFaces, const DRV_WorldView *View )
+{
+	DRV_TLVertex     Camera[ NULLDRV_WORLD_MAX_VERTS ], Clipped[ NULLDRV_WORLD_MAX_VERTS + 1 ];
+	const geXForm3d *M;
+	geWinRect        Rect;
+	int32            i, v, NumClipped;
+
+	assert( World != NULL );
+	assert( View != NULL );
+
+	M = &View->XForm;
+
+	Rect.left   = ( int32 ) View->Left;
+	Rect.top    = ( int32 ) View->Top;
+	Rect.right  = ( int32 ) View->Right;
+	Rect.bottom = ( int32 ) View->Bottom;
+
+	NullRaster_SetClipRect( &Rect );
+
+	for ( i = 0; i < NumFaces; i++ )
+	{
+		const DRV_WorldFace   *Face;
+		const DRV_WorldVertex *pVert;
+
+		assert( Faces[ i ] >= 0 && Faces[ i ] < World->NumFaces );
+
+		Face  = &World->Faces[ Faces[ i ] ];
+		pVert = &World->Verts[ Face->FirstVert ];
+
+		if ( Face->NumVerts > NULLDRV_WORLD_MAX_VERTS )
+			continue;
+
+		for ( v = 0; v < Face->NumVerts; v++, pVert++ )
+		{
+			Camera[ v ].x = pVert->x * M->AX + pVert->y * M->AY + pVert->z * M->AZ + M->Translation.X;
+			Camera[ v ].y = pVert->x * M->BX + pVert->y * M->BY + pVert->z * M->BZ + M->Translation.Y;
+			Camera[ v ].z = pVert->x * M->CX + pVert->y * M->CY + pVert->z * M->CZ + M->Translation.Z;
+			Camera[ v ].u = pVert->u;
+			Camera[ v ].v = pVert->v;
+			Camera[ v ].r = pVert->r;
+			Camera[ v ].g = pVert->g;
+			Camera[ v ].b = pVert->b;
+			Camera[ v ].a = 255.0f;
+		}
+
+		NumClipped = World_ClipNear( Camera, Face->NumVerts, Clipped );
+
+		if ( NumClipped < 3 )
+			continue;
+
+		// Project the way geCamera_Project does
+		for ( v = 0; v < NumClipped; v++ )
+		{
+			float Z = -Clipped[ v ].z;
+			float ScaleOverZ = View->Scale / Z;
+
+			Clipped[ v ].x = Clipped[ v ].x * ScaleOverZ + View->XCenter;
+			Clipped[ v ].y = View->YCenter - Clipped[ v ].y * ScaleOverZ;
+			Clipped[ v ].z = Z * View->ZScale;
+		}
+
+		NullDrv_FrameStats.StaticFaces++;
+
+		RenderWorldPoly( Clipped, NumClipped, Face->THandle, ( DRV_TexInfo * ) &Face->TexInfo, Face->LInfo, Face->Flags );
+	}
+
+	NullRaster_SetClipRect( NULL );
+
+	return GE_TRUE;
+}
+
+static geBoolean DRIVERCC DrawDecal( geRDriver_THandle *THandle, geWinRect *SRect, int32 x, int32 y )
+{
+	NullDrv_FrameStats.Decals++;
+
+	if ( NullRaster_Active() )
+		NullRaster_DrawDecal( THandle, SRect, x, y );
+
+	return GE_TRUE;
+}
+
+static geBoolean DRIVERCC ScreenShot( const char *Name )
+{
+	if ( !NullRaster_Active() )
+	{
+		NullDrv_SetLastError( DRV_ERROR_GENERIC, "NULL_DRV:  Screen shots need the raster sub driver." );
+		return GE_FALSE;
+	}
+
+	if ( !NullRaster_WritePPM( Name ) )
+	{
+		NullDrv_SetLastError( DRV_ERROR_GENERIC, "NULL_DRV:  Could not write the screen shot." );
+		return GE_FALSE;
+	}
+
+	return GE_TRUE;
+}
+
+//====================================================================================
+//====================================================================================
+DRV_Driver NULLDRV =
+        {
+                "Null driver. v" DRV_VMAJS "." DRV_VMINS ".",// Name
+                DRV_VERSION_MAJOR,                           // VersionMajor
+                DRV_VERSION_MINOR,                           // VersionMinor
+
+                DRV_ERROR_NONE,// LastError
+                NULL,          // LastErrorStr
+
+                EnumSubDrivers,
+                EnumModes,
+
+                EnumPixelFormats,
+
+                DrvInit,
+                DrvShutdown,
+                DrvResetAll,
+                DrvUpdateWindow,
+                DrvSetActive,
+
+                THandle_Create,
+                THandle_Destroy,
+
+                THandle_Lock,
+                THandle_UnLock,
+
+                THandle_SetPalette,
+                THandle_GetPalette,
+
+                NULL,//SetAlpha
+                NULL,//GetAlpha
+
+                THandle_GetInfo,
+
+                BeginScene,
+                EndScene,
+                BeginWorld,
+                EndWorld,
+                BeginMeshes,
+                EndMeshes,
+                BeginModels,
+                EndModels,
+
+                RenderGouraudPoly,
+                RenderWorldPoly,
+                RenderMiscTexturePoly,
+
+                DrawDecal,
+
+                0, 0, 0,
+
+                &CacheInfo,
+
+                ScreenShot,
+
+                SetGamma,
+                GetGamma,
+
+                SetFogEnable,
+
+                NULL,// EngineSettings
+                NULL,// Init to NULL, engine SHOULD set this (SetupLightmap)
+                NULL,// GlobalInfo
+
+                RenderBatch,
+
+                World_Create,
+                World_Destroy,
+                World_Render,
+};
+
+//====================================================================================
+//====================================================================================
+DllExport geBoolean DriverHook( DRV_Driver **Driver )
+{
+	EngineSettings.CanSupportFlags = ( DRV_SUPPORT_ALPHA | DRV_SUPPORT_COLORKEY );
+	EngineSettings.PreferenceFlags = 0;
+
+	NULLDRV.EngineSettings = &EngineSettings;
+
+	*Driver = &NULLDRV;
+
+	NullDrv_SetLastError( DRV_ERROR_NONE, "NULL_DRV:  No error." );
+
+	return GE_TRUE;
+}
+
+//====================================================================================
+//====================================================================================
+DllExport void NullDrv_GetStats( NullDrv_Stats *Frame, NullDrv_Stats *Total )
+{
+	if ( Frame )
+		*Frame = LastFrameStats;
+	if ( Total )
+		*Total = NullDrv_TotalStats;
+}
+
+//====================================================================================
+//====================================================================================
+void NullDrv_SetLastError( int32 Error, const char *ErrorStr )
+{
+	LastError = Error;
+
+	if ( ErrorStr )
+	{
+		strncpy( LastErrorStr, ErrorStr, sizeof( LastErrorStr ) - 1 );
+		LastErrorStr[ sizeof( LastErrorStr ) - 1 ] = 0;
+	}
+	else
+		LastErrorStr[ 0 ] = 0;
+
+	NULLDRV.LastErrorStr = LastErrorStr;
+	NULLDRV.LastError    = LastError;
+}
@@ -0,0 +1,113 @@
+/*******************************************************************************
+Copyright © 2024 Mark E. Sowden <hogsy@oldtimes-software.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************/
+
+
+#ifndef NULLDRV_H
+#define NULLDRV_H
+
+#include "Dcommon.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//====================================================================================
+//	Headless driver
+//
+//	Fills the whole DRV_Driver table without a window or a GPU, so the engine can be
+//	benchmarked and regression tested on machines without either.  Sub driver 0 only
+//	counts what the engine sends, sub driver 1 also rasterizes it into a memory
+//	framebuffer (flat texture colour * gouraud, z buffered) that ScreenShot writes
+//	out as a binary PPM.
+//
+//	Static world faces (World_Create/World_Render) are kept in system memory, and
+//	transformed, near clipped and projected here the way a hardware driver would.
+//
+//	If the NULLDRV_RECORD environment variable names a file, one line of counters is
+//	appended to it per scene.
+//====================================================================================
+
+#define NULLDRV_SUBDRIVER_COUNT		0
+#define NULLDRV_SUBDRIVER_RASTER	1
+
+#define NULLDRV_MAX_MIP_LEVELS		4
+
+typedef struct
+{
+	int32		Scenes;
+	int32		WorldPolys;
+	int32		GouraudPolys;
+	int32		MiscPolys;
+	int32		Decals;
+	int32		Vertices;
+	int32		THandleCreates;
+	int32		THandleDestroys;
+	int32		THandleLocks;
+	int32		TextureUploadBytes;			// Mip data handed over through Lock/UnLock
+	int32		LightmapUploads;			// Lightmaps that had to be (re)uploaded
+	int32		LightmapUploadBytes;
+	int32		Pixels;						// Pixels written into the framebuffer
+	int32		Batches;					// RenderBatch calls
+	int32		StateChanges;				// Runs in those batches with a new type, flags or THandle
+	int32		StaticFaces;				// World polys that came in through World_Render
+} NullDrv_Stats;
+
+struct geRDriver_THandle
+{
+	geBoolean				Active;
+	int32					Width, Height;
+	int32					NumMipLevels;
+	geRDriver_PixelFormat	PixelFormat;
+
+	uint8					*Data[NULLDRV_MAX_MIP_LEVELS];
+	uint32					Color;			// Average XRGB of mip 0, what the rasterizer draws with
+	geBoolean				ColorValid;
+
+	geRDriver_THandle		*PalHandle;
+	geBoolean				Uploaded;		// Lightmaps: has been filled at least once
+};
+
+extern DRV_Driver		NULLDRV;
+extern NullDrv_Stats	NullDrv_FrameStats;
+extern NullDrv_Stats	NullDrv_TotalStats;
+
+void		NullDrv_SetLastError(int32 Error, const char *ErrorStr);
+
+// NullRaster.c
+geBoolean	NullRaster_Startup(int32 Width, int32 Height);
+void		NullRaster_Shutdown(void);
+geBoolean	NullRaster_Active(void);
+void		NullRaster_Clear(geBoolean Clear, geBoolean ClearZ);
+void		NullRaster_SetClipRect(const geWinRect *Rect);
+void		NullRaster_DrawPoly(const DRV_TLVertex *Pnts, int32 NumPoints, uint32 Color, U32 Flags);
+void		NullRaster_DrawDecal(const geRDriver_THandle *THandle, const geWinRect *SRect, int32 x, int32 y);
+geBoolean	NullRaster_WritePPM(const char *Name);
+
+// Exported, so a host that loaded the driver can read the counters back.
+// Frame is the last finished scene
+DllExport void NullDrv_GetStats(NullDrv_Stats *Frame, NullDrv_Stats *Total);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,358 @@
+/*******************************************************************************
+Copyright © 2024 Mark E. Sowden <hogsy@oldtimes-software.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************/
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "NullDrv.h"
+
+//====================================================================================
+//	Memory framebuffer for the raster sub driver
+//	Polys are drawn as fans of triangles, one colour per poly (the average of its
+//	texture) modulated by the gouraud colour, and tested against a 1/z buffer.
+//	Good enough to diff frames against, not meant to look like the real drivers.
+//====================================================================================
+
+static int32  FrameWidth;
+static int32  FrameHeight;
+static uint32 *FrameColor;
+static float  *FrameZ;
+static geWinRect ClipRect;		// Inclusive, polys are cut to this
+
+//====================================================================================
+//	NullRaster_Startup
+//====================================================================================
+geBoolean NullRaster_Startup( int32 Width, int32 Height )
+{
+	NullRaster_Shutdown();
+
+	if ( Width <= 0 || Height <= 0 )
+		return GE_FALSE;
+
+	FrameColor = ( uint32 * ) calloc( Width * Height, sizeof( uint32 ) );
+	FrameZ     = ( float * ) calloc( Width * Height, sizeof( float ) );
+
+	if ( !FrameColor || !FrameZ )
+	{
+		NullRaster_Shutdown();
+		return GE_FALSE;
+	}
+
+	FrameWidth  = Width;
+	FrameHeight = Height;
+
+	NullRaster_SetClipRect( NULL );
+
+	return GE_TRUE;
+}
+
+//====================================================================================
+//	NullRaster_Shutdown
+//====================================================================================
+void NullRaster_Shutdown( void )
+{
+	if ( FrameColor )
+		free( FrameColor );
+	if ( FrameZ )
+		free( FrameZ );
+
+	FrameColor  = NULL;
+	FrameZ      = NULL;
+	FrameWidth  = 0;
+	FrameHeight = 0;
+}
+
+//====================================================================================
+//	NullRaster_Active
+//====================================================================================
+geBoolean NullRaster_Active( void )
+{
+	return FrameColor != NULL;
+}
+
+//====================================================================================
+//	NullRaster_Clear
+//====================================================================================
+void NullRaster_Clear( geBoolean Clear, geBoolean ClearZ )
+{
+	if ( !FrameColor )
+		return;
+
+	if ( Clear )
+		memset( FrameColor, 0, FrameWidth * FrameHeight * sizeof( uint32 ) );
+
+	// 1/z of 0 is infinitely far away
+	if ( ClearZ )
+		memset( FrameZ, 0, FrameWidth * FrameHeight * sizeof( float ) );
+}
+
+//====================================================================================
+//	NullRaster_SetClipRect
+//	NULL is the whole framebuffer.  The engine clips TL polys itself, only polys the
+//	driver projects (World_Render) need this
+//====================================================================================
+void NullRaster_SetClipRect( const geWinRect *Rect )
+{
+	ClipRect.left   = 0;
+	ClipRect.top    = 0;
+	ClipRect.right  = FrameWidth - 1;
+	ClipRect.bottom = FrameHeight - 1;
+
+	if ( !Rect )
+		return;
+
+	if ( Rect->left > ClipRect.left )
+		ClipRect.left = Rect->left;
+	if ( Rect->top > ClipRect.top )
+		ClipRect.top = Rect->top;
+	if ( Rect->right < ClipRect.right )
+		ClipRect.right = Rect->right;
+	if ( Rect->bottom < ClipRect.bottom )
+		ClipRect.bottom = Rect->bottom;
+}
+
+//====================================================================================
+//	DrawTriangle
+//====================================================================================
+static void DrawTriangle( const DRV_TLVertex *v0, const DRV_TLVertex *v1, const DRV_TLVertex *v2, uint32 Color, U32 Flags )
+{
+	float Area, OneOverArea;
+	float OOZ[ 3 ];
+	float TexR, TexG, TexB;
+	int32 MinX, MinY, MaxX, MaxY, x, y;
+
+	Area = ( v1->x - v0->x ) * ( v2->y - v0->y ) - ( v2->x - v0->x ) * ( v1->y - v0->y );
+
+	if ( Area == 0.0f )
+		return;
+
+	OneOverArea = 1.0f / Area;
+
+	OOZ[ 0 ] = v0->z > 0.0f ? 1.0f / v0->z : 1.0f;
+	OOZ[ 1 ] = v1->z > 0.0f ? 1.0f / v1->z : 1.0f;
+	OOZ[ 2 ] = v2->z > 0.0f ? 1.0f / v2->z : 1.0f;
+
+	TexR = ( float ) ( ( Color >> 16 ) & 255 ) * ( 1.0f / 255.0f );
+	TexG = ( float ) ( ( Color >> 8 ) & 255 ) * ( 1.0f / 255.0f );
+	TexB = ( float ) ( Color & 255 ) * ( 1.0f / 255.0f );
+
+	MinX = ( int32 ) v0->x;
+	MaxX = MinX;
+	MinY = ( int32 ) v0->y;
+	MaxY = MinY;
+
+#define GROW( v )                    \
+	if ( ( int32 ) ( v )->x < MinX ) \
+		MinX = ( int32 ) ( v )->x;   \
+	if ( ( int32 ) ( v )->x > MaxX ) \
+		MaxX = ( int32 ) ( v )->x;   \
+	if ( ( int32 ) ( v )->y < MinY ) \
+		MinY = ( int32 ) ( v )->y;   \
+	if ( ( int32 ) ( v )->y > MaxY ) \
+		MaxY = ( int32 ) ( v )->y;
+
+	GROW( v1 )
+	GROW( v2 )
+#undef GROW
+
+	if ( MinX < ClipRect.left )
+		MinX = ClipRect.left;
+	if ( MinY < ClipRect.top )
+		MinY = ClipRect.top;
+	if ( MaxX > ClipRect.right )
+		MaxX = ClipRect.right;
+	if ( MaxY > ClipRect.bottom )
+		MaxY = ClipRect.bottom;
+
+	for ( y = MinY; y <= MaxY; y++ )
+	{
+		float py = ( float ) y + 0.5f;
+
+		for ( x = MinX; x <= MaxX; x++ )
+		{
+			float   px = ( float ) x + 0.5f;
+			float   w0, w1, w2, z, a, r, g, b;
+			int32   i;
+			uint32  Dest;
+
+			// Barycentrics, normalised so the winding doesn't matter
+			w0 = ( ( v1->x - px ) * ( v2->y - py ) - ( v2->x - px ) * ( v1->y - py ) ) * OneOverArea;
+			w1 = ( ( v2->x - px ) * ( v0->y - py ) - ( v0->x - px ) * ( v2->y - py ) ) * OneOverArea;
+			w2 = 1.0f - w0 - w1;
+
+			if ( w0 < 0.0f || w1 < 0.0f || w2 < 0.0f )
+				continue;
+
+			i = y * FrameWidth + x;
+			z = w0 * OOZ[ 0 ] + w1 * OOZ[ 1 ] + w2 * OOZ[ 2 ];
+
+			if ( !( Flags & DRV_RENDER_NO_ZMASK ) && z <= FrameZ[ i ] )
+				continue;
+
+			if ( !( Flags & DRV_RENDER_NO_ZWRITE ) )
+				FrameZ[ i ] = z;
+
+			r = ( w0 * v0->r + w1 * v1->r + w2 * v2->r ) * TexR;
+			g = ( w0 * v0->g + w1 * v1->g + w2 * v2->g ) * TexG;
+			b = ( w0 * v0->b + w1 * v1->b + w2 * v2->b ) * TexB;
+
+			if ( Flags & DRV_RENDER_ALPHA )
+			{
+				a    = ( w0 * v0->a + w1 * v1->a + w2 * v2->a ) * ( 1.0f / 255.0f );
+				Dest = FrameColor[ i ];
+				r    = r * a + ( float ) ( ( Dest >> 16 ) & 255 ) * ( 1.0f - a );
+				g    = g * a + ( float ) ( ( Dest >> 8 ) & 255 ) * ( 1.0f - a );
+				b    = b * a + ( float ) ( Dest & 255 ) * ( 1.0f - a );
+			}
+
+			if ( r > 255.0f )
+				r = 255.0f;
+			if ( g > 255.0f )
+				g = 255.0f;
+			if ( b > 255.0f )
+				b = 255.0f;
+
+			FrameColor[ i ] = ( ( uint32 ) r << 16 ) | ( ( uint32 ) g << 8 ) | ( uint32 ) b;
+			NullDrv_FrameStats.Pixels++;
+		}
+	}
+}
+
+//====================================================================================
+//	NullRaster_DrawPoly
+//====================================================================================
+void NullRaster_DrawPoly( const DRV_TLVertex *Pnts, int32 NumPoints, uint32 Color, U32 Flags )
+{
+	int32 i;
+
+	if ( !FrameColor )
+		return;
+
+	for ( i = 2; i < NumPoints; i++ )
+		DrawTriangle( &Pnts[ 0 ], &Pnts[ i - 1 ], &Pnts[ i ], Color, Flags );
+}
+
+//====================================================================================
+//	NullRaster_DrawDecal
+//	Decals are always 565, with a colour key of 1
+//====================================================================================
+void NullRaster_DrawDecal( const geRDriver_THandle *THandle, const geWinRect *SRect, int32 x, int32 y )
+{
+	geWinRect     Rect;
+	const uint16 *Src;
+	int32         u, v, dx, dy;
+
+	if ( !FrameColor || !THandle || !THandle->Data[ 0 ] )
+		return;
+
+	if ( THandle->PixelFormat.PixelFormat != GE_PIXELFORMAT_16BIT_565_RGB )
+		return;
+
+	if ( SRect )
+		Rect = *SRect;
+	else
+	{
+		Rect.left   = 0;
+		Rect.top    = 0;
+		Rect.right  = THandle->Width - 1;
+		Rect.bottom = THandle->Height - 1;
+	}
+
+	Src = ( const uint16 * ) THandle->Data[ 0 ];
+
+	for ( v = Rect.top; v <= Rect.bottom && v < THandle->Height; v++ )
+	{
+		dy = y + v - Rect.top;
+
+		if ( v < 0 || dy < 0 || dy >= FrameHeight )
+			continue;
+
+		for ( u = Rect.left; u <= Rect.right && u < THandle->Width; u++ )
+		{
+			uint32 c;
+
+			dx = x + u - Rect.left;
+
+			if ( u < 0 || dx < 0 || dx >= FrameWidth )
+				continue;
+
+			c = Src[ v * THandle->Width + u ];
+
+			if ( c == 1 )
+				continue;
+
+			FrameColor[ dy * FrameWidth + dx ] = ( ( ( c >> 11 ) & 31 ) << 19 ) | ( ( ( c >> 5 ) & 63 ) << 10 ) | ( ( c & 31 ) << 3 );
+			NullDrv_FrameStats.Pixels++;
+		}
+	}
+}
+
+//====================================================================================
+//	NullRaster_WritePPM
+//====================================================================================
+geBoolean NullRaster_WritePPM( const char *Name )
+{
+	FILE  *f;
+	int32  i;
+	uint8 *Row;
+
+	if ( !FrameColor )
+		return GE_FALSE;
+
+	f = fopen( Name, "wb" );
+
+	if ( !f )
+		return GE_FALSE;
+
+	Row = ( uint8 * ) malloc( FrameWidth * 3 );
+
+	if ( !Row )
+	{
+		fclose( f );
+		return GE_FALSE;
+	}
+
+	fprintf( f, "P6\n%d %d\n255\n", FrameWidth, FrameHeight );
+
+	for ( i = 0; i < FrameWidth * FrameHeight; i++ )
+	{
+		uint32 c = FrameColor[ i ];
+		int32  x = i % FrameWidth;
+
+		Row[ x * 3 + 0 ] = ( uint8 ) ( c >> 16 );
+		Row[ x * 3 + 1 ] = ( uint8 ) ( c >> 8 );
+		Row[ x * 3 + 2 ] = ( uint8 ) c;
+
+		if ( x == FrameWidth - 1 && fwrite( Row, FrameWidth * 3, 1, f ) != 1 )
+		{
+			free( Row );
+			fclose( f );
+			return GE_FALSE;
+		}
+	}
+
+	free( Row );
+
+	return fclose( f ) == 0;
+}
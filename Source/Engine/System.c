@@ -33,6 +33,7 @@ SOFTWARE.
 #include "engine.h"
 #include "list.h"
 #include "geAssert.h"
+#include "geThread.h"
 #include "Core/System.h"
 
 //#define SKY_HACK
@@ -102,12 +103,21 @@ geBoolean QueryPerformanceCounter( LARGE_INTEGER *performanceCount )
 //=====================================================================================
 //	Local static globals
 //=====================================================================================
+#if defined( _WIN32 )
+#	define DRIVER_EXT ".dll"
+#elif defined( __APPLE__ )
+#	define DRIVER_EXT ".dylib"
+#else
+#	define DRIVER_EXT ".so"
+#endif
+
 static const char DriverFileNames[][ 200 ] = {
-        { "GLDrv.dll" },
-        { "GlideDrv.dll" },
-        { "D3DDrv.dll" },
-        { "SoftDrv.dll" },
-        { "SoftDrv2.dll" },
+        { "GLDrv" DRIVER_EXT },
+        { "GlideDrv" DRIVER_EXT },
+        { "D3DDrv" DRIVER_EXT },
+        { "SoftDrv" DRIVER_EXT },
+        { "SoftDrv2" DRIVER_EXT },
+        { "NullDrv" DRIVER_EXT },// Headless, always last so a real driver is listed first
         { "" },
 };
 
@@ -303,6 +313,13 @@ geEngine *Sys_EngineCreate( HWND hWnd, const char *AppName, const char *DriverDi
 	if ( !geEngine_InitFonts( NewEngine ) )// must be after BitmapList
 		goto ExitWithError;
 
+	// Workers for the actor jobs and batched traces, last so nothing after it can fail
+	if ( !geThread_PoolStart( 0 ) )
+	{
+		geErrorLog_Add( GE_ERR_OUT_OF_MEMORY, NULL );
+		goto ExitWithError;
+	}
+
 	NewEngine->Changed = GE_TRUE;// Force a first time driver upload
 
 	NewEngine->DisplayFrameRateCounter = GE_TRUE;// Default to showing the FPS counter
@@ -363,6 +380,8 @@ void Sys_EngineFree( geEngine *Engine )
 
 	geRam_Free( Engine->DriverDirectory );
 
+	geThread_PoolStop();
+
 	List_Stop();
 
 	geRam_Free( Engine );
@@ -507,7 +526,7 @@ static geBoolean EnumSubDrivers( Sys_DriverInfo *DriverInfo, const char *DriverD
 
 	for ( i = 0; DriverFileNames[ i ][ 0 ] != 0; i++ )
 	{
-		if ( !strcmp( DriverFileNames[ i ], "D3DDrv.dll" ) && GlideFound )
+		if ( !strcmp( DriverFileNames[ i ], "D3DDrv" DRIVER_EXT ) && GlideFound )
 			continue;// Skip D3D if we found a glidedrv
 
 		Handle = geEngine_LoadLibrary( DriverFileNames[ i ], DriverDirectory );
@@ -547,7 +566,7 @@ static geBoolean EnumSubDrivers( Sys_DriverInfo *DriverInfo, const char *DriverD
 
 		geSystem_FreeLibrary( Handle );
 
-		if ( !strcmp( DriverFileNames[ i ], "GlideDrv.dll" ) )
+		if ( !strcmp( DriverFileNames[ i ], "GlideDrv" DRIVER_EXT ) )
 			GlideFound = GE_TRUE;
 	}
 
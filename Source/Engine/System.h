@@ -124,6 +124,13 @@ typedef struct
 	int32			NumFog;
 	int32			LMap1;				// Lmaps gone through first pass (reg light)
 	int32			LMap2;				// LMaps gone through 2nd pass (fog)
+	int32			PoseCacheHits;		// Actor poses copied from the pose cache
+	int32			PoseCacheMisses;	// Actor poses sampled into the pose cache
+	int32			LMapCacheHits;		// Lightmaps reused from the last combine
+	int32			LMapRecomputes;		// Lightmaps combined from their ltypes and dlights
+	int32			LMapUploadBytes;	// Lightmap bytes handed to the driver as dynamic
+	int32			BatchCmds;			// Polys sent through the driver's RenderBatch
+	int32			BatchRuns;			// Runs of those polys that share type, flags and THandle
 } Sys_DebugInfo;
 
 //{} Hack:
@@ -38,6 +38,7 @@
 #include "bitmap._h"
 #include "log.h"
 #include "Core/System.h"
+#include "posecache.h"
 
 //#define DO_ADDREMOVE_MESSAGES
 
@@ -990,15 +991,16 @@ geBoolean geEngine_AttachAllWorlds( geEngine *Engine )
 
 	for ( i = 0; i < Engine->NumWorlds; i++ )
 	{
-		if ( !geWorld_AttachAll( Engine->Worlds[ i ], RDriver, Engine->BitmapGamma ) )
+		// Lightmaps first, so the driver has them all by the time it gets the static faces
+		if ( !geEngine_CreateWorldLightmapTHandles( Engine, Engine->Worlds[ i ] ) )
 		{
-			geErrorLog_AddString( -1, "geEngine_AttachAllWorlds:  geWorld_AttachAll failed.", NULL );
+			geErrorLog_AddString( -1, "geEngine_AttachAllWorlds:  geEngine_CreateWorldLightmapTHandles failed.", NULL );
 			return GE_FALSE;
 		}
 
-		if ( !geEngine_CreateWorldLightmapTHandles( Engine, Engine->Worlds[ i ] ) )
+		if ( !geWorld_AttachAll( Engine->Worlds[ i ], RDriver, Engine->BitmapGamma ) )
 		{
-			geErrorLog_AddString( -1, "geEngine_AttachAllWorlds:  geEngine_CreateWorldLightmapTHandles failed.", NULL );
+			geErrorLog_AddString( -1, "geEngine_AttachAllWorlds:  geWorld_AttachAll failed.", NULL );
 			return GE_FALSE;
 		}
 	}
@@ -1254,7 +1256,11 @@ geSystemLibrary geEngine_LoadLibrary( const char *lpLibFileName, const char *Dri
 	char *StrEnd = Buff + strlen( Buff ) - 1;
 	if ( *StrEnd != '\\' && *StrEnd != '/' && *StrEnd != ':' )
 	{
+#if defined( _WIN32 )
 		strcat( Buff, "\\" );
+#else
+		strcat( Buff, "/" );
+#endif
 	}
 	strcat( Buff, lpLibFileName );
 	geSystemLibrary Library = geSystem_LoadLibrary( Buff );
@@ -1550,6 +1556,9 @@ GENESISAPI geBoolean geEngine_BeginFrame( geEngine *Engine, geCamera *Camera, ge
 	// Clear some debug info
 	memset( &Engine->DebugInfo, 0, sizeof( Engine->DebugInfo ) );
 
+	// Poses cached last frame might be sampled from motions that have changed since
+	gePoseCache_Flush();
+
 	if ( Camera )
 	{
 		geCamera_GetClippingRect( Camera, &gDrvRect );
@@ -1573,9 +1582,9 @@ GENESISAPI geBoolean geEngine_BeginFrame( geEngine *Engine, geCamera *Camera, ge
 	return GE_TRUE;
 }
 
-extern int32 NumExactCast;
-extern int32 NumBBoxCast;
-extern int32 NumGetContents;
+extern volatile int32 NumExactCast;
+extern volatile int32 NumBBoxCast;
+extern volatile int32 NumGetContents;
 
 //===================================================================================
 //	geEngine_EndFrame
@@ -1662,6 +1671,20 @@ GENESISAPI geBoolean geEngine_EndFrame( geEngine *Engine )
 		geEngine_Printf( Engine, 2, 2 + 15 * 5, "DLights: %3i", Engine->DebugInfo.NumDLights );
 		geEngine_Printf( Engine, 2, 2 + 15 * 6, "Fog    : %3i", Engine->DebugInfo.NumFog );
 		geEngine_Printf( Engine, 2, 2 + 15 * 7, "LMap1  : %3i, LMap2  : %3i", Engine->DebugInfo.LMap1, Engine->DebugInfo.LMap2 );
+		geEngine_Printf( Engine, 2, 2 + 15 * 11, "LCache : %3i hit, %3i calc, %6i bytes", Engine->DebugInfo.LMapCacheHits, Engine->DebugInfo.LMapRecomputes, Engine->DebugInfo.LMapUploadBytes );
+
+		if ( Engine->DebugInfo.BatchCmds )
+			geEngine_Printf( Engine, 2, 2 + 15 * 12, "Batch  : %4i polys, %4i runs", Engine->DebugInfo.BatchCmds, Engine->DebugInfo.BatchRuns );
+
+		if ( gePoseCache_GetTimeStep() > 0.0f )
+		{
+			gePoseCache_Stats PoseStats;
+
+			gePoseCache_GetStats( &PoseStats );
+			Engine->DebugInfo.PoseCacheHits   = PoseStats.Hits;
+			Engine->DebugInfo.PoseCacheMisses = PoseStats.Misses;
+			geEngine_Printf( Engine, 2, 2 + 15 * 10, "Poses  : %3i hit, %3i miss", Engine->DebugInfo.PoseCacheHits, Engine->DebugInfo.PoseCacheMisses );
+		}
 
 		// For now, just display debug info for the first world...
 		if ( Engine->NumWorlds )
@@ -23,6 +23,7 @@
 #include <assert.h>
 
 #include "ENTITIES.H"
+#include "geThread.h"
 
 //=====================================================================================
 //	Local Static Globals
@@ -32,6 +33,63 @@
 //	Local Static Function prototypes
 //=====================================================================================
 static		geWorld	*GWorld;		// Temp global world for testing new entity stuff
+static volatile int32 GWorldLock;	// Held while GWorld is in use, worlds can be loaded on other threads
+
+static geBoolean Ent_WorldInitLocked(geWorld *World);
+
+//====================================================================================
+//	IndexName
+//	Keeps a name index in step with the list it covers.  If the name can't go in,
+//	the index is dropped, and lookups go back to searching the list.
+//====================================================================================
+static void IndexName(geNameIndex **pIndex, const char *Name, void *Data, geBoolean Replace)
+{
+	geBoolean	Ret;
+
+	if (!*pIndex)
+		return;
+
+	if (Name)
+	{
+		if (Replace)
+			Ret = geNameIndex_Set(*pIndex, Name, Data);
+		else
+			Ret = geNameIndex_Add(*pIndex, Name, Data);
+
+		if (Ret)
+			return;
+	}
+
+	geNameIndex_Destroy(pIndex);
+}
+
+//====================================================================================
+//	Ent_WorldFindClassSet
+//====================================================================================
+geEntity_EntitySet *Ent_WorldFindClassSet(geWorld *World, const char *ClassName)
+{
+	geWorld_EntClassSet	*WSet;
+	int32				i;
+
+	assert(World);
+	assert(ClassName);
+
+	if (World->EntClassSetIndex)
+		return (geEntity_EntitySet*)geNameIndex_Find(World->EntClassSetIndex, ClassName);
+
+	WSet = World->EntClassSets;
+
+	for (i=0; i< World->NumEntClassSets; i++)
+	{
+		if (!WSet[i].ClassName)
+			continue;
+
+		if (!stricmp(WSet[i].ClassName, ClassName))
+			return WSet[i].Set;
+	}
+
+	return NULL;
+}
 
 //====================================================================================
 //====================================================================================
@@ -39,6 +97,7 @@ static geBoolean InsertEntityInClassList(geWorld *World, geEntity *Entity)
 {
 	const char			*EntClassName;
 	geWorld_EntClassSet	*WSet;
+	geEntity_EntitySet	*Set;
 	int32				i;
 
 	if (!Entity->Class)		// Ignore all no classes
@@ -48,35 +107,38 @@ static geBoolean InsertEntityInClassList(geWorld *World, geEntity *Entity)
 	
 	EntClassName = Entity->Class->Name;
 
-	WSet = World->EntClassSets;
+	Set = Ent_WorldFindClassSet(World, EntClassName);
 
-	for (i=0; i< World->NumEntClassSets; i++)
+	if (Set)
 	{
-		if (!WSet[i].ClassName)
-			continue;
-
-		if (!stricmp(WSet[i].ClassName, EntClassName))
-		{
-			// Add entity to this class set...
-			if (!geEntity_EntitySetAddEntity(WSet[i].Set, Entity))
-				return GE_FALSE;
+		// Add entity to this class set...
+		if (!geEntity_EntitySetAddEntity(Set, Entity))
+			return GE_FALSE;
 
-			return GE_TRUE;
-		}
+		return GE_TRUE;
 	}
 
+	i = World->NumEntClassSets;
+
 	if (i >= MAX_WORLD_ENT_CLASS_SETS)
 		return GE_FALSE;					// oh well...
 
+	WSet = World->EntClassSets;
+
 	// Create a new entity set
 	WSet[i].Set = geEntity_EntitySetCreate();
 
+	if (!WSet[i].Set)
+		return GE_FALSE;
+
 	// Insert the entity into a new class set
 	WSet[i].ClassName = EntClassName;
 	geEntity_EntitySetAddEntity(WSet[i].Set, Entity);
 
 	World->NumEntClassSets++;
 
+	IndexName(&World->EntClassSetIndex, EntClassName, WSet[i].Set, GE_FALSE);
+
 	return GE_TRUE;
 }
 
@@ -85,6 +147,24 @@ static geBoolean InsertEntityInClassList(geWorld *World, geEntity *Entity)
 //	Lets this module initialize data that it owns in the world
 //====================================================================================
 geBoolean Ent_WorldInit(geWorld *World)
+{
+	geBoolean			Ret;
+
+	geSpinLock_Lock(&GWorldLock);
+
+	GWorld = World;
+	Ret = Ent_WorldInitLocked(World);
+	GWorld = NULL;
+
+	geSpinLock_Unlock(&GWorldLock);
+
+	return Ret;
+}
+
+//====================================================================================
+//	Ent_WorldInitLocked
+//====================================================================================
+static geBoolean Ent_WorldInitLocked(geWorld *World)
 {
 	GBSP_BSPData		*BSP;
 	geEntity_EntitySet	*EntitySet;
@@ -92,9 +172,8 @@ geBoolean Ent_WorldInit(geWorld *World)
 
 	assert(World != NULL);
 	
-	GWorld = World;
-
 	World->NumEntClassSets = 0;
+	geNameIndex_Destroy(&World->EntClassSetIndex);
 
 	if ( ! World->CurrentBSP )
 		return GE_TRUE;
@@ -114,7 +193,9 @@ geBoolean Ent_WorldInit(geWorld *World)
 	World->EntClassSets[0].Set = EntitySet;
 	World->NumEntClassSets++;
 		
-	// Build class sets
+	// Build class sets, NULL index just means they are searched
+	World->EntClassSetIndex = geNameIndex_Create(64, GE_FALSE);
+
 	Entity = NULL;
 	while (1)
 	{
@@ -141,6 +222,8 @@ void Ent_WorldShutdown(geWorld *World)
 	
 	for (i=0; i< World->NumEntClassSets; i++)
 		geEntity_EntitySetDestroy(World->EntClassSets[i].Set);
+
+	geNameIndex_Destroy(&World->EntClassSetIndex);
 }
 
 //====================================================================================
@@ -217,10 +300,13 @@ geBoolean geEntity_GetModelNumForKey(geEntity *Entity, const char *Key, int32 *M
 {
 	geEntity_Epair	*Epair;
 	int32			Value;
+	uint32			KeyHash;
+
+	KeyHash = geNameIndex_HashName(Key, GE_FALSE);
 
 	for (Epair = Entity->Epairs; Epair; Epair = Epair->Next)
 	{
-		if (!stricmp(Epair->Key, Key))
+		if (Epair->KeyHash == KeyHash && !stricmp(Epair->Key, Key))
 		{
 			if (Epair->Value[0] == '*')
 				sscanf(Epair->Value+1, "%d", &Value);
@@ -246,6 +332,10 @@ geBoolean geEntity_AddEpair(geEntity *Entity, geEntity_Epair *Epair)
 	assert(Epair);
 
 	assert(Epair->Next == NULL);		// Make sure this is a fresh one (ahh yahh)
+	assert(Epair->Key);
+
+	// Lookups compare this before doing the stricmp
+	Epair->KeyHash = geNameIndex_HashName(Epair->Key, GE_FALSE);
 	
 	if (!Entity->Epairs)
 	{
@@ -267,10 +357,13 @@ geBoolean geEntity_AddEpair(geEntity *Entity, geEntity_Epair *Epair)
 const char *geEntity_GetStringForKey(const geEntity *Entity, const char *Key)
 {
 	geEntity_Epair	*Epair;
+	uint32			KeyHash;
+
+	KeyHash = geNameIndex_HashName(Key, GE_FALSE);
 
 	for (Epair = Entity->Epairs; Epair; Epair = Epair->Next)
 	{
-		if (!stricmp(Epair->Key, Key))
+		if (Epair->KeyHash == KeyHash && !stricmp(Epair->Key, Key))
 		{
 			return Epair->Value;
 		}
@@ -384,6 +477,9 @@ void geEntity_ClassDestroy(geEntity_Class *Class)
 		NextField = Field->Next;
 		geEntity_FieldDestroy(Field);
 	}
+
+	geNameIndex_Destroy(&Class->FieldIndex);
+
 	if (Class->Name)
 		geRam_Free(Class->Name);
 
@@ -398,7 +494,12 @@ geBoolean geEntity_ClassAddField(geEntity_Class	*Class, geEntity_Field *Field)
 	assert(Class);
 	assert(Field);
 
-	// Put at the beggining
+	if (!Class->Fields)
+		Class->FieldIndex = geNameIndex_Create(16, GE_FALSE);
+
+	// Put at the beggining, so the index takes the newest field for a name
+	IndexName(&Class->FieldIndex, Field->Name, Field, GE_TRUE);
+
 	Field->Next = Class->Fields;
 	Class->Fields = Field;
 
@@ -417,6 +518,9 @@ geEntity_Field *geEntity_ClassFindFieldByName(geEntity_Class *Class, const char
 
 	assert(Class);
 
+	if (Class->FieldIndex)
+		return (geEntity_Field*)geNameIndex_Find(Class->FieldIndex, Name);
+
 	for (Field = Class->Fields; Field; Field = Field->Next)
 	{
 		if	(!stricmp(Field->Name, Name))
@@ -472,6 +576,9 @@ void geEntity_EntitySetDestroy(geEntity_EntitySet *EntitySet)
 		}
 	}
 
+	geNameIndex_Destroy(&EntitySet->EntityIndex);
+	geNameIndex_Destroy(&EntitySet->ClassIndex);
+
 	// Finclaly destroy the sets themselves...
 	for (Set = EntitySet; Set; Set = Next)
 	{
@@ -490,6 +597,9 @@ geEntity_Class *geEntity_EntitySetFindClassByName(geEntity_EntitySet *Set, const
 
 	assert(Set);
 
+	if (Set->ClassIndex)
+		return (geEntity_Class*)geNameIndex_Find(Set->ClassIndex, Name);
+
 	for (Class = Set->Classes; Class; Class = Class->Next)
 	{
 		if	(!stricmp(Class->Name, Name))
@@ -524,6 +634,9 @@ geEntity *geEntity_EntitySetFindEntityByName(geEntity_EntitySet *EntitySet, cons
 	assert(EntitySet);
 	assert(Name);
 
+	if (EntitySet->EntityIndex)
+		return (geEntity*)geNameIndex_Find(EntitySet->EntityIndex, Name);
+
 	for (Set = EntitySet; Set; Set = Set->Next)
 	{
 		EntName = geEntity_GetStringForKey(Set->Entity, "%Name%");
@@ -544,6 +657,7 @@ geEntity *geEntity_EntitySetFindEntityByName(geEntity_EntitySet *EntitySet, cons
 geBoolean geEntity_EntitySetAddEntity(geEntity_EntitySet *EntitySet, geEntity *Entity)
 {
 	geEntity_EntitySet	*NewSet, *Set;
+	const char			*Name;
 	
 	assert(EntitySet);
 	assert(Entity);
@@ -555,23 +669,39 @@ geBoolean geEntity_EntitySetAddEntity(geEntity_EntitySet *EntitySet, geEntity *E
 		assert(EntitySet->Current == NULL);
 
 		EntitySet->Entity = Entity;
-		return GE_TRUE;
+		EntitySet->Tail = EntitySet;
 	}
+	else
+	{
+		NewSet = geEntity_EntitySetCreate();
 
-	NewSet = geEntity_EntitySetCreate();
-
-	if (!NewSet)
-		return GE_FALSE;
+		if (!NewSet)
+			return GE_FALSE;
 
-	// Store the entity
-	NewSet->Entity = Entity;
+		// Store the entity
+		NewSet->Entity = Entity;
 	
-	// Jump to end of list (we allways want them to work on the first set in the list...)
-	for (Set = EntitySet; Set->Next; Set = Set->Next);		
+		// Jump to end of list (we allways want them to work on the first set in the list...)
+		Set = EntitySet->Tail;
+
+		if (!Set)
+			for (Set = EntitySet; Set->Next; Set = Set->Next);		
+
+		assert(Set->Next == NULL);
 
-	// Add the newset
-	Set->Next = NewSet;
-return GE_TRUE;
+		// Add the newset
+		Set->Next = NewSet;
+		EntitySet->Tail = NewSet;
+	}
+
+	// Appended, so the index keeps the first entity for a name like the search did.
+	// Entities without a name can't be found by name, so they stay out of it.
+	Name = geEntity_GetStringForKey(Entity, "%Name%");
+
+	if (EntitySet->EntityIndex && Name)
+		IndexName(&EntitySet->EntityIndex, Name, Entity, GE_FALSE);
+
+	return GE_TRUE;
 }
 
 //====================================================================================
@@ -630,7 +760,12 @@ geBoolean geEntity_EntitySetAddClass(geEntity_EntitySet *EntitySet, geEntity_Cla
 
 	assert(Class->Next == NULL);		// We want fresh ones only
 
-	// Just put in front of list
+	if (!EntitySet->Classes)
+		EntitySet->ClassIndex = geNameIndex_Create(64, GE_FALSE);
+
+	// Just put in front of list, so the index takes the newest class for a name
+	IndexName(&EntitySet->ClassIndex, Class->Name, Class, GE_TRUE);
+
 	Class->Next = EntitySet->Classes;
 	EntitySet->Classes = Class;
 
@@ -954,11 +1089,45 @@ static geBoolean ParseClassData(geEntity_EntitySet *EntitySet)
 	return GE_TRUE;
 }
 
+//====================================================================================
+//	BuildEntityIndex
+//	Model and struct fields refer to other entities by %Name%
+//====================================================================================
+static void BuildEntityIndex(geEntity_EntitySet *EntitySet)
+{
+	geEntity_EntitySet	*Set;
+	const char			*Name;
+	int32				NumEntities;
+
+	NumEntities = 0;
+
+	for (Set = EntitySet; Set; Set = Set->Next)
+		NumEntities++;
+
+	geNameIndex_Destroy(&EntitySet->EntityIndex);
+	EntitySet->EntityIndex = geNameIndex_Create(NumEntities, GE_FALSE);
+
+	for (Set = EntitySet; Set && EntitySet->EntityIndex; Set = Set->Next)
+	{
+		if (!Set->Entity)
+			continue;
+
+		Name = geEntity_GetStringForKey(Set->Entity, "%Name%");
+
+		if (!Name)
+			continue;
+
+		IndexName(&EntitySet->EntityIndex, Name, Set->Entity, GE_FALSE);
+	}
+}
+
 //====================================================================================
 //	geEntity_EntitySetBuildClasses
 //====================================================================================
 geBoolean geEntity_EntitySetBuildClasses(geEntity_EntitySet *Set)
 {
+	BuildEntityIndex(Set);
+
 	if (!BuildClassTypes(Set))
 		return GE_FALSE;
 
@@ -63,6 +63,7 @@ GENESISAPI geEngine *geEngine_CreateWithVersion(HWND hWnd, const char *AppName,
 //=====================================================================================
 GENESISAPI void geEngine_Free(geEngine *Engine)
 {
+	gePoseCache_Flush();
 	Sys_EngineFree(Engine);
 }
 
@@ -222,8 +223,11 @@ GENESISAPI void geWorld_ModelMotionSample(
 	gePath *	P;
 
 	P = geMotion_GetPath((const geMotion *)M, 0);
-	assert(P);
-	gePath_Sample(P, Time, XForm);
+
+	if (P)
+		gePath_Sample(P, Time, XForm);
+	else
+		geMotion_Sample((const geMotion *)M, 0, Time, XForm);	// Couldn't unpack the path of a packed motion
 }
 
 GENESISAPI void * geWorld_ModelGetUserData(const geWorld_Model *Model)
@@ -329,6 +333,14 @@ GENESISAPI geBoolean geWorld_Collision(geWorld *World, const geVec3d *Mins, cons
 	return Trace_GEWorldCollision(World, Mins, Maxs, Front, Back, Contents, CollideFlags, UserFlags, CollisionCB, Context, Col);
 }
 
+//========================================================================================
+//	geWorld_CollisionBatch
+//========================================================================================
+GENESISAPI geBoolean geWorld_CollisionBatch(geWorld *World, GE_CollisionQuery *Queries, int32 NumQueries, uint32 Contents, uint32 CollideFlags, uint32 UserFlags, GE_CollisionCB *CollisionCB, void *Context)
+{
+	return Trace_CollisionBatch(World, Queries, NumQueries, Contents, CollideFlags, UserFlags, CollisionCB, Context);
+}
+
 //========================================================================================
 //	geWorld_GetContents
 //========================================================================================
@@ -0,0 +1,344 @@
+/*******************************************************************************
+Copyright © 2024 Mark E. Sowden <hogsy@oldtimes-software.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************/
+
+
+#include <assert.h>
+#include <string.h>
+
+#include "geNameIndex.h"
+#include "RAM.H"
+
+#define NAMEINDEX_MIN_SLOTS		16
+#define NAMEINDEX_MIN_NAMES		256
+
+typedef struct
+{
+	uint32			Hash;
+	int32			Name;				// Offset into Index->Names, -1 for an empty slot
+	void			*Data;
+} geNameIndex_Entry;
+
+struct geNameIndex
+{
+	geBoolean			CaseSensitive;
+
+	int32				Count;
+	int32				NumSlots;		// Always a power of 2, and kept at least twice Count
+	geNameIndex_Entry	*Slots;
+
+	char				*Names;			// All the names, back to back
+	int32				NamesSize;
+	int32				NamesMax;
+};
+
+//=====================================================================================
+//	geNameIndex_HashName
+//	FNV-1a, folding ASCII case the same way stricmp does when CaseSensitive is false
+//=====================================================================================
+uint32 geNameIndex_HashName(const char *Name, geBoolean CaseSensitive)
+{
+	uint32		Hash;
+	uint32		c;
+
+	assert(Name);
+
+	Hash = 2166136261u;
+
+	for (; *Name; Name++)
+	{
+		c = (uint8)*Name;
+
+		if (!CaseSensitive && c >= 'A' && c <= 'Z')
+			c += 'a' - 'A';
+
+		Hash = (Hash ^ c) * 16777619u;
+	}
+
+	return Hash;
+}
+
+//=====================================================================================
+//	AllocSlots
+//=====================================================================================
+static geNameIndex_Entry *AllocSlots(int32 NumSlots)
+{
+	geNameIndex_Entry	*Slots;
+	int32				i;
+
+	Slots = GE_RAM_ALLOCATE_ARRAY(geNameIndex_Entry, NumSlots);
+
+	if (!Slots)
+		return NULL;
+
+	for (i=0; i< NumSlots; i++)
+	{
+		Slots[i].Hash = 0;
+		Slots[i].Name = -1;
+		Slots[i].Data = NULL;
+	}
+
+	return Slots;
+}
+
+//=====================================================================================
+//	geNameIndex_Create
+//=====================================================================================
+geNameIndex *geNameIndex_Create(int32 ExpectedCount, geBoolean CaseSensitive)
+{
+	geNameIndex		*Index;
+	int32			NumSlots;
+
+	Index = GE_RAM_ALLOCATE_STRUCT(geNameIndex);
+
+	if (!Index)
+		return NULL;
+
+	memset(Index, 0, sizeof(geNameIndex));
+
+	Index->CaseSensitive = CaseSensitive;
+
+	for (NumSlots = NAMEINDEX_MIN_SLOTS; NumSlots < ExpectedCount*2; NumSlots <<= 1);
+
+	Index->NumSlots = NumSlots;
+	Index->Slots = AllocSlots(NumSlots);
+
+	if (!Index->Slots)
+		goto ExitWithError;
+
+	Index->NamesMax = ExpectedCount*16;
+
+	if (Index->NamesMax < NAMEINDEX_MIN_NAMES)
+		Index->NamesMax = NAMEINDEX_MIN_NAMES;
+
+	Index->Names = GE_RAM_ALLOCATE_ARRAY(char, Index->NamesMax);
+
+	if (!Index->Names)
+		goto ExitWithError;
+
+	return Index;
+
+	ExitWithError:
+	{
+		geNameIndex_Destroy(&Index);
+		return NULL;
+	}
+}
+
+//=====================================================================================
+//	geNameIndex_Destroy
+//=====================================================================================
+void geNameIndex_Destroy(geNameIndex **pIndex)
+{
+	geNameIndex		*Index;
+
+	assert(pIndex);
+
+	Index = *pIndex;
+
+	if (!Index)
+		return;
+
+	if (Index->Slots)
+		geRam_Free(Index->Slots);
+
+	if (Index->Names)
+		geRam_Free(Index->Names);
+
+	geRam_Free(Index);
+
+	*pIndex = NULL;
+}
+
+//=====================================================================================
+//	FindSlot
+//	Returns the slot holding Name, or the empty slot it would go in
+//=====================================================================================
+static int32 FindSlot(const geNameIndex *Index, const char *Name, uint32 Hash)
+{
+	const geNameIndex_Entry	*Slot;
+	uint32					Mask;
+	uint32					i;
+
+	Mask = (uint32)Index->NumSlots - 1;
+
+	for (i = Hash & Mask; ; i = (i+1) & Mask)
+	{
+		Slot = &Index->Slots[i];
+
+		if (Slot->Name < 0)
+			return (int32)i;
+
+		if (Slot->Hash != Hash)
+			continue;
+
+		if (Index->CaseSensitive)
+		{
+			if (!strcmp(Index->Names + Slot->Name, Name))
+				return (int32)i;
+		}
+		else if (!stricmp(Index->Names + Slot->Name, Name))
+			return (int32)i;
+	}
+}
+
+//=====================================================================================
+//	Grow
+//=====================================================================================
+static geBoolean Grow(geNameIndex *Index)
+{
+	geNameIndex_Entry	*OldSlots, *NewSlots;
+	int32				OldNumSlots, NewNumSlots;
+	uint32				Mask, s;
+	int32				i;
+
+	OldSlots = Index->Slots;
+	OldNumSlots = Index->NumSlots;
+	NewNumSlots = OldNumSlots*2;
+
+	NewSlots = AllocSlots(NewNumSlots);
+
+	if (!NewSlots)
+		return GE_FALSE;
+
+	// Names are unique already, so only the hash is needed to re-place them
+	Mask = (uint32)NewNumSlots - 1;
+
+	for (i=0; i< OldNumSlots; i++)
+	{
+		if (OldSlots[i].Name < 0)
+			continue;
+
+		for (s = OldSlots[i].Hash & Mask; NewSlots[s].Name >= 0; s = (s+1) & Mask);
+
+		NewSlots[s] = OldSlots[i];
+	}
+
+	geRam_Free(OldSlots);
+
+	Index->Slots = NewSlots;
+	Index->NumSlots = NewNumSlots;
+
+	return GE_TRUE;
+}
+
+//=====================================================================================
+//	Insert
+//=====================================================================================
+static geBoolean Insert(geNameIndex *Index, const char *Name, void *Data, geBoolean Replace)
+{
+	geNameIndex_Entry	*Slot;
+	uint32				Hash;
+	int32				Length;
+
+	assert(Index);
+	assert(Name);
+
+	if ((Index->Count+1)*2 > Index->NumSlots)
+	{
+		if (!Grow(Index))
+			return GE_FALSE;
+	}
+
+	Hash = geNameIndex_HashName(Name, Index->CaseSensitive);
+	Slot = &Index->Slots[FindSlot(Index, Name, Hash)];
+
+	if (Slot->Name >= 0)
+	{
+		if (Replace)
+			Slot->Data = Data;
+
+		return GE_TRUE;
+	}
+
+	Length = (int32)strlen(Name) + 1;
+
+	if (Index->NamesSize + Length > Index->NamesMax)
+	{
+		char	*NewNames;
+		int32	NewMax;
+
+		for (NewMax = Index->NamesMax*2; NewMax < Index->NamesSize + Length; NewMax *= 2);
+
+		NewNames = GE_RAM_REALLOC_ARRAY(Index->Names, char, NewMax);
+
+		if (!NewNames)
+			return GE_FALSE;
+
+		Index->Names = NewNames;
+		Index->NamesMax = NewMax;
+	}
+
+	memcpy(Index->Names + Index->NamesSize, Name, Length);
+
+	Slot->Hash = Hash;
+	Slot->Name = Index->NamesSize;
+	Slot->Data = Data;
+
+	Index->NamesSize += Length;
+	Index->Count++;
+
+	return GE_TRUE;
+}
+
+//=====================================================================================
+//	geNameIndex_Add
+//=====================================================================================
+geBoolean geNameIndex_Add(geNameIndex *Index, const char *Name, void *Data)
+{
+	return Insert(Index, Name, Data, GE_FALSE);
+}
+
+//=====================================================================================
+//	geNameIndex_Set
+//=====================================================================================
+geBoolean geNameIndex_Set(geNameIndex *Index, const char *Name, void *Data)
+{
+	return Insert(Index, Name, Data, GE_TRUE);
+}
+
+//=====================================================================================
+//	geNameIndex_Find
+//=====================================================================================
+void *geNameIndex_Find(const geNameIndex *Index, const char *Name)
+{
+	const geNameIndex_Entry	*Slot;
+
+	assert(Index);
+	assert(Name);
+
+	Slot = &Index->Slots[FindSlot(Index, Name, geNameIndex_HashName(Name, Index->CaseSensitive))];
+
+	if (Slot->Name < 0)
+		return NULL;
+
+	return Slot->Data;
+}
+
+//=====================================================================================
+//	geNameIndex_GetCount
+//=====================================================================================
+int32 geNameIndex_GetCount(const geNameIndex *Index)
+{
+	assert(Index);
+
+	return Index->Count;
+}
@@ -0,0 +1,60 @@
+/*******************************************************************************
+Copyright © 2024 Mark E. Sowden <hogsy@oldtimes-software.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************/
+
+
+#ifndef GE_NAMEINDEX_H
+#define GE_NAMEINDEX_H
+
+#include "BASETYPE.H"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//=====================================================================================
+//	Hashed name -> pointer index
+//
+//	Stands in for the linear stricmp/strcmp scans over name lists.  The index keeps
+//	its own copy of every name, so the owner is free to move or free its strings.
+//	Lookups match the scans they replace: Add keeps the entry that is already there
+//	(first match in a list that is appended to), Set replaces it (first match in a
+//	list that is prepended to).
+//=====================================================================================
+
+typedef struct geNameIndex		geNameIndex;
+
+geNameIndex	*geNameIndex_Create(int32 ExpectedCount, geBoolean CaseSensitive);
+void		geNameIndex_Destroy(geNameIndex **pIndex);
+
+geBoolean	geNameIndex_Add(geNameIndex *Index, const char *Name, void *Data);	// Keeps an existing entry
+geBoolean	geNameIndex_Set(geNameIndex *Index, const char *Name, void *Data);	// Replaces an existing entry
+void		*geNameIndex_Find(const geNameIndex *Index, const char *Name);		// NULL if not there
+int32		geNameIndex_GetCount(const geNameIndex *Index);
+
+// The hash the index uses, for callers that want to compare hashes before strings
+uint32		geNameIndex_HashName(const char *Name, geBoolean CaseSensitive);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,591 @@
+/*******************************************************************************
+Copyright © 2024 Mark E. Sowden <hogsy@oldtimes-software.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************/
+
+
+#include <assert.h>
+#include <string.h>
+
+#ifdef _WIN32
+#	include <windows.h>
+#else
+#	include <pthread.h>
+#	include <sched.h>
+#	include <unistd.h>
+#endif
+
+#include "geThread.h"
+#include "RAM.H"
+
+#define GETHREAD_MAX_THREADS	64
+
+typedef struct
+{
+	volatile int32		Cursor;
+	volatile int32		Abort;
+	int32				NumWork;
+	geThread_WorkCB		*Func;
+	void				*Context;
+} geThread_Run;
+
+typedef struct
+{
+	geThread_Run		*Run;
+	int32				ThreadNum;
+} geThread_Worker;
+
+struct geThread
+{
+#ifdef _WIN32
+	HANDLE				Handle;
+#else
+	pthread_t			Handle;
+#endif
+	geThread_Func		*Func;
+	void				*Context;
+};
+
+// Workers started by geThread_PoolStart, they sleep until geThread_RunOnIndividual hands them a run
+typedef struct
+{
+	int32				NumThreads;			// Including the thread that hands out the run
+	volatile int32		Busy;				// A run owns the pool
+	geThread_Run		*Run;
+	int32				RunThreads;			// Workers with ThreadNum < RunThreads take part in Run
+	int32				RunNum;				// Bumped for every run, workers wait for it to change
+	int32				NumActive;			// Workers still working on Run
+	geBoolean			Quit;
+	geThread_Worker		Workers[GETHREAD_MAX_THREADS];
+#ifdef _WIN32
+	CRITICAL_SECTION	Mutex;
+	CONDITION_VARIABLE	Wake;
+	CONDITION_VARIABLE	Done;
+	HANDLE				Threads[GETHREAD_MAX_THREADS];
+#else
+	pthread_mutex_t		Mutex;
+	pthread_cond_t		Wake;
+	pthread_cond_t		Done;
+	pthread_t			Threads[GETHREAD_MAX_THREADS];
+#endif
+} geThread_Pool;
+
+static geThread_Pool	*Pool;
+static int32			PoolUsageCount;
+
+//=====================================================================================
+//	geAtomic_Add
+//=====================================================================================
+int32 geAtomic_Add(volatile int32 *Value, int32 Add)
+{
+#ifdef _WIN32
+	return InterlockedExchangeAdd((volatile LONG*)Value, Add) + Add;
+#else
+	return __atomic_add_fetch(Value, Add, __ATOMIC_SEQ_CST);
+#endif
+}
+
+//=====================================================================================
+//	geAtomic_Get
+//=====================================================================================
+int32 geAtomic_Get(volatile int32 *Value)
+{
+#ifdef _WIN32
+	return InterlockedCompareExchange((volatile LONG*)Value, 0, 0);
+#else
+	return __atomic_load_n(Value, __ATOMIC_SEQ_CST);
+#endif
+}
+
+//=====================================================================================
+//	geAtomic_Set
+//=====================================================================================
+void geAtomic_Set(volatile int32 *Value, int32 NewValue)
+{
+#ifdef _WIN32
+	InterlockedExchange((volatile LONG*)Value, NewValue);
+#else
+	__atomic_store_n(Value, NewValue, __ATOMIC_SEQ_CST);
+#endif
+}
+
+//=====================================================================================
+//	geAtomic_CompareExchange
+//	Sets Value to NewValue if it was Compare, returns GE_TRUE if it did
+//=====================================================================================
+geBoolean geAtomic_CompareExchange(volatile int32 *Value, int32 Compare, int32 NewValue)
+{
+#ifdef _WIN32
+	return InterlockedCompareExchange((volatile LONG*)Value, NewValue, Compare) == Compare;
+#else
+	return __atomic_compare_exchange_n(Value, &Compare, NewValue, 0, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+#endif
+}
+
+//=====================================================================================
+//	geSpinLock_Lock / geSpinLock_Unlock
+//=====================================================================================
+static void geThread_Yield(void)
+{
+#ifdef _WIN32
+	SwitchToThread();
+#else
+	sched_yield();
+#endif
+}
+
+void geSpinLock_Lock(volatile int32 *Lock)
+{
+	while (!geAtomic_CompareExchange(Lock, 0, 1))
+		geThread_Yield();
+}
+
+void geSpinLock_Unlock(volatile int32 *Lock)
+{
+	assert(*Lock == 1);
+	geAtomic_Set(Lock, 0);
+}
+
+//=====================================================================================
+//	geThread_ResolveCount
+//=====================================================================================
+int32 geThread_ResolveCount(int32 NumThreads)
+{
+	if (NumThreads <= 0)
+	{
+#ifdef _WIN32
+		SYSTEM_INFO		Info;
+
+		GetSystemInfo(&Info);
+		NumThreads = (int32)Info.dwNumberOfProcessors;
+#else
+		NumThreads = (int32)sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+		if (NumThreads <= 0)
+			NumThreads = 1;
+	}
+
+	if (NumThreads > GETHREAD_MAX_THREADS)
+		NumThreads = GETHREAD_MAX_THREADS;
+
+	return NumThreads;
+}
+
+//=====================================================================================
+//	geThread_Work
+//=====================================================================================
+static void geThread_Work(geThread_Run *Run, int32 ThreadNum)
+{
+	while (!geAtomic_Get(&Run->Abort))
+	{
+		int32	WorkNum = geAtomic_Add(&Run->Cursor, 1) - 1;
+
+		if (WorkNum >= Run->NumWork)
+			break;
+
+		if (!Run->Func(ThreadNum, WorkNum, Run->Context))
+		{
+			geAtomic_Set(&Run->Abort, 1);
+			break;
+		}
+	}
+}
+
+#ifdef _WIN32
+static DWORD WINAPI geThread_Entry(LPVOID Param)
+{
+	geThread_Worker	*Worker = (geThread_Worker*)Param;
+
+	geThread_Work(Worker->Run, Worker->ThreadNum);
+	return 0;
+}
+#else
+static void *geThread_Entry(void *Param)
+{
+	geThread_Worker	*Worker = (geThread_Worker*)Param;
+
+	geThread_Work(Worker->Run, Worker->ThreadNum);
+	return NULL;
+}
+#endif
+
+//=====================================================================================
+//	Pool support functions
+//=====================================================================================
+static void geThread_PoolLock(void)
+{
+#ifdef _WIN32
+	EnterCriticalSection(&Pool->Mutex);
+#else
+	pthread_mutex_lock(&Pool->Mutex);
+#endif
+}
+
+static void geThread_PoolUnlock(void)
+{
+#ifdef _WIN32
+	LeaveCriticalSection(&Pool->Mutex);
+#else
+	pthread_mutex_unlock(&Pool->Mutex);
+#endif
+}
+
+#ifdef _WIN32
+static void geThread_PoolWait(CONDITION_VARIABLE *Cond)
+{
+	SleepConditionVariableCS(Cond, &Pool->Mutex, INFINITE);
+}
+
+static void geThread_PoolWakeAll(CONDITION_VARIABLE *Cond)
+{
+	WakeAllConditionVariable(Cond);
+}
+#else
+static void geThread_PoolWait(pthread_cond_t *Cond)
+{
+	pthread_cond_wait(Cond, &Pool->Mutex);
+}
+
+static void geThread_PoolWakeAll(pthread_cond_t *Cond)
+{
+	pthread_cond_broadcast(Cond);
+}
+#endif
+
+//=====================================================================================
+//	geThread_PoolWork
+//	Loop of a pool worker, until geThread_PoolStop
+//=====================================================================================
+static void geThread_PoolWork(int32 ThreadNum)
+{
+	geThread_Run	*Run;
+	int32			LastRun;
+
+	LastRun = 0;
+
+	geThread_PoolLock();
+
+	for (;;)
+	{
+		while (!Pool->Quit && Pool->RunNum == LastRun)
+			geThread_PoolWait(&Pool->Wake);
+
+		if (Pool->Quit)
+			break;
+
+		LastRun = Pool->RunNum;
+
+		if (ThreadNum >= Pool->RunThreads)
+			continue;		// Not needed for this one
+
+		Run = Pool->Run;
+
+		geThread_PoolUnlock();
+		geThread_Work(Run, ThreadNum);
+		geThread_PoolLock();
+
+		if (--Pool->NumActive == 0)
+			geThread_PoolWakeAll(&Pool->Done);
+	}
+
+	geThread_PoolUnlock();
+}
+
+#ifdef _WIN32
+static DWORD WINAPI geThread_PoolEntry(LPVOID Param)
+{
+	geThread_PoolWork(((geThread_Worker*)Param)->ThreadNum);
+	return 0;
+}
+#else
+static void *geThread_PoolEntry(void *Param)
+{
+	geThread_PoolWork(((geThread_Worker*)Param)->ThreadNum);
+	return NULL;
+}
+#endif
+
+//=====================================================================================
+//	geThread_PoolStart
+//=====================================================================================
+geBoolean geThread_PoolStart(int32 NumThreads)
+{
+	int32	i;
+
+	assert(PoolUsageCount >= 0);
+
+	if (PoolUsageCount++)
+		return GE_TRUE;
+
+	assert(!Pool);
+
+	Pool = GE_RAM_ALLOCATE_STRUCT(geThread_Pool);
+
+	if (!Pool)
+	{
+		PoolUsageCount--;
+		return GE_FALSE;
+	}
+
+	memset(Pool, 0, sizeof(*Pool));
+
+#ifdef _WIN32
+	InitializeCriticalSection(&Pool->Mutex);
+	InitializeConditionVariable(&Pool->Wake);
+	InitializeConditionVariable(&Pool->Done);
+#else
+	pthread_mutex_init(&Pool->Mutex, NULL);
+	pthread_cond_init(&Pool->Wake, NULL);
+	pthread_cond_init(&Pool->Done, NULL);
+#endif
+
+	NumThreads = geThread_ResolveCount(NumThreads);
+
+	// Thread 0 is whoever hands out the run.  If a worker can't be started, the pool is just smaller.
+	for (Pool->NumThreads = 1; Pool->NumThreads < NumThreads; Pool->NumThreads++)
+	{
+		i = Pool->NumThreads - 1;
+
+		Pool->Workers[i].Run = NULL;
+		Pool->Workers[i].ThreadNum = Pool->NumThreads;
+
+#ifdef _WIN32
+		Pool->Threads[i] = CreateThread(NULL, 0, geThread_PoolEntry, &Pool->Workers[i], 0, NULL);
+		if (!Pool->Threads[i])
+			break;
+#else
+		if (pthread_create(&Pool->Threads[i], NULL, geThread_PoolEntry, &Pool->Workers[i]) != 0)
+			break;
+#endif
+	}
+
+	return GE_TRUE;
+}
+
+//=====================================================================================
+//	geThread_PoolStop
+//=====================================================================================
+void geThread_PoolStop(void)
+{
+	int32	i;
+
+	assert(PoolUsageCount > 0);
+
+	if (--PoolUsageCount)
+		return;
+
+	assert(Pool);
+	assert(!Pool->Busy);
+
+	geThread_PoolLock();
+	Pool->Quit = GE_TRUE;
+	geThread_PoolWakeAll(&Pool->Wake);
+	geThread_PoolUnlock();
+
+	for (i=0; i< Pool->NumThreads-1; i++)
+	{
+#ifdef _WIN32
+		WaitForSingleObject(Pool->Threads[i], INFINITE);
+		CloseHandle(Pool->Threads[i]);
+#else
+		pthread_join(Pool->Threads[i], NULL);
+#endif
+	}
+
+#ifdef _WIN32
+	DeleteCriticalSection(&Pool->Mutex);
+#else
+	pthread_cond_destroy(&Pool->Done);
+	pthread_cond_destroy(&Pool->Wake);
+	pthread_mutex_destroy(&Pool->Mutex);
+#endif
+
+	geRam_Free(Pool);
+	Pool = NULL;		// geThread_RunOnIndividual goes back to its own threads, and the next start makes a new pool
+}
+
+//=====================================================================================
+//	geThread_PoolRun
+//	Hands Run to the pool workers and works on it too, until it is done
+//=====================================================================================
+static void geThread_PoolRun(geThread_Run *Run, int32 NumThreads)
+{
+	if (NumThreads > Pool->NumThreads)
+		NumThreads = Pool->NumThreads;
+
+	geThread_PoolLock();
+	Pool->Run = Run;
+	Pool->RunThreads = NumThreads;
+	Pool->NumActive = NumThreads - 1;
+	Pool->RunNum++;
+	geThread_PoolWakeAll(&Pool->Wake);
+	geThread_PoolUnlock();
+
+	geThread_Work(Run, 0);
+
+	geThread_PoolLock();
+	while (Pool->NumActive)
+		geThread_PoolWait(&Pool->Done);
+	Pool->Run = NULL;
+	geThread_PoolUnlock();
+}
+
+//=====================================================================================
+//	geThread_RunOnIndividual
+//	Calls Func once for every WorkNum in [0, NumWork), spread across NumThreads.
+//	Uses the pool when it is started, otherwise threads are started for this run.
+//	If a thread can't be started, the ones that did (and the caller) do its share.
+//=====================================================================================
+geBoolean geThread_RunOnIndividual(int32 NumWork, int32 NumThreads, geThread_WorkCB *Func, void *Context)
+{
+	geThread_Run		Run;
+	geThread_Worker		Workers[GETHREAD_MAX_THREADS];
+#ifdef _WIN32
+	HANDLE				Threads[GETHREAD_MAX_THREADS];
+#else
+	pthread_t			Threads[GETHREAD_MAX_THREADS];
+#endif
+	int32				i, NumStarted;
+
+	assert(Func);
+
+	Run.Cursor = 0;
+	Run.Abort = 0;
+	Run.NumWork = NumWork;
+	Run.Func = Func;
+	Run.Context = Context;
+
+	NumThreads = geThread_ResolveCount(NumThreads);
+
+	if (NumThreads > NumWork)
+		NumThreads = NumWork;
+
+	if (Pool)
+	{
+		// Runs from inside a run, or from two threads at once, keep to the calling thread,
+		// the pool workers are busy anyway
+		if (NumThreads > 1 && geAtomic_CompareExchange(&Pool->Busy, 0, 1))
+		{
+			geThread_PoolRun(&Run, NumThreads);
+			geAtomic_Set(&Pool->Busy, 0);
+		}
+		else
+			geThread_Work(&Run, 0);
+
+		return !Run.Abort;
+	}
+
+	// Thread 0 is the caller
+	for (NumStarted = 0, i = 1; i< NumThreads; i++)
+	{
+		Workers[NumStarted].Run = &Run;
+		Workers[NumStarted].ThreadNum = i;
+
+#ifdef _WIN32
+		Threads[NumStarted] = CreateThread(NULL, 0, geThread_Entry, &Workers[NumStarted], 0, NULL);
+		if (!Threads[NumStarted])
+			break;
+#else
+		if (pthread_create(&Threads[NumStarted], NULL, geThread_Entry, &Workers[NumStarted]) != 0)
+			break;
+#endif
+		NumStarted++;
+	}
+
+	geThread_Work(&Run, 0);
+
+	for (i=0; i< NumStarted; i++)
+	{
+#ifdef _WIN32
+		WaitForSingleObject(Threads[i], INFINITE);
+		CloseHandle(Threads[i]);
+#else
+		pthread_join(Threads[i], NULL);
+#endif
+	}
+
+	return !Run.Abort;
+}
+
+#ifdef _WIN32
+static DWORD WINAPI geThread_StartEntry(LPVOID Param)
+{
+	geThread	*Thread = (geThread*)Param;
+
+	Thread->Func(Thread->Context);
+	return 0;
+}
+#else
+static void *geThread_StartEntry(void *Param)
+{
+	geThread	*Thread = (geThread*)Param;
+
+	Thread->Func(Thread->Context);
+	return NULL;
+}
+#endif
+
+//=====================================================================================
+//	geThread_Start
+//=====================================================================================
+geThread *geThread_Start(geThread_Func *Func, void *Context)
+{
+	geThread	*Thread;
+
+	assert(Func);
+
+	Thread = GE_RAM_ALLOCATE_STRUCT(geThread);
+
+	if (!Thread)
+		return NULL;
+
+	Thread->Func = Func;
+	Thread->Context = Context;
+
+#ifdef _WIN32
+	Thread->Handle = CreateThread(NULL, 0, geThread_StartEntry, Thread, 0, NULL);
+	if (!Thread->Handle)
+#else
+	if (pthread_create(&Thread->Handle, NULL, geThread_StartEntry, Thread) != 0)
+#endif
+	{
+		geRam_Free(Thread);
+		return NULL;
+	}
+
+	return Thread;
+}
+
+//=====================================================================================
+//	geThread_Join
+//=====================================================================================
+void geThread_Join(geThread *Thread)
+{
+	assert(Thread);
+
+#ifdef _WIN32
+	WaitForSingleObject(Thread->Handle, INFINITE);
+	CloseHandle(Thread->Handle);
+#else
+	pthread_join(Thread->Handle, NULL);
+#endif
+
+	geRam_Free(Thread);
+}
@@ -0,0 +1,74 @@
+/*******************************************************************************
+Copyright © 2024 Mark E. Sowden <hogsy@oldtimes-software.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************/
+
+
+#ifndef GE_THREAD_H
+#define GE_THREAD_H
+
+#include "BASETYPE.H"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//=====================================================================================
+//	Minimal threading support for the engine
+//
+//	geThread_RunOnIndividual hands out work items in index order from a shared
+//	cursor, the calling thread works too.  Work callbacks must not touch anything
+//	another item could be writing.
+//=====================================================================================
+
+// Return GE_FALSE to abort the whole run
+typedef geBoolean geThread_WorkCB(int32 ThreadNum, int32 WorkNum, void *Context);
+
+int32		geThread_ResolveCount(int32 NumThreads);		// <= 0 means one per hardware thread
+geBoolean	geThread_RunOnIndividual(int32 NumWork, int32 NumThreads, geThread_WorkCB *Func, void *Context);
+
+// Keeps NumThreads-1 workers waiting for geThread_RunOnIndividual, so runs don't start threads of
+// their own.  Calls nest, the last geThread_PoolStop stops the workers.  Don't stop the pool while
+// a run is going.
+geBoolean	geThread_PoolStart(int32 NumThreads);
+void		geThread_PoolStop(void);
+
+// A single long running thread, for work that has to outlive the call that started it
+typedef struct geThread		geThread;
+typedef void geThread_Func(void *Context);
+
+geThread	*geThread_Start(geThread_Func *Func, void *Context);	// NULL if the thread could not be started
+void		geThread_Join(geThread *Thread);						// Waits for Func to return, then frees Thread
+
+// Atomics, all of them full barriers
+int32		geAtomic_Add(volatile int32 *Value, int32 Add);	// Returns the new value
+int32		geAtomic_Get(volatile int32 *Value);
+void		geAtomic_Set(volatile int32 *Value, int32 NewValue);
+geBoolean	geAtomic_CompareExchange(volatile int32 *Value, int32 Compare, int32 NewValue);
+
+// Spin lock on an int32 that starts out 0, for short and rare critical sections
+void		geSpinLock_Lock(volatile int32 *Lock);
+void		geSpinLock_Unlock(volatile int32 *Lock);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
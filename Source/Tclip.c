@@ -72,6 +72,7 @@ TClip_Rasterize      : 0.006183 : 1.$ %
 #include "bitmap._h"
 #include "list.h"
 #include "timer.h"
+#include "DrvBatch.h"
 
 TIMER_VARS(TClip_Triangle);
 
@@ -231,13 +232,13 @@ void GENESISCC geTClip_Triangle(const GE_LVertex TriVertex[3])
 
 static void RASTERIZECC geTClip_Rasterize_Tex(const GE_LVertex * TriVtx)
 {
-	geTClip_Statics.Driver->RenderMiscTexturePoly((DRV_TLVertex *)TriVtx,
+	DrvBatch_MiscTexturePoly(geTClip_Statics.Driver, (DRV_TLVertex *)TriVtx,
 		3,geTClip_Statics.THandle,0);
 }
 
 static void RASTERIZECC geTClip_Rasterize_Gou(const GE_LVertex * TriVtx)
 {
-	geTClip_Statics.Driver->RenderGouraudPoly((DRV_TLVertex *)TriVtx,3,0);
+	DrvBatch_GouraudPoly(geTClip_Statics.Driver, (DRV_TLVertex *)TriVtx,3,0);
 }
 
 static void GENESISCC geTClip_Rasterize(const GE_LVertex * TriVtx)
@@ -248,12 +249,12 @@ static void GENESISCC geTClip_Rasterize(const GE_LVertex * TriVtx)
 
 	if ( geTClip_Statics.THandle )
 	{
-		geTClip_Statics.Driver->RenderMiscTexturePoly((DRV_TLVertex *)TriVtx,
+		DrvBatch_MiscTexturePoly(geTClip_Statics.Driver, (DRV_TLVertex *)TriVtx,
 			3,geTClip_Statics.THandle,0);
 	}
 	else
 	{
-		geTClip_Statics.Driver->RenderGouraudPoly((DRV_TLVertex *)TriVtx,
+		DrvBatch_GouraudPoly(geTClip_Statics.Driver, (DRV_TLVertex *)TriVtx,
 			3,0);
 	}
 }
@@ -515,12 +516,12 @@ uint32 OutBits = 0;
 
 	if ( geTClip_Statics.THandle )
 	{
-		geTClip_Statics.Driver->RenderMiscTexturePoly((DRV_TLVertex *)TriVertex,
+		DrvBatch_MiscTexturePoly(geTClip_Statics.Driver, (DRV_TLVertex *)TriVertex,
 			3,geTClip_Statics.THandle,0);
 	}
 	else
 	{
-		geTClip_Statics.Driver->RenderGouraudPoly((DRV_TLVertex *)TriVertex,3,0);
+		DrvBatch_GouraudPoly(geTClip_Statics.Driver, (DRV_TLVertex *)TriVertex,3,0);
 	}
 
 #endif //}
@@ -233,8 +233,13 @@ static	geBoolean	GENESISCC FSMemory_GetS(void *Handle, void *Buff, int MaxLen)
 		}
 		return GE_FALSE;
 	#endif
-	
-	*(pBuff + 1) = 0;
+
+	// End the line the way the DOS file system does (this used to leave a junk char
+	// before the terminator, one past the end of a full buffer)
+	if	(pBuff > (char *)Buff && *(pBuff - 1) == '\r')
+		*(pBuff - 1) = '\n';
+
+	*pBuff = 0;
 	return GE_TRUE;
 	
 }
@@ -262,6 +267,25 @@ static	geBoolean	GENESISCC FSMemory_Read(void *Handle, void *Buff, int Count)
 	return GE_TRUE;
 }
 
+static	geBoolean	GENESISCC FSMemory_ReadAt(void *Handle, long Position, void *Buff, int Count)
+{
+	MemoryFile *	File;
+
+	assert(Buff);
+	assert(Count != 0);
+
+	File = ( MemoryFile * ) Handle;
+
+	CHECK_HANDLE(File);
+
+	if	(Position < 0 || Position > File->Size || File->Size - Position < Count)
+		return GE_FALSE;
+
+	memcpy(Buff, File->Memory + Position, Count);
+
+	return GE_TRUE;
+}
+
 static	geBoolean	GENESISCC TestForExpansion(MemoryFile *File, int Size)
 {
 	assert(File);
@@ -492,6 +516,9 @@ static	geVFile_SystemAPIs	FSMemory_APIs =
 	FSMemory_SetAttributes,
 	FSMemory_SetTime,
 	FSMemory_SetHints,
+
+	NULL,	// Map: the application owns the block and may free it under us, so callers copy
+	FSMemory_ReadAt,
 };
 
 const geVFile_SystemAPIs * GENESISCC FSMemory_GetAPIs(void)
@@ -27,6 +27,7 @@
 
 #include "GENESIS.H"
 #include "RAM.H"
+#include "geNameIndex.h"
 
 #include	"dirtree.h"
 
@@ -40,6 +41,18 @@
 static int DirTree_SignatureBase=0x696C6345;
 static int DirTree_SignatureOffset=0x21657370;
 
+#define	DIRTREE_INDEX_MIN_BUCKETS	64
+
+// Every entry in the tree hashed by (Parent, Name), so a path lookup is one probe
+// per path component instead of a walk of each directory's children.  The entries
+// chain through DirTree::HashNext, so the index allocates nothing per entry.
+typedef	struct	DirTree_Index
+{
+	int					NumBuckets;		// Always a power of 2
+	int					Count;
+	struct DirTree **	Buckets;
+}	DirTree_Index;
+
 typedef struct	DirTree
 {
 	char *				Name;
@@ -51,6 +64,10 @@ typedef struct	DirTree
 	struct DirTree *	Parent;
 	struct DirTree *	Children;
 	struct DirTree *	Siblings;
+
+	DirTree_Index *		Index;			// Shared by the whole tree, owned by the root.  NULL means search.
+	unsigned int		Hash;			// Of Parent and Name, valid while Index is set
+	struct DirTree *	HashNext;
 }	DirTree;
 
 typedef struct	DirTree_Finder
@@ -72,6 +89,194 @@ static	char *	DuplicateString(const char *String)
 	return NewString;
 }
 
+static	unsigned int	HashEntry(const DirTree *Parent, const char *Name)
+{
+	unsigned int	Hash;
+
+	Hash = (unsigned int)((uintptr_t)Parent >> 4) * 2654435761u;
+
+	return Hash ^ geNameIndex_HashName(Name, GE_FALSE);
+}
+
+static	void	IndexInsert(DirTree_Index *Index, DirTree *Tree)
+{
+	DirTree **	Bucket;
+
+	assert(Index);
+	assert(Tree->Parent);
+
+	Tree->Index = Index;
+	Tree->Hash	= HashEntry(Tree->Parent, Tree->Name);
+
+	// Goes in front, so it shadows an older entry of the same name like the child list does
+	Bucket = &Index->Buckets[Tree->Hash & (Index->NumBuckets - 1)];
+	Tree->HashNext = *Bucket;
+	*Bucket = Tree;
+
+	Index->Count++;
+}
+
+static	void	IndexRemove(DirTree_Index *Index, DirTree *Tree)
+{
+	DirTree **	Link;
+
+	for	(Link = &Index->Buckets[Tree->Hash & (Index->NumBuckets - 1)]; *Link; Link = &(*Link)->HashNext)
+	{
+		if	(*Link == Tree)
+		{
+			*Link = Tree->HashNext;
+			Tree->HashNext = NULL;
+			Index->Count--;
+			return;
+		}
+	}
+
+	assert(!"Entry not in the index");
+}
+
+static	void	IndexRemoveTree(DirTree_Index *Index, DirTree *Tree)
+{
+	DirTree *	Child;
+
+	for	(Child = Tree->Children; Child; Child = Child->Siblings)
+		IndexRemoveTree(Index, Child);
+
+	IndexRemove(Index, Tree);
+}
+
+static	void	IndexInsertList(DirTree_Index *Index, DirTree *Parent, DirTree *List)
+{
+	if	(!List)
+		return;
+
+	// The tail goes in first, so the head of the list ends up first in the bucket
+	IndexInsertList(Index, Parent, List->Siblings);
+
+	assert(List->Parent == Parent);
+	IndexInsert(Index, List);
+
+	IndexInsertList(Index, List, List->Children);
+}
+
+static	geBoolean	IndexGrow(DirTree_Index *Index)
+{
+	DirTree **	NewBuckets;
+	DirTree *	Tree;
+	DirTree *	Next;
+	int			NewNumBuckets;
+	int			i;
+
+	NewNumBuckets = Index->NumBuckets * 2;
+	NewBuckets = geRam_Allocate(sizeof(*NewBuckets) * NewNumBuckets);
+	if	(!NewBuckets)
+		return GE_FALSE;
+	memset(NewBuckets, 0, sizeof(*NewBuckets) * NewNumBuckets);
+
+	// Walk each chain back to front, so entries keep their order in the new chains
+	for	(i = 0; i < Index->NumBuckets; i++)
+	{
+		DirTree *	Reversed;
+
+		Reversed = NULL;
+		for	(Tree = Index->Buckets[i]; Tree; Tree = Next)
+		{
+			Next = Tree->HashNext;
+			Tree->HashNext = Reversed;
+			Reversed = Tree;
+		}
+
+		for	(Tree = Reversed; Tree; Tree = Next)
+		{
+			DirTree **	Bucket;
+
+			Next = Tree->HashNext;
+			Bucket = &NewBuckets[Tree->Hash & (NewNumBuckets - 1)];
+			Tree->HashNext = *Bucket;
+			*Bucket = Tree;
+		}
+	}
+
+	geRam_Free(Index->Buckets);
+	Index->Buckets = NewBuckets;
+	Index->NumBuckets = NewNumBuckets;
+
+	return GE_TRUE;
+}
+
+static	void	IndexDestroy(DirTree_Index *Index)
+{
+	assert(Index);
+
+	geRam_Free(Index->Buckets);
+	geRam_Free(Index);
+}
+
+static	void	ClearIndex(DirTree *Tree)
+{
+	for	(; Tree; Tree = Tree->Siblings)
+	{
+		Tree->Index = NULL;
+		Tree->HashNext = NULL;
+		ClearIndex(Tree->Children);
+	}
+}
+
+// Indexes a whole tree.  If there isn't memory for it, lookups just search as before.
+static	void	BuildIndex(DirTree *Root, int NumEntries)
+{
+	DirTree_Index *	Index;
+	int				NumBuckets;
+
+	assert(Root);
+	assert(!Root->Parent);
+
+	Index = geRam_Allocate(sizeof(*Index));
+	if	(!Index)
+		return;
+
+	for	(NumBuckets = DIRTREE_INDEX_MIN_BUCKETS; NumBuckets < NumEntries; NumBuckets *= 2);
+
+	Index->NumBuckets = NumBuckets;
+	Index->Count = 0;
+	Index->Buckets = geRam_Allocate(sizeof(*Index->Buckets) * NumBuckets);
+	if	(!Index->Buckets)
+	{
+		geRam_Free(Index);
+		return;
+	}
+	memset(Index->Buckets, 0, sizeof(*Index->Buckets) * NumBuckets);
+
+	Root->Index = Index;
+	IndexInsertList(Index, Root, Root->Children);
+}
+
+static	DirTree *	FindChild(const DirTree *Tree, const char *Name)
+{
+	DirTree *	Child;
+
+	if	(Tree->Index)
+	{
+		unsigned int	Hash;
+
+		Hash = HashEntry(Tree, Name);
+		for	(Child = Tree->Index->Buckets[Hash & (Tree->Index->NumBuckets - 1)]; Child; Child = Child->HashNext)
+		{
+			if	(Child->Hash == Hash && Child->Parent == Tree && !stricmp(Child->Name, Name))
+				return Child;
+		}
+
+		return NULL;
+	}
+
+	for	(Child = Tree->Children; Child; Child = Child->Siblings)
+	{
+		if	(!stricmp(Child->Name, Name))
+			return Child;
+	}
+
+	return NULL;
+}
+
 DirTree *DirTree_Create(void)
 {
 	DirTree *	Tree;
@@ -90,6 +295,8 @@ DirTree *DirTree_Create(void)
 
 	Tree->AttributeFlags |= GE_VFILE_ATTRIB_DIRECTORY;
 
+	BuildIndex(Tree, 0);
+
 	return Tree;
 }
 
@@ -98,6 +305,10 @@ void	DirTree_Destroy(DirTree *Tree)
 	assert(Tree);
 	assert(Tree->Name);
 
+	// Only the root owns the index
+	if	(Tree->Index && !Tree->Parent)
+		IndexDestroy(Tree->Index);
+
 	if	(Tree->Children)
 		DirTree_Destroy(Tree->Children);
 
@@ -278,7 +489,7 @@ geBoolean DirTree_GetSize(const DirTree *Tree, long *Size)
 	return GE_TRUE;
 }
 
-static	geBoolean	ReadTree(geVFile *File, DirTree **TreePtr)
+static	geBoolean	ReadTree(geVFile *File, DirTree **TreePtr, int *NumEntries)
 {
 	int			Terminator;
 	int			Length;
@@ -297,6 +508,7 @@ static	geBoolean	ReadTree(geVFile *File, DirTree **TreePtr)
 	if	(!Tree)
 		return GE_FALSE;
 	memset(Tree, 0, sizeof(*Tree));
+	(*NumEntries)++;
 
 	// Read the name
 	if	(geVFile_Read(File, &Length, sizeof(Length)) == GE_FALSE)
@@ -342,12 +554,12 @@ static	geBoolean	ReadTree(geVFile *File, DirTree **TreePtr)
 
 //printf("Reading children of '%s'\n", Tree->Name);
 	// Read the children
-	if	(ReadTree(File, &Tree->Children) == GE_FALSE)
+	if	(ReadTree(File, &Tree->Children, NumEntries) == GE_FALSE)
 		goto fail;
 
 //printf("Reading siblings of '%s'\n", Tree->Name);
 	// Read the Siblings
-	if	(ReadTree(File, &Tree->Siblings) == GE_FALSE)
+	if	(ReadTree(File, &Tree->Siblings, NumEntries) == GE_FALSE)
 		goto fail;
 
 //DirTree_Dump(Tree);
@@ -361,12 +573,22 @@ fail:
 	return GE_FALSE;
 }
 
+static	void	LinkParents(DirTree *Parent, DirTree *List)
+{
+	for	(; List; List = List->Siblings)
+	{
+		List->Parent = Parent;
+		LinkParents(List, List->Children);
+	}
+}
+
 DirTree *DirTree_CreateFromFile(geVFile *File)
 {
 	DirTree *		Res;
 	DirTree_Header	Header;
 	long			StartPosition;
 	long			EndPosition;
+	int				NumEntries;
 	
 	if	(geVFile_Tell(File, &StartPosition) == GE_FALSE)
 		return GE_FALSE;
@@ -377,7 +599,8 @@ DirTree *DirTree_CreateFromFile(geVFile *File)
 	if	(Header.Signature != DIRTREE_FILE_SIGNATURE)
 		return GE_FALSE;
 
-	if	(ReadTree(File, &Res) == GE_FALSE)
+	NumEntries = 0;
+	if	(ReadTree(File, &Res, &NumEntries) == GE_FALSE)
 		return NULL;
 
 	geVFile_Tell(File, &EndPosition);
@@ -387,6 +610,11 @@ DirTree *DirTree_CreateFromFile(geVFile *File)
 		return NULL;
 	}
 
+	LinkParents(Res, Res->Children);
+
+	// Opens look files up by path from here on, so hash the whole directory once now
+	BuildIndex(Res, NumEntries);
+
 	return Res;
 }
 
@@ -404,33 +632,24 @@ static	const char *GetNextDir(const char *Path, char *Buff)
 
 DirTree *DirTree_FindExact(const DirTree *Tree, const char *Path)
 {
-	static char	Buff[PATH_MAX];
-	DirTree *	Siblings;
+	char		Buff[PATH_MAX];
 
 	assert(Tree);
 	assert(Path);
 
-	if	(*Path == '\\')
-		return NULL;
-
-	if	(*Path == '\0')
-		return (DirTree *)Tree;
+	while	(*Path)
+	{
+		if	(*Path == '\\')
+			return NULL;
 
-	Path = GetNextDir(Path, Buff);
+		Path = GetNextDir(Path, Buff);
 
-	Siblings = Tree->Children;
-	while	(Siblings)
-	{
-		if	(!stricmp(Siblings->Name, Buff))
-		{
-			if	(!*Path)
-				return Siblings;
-			return DirTree_FindExact(Siblings, Path);
-		}
-		Siblings = Siblings->Siblings;
+		Tree = FindChild(Tree, Buff);
+		if	(!Tree)
+			return NULL;
 	}
 
-	return NULL;
+	return (DirTree *)Tree;
 }
 
 DirTree *DirTree_FindPartial(
@@ -438,33 +657,27 @@ DirTree *DirTree_FindPartial(
 	const char *	Path,
 	const char **	LeftOvers)
 {
-	static char	Buff[PATH_MAX];
-	DirTree *	Siblings;
+	char		Buff[PATH_MAX];
+	DirTree *	Child;
 
 	assert(Tree);
 	assert(Path);
 
-	if	(*Path == '\\')
-		return NULL;
-
 	*LeftOvers = Path;
 
-	if	(*Path == '\0')
-		return (DirTree *)Tree;
+	while	(*Path)
+	{
+		if	(*Path == '\\')
+			return NULL;
 
-	Path = GetNextDir(Path, Buff);
+		Path = GetNextDir(Path, Buff);
 
-	Siblings = Tree->Children;
-	while	(Siblings)
-	{
-		if	(!stricmp(Siblings->Name, Buff))
-		{
-			*LeftOvers = Path;
-			if	(!*Path)
-				return Siblings;
-			return DirTree_FindPartial(Siblings, Path, LeftOvers);
-		}
-		Siblings = Siblings->Siblings;
+		Child = FindChild(Tree, Buff);
+		if	(!Child)
+			break;
+
+		Tree = Child;
+		*LeftOvers = Path;
 	}
 
 	return (DirTree *)Tree;
@@ -514,12 +727,21 @@ DirTree * DirTree_AddFile(DirTree *Tree, const char *Path, geBoolean IsDirectory
 		return NULL;
 	}
 
+	NewEntry->Parent   = Tree;
 	NewEntry->Siblings = Tree->Children;
 						 Tree->Children = NewEntry;
 
 	if	(IsDirectory == GE_TRUE)
 		NewEntry->AttributeFlags |= GE_VFILE_ATTRIB_DIRECTORY;
 
+	if	(Tree->Index)
+	{
+		if	(Tree->Index->Count >= Tree->Index->NumBuckets * 2)
+			IndexGrow(Tree->Index);		// Just longer chains if this fails
+
+		IndexInsert(Tree->Index, NewEntry);
+	}
+
 	return NewEntry;
 }
 
@@ -553,6 +775,11 @@ geBoolean DirTree_Remove(DirTree *Tree, DirTree *SubTree)
 			if	(SubTree == Parent->Children)
 				Parent->Children = SubTree->Siblings;
 			SubTree->Siblings = NULL;
+			if	(SubTree->Index)
+			{
+				IndexRemoveTree(SubTree->Index, SubTree);
+				ClearIndex(SubTree);
+			}
 			DirTree_Destroy(SubTree);
 			return GE_TRUE;
 		}
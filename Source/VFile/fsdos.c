@@ -884,6 +884,81 @@ static	geBoolean	GENESISCC FSDos_RenameFile(geVFile *FS, void *Handle, const cha
 	return GE_TRUE;
 }
 
+static	void	GENESISCC FSDos_Unmap(void *Base, long Size)
+{
+	UnmapViewOfFile(Base);
+}
+
+static	geBoolean	GENESISCC FSDos_Map(void *Handle, geVFile_MapView *View)
+{
+	DosFile *	File;
+	HANDLE		MapHandle;
+	void *		Base;
+	long		Size;
+
+	File = Handle;
+
+	CHECK_HANDLE(File);
+
+	if	(File->IsDirectory == GE_TRUE)
+		return GE_FALSE;
+
+	assert(File->FileHandle != INVALID_HANDLE_VALUE);
+
+	if	(FSDos_Size(File, &Size) == GE_FALSE || Size <= 0)
+		return GE_FALSE;
+
+	MapHandle = CreateFileMapping(File->FileHandle, NULL, PAGE_READONLY, 0, 0, NULL);
+	if	(!MapHandle)
+		return GE_FALSE;
+
+	Base = MapViewOfFile(MapHandle, FILE_MAP_READ, 0, 0, 0);
+
+	// The view keeps the mapping object alive, so we can let go of it right away
+	CloseHandle(MapHandle);
+
+	if	(!Base)
+		return GE_FALSE;
+
+	View->Data	= Base;
+	View->Size	= Size;
+	View->Base	= Base;
+	View->Unmap	= FSDos_Unmap;
+
+	return GE_TRUE;
+}
+
+static	geBoolean	GENESISCC FSDos_ReadAt(void *Handle, long Position, void *Buff, int Count)
+{
+	DosFile *	File;
+	OVERLAPPED	Overlapped;
+	DWORD		BytesRead;
+
+	assert(Buff);
+	assert(Count != 0);
+
+	File = Handle;
+
+	CHECK_HANDLE(File);
+
+	if	(File->IsDirectory == GE_TRUE)
+		return GE_FALSE;
+
+	assert(File->FileHandle != INVALID_HANDLE_VALUE);
+
+	// The offset in the OVERLAPPED makes this a positional read, no SetFilePointer first
+	memset(&Overlapped, 0, sizeof(Overlapped));
+	Overlapped.Offset = (DWORD)Position;
+
+	if	(ReadFile(File->FileHandle, Buff, Count, &BytesRead, &Overlapped) == FALSE)
+		return GE_FALSE;
+
+	if	(BytesRead != (DWORD)Count)
+		return GE_FALSE;
+
+	return GE_TRUE;
+}
+
 static	geVFile_SystemAPIs	FSDos_APIs =
 {
 	FSDos_FinderCreate,
@@ -914,6 +989,9 @@ static	geVFile_SystemAPIs	FSDos_APIs =
 	FSDos_SetAttributes,
 	FSDos_SetTime,
 	FSDos_SetHints,
+
+	FSDos_Map,
+	FSDos_ReadAt,
 };
 
 const geVFile_SystemAPIs *GENESISCC FSDos_GetAPIs(void)
@@ -40,6 +40,10 @@
 
 #define	HEADER_VERSION	0
 
+#define	DEFAULT_READ_AHEAD_SIZE	0x4000
+
+static	int		ReadAheadSize = DEFAULT_READ_AHEAD_SIZE;
+
 typedef	struct	VFSFileHeader
 {
 	unsigned int	Signature;
@@ -75,6 +79,12 @@ typedef	struct	VFSFile
 	long			DataLength;			// Current size of the aggregate including VFS header
 	geBoolean		Dispersed;			// Is this VFS dispersed?
 
+	// Read only files read the RWOps file through this, see ReadAtRelPos
+	char *			ReadAhead;
+	int				ReadAheadSize;		// 0 to read straight from the RWOps file
+	long			ReadAheadPos;		// Relative position of ReadAhead[0]
+	int				ReadAheadLength;	// Valid bytes in ReadAhead
+
 }	VFSFile;
 
 typedef	struct	VFSFinder
@@ -265,6 +275,10 @@ static	void *	GENESISCC FSVFS_Open(
 		{
 			assert(!(OpenModeFlags & GE_VFILE_OPEN_UPDATE));
 			DirTree_GetFileSize(FileEntry, &NewFile->Length);
+
+			// Nothing can change our bytes, so they can be read ahead.  A small file
+			// only needs a buffer its own size, and is then read in one go.
+			NewFile->ReadAheadSize = (int)min((long)ReadAheadSize, NewFile->Length);
 		}
 	}
 
@@ -454,6 +468,9 @@ static	void	GENESISCC FSVFS_Close(void *Handle)
 		DirTree_SetFileSize(File->DirEntry, File->Length);
 	}
 
+	if	(File->ReadAhead)
+		geRam_Free(File->ReadAhead);
+
 	geRam_Free(File);
 }
 
@@ -494,6 +511,65 @@ static	void		GENESISCC UpdateFilePos(VFSFile *File)
 	assert(File->CurrentRelPos >= 0);
 }
 
+//	Reads at a position relative to our start, without using the RWOps file pointer.
+//	Small reads of a read only file go through the read ahead buffer, so a run of
+//	them costs one RWOps read per buffer.
+static	geBoolean	ReadAtRelPos(VFSFile *File, long Pos, void *Buff, int Count)
+{
+	char *	Dest;
+	int		Copy;
+
+	assert(!File->Directory);
+	assert(Pos >= 0);
+	assert(Count >= 0);
+	assert(Pos + Count <= File->Length);
+
+	// Big reads gain nothing from the extra copy
+	if	(Count >= File->ReadAheadSize)
+		return geVFile_ReadAt(File->RWOps, File->RWOpsStartPos + Pos, Buff, Count);
+
+	if	(!File->ReadAhead)
+	{
+		File->ReadAhead = geRam_Allocate(File->ReadAheadSize);
+		if	(!File->ReadAhead)
+		{
+			File->ReadAheadSize = 0;
+			return geVFile_ReadAt(File->RWOps, File->RWOpsStartPos + Pos, Buff, Count);
+		}
+		File->ReadAheadLength = 0;
+	}
+
+	Dest = Buff;
+
+	while	(Count > 0)
+	{
+		if	(Pos < File->ReadAheadPos || Pos >= File->ReadAheadPos + File->ReadAheadLength)
+		{
+			int		Length;
+
+			Length = (int)min((long)File->ReadAheadSize, File->Length - Pos);
+
+			if	(geVFile_ReadAt(File->RWOps, File->RWOpsStartPos + Pos, File->ReadAhead, Length) == GE_FALSE)
+			{
+				File->ReadAheadLength = 0;
+				return GE_FALSE;
+			}
+
+			File->ReadAheadPos	  = Pos;
+			File->ReadAheadLength = Length;
+		}
+
+		Copy = (int)min((long)Count, File->ReadAheadPos + File->ReadAheadLength - Pos);
+		memcpy(Dest, File->ReadAhead + (Pos - File->ReadAheadPos), Copy);
+
+		Dest  += Copy;
+		Pos   += Copy;
+		Count -= Copy;
+	}
+
+	return GE_TRUE;
+}
+
 static	geBoolean	GENESISCC FSVFS_GetS(void *Handle, void *Buff, int MaxLen)
 {
 	VFSFile *	File;
@@ -527,10 +603,6 @@ static	geBoolean	GENESISCC FSVFS_GetS(void *Handle, void *Buff, int MaxLen)
 static	geBoolean	GENESISCC FSVFS_Read(void *Handle, void *Buff, int Count)
 {
 	VFSFile *	File;
-	geBoolean	Res;
-#ifndef	NDEBUG
-	int			CurRelPos;
-#endif
 
 	assert(Buff);
 	assert(Count != 0);
@@ -545,21 +617,36 @@ static	geBoolean	GENESISCC FSVFS_Read(void *Handle, void *Buff, int Count)
 	assert(File->CurrentRelPos >= 0);
 	assert(File->CurrentRelPos <= File->Length);
 
-	if	(!ForceFilePos(File))
+	if	(ClampOperationSize(File, Count) != Count)
 		return GE_FALSE;
 
-	if	(ClampOperationSize(File, Count) != Count)
+	// Positional, so there is no seek before or tell after
+	if	(ReadAtRelPos(File, File->CurrentRelPos, Buff, Count) == GE_FALSE)
 		return GE_FALSE;
 
-#ifndef	NDEBUG
-	CurRelPos = File->CurrentRelPos;
-#endif
-	Res = geVFile_Read(File->RWOps, Buff, Count);
+	File->CurrentRelPos += Count;
 
-	UpdateFilePos(File);
-	assert(File->CurrentRelPos - CurRelPos == Count);
+	return GE_TRUE;
+}
 
-	return Res;
+static	geBoolean	GENESISCC FSVFS_ReadAt(void *Handle, long Position, void *Buff, int Count)
+{
+	VFSFile *	File;
+
+	assert(Buff);
+	assert(Count != 0);
+
+	File = Handle;
+
+	CHECK_HANDLE(File);
+
+	if	(File->Directory)
+		return GE_FALSE;
+
+	if	(Position < 0 || Position > File->Length || File->Length - Position < Count)
+		return GE_FALSE;
+
+	return ReadAtRelPos(File, Position, Buff, Count);
 }
 
 static	geBoolean	GENESISCC FSVFS_Write(void *Handle, const void *Buff, int Count)
@@ -637,6 +724,17 @@ static	geBoolean	GENESISCC FSVFS_Seek(void *Handle, int Where, geVFile_Whence Wh
 	if	(AbsolutePos < File->RWOpsStartPos)
 		return GE_FALSE;
 
+	// A read only file can't grow, and reads don't use the RWOps file pointer,
+	// so there is nothing to tell it
+	if	(!(File->OpenModeFlags & (GE_VFILE_OPEN_CREATE | GE_VFILE_OPEN_UPDATE)))
+	{
+		if	(AbsolutePos - File->RWOpsStartPos > File->Length)
+			return GE_FALSE;
+
+		File->CurrentRelPos = AbsolutePos - File->RWOpsStartPos;
+		return GE_TRUE;
+	}
+
 	Res = geVFile_Seek(File->RWOps, AbsolutePos, GE_VFILE_SEEKSET);
 
 	UpdateFilePos(File);
@@ -807,6 +905,50 @@ assert(!"Not implemented");
 	return GE_FALSE;
 }
 
+static	void	GENESISCC FSVFS_Unmap(void *Base, long Size)
+{
+	geVFile_DestroyMapping(Base);
+}
+
+static	geBoolean	GENESISCC FSVFS_Map(void *Handle, geVFile_MapView *View)
+{
+	VFSFile *			File;
+	geVFile_Mapping *	Parent;
+	const char *		Data;
+	long				ParentSize;
+
+	File = Handle;
+
+	CHECK_HANDLE(File);
+
+	if	(File->Directory)
+		return GE_FALSE;
+
+	// Only files that can no longer change are safe to hand out
+	if	(File->OpenModeFlags & (GE_VFILE_OPEN_CREATE | GE_VFILE_OPEN_UPDATE))
+		return GE_FALSE;
+
+	// We live inside our parent, so map the parent and point into it
+	Parent = geVFile_CreateMapping(File->RWOps);
+	if	(!Parent)
+		return GE_FALSE;
+
+	Data = geVFile_MappingGetData(Parent, &ParentSize);
+
+	if	(File->RWOpsStartPos < 0 || File->RWOpsStartPos + File->Length > ParentSize)
+	{
+		geVFile_DestroyMapping(Parent);
+		return GE_FALSE;
+	}
+
+	View->Data	= Data + File->RWOpsStartPos;
+	View->Size	= File->Length;
+	View->Base	= Parent;
+	View->Unmap	= FSVFS_Unmap;
+
+	return GE_TRUE;
+}
+
 static	geVFile_SystemAPIs	FSVFS_APIs =
 {
 	FSVFS_FinderCreate,
@@ -837,8 +979,18 @@ static	geVFile_SystemAPIs	FSVFS_APIs =
 	FSVFS_SetAttributes,
 	FSVFS_SetTime,
 	FSVFS_SetHints,
+
+	FSVFS_Map,
+	FSVFS_ReadAt,
 };
 
+void GENESISCC FSVFS_SetReadAheadSize(int Size)
+{
+	assert(Size >= 0);
+
+	ReadAheadSize = Size;
+}
+
 const geVFile_SystemAPIs * GENESISCC FSVFS_GetAPIs(void)
 {
 	return &FSVFS_APIs;
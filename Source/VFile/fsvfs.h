@@ -26,5 +26,7 @@
 
 const	geVFile_SystemAPIs * GENESISCC FSVFS_GetAPIs(void);
 
+void GENESISCC FSVFS_SetReadAheadSize(int Size);
+
 #endif
 
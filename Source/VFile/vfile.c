@@ -447,6 +447,26 @@ GENESISAPI geBoolean GENESISCC geVFile_Read(geVFile *File, void *Buff, int Count
 	return File->APIs->Read(File->FSData, Buff, Count);
 }
 
+GENESISAPI geBoolean GENESISCC geVFile_ReadAt(geVFile *File, long Position, void *Buff, int Count)
+{
+	assert(File);
+	assert(Buff);
+
+	if	(Count == 0)
+		return GE_TRUE;
+
+	if	(Position < 0)
+		return GE_FALSE;
+
+	if	(File->APIs->ReadAt)
+		return File->APIs->ReadAt(File->FSData, Position, Buff, Count);
+
+	if	(File->APIs->Seek(File->FSData, Position, GE_VFILE_SEEKSET) == GE_FALSE)
+		return GE_FALSE;
+
+	return File->APIs->Read(File->FSData, Buff, Count);
+}
+
 GENESISAPI geBoolean GENESISCC geVFile_Write(geVFile *File, const void *Buff, int Count)
 {
 	assert(File);
@@ -536,6 +556,63 @@ GENESISAPI geBoolean GENESISCC geVFile_SetHints(geVFile *File, const geVFile_Hin
 	return File->APIs->SetHints(File->FSData, Hints);
 }
 
+typedef	struct	geVFile_Mapping
+{
+	geVFile_MapView	View;
+}	geVFile_Mapping;
+
+GENESISAPI geVFile_Mapping * GENESISCC geVFile_CreateMapping(geVFile *File)
+{
+	geVFile_Mapping *	Mapping;
+
+	assert(File);
+
+	if	(!File->APIs->Map)
+		return NULL;
+
+	Mapping = geRam_Allocate(sizeof(*Mapping));
+	if	(!Mapping)
+		return NULL;
+
+	memset(Mapping, 0, sizeof(*Mapping));
+
+	if	(File->APIs->Map(File->FSData, &Mapping->View) == GE_FALSE)
+	{
+		geRam_Free(Mapping);
+		return NULL;
+	}
+
+	assert(Mapping->View.Data);
+	assert(Mapping->View.Unmap);
+
+	return Mapping;
+}
+
+GENESISAPI const void * GENESISCC geVFile_MappingGetData(const geVFile_Mapping *Mapping, long *Size)
+{
+	assert(Mapping);
+
+	if	(Size)
+		*Size = Mapping->View.Size;
+
+	return Mapping->View.Data;
+}
+
+GENESISAPI void GENESISCC geVFile_DestroyMapping(geVFile_Mapping *Mapping)
+{
+	assert(Mapping);
+
+	Mapping->View.Unmap(Mapping->View.Base, Mapping->View.Size);
+	geRam_Free(Mapping);
+}
+
+GENESISAPI void GENESISCC geVFile_SetReadAheadSize(int Size)
+{
+	assert(Size >= 0);
+
+	FSVFS_SetReadAheadSize(Size);
+}
+
 GENESISAPI geVFile_Finder * GENESISCC geVFile_CreateFinder(
 	geVFile *FileSystem,
 	const char *FileSpec)
@@ -173,6 +173,9 @@ typedef	enum
 
 GENESISAPI geBoolean GENESISCC geVFile_GetS  		 (		geVFile *File, void *Buff, int MaxLen);
 GENESISAPI geBoolean GENESISCC geVFile_Read  		 (		geVFile *File, void *Buff, int Count);
+GENESISAPI geBoolean GENESISCC geVFile_ReadAt		 (		geVFile *File, long Position, void *Buff, int Count);
+	// Reads Count bytes at Position, in one call where the file system can.  Leaves
+	// the file pointer undefined, so Seek before going back to geVFile_Read.
 GENESISAPI geBoolean GENESISCC geVFile_Write 		 (		geVFile *File, const void *Buff, int Count);
 GENESISAPI geBoolean GENESISCC geVFile_Seek  		 (		geVFile *File, int where, geVFile_Whence Whence);
 GENESISAPI geBoolean GENESISCC geVFile_Printf		 (		geVFile *File, const char *Format, ...);
@@ -188,6 +191,27 @@ GENESISAPI geBoolean GENESISCC geVFile_SetAttributes(		geVFile *File, geVFile_At
 GENESISAPI geBoolean GENESISCC geVFile_SetTime		 (		geVFile *File, const geVFile_Time *Time);
 GENESISAPI geBoolean GENESISCC geVFile_SetHints	 (		geVFile *File, const geVFile_Hints *Hints);
 
+//---------- Mapping -----------
+
+typedef	struct	geVFile_Mapping	geVFile_Mapping;
+
+GENESISAPI geVFile_Mapping * GENESISCC geVFile_CreateMapping(geVFile *File);
+	// Maps the whole of a read only file into memory.  Returns NULL if the file
+	// system underneath cannot map (memory files, writable files, ...), in which
+	// case the caller should fall back to geVFile_Read.  The mapping stays valid
+	// after the file is closed, until geVFile_DestroyMapping.
+
+GENESISAPI const void * GENESISCC geVFile_MappingGetData(const geVFile_Mapping *Mapping, long *Size);
+GENESISAPI void GENESISCC geVFile_DestroyMapping(geVFile_Mapping *Mapping);
+
+//---------- Read ahead -----------
+
+GENESISAPI void GENESISCC geVFile_SetReadAheadSize(int Size);
+	// Size of the buffer each read only file inside a VFS reads its parent through.
+	// Small reads are served from it, so opening lots of small files in a packed
+	// VFS costs one parent read per buffer instead of a seek and read per call.
+	// Applies to files opened after the call.  0 turns it off.
+
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,482 @@
+/*******************************************************************************
+Copyright © 2024 Mark E. Sowden <hogsy@oldtimes-software.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************/
+
+
+#include <assert.h>
+#include <math.h>
+#include <string.h>
+
+#include "ActorGrid.h"
+#include "RAM.H"
+#include "geThread.h"
+#include "Errorlog.h"
+
+#define ACTORGRID_CELL_SIZE			(256.0f)
+#define ACTORGRID_MAX_ACTOR_CELLS	64		// Actors covering more cells than this go in BigList
+#define ACTORGRID_MAX_QUERY_CELLS	512		// Queries covering more cells than this just scan the actors
+
+#define ACTORGRID_BIG_CELL			(-0x7fffffff)	// Cell[0] of the entries in BigList
+
+//=====================================================================================
+//	Local static support functions
+//=====================================================================================
+static void ActorGrid_GetCells(const geVec3d *Mins, const geVec3d *Maxs, int32 *CellMins, int32 *CellMaxs)
+{
+	int32	i;
+
+	for (i=0; i< 3; i++)
+	{
+		CellMins[i] = (int32)floorf(VectorToSUB(*Mins, i) / ACTORGRID_CELL_SIZE);
+		CellMaxs[i] = (int32)floorf(VectorToSUB(*Maxs, i) / ACTORGRID_CELL_SIZE);
+	}
+}
+
+static int32 ActorGrid_NumCells(const int32 *CellMins, const int32 *CellMaxs)
+{
+	int32	i, NumCells;
+
+	NumCells = 1;
+
+	for (i=0; i< 3; i++)
+	{
+		int32	Size = CellMaxs[i] - CellMins[i] + 1;
+
+		// Don't let huge boxes overflow the count
+		if (Size > ACTORGRID_MAX_QUERY_CELLS)
+			return ACTORGRID_MAX_QUERY_CELLS+1;
+
+		NumCells *= Size;
+
+		if (NumCells > ACTORGRID_MAX_QUERY_CELLS)
+			return ACTORGRID_MAX_QUERY_CELLS+1;
+	}
+
+	return NumCells;
+}
+
+static int32 ActorGrid_Hash(int32 X, int32 Y, int32 Z)
+{
+	uint32	Hash;
+
+	Hash = ((uint32)X * 73856093u) ^ ((uint32)Y * 19349663u) ^ ((uint32)Z * 83492791u);
+
+	return (int32)(Hash & (ACTORGRID_HASH_SIZE-1));
+}
+
+static int32 *ActorGrid_BucketHead(World_ActorGrid *Grid, const World_ActorGridEntry *Entry)
+{
+	if (Entry->Cell[0] == ACTORGRID_BIG_CELL)
+		return &Grid->BigList;
+
+	return &Grid->Buckets[ActorGrid_Hash(Entry->Cell[0], Entry->Cell[1], Entry->Cell[2])];
+}
+
+static geBoolean ActorGrid_BoxesTouch(const geExtBox *Box, const geVec3d *Mins, const geVec3d *Maxs)
+{
+	if (Maxs->X < Box->Min.X || Mins->X > Box->Max.X)
+		return GE_FALSE;
+	if (Maxs->Y < Box->Min.Y || Mins->Y > Box->Max.Y)
+		return GE_FALSE;
+	if (Maxs->Z < Box->Min.Z || Mins->Z > Box->Max.Z)
+		return GE_FALSE;
+
+	return GE_TRUE;
+}
+
+//=====================================================================================
+//	ActorGrid_AllocEntry
+//=====================================================================================
+static int32 ActorGrid_AllocEntry(World_ActorGrid *Grid)
+{
+	int32	Entry;
+
+	if (Grid->FreeEntry != -1)
+	{
+		Entry = Grid->FreeEntry;
+		Grid->FreeEntry = Grid->Entries[Entry].Next;
+		return Entry;
+	}
+
+	if (Grid->NumEntries >= Grid->MaxEntries)
+	{
+		World_ActorGridEntry	*NewEntries;
+		int32					NewMax;
+
+		NewMax = Grid->MaxEntries ? Grid->MaxEntries*2 : 64;
+
+		NewEntries = GE_RAM_REALLOC_ARRAY(Grid->Entries, World_ActorGridEntry, NewMax);
+
+		if (!NewEntries)
+		{
+			geErrorLog_Add(GE_ERR_OUT_OF_MEMORY, NULL);
+			return -1;
+		}
+
+		Grid->Entries = NewEntries;
+		Grid->MaxEntries = NewMax;
+	}
+
+	return Grid->NumEntries++;
+}
+
+//=====================================================================================
+//	ActorGrid_Unlink
+//	Takes all the entries of an actor out of the grid
+//=====================================================================================
+static void ActorGrid_Unlink(geWorld *World, int32 Index)
+{
+	World_ActorGrid	*Grid;
+	World_Actor		*WActor;
+	int32			Entry, NextOfActor;
+
+	Grid = &World->ActorGrid;
+	WActor = &World->ActorArray[Index];
+
+	for (Entry = WActor->FirstEntry; Entry != -1; Entry = NextOfActor)
+	{
+		int32	*Link;
+
+		NextOfActor = Grid->Entries[Entry].NextOfActor;
+
+		// Buckets are short, just look for the link that points at this entry
+		for (Link = ActorGrid_BucketHead(Grid, &Grid->Entries[Entry]); *Link != Entry; Link = &Grid->Entries[*Link].Next)
+			assert(*Link != -1);
+
+		*Link = Grid->Entries[Entry].Next;
+
+		Grid->Entries[Entry].Next = Grid->FreeEntry;
+		Grid->FreeEntry = Entry;
+	}
+
+	WActor->FirstEntry = -1;
+}
+
+//=====================================================================================
+//	ActorGrid_LinkEntry
+//=====================================================================================
+static geBoolean ActorGrid_LinkEntry(geWorld *World, int32 Index, int32 X, int32 Y, int32 Z)
+{
+	World_ActorGrid			*Grid;
+	World_ActorGridEntry	*Entry;
+	int32					EntryNum, *Head;
+
+	Grid = &World->ActorGrid;
+
+	EntryNum = ActorGrid_AllocEntry(Grid);
+
+	if (EntryNum == -1)
+		return GE_FALSE;
+
+	Entry = &Grid->Entries[EntryNum];
+
+	Entry->Actor = Index;
+	Entry->Cell[0] = X;
+	Entry->Cell[1] = Y;
+	Entry->Cell[2] = Z;
+
+	Head = ActorGrid_BucketHead(Grid, Entry);
+
+	Entry->Next = *Head;
+	*Head = EntryNum;
+
+	Entry->NextOfActor = World->ActorArray[Index].FirstEntry;
+	World->ActorArray[Index].FirstEntry = EntryNum;
+
+	return GE_TRUE;
+}
+
+//=====================================================================================
+//	ActorGrid_Link
+//	Puts an actor in all the cells its box covers
+//=====================================================================================
+static geBoolean ActorGrid_Link(geWorld *World, int32 Index)
+{
+	World_Actor		*WActor;
+	int32			x, y, z;
+
+	WActor = &World->ActorArray[Index];
+
+	assert(WActor->BoxValid);
+	assert(WActor->FirstEntry == -1);
+
+	if (ActorGrid_NumCells(WActor->CellMins, WActor->CellMaxs) > ACTORGRID_MAX_ACTOR_CELLS)
+		return ActorGrid_LinkEntry(World, Index, ACTORGRID_BIG_CELL, 0, 0);
+
+	for (z = WActor->CellMins[2]; z <= WActor->CellMaxs[2]; z++)
+	{
+		for (y = WActor->CellMins[1]; y <= WActor->CellMaxs[1]; y++)
+		{
+			for (x = WActor->CellMins[0]; x <= WActor->CellMaxs[0]; x++)
+			{
+				if (!ActorGrid_LinkEntry(World, Index, x, y, z))
+					return GE_FALSE;
+			}
+		}
+	}
+
+	return GE_TRUE;
+}
+
+//=====================================================================================
+//	ActorGrid_Init
+//=====================================================================================
+void ActorGrid_Init(geWorld *World)
+{
+	World_ActorGrid	*Grid;
+	int32			i;
+
+	assert(World);
+
+	Grid = &World->ActorGrid;
+
+	memset(Grid, 0, sizeof(*Grid));
+
+	for (i=0; i< ACTORGRID_HASH_SIZE; i++)
+		Grid->Buckets[i] = -1;
+
+	Grid->BigList = -1;
+	Grid->FreeEntry = -1;
+}
+
+//=====================================================================================
+//	ActorGrid_Shutdown
+//=====================================================================================
+void ActorGrid_Shutdown(geWorld *World)
+{
+	assert(World);
+
+	if (World->ActorGrid.Entries)
+		geRam_Free(World->ActorGrid.Entries);
+
+	ActorGrid_Init(World);
+}
+
+//=====================================================================================
+//	ActorGrid_AddActor
+//	The actor gets put in the grid on the next refresh
+//=====================================================================================
+void ActorGrid_AddActor(geWorld *World, int32 Index)
+{
+	World_Actor		*WActor;
+
+	assert(World);
+	assert(Index >= 0 && Index < World->ActorCount);
+
+	WActor = &World->ActorArray[Index];
+
+	WActor->BoxValid = GE_FALSE;
+	WActor->FirstEntry = -1;
+
+	geAtomic_Set(&World->ActorGrid.Dirty, 1);
+}
+
+//=====================================================================================
+//	ActorGrid_RemoveActor
+//=====================================================================================
+void ActorGrid_RemoveActor(geWorld *World, int32 Index)
+{
+	assert(World);
+	assert(Index >= 0 && Index < World->ActorCount);
+
+	ActorGrid_Unlink(World, Index);
+	World->ActorArray[Index].BoxValid = GE_FALSE;
+}
+
+//=====================================================================================
+//	ActorGrid_MoveActor
+//	ActorArray[From] was copied to ActorArray[To], fix up the entries that point at it
+//=====================================================================================
+void ActorGrid_MoveActor(geWorld *World, int32 From, int32 To)
+{
+	int32	Entry;
+
+	assert(World);
+
+	for (Entry = World->ActorArray[To].FirstEntry; Entry != -1; Entry = World->ActorGrid.Entries[Entry].NextOfActor)
+	{
+		assert(World->ActorGrid.Entries[Entry].Actor == From);
+		World->ActorGrid.Entries[Entry].Actor = To;
+	}
+}
+
+//=====================================================================================
+//	ActorGrid_Refresh
+//	Re-reads the actor boxes if any actor changed since the last time.  Several
+//	threads can query at once, the first one in does the refresh for all of them.
+//=====================================================================================
+static geBoolean ActorGrid_UpToDate(World_ActorGrid *Grid, int32 Generation)
+{
+	return !geAtomic_Get(&Grid->Dirty) && geAtomic_Get(&Grid->Generation) == Generation;
+}
+
+void ActorGrid_Refresh(geWorld *World)
+{
+	World_ActorGrid	*Grid;
+	int32			Generation;
+	int32			i;
+	geBoolean		OutOfMemory;
+
+	assert(World);
+
+	Grid = &World->ActorGrid;
+	Generation = (int32)geActor_GetChangeGeneration();
+
+	if (ActorGrid_UpToDate(Grid, Generation))
+		return;
+
+	geSpinLock_Lock(&Grid->Lock);
+
+	if (ActorGrid_UpToDate(Grid, Generation))
+	{
+		geSpinLock_Unlock(&Grid->Lock);
+		return;
+	}
+
+	OutOfMemory = GE_FALSE;
+
+	for (i=0; i< World->ActorCount; i++)
+	{
+		World_Actor		*WActor;
+		geExtBox		Box;
+		int32			CellMins[3], CellMaxs[3];
+
+		WActor = &World->ActorArray[i];
+
+		// Same box geActor_GetExtBox gives, but only pose the actor once
+		geActor_GetPosition(WActor->Actor, &WActor->Pos);
+		geActor_GetNonWorldExtBox(WActor->Actor, &WActor->LocalBox);
+
+		geVec3d_Add(&WActor->Pos, &WActor->LocalBox.Min, &Box.Min);
+		geVec3d_Add(&WActor->Pos, &WActor->LocalBox.Max, &Box.Max);
+
+		ActorGrid_GetCells(&Box.Min, &Box.Max, CellMins, CellMaxs);
+
+		WActor->Box = Box;
+
+		// Most of the time the actor stays in the same cells
+		if (WActor->BoxValid && WActor->FirstEntry != -1 &&
+			CellMins[0] == WActor->CellMins[0] && CellMins[1] == WActor->CellMins[1] && CellMins[2] == WActor->CellMins[2] &&
+			CellMaxs[0] == WActor->CellMaxs[0] && CellMaxs[1] == WActor->CellMaxs[1] && CellMaxs[2] == WActor->CellMaxs[2])
+			continue;
+
+		ActorGrid_Unlink(World, i);
+
+		WActor->BoxValid = GE_TRUE;
+		memcpy(WActor->CellMins, CellMins, sizeof(CellMins));
+		memcpy(WActor->CellMaxs, CellMaxs, sizeof(CellMaxs));
+
+		if (!ActorGrid_Link(World, i))
+		{
+			// Don't leave it in half its cells, it gets linked again on the next refresh
+			ActorGrid_Unlink(World, i);
+			OutOfMemory = GE_TRUE;
+		}
+	}
+
+	// Every actor that failed before was retried above, so this is the whole story
+	Grid->OutOfMemory = OutOfMemory;
+
+	geAtomic_Set(&Grid->Dirty, 0);
+	geAtomic_Set(&Grid->Generation, Generation);
+
+	geSpinLock_Unlock(&Grid->Lock);
+}
+
+//=====================================================================================
+//	ActorGrid_Query
+//=====================================================================================
+void ActorGrid_Query(geWorld *World, const geVec3d *Mins, const geVec3d *Maxs, ActorGrid_CB *CB, void *Context)
+{
+	World_ActorGrid			*Grid;
+	World_ActorGridEntry	*Entry;
+	World_Actor				*WActor;
+	int32					CellMins[3], CellMaxs[3];
+	int32					x, y, z, i, EntryNum;
+
+	assert(World);
+	assert(Mins && Maxs);
+	assert(CB);
+
+	ActorGrid_Refresh(World);
+
+	Grid = &World->ActorGrid;
+
+	ActorGrid_GetCells(Mins, Maxs, CellMins, CellMaxs);
+
+	if (Grid->OutOfMemory || ActorGrid_NumCells(CellMins, CellMaxs) > ACTORGRID_MAX_QUERY_CELLS)
+	{
+		// Big query, just go through them all (still saves getting every box from the actor)
+		for (i=0, WActor = World->ActorArray; i< World->ActorCount; i++, WActor++)
+		{
+			if (!WActor->BoxValid || !ActorGrid_BoxesTouch(&WActor->Box, Mins, Maxs))
+				continue;
+
+			if (!CB(WActor, Context))
+				return;
+		}
+		return;
+	}
+
+	for (z = CellMins[2]; z <= CellMaxs[2]; z++)
+	{
+		for (y = CellMins[1]; y <= CellMaxs[1]; y++)
+		{
+			for (x = CellMins[0]; x <= CellMaxs[0]; x++)
+			{
+				for (EntryNum = Grid->Buckets[ActorGrid_Hash(x, y, z)]; EntryNum != -1; EntryNum = Entry->Next)
+				{
+					Entry = &Grid->Entries[EntryNum];
+
+					if (Entry->Cell[0] != x || Entry->Cell[1] != y || Entry->Cell[2] != z)
+						continue;		// Other cell with the same hash
+
+					WActor = &World->ActorArray[Entry->Actor];
+
+					// An actor is in every cell it covers, only report it from the first cell
+					// that is also in the query, so it is only reported once
+					if (x != max(WActor->CellMins[0], CellMins[0]) ||
+						y != max(WActor->CellMins[1], CellMins[1]) ||
+						z != max(WActor->CellMins[2], CellMins[2]))
+						continue;
+
+					if (!ActorGrid_BoxesTouch(&WActor->Box, Mins, Maxs))
+						continue;
+
+					if (!CB(WActor, Context))
+						return;
+				}
+			}
+		}
+	}
+
+	for (EntryNum = Grid->BigList; EntryNum != -1; EntryNum = Entry->Next)
+	{
+		Entry = &Grid->Entries[EntryNum];
+		WActor = &World->ActorArray[Entry->Actor];
+
+		if (!ActorGrid_BoxesTouch(&WActor->Box, Mins, Maxs))
+			continue;
+
+		if (!CB(WActor, Context))
+			return;
+	}
+}
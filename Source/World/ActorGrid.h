@@ -0,0 +1,68 @@
+/*******************************************************************************
+Copyright © 2024 Mark E. Sowden <hogsy@oldtimes-software.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************/
+
+
+#ifndef GE_ACTORGRID_H
+#define GE_ACTORGRID_H
+
+#include "WORLD.H"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//=====================================================================================
+//	Collision broadphase for the actors in a world
+//
+//	Actor boxes are cached in World_Actor and hashed into a sparse grid.  The cache is
+//	refreshed on the first query after any actor was reposed (geActor_GetChangeGeneration),
+//	and only actors that moved to other cells are rehashed.
+//
+//	Getting an actor's position poses its joints, so only the refresh (under the grid
+//	lock) asks the actors.  Queries and traces only read the cached Box/LocalBox/Pos.
+//
+//	Queries can come from several threads at once, as long as no actor is changed
+//	or added/removed while they run.
+//=====================================================================================
+
+// Return GE_FALSE to stop the query
+typedef geBoolean ActorGrid_CB(World_Actor *WActor, void *Context);
+
+void		ActorGrid_Init(geWorld *World);
+void		ActorGrid_Shutdown(geWorld *World);
+
+// Called by geWorld_AddActor/geWorld_RemoveActor
+void		ActorGrid_AddActor(geWorld *World, int32 Index);
+void		ActorGrid_RemoveActor(geWorld *World, int32 Index);
+void		ActorGrid_MoveActor(geWorld *World, int32 From, int32 To);
+
+void		ActorGrid_Refresh(geWorld *World);
+
+// Calls CB for every actor whose box touches Mins/Maxs (world space), in no particular order.
+// Does not look at the actor flags.
+void		ActorGrid_Query(geWorld *World, const geVec3d *Mins, const geVec3d *Maxs, ActorGrid_CB *CB, void *Context);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
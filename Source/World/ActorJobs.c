@@ -0,0 +1,225 @@
+/*******************************************************************************
+Copyright © 2024 Mark E. Sowden <hogsy@oldtimes-software.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************/
+
+
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ActorJobs.h"
+#include "RAM.H"
+#include "geThread.h"
+#include "Errorlog.h"
+
+#define ACTORJOBS_MIN_PARALLEL		8		// Fewer visible actors than this aren't worth the threads
+
+//=====================================================================================
+//	Local static support functions
+//=====================================================================================
+static World_ActorJob	*SortJobs;			// For qsort, ActorJobs_Prepare is only called from the render thread
+
+static int ActorJobs_Compare(const void *a, const void *b)
+{
+	const World_ActorJob	*Job1 = &SortJobs[*(const int32*)a];
+	const World_ActorJob	*Job2 = &SortJobs[*(const int32*)b];
+
+	if (Job1->Root != Job2->Root)
+		return ((uintptr_t)Job1->Root < (uintptr_t)Job2->Root) ? -1 : 1;
+
+	if (Job1->Depth != Job2->Depth)
+		return (Job1->Depth < Job2->Depth) ? -1 : 1;
+
+	// Keep it stable
+	return (*(const int32*)a < *(const int32*)b) ? -1 : 1;
+}
+
+//=====================================================================================
+//	ActorJobs_Work
+//	Prepares one attachment chain, parents first
+//=====================================================================================
+static geBoolean ActorJobs_Work(int32 ThreadNum, int32 WorkNum, void *Context)
+{
+	World_ActorJobs	*ActorJobs = (World_ActorJobs*)Context;
+	int32			i, Start, End;
+
+	Start = ActorJobs->Groups[WorkNum];
+	End = (WorkNum+1 < ActorJobs->NumGroups) ? ActorJobs->Groups[WorkNum+1] : ActorJobs->NumOrder;
+
+	for (i=Start; i< End; i++)
+	{
+		World_ActorJob	*Job = &ActorJobs->Jobs[ActorJobs->Order[i]];
+
+		// If this fails, geActor_Render just does the work (and logs the error) itself
+		geActor_PrepareRender(Job->WActor->Actor, ActorJobs->Camera);
+	}
+
+	return GE_TRUE;
+}
+
+//=====================================================================================
+//	ActorJobs_Init
+//=====================================================================================
+void ActorJobs_Init(geWorld *World)
+{
+	assert(World);
+
+	memset(&World->ActorJobs, 0, sizeof(World->ActorJobs));
+}
+
+//=====================================================================================
+//	ActorJobs_Shutdown
+//=====================================================================================
+void ActorJobs_Shutdown(geWorld *World)
+{
+	World_ActorJobs	*ActorJobs;
+
+	assert(World);
+
+	ActorJobs = &World->ActorJobs;
+
+	if (ActorJobs->Jobs)
+		geRam_Free(ActorJobs->Jobs);
+	if (ActorJobs->Order)
+		geRam_Free(ActorJobs->Order);
+	if (ActorJobs->Groups)
+		geRam_Free(ActorJobs->Groups);
+
+	ActorJobs_Init(World);
+}
+
+//=====================================================================================
+//	ActorJobs_Begin
+//=====================================================================================
+geBoolean ActorJobs_Begin(geWorld *World)
+{
+	World_ActorJobs	*ActorJobs;
+
+	assert(World);
+
+	ActorJobs = &World->ActorJobs;
+
+	ActorJobs->NumJobs = 0;
+	ActorJobs->NumOrder = 0;
+	ActorJobs->NumGroups = 0;
+
+	if (World->ActorCount > ActorJobs->MaxJobs)
+	{
+		int32	MaxJobs = World->ActorCount + 16;
+
+		ActorJobs_Shutdown(World);
+
+		ActorJobs->Jobs = GE_RAM_ALLOCATE_ARRAY(World_ActorJob, MaxJobs);
+		ActorJobs->Order = GE_RAM_ALLOCATE_ARRAY(int32, MaxJobs);
+		ActorJobs->Groups = GE_RAM_ALLOCATE_ARRAY(int32, MaxJobs);
+
+		if (!ActorJobs->Jobs || !ActorJobs->Order || !ActorJobs->Groups)
+		{
+			ActorJobs_Shutdown(World);
+			geErrorLog_Add(GE_ERR_OUT_OF_MEMORY, NULL);
+			return GE_FALSE;
+		}
+
+		ActorJobs->MaxJobs = MaxJobs;
+	}
+
+	return GE_TRUE;
+}
+
+//=====================================================================================
+//	ActorJobs_Add
+//=====================================================================================
+void ActorJobs_Add(geWorld *World, World_Actor *WActor)
+{
+	World_ActorJobs	*ActorJobs;
+	World_ActorJob	*Job;
+
+	assert(World);
+	assert(WActor);
+
+	ActorJobs = &World->ActorJobs;
+
+	assert(ActorJobs->NumJobs < ActorJobs->MaxJobs);
+
+	Job = &ActorJobs->Jobs[ActorJobs->NumJobs++];
+
+	Job->WActor = WActor;
+	Job->Root = NULL;
+	Job->Depth = 0;
+}
+
+//=====================================================================================
+//	ActorJobs_Prepare
+//=====================================================================================
+void ActorJobs_Prepare(geWorld *World, const geCamera *Camera)
+{
+	World_ActorJobs	*ActorJobs;
+	int32			i, NumOrder;
+
+	assert(World);
+	assert(Camera);
+
+	ActorJobs = &World->ActorJobs;
+
+	if (ActorJobs->NumJobs < ACTORJOBS_MIN_PARALLEL)
+		return;
+
+	if (geThread_ResolveCount(0) <= 1)
+		return;
+
+	// Anything that allocates has to happen out here
+	NumOrder = 0;
+
+	for (i=0; i< ActorJobs->NumJobs; i++)
+	{
+		World_ActorJob	*Job = &ActorJobs->Jobs[i];
+		int				Depth;
+
+		if (!geActor_ReserveRender(Job->WActor->Actor))
+			continue;
+
+		Job->Root = geActor_GetAttachRoot(Job->WActor->Actor, &Depth);
+		Job->Depth = Depth;
+
+		ActorJobs->Order[NumOrder++] = i;
+	}
+
+	// Sort by attachment root, so each chain is in one run, parents first
+	SortJobs = ActorJobs->Jobs;
+	qsort(ActorJobs->Order, NumOrder, sizeof(int32), ActorJobs_Compare);
+	SortJobs = NULL;
+
+	ActorJobs->NumGroups = 0;
+
+	for (i=0; i< NumOrder; i++)
+	{
+		if (i == 0 || ActorJobs->Jobs[ActorJobs->Order[i]].Root != ActorJobs->Jobs[ActorJobs->Order[i-1]].Root)
+			ActorJobs->Groups[ActorJobs->NumGroups++] = i;
+	}
+
+	ActorJobs->NumOrder = NumOrder;
+	ActorJobs->Camera = Camera;
+
+	geThread_RunOnIndividual(ActorJobs->NumGroups, geThread_ResolveCount(0), ActorJobs_Work, ActorJobs);
+
+	ActorJobs->Camera = NULL;
+}
@@ -0,0 +1,58 @@
+/*******************************************************************************
+Copyright © 2024 Mark E. Sowden <hogsy@oldtimes-software.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************/
+
+
+
+#ifndef GE_ACTORJOBS_H
+#define GE_ACTORJOBS_H
+
+#include "WORLD.H"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//=====================================================================================
+//	Parallel skinning of the actors visible in a frame
+//
+//	The world render adds its visible actors, then ActorJobs_Prepare poses and skins
+//	them on worker threads before any of them are drawn.  Drawing stays on the calling
+//	thread, in the order the actors were added, and picks up the prepared skins.
+//
+//	Actors attached to each other (gePose_Attach) share pose state, so every attachment
+//	chain is one job, updated from the top of the chain down.
+//=====================================================================================
+
+void		ActorJobs_Init(geWorld *World);
+void		ActorJobs_Shutdown(geWorld *World);
+
+// Starts a new list, room is made for every actor in the world
+geBoolean	ActorJobs_Begin(geWorld *World);
+void		ActorJobs_Add(geWorld *World, World_Actor *WActor);
+
+void		ActorJobs_Prepare(geWorld *World, const geCamera *Camera);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,351 @@
+/*******************************************************************************
+Copyright © 2024 Mark E. Sowden <hogsy@oldtimes-software.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************/
+
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "DrvBatch.h"
+#include "RAM.H"
+#include "Errorlog.h"
+
+// Any of these and the poly has to be drawn in the order it was sent
+#define DRVBATCH_ORDERED_FLAGS	(DRV_RENDER_ALPHA | DRV_RENDER_FLUSH | DRV_RENDER_NO_ZMASK | DRV_RENDER_NO_ZWRITE)
+
+#define DRVBATCH_MIN_CMDS		256
+#define DRVBATCH_MIN_VERTS		1024
+
+typedef struct
+{
+	DRV_RenderCmd	Cmd;
+	int32			Segment;				// Run of polys that are all sortable, or all ordered
+	geBoolean		Ordered;
+	int32			Seq;					// Submission order
+} DrvBatch_Entry;
+
+typedef struct
+{
+	DRV_Driver		*Driver;				// Only set while recording for a driver with RenderBatch
+
+	DrvBatch_Entry	*Entries;
+	DRV_RenderCmd	*Cmds;					// Sorted copy of Entries, handed to the driver
+	int32			NumEntries;
+	int32			MaxEntries;
+
+	DRV_TLVertex	*Verts;
+	int32			NumVerts;
+	int32			MaxVerts;
+
+	int32			Segment;
+	geBoolean		SegmentOrdered;
+
+	int32			StatCmds;
+	int32			StatRuns;
+} DrvBatch_StaticsType;
+
+static DrvBatch_StaticsType	DrvBatch_Statics;
+
+//=====================================================================================
+//	Local static support functions
+//=====================================================================================
+static geRDriver_THandle *DrvBatch_LMapTHandle(const DRV_RenderCmd *Cmd)
+{
+	return Cmd->LInfo ? Cmd->LInfo->THandle : NULL;
+}
+
+static int DrvBatch_Compare(const void *a, const void *b)
+{
+	const DrvBatch_Entry	*Entry1 = (const DrvBatch_Entry*)a;
+	const DrvBatch_Entry	*Entry2 = (const DrvBatch_Entry*)b;
+
+	if (Entry1->Segment != Entry2->Segment)
+		return (Entry1->Segment < Entry2->Segment) ? -1 : 1;
+
+	if (!Entry1->Ordered)
+	{
+		const DRV_RenderCmd		*Cmd1 = &Entry1->Cmd;
+		const DRV_RenderCmd		*Cmd2 = &Entry2->Cmd;
+
+		if (Cmd1->Type != Cmd2->Type)
+			return (Cmd1->Type < Cmd2->Type) ? -1 : 1;
+
+		if (Cmd1->Flags != Cmd2->Flags)
+			return (Cmd1->Flags < Cmd2->Flags) ? -1 : 1;
+
+		if (Cmd1->THandle != Cmd2->THandle)
+			return ((uintptr_t)Cmd1->THandle < (uintptr_t)Cmd2->THandle) ? -1 : 1;
+
+		if (DrvBatch_LMapTHandle(Cmd1) != DrvBatch_LMapTHandle(Cmd2))
+			return ((uintptr_t)DrvBatch_LMapTHandle(Cmd1) < (uintptr_t)DrvBatch_LMapTHandle(Cmd2)) ? -1 : 1;
+	}
+
+	// Keep it stable
+	return (Entry1->Seq < Entry2->Seq) ? -1 : 1;
+}
+
+//=====================================================================================
+//	DrvBatch_Grow
+//=====================================================================================
+static geBoolean DrvBatch_Grow(int32 NumPoints)
+{
+	DrvBatch_StaticsType	*S = &DrvBatch_Statics;
+
+	if (S->NumEntries >= S->MaxEntries)
+	{
+		DrvBatch_Entry	*Entries;
+		DRV_RenderCmd	*Cmds;
+		int32			Max;
+
+		Max = S->MaxEntries ? S->MaxEntries*2 : DRVBATCH_MIN_CMDS;
+
+		Entries = GE_RAM_REALLOC_ARRAY(S->Entries, DrvBatch_Entry, Max);
+		if (!Entries)
+			return GE_FALSE;
+		S->Entries = Entries;
+
+		Cmds = GE_RAM_REALLOC_ARRAY(S->Cmds, DRV_RenderCmd, Max);
+		if (!Cmds)
+			return GE_FALSE;
+		S->Cmds = Cmds;
+
+		S->MaxEntries = Max;
+	}
+
+	if (S->NumVerts + NumPoints > S->MaxVerts)
+	{
+		DRV_TLVertex	*Verts;
+		int32			Max;
+
+		Max = S->MaxVerts ? S->MaxVerts*2 : DRVBATCH_MIN_VERTS;
+
+		while (S->NumVerts + NumPoints > Max)
+			Max *= 2;
+
+		Verts = GE_RAM_REALLOC_ARRAY(S->Verts, DRV_TLVertex, Max);
+		if (!Verts)
+			return GE_FALSE;
+		S->Verts = Verts;
+
+		S->MaxVerts = Max;
+	}
+
+	return GE_TRUE;
+}
+
+//=====================================================================================
+//	DrvBatch_Add
+//	Returns NULL when the poly should go straight to the driver
+//=====================================================================================
+static DRV_RenderCmd *DrvBatch_Add(DRV_Driver *Driver, const DRV_TLVertex *Pnts, int32 NumPoints, uint32 Type, uint32 Flags)
+{
+	DrvBatch_StaticsType	*S = &DrvBatch_Statics;
+	DrvBatch_Entry			*Entry;
+	geBoolean				Ordered;
+
+	if (!S->Driver || Driver != S->Driver)
+		return NULL;
+
+	if (!DrvBatch_Grow(NumPoints))
+	{
+		// Draw what we have, so this one still lands after it
+		DrvBatch_Flush();
+		return NULL;
+	}
+
+	Ordered = (Flags & DRVBATCH_ORDERED_FLAGS) ? GE_TRUE : GE_FALSE;
+
+	if (S->NumEntries == 0)
+	{
+		S->Segment = 0;
+		S->SegmentOrdered = Ordered;
+	}
+	else if (Ordered != S->SegmentOrdered)
+	{
+		S->Segment++;
+		S->SegmentOrdered = Ordered;
+	}
+
+	Entry = &S->Entries[S->NumEntries];
+
+	Entry->Segment = S->Segment;
+	Entry->Ordered = Ordered;
+	Entry->Seq = S->NumEntries;
+
+	memset(&Entry->Cmd, 0, sizeof(Entry->Cmd));
+	Entry->Cmd.Type = Type;
+	Entry->Cmd.Flags = Flags;
+	Entry->Cmd.FirstVert = S->NumVerts;
+	Entry->Cmd.NumPoints = NumPoints;
+
+	memcpy(&S->Verts[S->NumVerts], Pnts, sizeof(DRV_TLVertex)*NumPoints);
+
+	S->NumVerts += NumPoints;
+	S->NumEntries++;
+
+	return &Entry->Cmd;
+}
+
+//=====================================================================================
+//	DrvBatch_Begin
+//=====================================================================================
+void DrvBatch_Begin(DRV_Driver *Driver)
+{
+	DrvBatch_StaticsType	*S = &DrvBatch_Statics;
+
+	assert(Driver);
+	assert(S->NumEntries == 0);
+
+	S->Driver = Driver->RenderBatch ? Driver : NULL;
+	S->NumEntries = 0;
+	S->NumVerts = 0;
+}
+
+//=====================================================================================
+//	DrvBatch_Flush
+//	Sorts what was recorded, and sends it to the driver
+//=====================================================================================
+geBoolean DrvBatch_Flush(void)
+{
+	DrvBatch_StaticsType	*S = &DrvBatch_Statics;
+	const DRV_RenderCmd		*Prev;
+	geBoolean				Ret;
+	int32					i;
+
+	if (!S->Driver || S->NumEntries == 0)
+		return GE_TRUE;
+
+	qsort(S->Entries, S->NumEntries, sizeof(DrvBatch_Entry), DrvBatch_Compare);
+
+	Prev = NULL;
+
+	for (i=0; i< S->NumEntries; i++)
+	{
+		S->Cmds[i] = S->Entries[i].Cmd;
+
+		if (!Prev || Prev->Type != S->Cmds[i].Type || Prev->Flags != S->Cmds[i].Flags || Prev->THandle != S->Cmds[i].THandle)
+			S->StatRuns++;
+
+		Prev = &S->Cmds[i];
+	}
+
+	S->StatCmds += S->NumEntries;
+
+	Ret = S->Driver->RenderBatch(S->Cmds, S->NumEntries, S->Verts);
+
+	S->NumEntries = 0;
+	S->NumVerts = 0;
+
+	return Ret;
+}
+
+//=====================================================================================
+//	DrvBatch_End
+//=====================================================================================
+geBoolean DrvBatch_End(void)
+{
+	geBoolean	Ret;
+
+	Ret = DrvBatch_Flush();
+
+	DrvBatch_Statics.Driver = NULL;
+
+	return Ret;
+}
+
+//=====================================================================================
+//	DrvBatch_Shutdown
+//=====================================================================================
+void DrvBatch_Shutdown(void)
+{
+	DrvBatch_StaticsType	*S = &DrvBatch_Statics;
+
+	if (S->Entries)
+		geRam_Free(S->Entries);
+	if (S->Cmds)
+		geRam_Free(S->Cmds);
+	if (S->Verts)
+		geRam_Free(S->Verts);
+
+	memset(S, 0, sizeof(*S));
+}
+
+//=====================================================================================
+//	DrvBatch_GouraudPoly
+//=====================================================================================
+void DrvBatch_GouraudPoly(DRV_Driver *Driver, DRV_TLVertex *Pnts, int32 NumPoints, uint32 Flags)
+{
+	if (!DrvBatch_Add(Driver, Pnts, NumPoints, DRV_CMD_GOURAUD_POLY, Flags))
+		Driver->RenderGouraudPoly(Pnts, NumPoints, Flags);
+}
+
+//=====================================================================================
+//	DrvBatch_WorldPoly
+//=====================================================================================
+void DrvBatch_WorldPoly(DRV_Driver *Driver, DRV_TLVertex *Pnts, int32 NumPoints, geRDriver_THandle *THandle, DRV_TexInfo *TexInfo, DRV_LInfo *LInfo, uint32 Flags)
+{
+	DRV_RenderCmd	*Cmd;
+
+	Cmd = DrvBatch_Add(Driver, Pnts, NumPoints, DRV_CMD_WORLD_POLY, Flags);
+
+	if (!Cmd)
+	{
+		Driver->RenderWorldPoly(Pnts, NumPoints, THandle, TexInfo, LInfo, Flags);
+		return;
+	}
+
+	Cmd->THandle = THandle;
+	Cmd->TexInfo = *TexInfo;
+	Cmd->LInfo = LInfo;
+}
+
+//=====================================================================================
+//	DrvBatch_MiscTexturePoly
+//=====================================================================================
+void DrvBatch_MiscTexturePoly(DRV_Driver *Driver, DRV_TLVertex *Pnts, int32 NumPoints, geRDriver_THandle *THandle, uint32 Flags)
+{
+	DRV_RenderCmd	*Cmd;
+
+	Cmd = DrvBatch_Add(Driver, Pnts, NumPoints, DRV_CMD_MISC_TEXTURE_POLY, Flags);
+
+	if (!Cmd)
+	{
+		Driver->RenderMiscTexturePoly(Pnts, NumPoints, THandle, Flags);
+		return;
+	}
+
+	Cmd->THandle = THandle;
+}
+
+//=====================================================================================
+//	DrvBatch_GetStats
+//=====================================================================================
+void DrvBatch_GetStats(int32 *NumCmds, int32 *NumRuns)
+{
+	if (NumCmds)
+		*NumCmds = DrvBatch_Statics.StatCmds;
+	if (NumRuns)
+		*NumRuns = DrvBatch_Statics.StatRuns;
+
+	DrvBatch_Statics.StatCmds = 0;
+	DrvBatch_Statics.StatRuns = 0;
+}
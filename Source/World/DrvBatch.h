@@ -0,0 +1,65 @@
+/*******************************************************************************
+Copyright © 2024 Mark E. Sowden <hogsy@oldtimes-software.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************/
+
+
+#ifndef GE_DRVBATCH_H
+#define GE_DRVBATCH_H
+
+#include "Dcommon.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//=====================================================================================
+//	Frame command buffer between the world render and the driver
+//
+//	While a world is being rendered, polys sent through DrvBatch are recorded instead
+//	of going straight to the driver.  DrvBatch_Flush sorts them by command type, flags,
+//	THandle and lightmap, and hands them to the driver's RenderBatch in one call, so the
+//	driver only changes state once per run.
+//
+//	Polys that depend on draw order (alpha, flush, no z test or no z write) split the
+//	stream into segments, and are never moved past each other or past the sortable
+//	polys around them.  The world render flushes before every driver Begin/End call.
+//
+//	Outside DrvBatch_Begin/DrvBatch_End, or with a driver that has no RenderBatch, the
+//	calls go straight through to the driver.
+//=====================================================================================
+
+void		DrvBatch_Begin(DRV_Driver *Driver);
+geBoolean	DrvBatch_Flush(void);
+geBoolean	DrvBatch_End(void);
+void		DrvBatch_Shutdown(void);
+
+void		DrvBatch_GouraudPoly(DRV_Driver *Driver, DRV_TLVertex *Pnts, int32 NumPoints, uint32 Flags);
+void		DrvBatch_WorldPoly(DRV_Driver *Driver, DRV_TLVertex *Pnts, int32 NumPoints, geRDriver_THandle *THandle, DRV_TexInfo *TexInfo, DRV_LInfo *LInfo, uint32 Flags);
+void		DrvBatch_MiscTexturePoly(DRV_Driver *Driver, DRV_TLVertex *Pnts, int32 NumPoints, geRDriver_THandle *THandle, uint32 Flags);
+
+// Commands and state runs submitted since the last call
+void		DrvBatch_GetStats(int32 *NumCmds, int32 *NumRuns);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
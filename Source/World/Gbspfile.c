@@ -83,24 +83,95 @@ fail:
 
 //========================================================================================
 // ReadChunkData
+//	Mapped is the chunk data inside the mapped file, or NULL to read it from f
 //========================================================================================
-static geBoolean ReadChunkData(GBSP_Chunk *Chunk, void *Data, geVFile *f)
+static geBoolean ReadChunkData(const GBSP_Chunk *Chunk, void *Data, geVFile *f, const uint8 *Mapped)
 {
+	if (Mapped)
+	{
+		memcpy(Data, Mapped, Chunk->Size * Chunk->Elements);
+		return GE_TRUE;
+	}
+
 	return geVFile_Read(f, Data, Chunk->Size * Chunk->Elements);
 }
 
 //========================================================================================
-//	ReadChunk
+// LoadChunkArray
+//	Points *Data straight at the mapped chunk when we can, otherwise allocates and fills
+//	a copy.  Copy is for chunks the engine writes to (or frees) after load.
 //========================================================================================
-static geBoolean ReadChunk(GBSP_BSPData *BSP, GBSP_Chunk *Chunk, geVFile *f)
+static geBoolean LoadChunkArray(const GBSP_Chunk *Chunk, geVFile *f, const uint8 *Mapped, geBoolean Copy, void **Data)
 {
-	int	i;
+	int32	Bytes;
 
-	if (geVFile_Read(f, Chunk, sizeof(GBSP_Chunk)) == GE_FALSE)
+	Bytes = Chunk->Size * Chunk->Elements;
+
+	// A GBSP inside a VFS can start anywhere in the mapped parent, so check alignment here
+	if (Mapped && !Copy && !((uintptr_t)Mapped & 3))
 	{
-		return GE_FALSE;
+		*Data = (void*)Mapped;
+		return GE_TRUE;
 	}
 
+	*Data = geRam_Allocate(Bytes);
+
+	if (!*Data)
+		return Bytes == 0;
+
+	return ReadChunkData(Chunk, *Data, f, Mapped);
+}
+
+//========================================================================================
+// IsMapped
+//========================================================================================
+static geBoolean IsMapped(const GBSP_BSPData *BSP, const void *Data)
+{
+	return BSP->Mapping && (const uint8*)Data >= BSP->MapStart && (const uint8*)Data <= BSP->MapEnd;
+}
+
+//========================================================================================
+// FreeChunkArray
+//========================================================================================
+static void FreeChunkArray(const GBSP_BSPData *BSP, void *Data)
+{
+	if (Data && !IsMapped(BSP, Data))
+		geRam_Free(Data);
+}
+
+//========================================================================================
+// LoadMappedMotions
+//	The motions are text, so give LoadMotions a memory file over the mapped bytes
+//========================================================================================
+static geBoolean LoadMappedMotions(GBSP_BSPData *BSP, const GBSP_Chunk *Chunk, const uint8 *Mapped)
+{
+	geVFile_MemoryContext	Context;
+	geVFile					*MemFile;
+	geBoolean				Ret;
+
+	Context.Data = (void*)Mapped;
+	Context.DataLength = Chunk->Size * Chunk->Elements;
+
+	MemFile = geVFile_OpenNewSystem(NULL, GE_VFILE_TYPE_MEMORY, NULL, &Context, GE_VFILE_OPEN_READONLY);
+
+	if (!MemFile)
+		return GE_FALSE;
+
+	Ret = LoadMotions(BSP, MemFile);
+
+	geVFile_Close(MemFile);
+
+	return Ret;
+}
+
+//========================================================================================
+//	LoadChunk
+//	Mapped is the chunk data inside the mapped file, or NULL to read it from f
+//========================================================================================
+static geBoolean LoadChunk(GBSP_BSPData *BSP, const GBSP_Chunk *Chunk, geVFile *f, const uint8 *Mapped)
+{
+	int	i;
+
 	switch(Chunk->Type)
 	{
 		case GBSP_CHUNK_HEADER:
@@ -111,14 +182,14 @@ static geBoolean ReadChunk(GBSP_BSPData *BSP, GBSP_Chunk *Chunk, geVFile *f)
 				geErrorLog_Add(GE_ERR_BAD_BSP_FILE_CHUNK_SIZE, NULL);
 				return GE_FALSE;
 			}
-			if (!ReadChunkData(Chunk, (void*)&BSP->GBSPHeader, f))
+			if (!ReadChunkData(Chunk, (void*)&BSP->GBSPHeader, f, Mapped))
 				return GE_FALSE;
 			if (strcmp(BSP->GBSPHeader.TAG, "GBSP"))
 			{
 				geErrorLog_Add(GE_ERR_INVALID_BSP_TAG, NULL);
 				return GE_FALSE;
 			}
-			if (BSP->GBSPHeader.Version != GBSP_VERSION)
+			if (BSP->GBSPHeader.Version != GBSP_VERSION && BSP->GBSPHeader.Version != GBSP_VERSION_UNALIGNED)
 			{
 				geErrorLog_Add(GE_ERR_INVALID_BSP_VERSION, NULL);
 				return GE_FALSE;
@@ -134,8 +205,7 @@ static geBoolean ReadChunk(GBSP_BSPData *BSP, GBSP_Chunk *Chunk, geVFile *f)
 				return GE_FALSE;
 			}
 			BSP->NumGFXModels = Chunk->Elements;
-			BSP->GFXModels = GE_RAM_ALLOCATE_ARRAY(GFX_Model, BSP->NumGFXModels);
-			if (!ReadChunkData(Chunk, (void*)BSP->GFXModels, f))
+			if (!LoadChunkArray(Chunk, f, Mapped, GE_TRUE, (void**)&BSP->GFXModels))
 				return GE_FALSE;
 			// Walk the models and zero out the motion pointers
 			for	(i = 0; i < BSP->NumGFXModels; i++)
@@ -151,8 +221,7 @@ static geBoolean ReadChunk(GBSP_BSPData *BSP, GBSP_Chunk *Chunk, geVFile *f)
 				return GE_FALSE;
 			}
 			BSP->NumGFXNodes = Chunk->Elements;
-			BSP->GFXNodes = (GFX_Node*)geRam_Allocate(sizeof(GFX_Node)*BSP->NumGFXNodes);
-			if (!ReadChunkData(Chunk, (void*)BSP->GFXNodes, f))
+			if (!LoadChunkArray(Chunk, f, Mapped, GE_FALSE, (void**)&BSP->GFXNodes))
 				return GE_FALSE;
 			break;
 		}
@@ -167,8 +236,7 @@ static geBoolean ReadChunk(GBSP_BSPData *BSP, GBSP_Chunk *Chunk, geVFile *f)
 			BSP->NumGFXBNodes = Chunk->Elements;
 			if (BSP->NumGFXBNodes)
 			{
-				BSP->GFXBNodes = (GFX_BNode*)geRam_Allocate(sizeof(GFX_BNode)*BSP->NumGFXBNodes);
-				if (!ReadChunkData(Chunk, (void*)BSP->GFXBNodes, f))
+				if (!LoadChunkArray(Chunk, f, Mapped, GE_FALSE, (void**)&BSP->GFXBNodes))
 					return GE_FALSE;
 			}
 			break;
@@ -182,8 +250,7 @@ static geBoolean ReadChunk(GBSP_BSPData *BSP, GBSP_Chunk *Chunk, geVFile *f)
 				return GE_FALSE;
 			}
 			BSP->NumGFXLeafs = Chunk->Elements;
-			BSP->GFXLeafs = (GFX_Leaf*)geRam_Allocate(sizeof(GFX_Leaf)*BSP->NumGFXLeafs);
-			if (!ReadChunkData(Chunk, (void*)BSP->GFXLeafs, f))
+			if (!LoadChunkArray(Chunk, f, Mapped, GE_FALSE, (void**)&BSP->GFXLeafs))
 				return GE_FALSE;
 			break;
 		}
@@ -197,8 +264,7 @@ static geBoolean ReadChunk(GBSP_BSPData *BSP, GBSP_Chunk *Chunk, geVFile *f)
 			}
 			BSP->NumGFXClusters = Chunk->Elements;
 			//BSP->GFXClusters = GE_RAM_ALLOCATE_ARRAY(GFX_Cluster, BSP->NumGFXClusters);
-			BSP->GFXClusters = (GFX_Cluster*)geRam_Allocate(sizeof(GFX_Cluster)*BSP->NumGFXClusters);
-			if (!ReadChunkData(Chunk, (void*)BSP->GFXClusters, f))
+			if (!LoadChunkArray(Chunk, f, Mapped, GE_FALSE, (void**)&BSP->GFXClusters))
 				return GE_FALSE;
 			break;
 		}
@@ -211,8 +277,7 @@ static geBoolean ReadChunk(GBSP_BSPData *BSP, GBSP_Chunk *Chunk, geVFile *f)
 				return GE_FALSE;
 			}
 			BSP->NumGFXAreas = Chunk->Elements;
-			BSP->GFXAreas = GE_RAM_ALLOCATE_ARRAY(GFX_Area, BSP->NumGFXAreas);
-			if (!ReadChunkData(Chunk, BSP->GFXAreas, f))
+			if (!LoadChunkArray(Chunk, f, Mapped, GE_FALSE, (void**)&BSP->GFXAreas))
 				return GE_FALSE;
 			break;
 		}
@@ -225,8 +290,7 @@ static geBoolean ReadChunk(GBSP_BSPData *BSP, GBSP_Chunk *Chunk, geVFile *f)
 				return GE_FALSE;
 			}
 			BSP->NumGFXAreaPortals = Chunk->Elements;
-			BSP->GFXAreaPortals = GE_RAM_ALLOCATE_ARRAY(GFX_AreaPortal, BSP->NumGFXAreaPortals);
-			if (!ReadChunkData(Chunk, BSP->GFXAreaPortals, f))
+			if (!LoadChunkArray(Chunk, f, Mapped, GE_FALSE, (void**)&BSP->GFXAreaPortals))
 				return GE_FALSE;
 			break;
 		}
@@ -239,8 +303,7 @@ static geBoolean ReadChunk(GBSP_BSPData *BSP, GBSP_Chunk *Chunk, geVFile *f)
 				return GE_FALSE;
 			}
 			BSP->NumGFXPortals = Chunk->Elements;
-			BSP->GFXPortals = (GFX_Portal*)geRam_Allocate(sizeof(GFX_Portal)*BSP->NumGFXPortals);
-			if (!ReadChunkData(Chunk, (void*)BSP->GFXPortals, f))
+			if (!LoadChunkArray(Chunk, f, Mapped, GE_FALSE, (void**)&BSP->GFXPortals))
 				return GE_FALSE;
 			break;
 		}
@@ -253,8 +316,7 @@ static geBoolean ReadChunk(GBSP_BSPData *BSP, GBSP_Chunk *Chunk, geVFile *f)
 				return GE_FALSE;
 			}
 			BSP->NumGFXPlanes = Chunk->Elements;
-			BSP->GFXPlanes = (GFX_Plane*)geRam_Allocate(sizeof(GFX_Plane)*BSP->NumGFXPlanes);
-			if (!ReadChunkData(Chunk, (void*)BSP->GFXPlanes, f))
+			if (!LoadChunkArray(Chunk, f, Mapped, GE_FALSE, (void**)&BSP->GFXPlanes))
 				return GE_FALSE;
 			break;
 		}
@@ -267,8 +329,7 @@ static geBoolean ReadChunk(GBSP_BSPData *BSP, GBSP_Chunk *Chunk, geVFile *f)
 				return GE_FALSE;
 			}
 			BSP->NumGFXFaces = Chunk->Elements;
-			BSP->GFXFaces = (GFX_Face*)geRam_Allocate(sizeof(GFX_Face)*BSP->NumGFXFaces);
-			if (!ReadChunkData(Chunk, (void*)BSP->GFXFaces, f))
+			if (!LoadChunkArray(Chunk, f, Mapped, GE_FALSE, (void**)&BSP->GFXFaces))
 				return GE_FALSE;
 			break;
 		}
@@ -281,8 +342,7 @@ static geBoolean ReadChunk(GBSP_BSPData *BSP, GBSP_Chunk *Chunk, geVFile *f)
 				return GE_FALSE;
 			}
 			BSP->NumGFXLeafFaces = Chunk->Elements;
-			BSP->GFXLeafFaces = (int32*)geRam_Allocate(sizeof(int32)*BSP->NumGFXLeafFaces);
-			if (!ReadChunkData(Chunk, (void*)BSP->GFXLeafFaces, f))
+			if (!LoadChunkArray(Chunk, f, Mapped, GE_FALSE, (void**)&BSP->GFXLeafFaces))
 				return GE_FALSE;
 			break;
 		}
@@ -295,8 +355,7 @@ static geBoolean ReadChunk(GBSP_BSPData *BSP, GBSP_Chunk *Chunk, geVFile *f)
 				return GE_FALSE;
 			}
 			BSP->NumGFXLeafSides = Chunk->Elements;
-			BSP->GFXLeafSides = (GFX_LeafSide*)geRam_Allocate(sizeof(GFX_LeafSide)*BSP->NumGFXLeafSides);
-			if (!ReadChunkData(Chunk, (void*)BSP->GFXLeafSides, f))
+			if (!LoadChunkArray(Chunk, f, Mapped, GE_FALSE, (void**)&BSP->GFXLeafSides))
 				return GE_FALSE;
 			break;
 		}
@@ -309,8 +368,7 @@ static geBoolean ReadChunk(GBSP_BSPData *BSP, GBSP_Chunk *Chunk, geVFile *f)
 				return GE_FALSE;
 			}
 			BSP->NumGFXVerts = Chunk->Elements;
-			BSP->GFXVerts = (geVec3d*)geRam_Allocate(sizeof(geVec3d)*BSP->NumGFXVerts);
-			if (!ReadChunkData(Chunk, (void*)BSP->GFXVerts, f))
+			if (!LoadChunkArray(Chunk, f, Mapped, GE_FALSE, (void**)&BSP->GFXVerts))
 				return GE_FALSE;
 			break;
 		}
@@ -324,8 +382,7 @@ static geBoolean ReadChunk(GBSP_BSPData *BSP, GBSP_Chunk *Chunk, geVFile *f)
 			}
 
 			BSP->NumGFXVertIndexList = Chunk->Elements;
-			BSP->GFXVertIndexList = (int32*)geRam_Allocate(sizeof(int32)*BSP->NumGFXVertIndexList);
-			if (!ReadChunkData(Chunk, (void*)BSP->GFXVertIndexList, f))
+			if (!LoadChunkArray(Chunk, f, Mapped, GE_FALSE, (void**)&BSP->GFXVertIndexList))
 				return GE_FALSE;
 			break;
 		}
@@ -339,8 +396,7 @@ static geBoolean ReadChunk(GBSP_BSPData *BSP, GBSP_Chunk *Chunk, geVFile *f)
 				return GE_FALSE;
 			}
 			BSP->NumGFXRGBVerts = Chunk->Elements;
-			BSP->GFXRGBVerts = (geVec3d*)geRam_Allocate(sizeof(geVec3d)*BSP->NumGFXRGBVerts);
-			if (!ReadChunkData(Chunk, (void*)BSP->GFXRGBVerts, f))
+			if (!LoadChunkArray(Chunk, f, Mapped, GE_FALSE, (void**)&BSP->GFXRGBVerts))
 				return GE_FALSE;
 			break;
 		}
@@ -354,8 +410,7 @@ static geBoolean ReadChunk(GBSP_BSPData *BSP, GBSP_Chunk *Chunk, geVFile *f)
 				return GE_FALSE;
 			}
 			BSP->NumGFXTexInfo = Chunk->Elements;
-			BSP->GFXTexInfo = (GFX_TexInfo*)geRam_Allocate(sizeof(GFX_TexInfo)*BSP->NumGFXTexInfo);
-			if (!ReadChunkData(Chunk, (void*)BSP->GFXTexInfo, f))
+			if (!LoadChunkArray(Chunk, f, Mapped, GE_FALSE, (void**)&BSP->GFXTexInfo))
 				return GE_FALSE;
 			break;
 		}
@@ -369,8 +424,7 @@ static geBoolean ReadChunk(GBSP_BSPData *BSP, GBSP_Chunk *Chunk, geVFile *f)
 				return GE_FALSE;
 			}
 			BSP->NumGFXTextures = Chunk->Elements;
-			BSP->GFXTextures = (GFX_Texture*)geRam_Allocate(sizeof(GFX_Texture)*BSP->NumGFXTextures);
-			if (!ReadChunkData(Chunk, (void*)BSP->GFXTextures, f))
+			if (!LoadChunkArray(Chunk, f, Mapped, GE_FALSE, (void**)&BSP->GFXTextures))
 				return GE_FALSE;
 			break;
 		}
@@ -384,8 +438,7 @@ static geBoolean ReadChunk(GBSP_BSPData *BSP, GBSP_Chunk *Chunk, geVFile *f)
 				return GE_FALSE;
 			}
 			BSP->NumGFXTexData = Chunk->Elements;
-			BSP->GFXTexData = (uint8*)geRam_Allocate(sizeof(uint8)*BSP->NumGFXTexData);
-			if (!ReadChunkData(Chunk, (void*)BSP->GFXTexData, f))
+			if (!LoadChunkArray(Chunk, f, Mapped, GE_FALSE, (void**)&BSP->GFXTexData))
 				return GE_FALSE;
 			break;
 		}
@@ -398,8 +451,7 @@ static geBoolean ReadChunk(GBSP_BSPData *BSP, GBSP_Chunk *Chunk, geVFile *f)
 				return GE_FALSE;
 			}
 			BSP->NumGFXEntData = Chunk->Elements;
-			BSP->GFXEntData = (uint8*)geRam_Allocate(sizeof(uint8)*BSP->NumGFXEntData);
-			if (!ReadChunkData(Chunk, (void*)BSP->GFXEntData, f))
+			if (!LoadChunkArray(Chunk, f, Mapped, GE_FALSE, (void**)&BSP->GFXEntData))
 				return GE_FALSE;
 			break;
 		}
@@ -412,8 +464,7 @@ static geBoolean ReadChunk(GBSP_BSPData *BSP, GBSP_Chunk *Chunk, geVFile *f)
 				return GE_FALSE;
 			}
 			BSP->NumGFXLightData = Chunk->Elements;
-			BSP->GFXLightData = (uint8*)geRam_Allocate(sizeof(uint8)*BSP->NumGFXLightData);
-			if (!ReadChunkData(Chunk, (void*)BSP->GFXLightData, f))
+			if (!LoadChunkArray(Chunk, f, Mapped, GE_FALSE, (void**)&BSP->GFXLightData))
 				return GE_FALSE;
 			break;
 		}
@@ -426,8 +477,7 @@ static geBoolean ReadChunk(GBSP_BSPData *BSP, GBSP_Chunk *Chunk, geVFile *f)
 				return GE_FALSE;
 			}
 			BSP->NumGFXVisData = Chunk->Elements;
-			BSP->GFXVisData = (uint8*)geRam_Allocate(sizeof(uint8)*BSP->NumGFXVisData);
-			if (!ReadChunkData(Chunk, (void*)BSP->GFXVisData, f))
+			if (!LoadChunkArray(Chunk, f, Mapped, GE_FALSE, (void**)&BSP->GFXVisData))
 				return GE_FALSE;
 			break;
 		}
@@ -440,7 +490,7 @@ static geBoolean ReadChunk(GBSP_BSPData *BSP, GBSP_Chunk *Chunk, geVFile *f)
 				geErrorLog_Add(GE_ERR_BAD_BSP_FILE_CHUNK_SIZE, NULL);
 				return GE_FALSE;
 			}
-			if (!ReadChunkData(Chunk, (void*)&BSP->GFXSkyData, f))
+			if (!ReadChunkData(Chunk, (void*)&BSP->GFXSkyData, f, Mapped))
 				return GE_FALSE;
 			break;
 		}
@@ -454,10 +504,7 @@ static geBoolean ReadChunk(GBSP_BSPData *BSP, GBSP_Chunk *Chunk, geVFile *f)
 				return GE_FALSE;
 			}
 			BSP->NumGFXPalettes = Chunk->Elements;
-			BSP->GFXPalettes = (DRV_Palette*)geRam_Allocate(sizeof(DRV_Palette)*BSP->NumGFXPalettes);
-			if	(BSP->GFXPalettes == NULL)
-				return GE_FALSE;
-			if (!ReadChunkData(Chunk, (void*)BSP->GFXPalettes, f))
+			if (!LoadChunkArray(Chunk, f, Mapped, GE_FALSE, (void**)&BSP->GFXPalettes))
 				return GE_FALSE;
 			break;
 		}
@@ -465,9 +512,48 @@ static geBoolean ReadChunk(GBSP_BSPData *BSP, GBSP_Chunk *Chunk, geVFile *f)
 		case GBSP_CHUNK_MOTIONS:
 		{
 //		printf("GBSP_CHUNK_MOTIONS\n");
+			if (Mapped)
+				return LoadMappedMotions(BSP, Chunk, Mapped);
 			return LoadMotions(BSP, f);
 		}
 
+		case GBSP_CHUNK_SURF_INFO:
+		{
+			if (sizeof(GFX_SurfInfo) != Chunk->Size)
+			{
+				geErrorLog_Add(GE_ERR_BAD_BSP_FILE_CHUNK_SIZE, NULL);
+				return GE_FALSE;
+			}
+			BSP->NumGFXSurfInfo = Chunk->Elements;
+			if (!LoadChunkArray(Chunk, f, Mapped, GE_FALSE, (void**)&BSP->GFXSurfInfo))
+				return GE_FALSE;
+			break;
+		}
+
+		case GBSP_CHUNK_NODE_PARENTS:
+		{
+			if (sizeof(int32) != Chunk->Size)
+			{
+				geErrorLog_Add(GE_ERR_BAD_BSP_FILE_CHUNK_SIZE, NULL);
+				return GE_FALSE;
+			}
+			BSP->NumGFXNodeParents = Chunk->Elements;
+			if (!LoadChunkArray(Chunk, f, Mapped, GE_FALSE, (void**)&BSP->GFXNodeParents))
+				return GE_FALSE;
+			break;
+		}
+
+		case GBSP_CHUNK_TABLE:
+		case GBSP_CHUNK_PAD:
+		{
+			// Only there for loaders that map the file, skip over them
+			if (Mapped)
+				break;
+			if (!geVFile_Seek(f, Chunk->Size * Chunk->Elements, GE_VFILE_SEEKCUR))
+				return GE_FALSE;
+			break;
+		}
+
 		case GBSP_CHUNK_END:
 		{
 //		printf("GBSP_CHUNK_END\n");
@@ -481,19 +567,266 @@ static geBoolean ReadChunk(GBSP_BSPData *BSP, GBSP_Chunk *Chunk, geVFile *f)
 	return TRUE;
 }
 
+//========================================================================================
+//	BuildTraceNodes
+//	Packs the GFXNodes reachable from the model roots into GFXTraceNodes, depth first
+//	with the front child always directly after its parent, and the planes copied in
+//========================================================================================
+typedef struct
+{
+	int32		Node;								// Index into GFXNodes
+	int32		*Link;								// Parent child slot to point at the packed node
+} TraceBuildEntry;
+
+static geBoolean BuildTraceNodes(GBSP_BSPData *BSP)
+{
+	TraceBuildEntry	*Stack;
+	int32			StackTop, i, m;
+
+	BSP->NumGFXTraceNodes = 0;
+
+	if (BSP->NumGFXNodes <= 0)
+		return GE_TRUE;
+
+	BSP->GFXTraceNodes = GE_RAM_ALLOCATE_ARRAY(GFX_TraceNode, BSP->NumGFXNodes);
+	BSP->GFXTraceRemap = GE_RAM_ALLOCATE_ARRAY(int32, BSP->NumGFXNodes);
+	// Every node is pushed at most once, so this can't overflow
+	Stack = GE_RAM_ALLOCATE_ARRAY(TraceBuildEntry, BSP->NumGFXNodes);
+
+	if (!BSP->GFXTraceNodes || !BSP->GFXTraceRemap || !Stack)
+	{
+		geErrorLog_Add(GE_ERR_OUT_OF_MEMORY, NULL);
+		goto ExitWithError;
+	}
+
+	for (i=0; i< BSP->NumGFXNodes; i++)
+		BSP->GFXTraceRemap[i] = -1;
+
+	// Model roots, then node 0 in case something walks the tree from there without a model
+	for (m=0; m<= BSP->NumGFXModels; m++)
+	{
+		int32	Root = (m < BSP->NumGFXModels) ? BSP->GFXModels[m].RootNode[0] : 0;
+
+		if (Root < 0 || Root >= BSP->NumGFXNodes || BSP->GFXTraceRemap[Root] != -1)
+			continue;
+
+		StackTop = 0;
+		Stack[StackTop].Node = Root;
+		Stack[StackTop].Link = NULL;
+		StackTop++;
+
+		while (StackTop > 0)
+		{
+			TraceBuildEntry	Entry;
+			GFX_Node		*Node;
+			GFX_Plane		*Plane;
+			GFX_TraceNode	*TNode;
+			int32			Side, Packed;
+
+			Entry = Stack[--StackTop];
+			Node = &BSP->GFXNodes[Entry.Node];
+
+			if (Node->PlaneNum < 0 || Node->PlaneNum >= BSP->NumGFXPlanes)
+			{
+				geErrorLog_Add(GE_ERR_GBSP_LOAD_FAILURE, NULL);
+				goto ExitWithError;
+			}
+
+			Packed = BSP->NumGFXTraceNodes++;
+			BSP->GFXTraceRemap[Entry.Node] = Packed;
+
+			if (Entry.Link)
+				*Entry.Link = Packed;
+
+			Plane = &BSP->GFXPlanes[Node->PlaneNum];
+			TNode = &BSP->GFXTraceNodes[Packed];
+
+			TNode->Normal = Plane->Normal;
+			TNode->Dist = Plane->Dist;
+			TNode->Type = Plane->Type;
+			TNode->Node = Entry.Node;
+
+			// Push the back side first, so the front side gets packed right after this node
+			for (Side = 1; Side >= 0; Side--)
+			{
+				int32	Child = Node->Children[Side];
+
+				TNode->Children[Side] = Child;
+
+				if (Child < 0)
+					continue;				// Leafs keep their index
+
+				if (Child >= BSP->NumGFXNodes || BSP->GFXTraceRemap[Child] != -1 || StackTop >= BSP->NumGFXNodes)
+				{
+					geErrorLog_Add(GE_ERR_GBSP_LOAD_FAILURE, NULL);
+					goto ExitWithError;
+				}
+
+				Stack[StackTop].Node = Child;
+				Stack[StackTop].Link = &TNode->Children[Side];
+				StackTop++;
+			}
+		}
+	}
+
+	geRam_Free(Stack);
+
+	return GE_TRUE;
+
+	ExitWithError:
+	{
+		if (Stack)
+			geRam_Free(Stack);
+		return GE_FALSE;
+	}
+}
+
+//========================================================================================
+//	LoadMappedChunks
+//	Called with the file just past the GBSP_CHUNK_TABLE chunk header.  If the file can be
+//	mapped, every chunk in the table is loaded out of the mapping and *Loaded is set, with
+//	the file left past the GBSP_CHUNK_END.  Otherwise the file is left past the table, so
+//	the caller can carry on reading the chunks one by one.
+//========================================================================================
+static geBoolean LoadMappedChunks(GBSP_BSPData *BSP, geVFile *File, const GBSP_Chunk *TableChunk, long Start, geBoolean *Loaded)
+{
+	GBSP_ChunkTableEntry	*Table;
+	const uint8				*MapData;
+	long					MapSize, EndOffset;
+	int32					i;
+
+	*Loaded = GE_FALSE;
+
+	if (sizeof(GBSP_ChunkTableEntry) != TableChunk->Size || TableChunk->Elements <= 0)
+	{
+		geErrorLog_Add(GE_ERR_BAD_BSP_FILE_CHUNK_SIZE, NULL);
+		return GE_FALSE;
+	}
+
+	Table = GE_RAM_ALLOCATE_ARRAY(GBSP_ChunkTableEntry, TableChunk->Elements);
+
+	if (!Table)
+	{
+		geErrorLog_Add(GE_ERR_OUT_OF_MEMORY, NULL);
+		return GE_FALSE;
+	}
+
+	if (!geVFile_Read(File, Table, sizeof(GBSP_ChunkTableEntry)*TableChunk->Elements))
+	{
+		geRam_Free(Table);
+		return GE_FALSE;
+	}
+
+	assert(!BSP->Mapping);
+
+	BSP->Mapping = geVFile_CreateMapping(File);
+
+	if (!BSP->Mapping)
+	{
+		// This file system can't map, so it gets read the old way
+		geRam_Free(Table);
+		return GE_TRUE;
+	}
+
+	MapData = (const uint8*)geVFile_MappingGetData(BSP->Mapping, &MapSize);
+
+	BSP->MapStart = MapData;
+	BSP->MapEnd = MapData + MapSize;
+
+	EndOffset = -1;
+
+	for (i=0; i< TableChunk->Elements; i++)
+	{
+		GBSP_ChunkTableEntry	*Entry;
+		GBSP_Chunk				Chunk;
+
+		Entry = &Table[i];
+
+		if (Entry->Size < 0 || Entry->Elements < 0 || Entry->Offset < 0 ||
+			Start + Entry->Offset + (long)Entry->Size*Entry->Elements > MapSize)
+		{
+			geErrorLog_Add(GE_ERR_BAD_BSP_FILE_CHUNK_SIZE, NULL);
+			geRam_Free(Table);
+			return GE_FALSE;
+		}
+
+		// The header was read before the table, the rest carry no data
+		if (Entry->Type == GBSP_CHUNK_HEADER || Entry->Type == GBSP_CHUNK_TABLE || Entry->Type == GBSP_CHUNK_PAD)
+			continue;
+
+		if (Entry->Type == GBSP_CHUNK_END)
+		{
+			EndOffset = Entry->Offset;
+			continue;
+		}
+
+		Chunk.Type = Entry->Type;
+		Chunk.Size = Entry->Size;
+		Chunk.Elements = Entry->Elements;
+
+		if (!LoadChunk(BSP, &Chunk, NULL, MapData + Start + Entry->Offset))
+		{
+			geRam_Free(Table);
+			return GE_FALSE;
+		}
+	}
+
+	geRam_Free(Table);
+
+	if (EndOffset < 0)
+	{
+		geErrorLog_Add(GE_ERR_ERROR_READING_BSP_CHUNK, NULL);
+		return GE_FALSE;
+	}
+
+	// Leave the file where a sequential load would have, for anyone reading past the world
+	if (!geVFile_Seek(File, Start + EndOffset, GE_VFILE_SEEKSET))
+		return GE_FALSE;
+
+	*Loaded = GE_TRUE;
+
+	return GE_TRUE;
+}
+
 //========================================================================================
 //	GBSP_LoadGBSPFile
 //========================================================================================
 BOOL GBSP_LoadGBSPFile(geVFile *File, GBSP_BSPData *BSP)
 {
 	GBSP_Chunk	Chunk;
+	long		Start;
+	geBoolean	Loaded;
 
 	assert(File);
 	assert(BSP);
 
+	// Chunk table offsets are from the start of the GBSP, which need not be the start of the file
+	if (!geVFile_Tell(File, &Start))
+		return GE_FALSE;
+
 	while (1)
 	{
-		if (!ReadChunk(BSP, &Chunk, File))
+		if (geVFile_Read(File, &Chunk, sizeof(GBSP_Chunk)) == GE_FALSE)
+		{
+			geErrorLog_Add(GE_ERR_ERROR_READING_BSP_CHUNK, NULL);
+			return GE_FALSE;
+		}
+
+		if (Chunk.Type == GBSP_CHUNK_TABLE)
+		{
+			if (!LoadMappedChunks(BSP, File, &Chunk, Start, &Loaded))
+			{
+				geErrorLog_Add(GE_ERR_ERROR_READING_BSP_CHUNK, NULL);
+				return GE_FALSE;
+			}
+
+			if (Loaded)
+				break;
+
+			continue;
+		}
+
+		if (!LoadChunk(BSP, &Chunk, File, NULL))
 		{
 			geErrorLog_Add(GE_ERR_ERROR_READING_BSP_CHUNK, NULL);
 			return GE_FALSE;
@@ -503,9 +836,39 @@ BOOL GBSP_LoadGBSPFile(geVFile *File, GBSP_BSPData *BSP)
 			break;
 	}
 
+	if (!BuildTraceNodes(BSP))
+		return GE_FALSE;
+
 	return TRUE;
 }
 
+//========================================================================================
+//	GBSP_FreeTexData
+//	World creation turns the texture data into bitmaps, after which it can go
+//========================================================================================
+void GBSP_FreeTexData(GBSP_BSPData *BSP)
+{
+	FreeChunkArray(BSP, BSP->GFXTexData);
+
+	BSP->GFXTexData = NULL;
+	BSP->NumGFXTexData = 0;
+}
+
+//========================================================================================
+//	GBSP_FreeDerivedData
+//	The optional precomputed chunks are only needed while the world is being set up
+//========================================================================================
+void GBSP_FreeDerivedData(GBSP_BSPData *BSP)
+{
+	FreeChunkArray(BSP, BSP->GFXSurfInfo);
+	FreeChunkArray(BSP, BSP->GFXNodeParents);
+
+	BSP->GFXSurfInfo = NULL;
+	BSP->GFXNodeParents = NULL;
+	BSP->NumGFXSurfInfo = 0;
+	BSP->NumGFXNodeParents = 0;
+}
+
 //========================================================================================
 //	GBSP_FreeGBSPFile
 //========================================================================================
@@ -517,51 +880,35 @@ BOOL GBSP_FreeGBSPFile(GBSP_BSPData *BSP)
 		for	(i = 0; i < BSP->NumGFXModels; i++)
 			if (BSP->GFXModels[i].Motion != NULL)
 				geMotion_Destroy(&(BSP->GFXModels[i].Motion));
-		geRam_Free(BSP->GFXModels);
+		FreeChunkArray(BSP, BSP->GFXModels);
 	}
 
-	if (BSP->GFXNodes)
-		geRam_Free(BSP->GFXNodes);
-	if (BSP->GFXBNodes)
-		geRam_Free(BSP->GFXBNodes);
-	if (BSP->GFXLeafs)
-		geRam_Free(BSP->GFXLeafs);
-	if (BSP->GFXClusters)
-		geRam_Free(BSP->GFXClusters);
-	if (BSP->GFXAreas)
-		geRam_Free(BSP->GFXAreas);
-	if (BSP->GFXAreaPortals)
-		geRam_Free(BSP->GFXAreaPortals);
-	if (BSP->GFXPortals)
-		geRam_Free(BSP->GFXPortals);
-	if (BSP->GFXPlanes)
-		geRam_Free(BSP->GFXPlanes);
-	if (BSP->GFXFaces)
-		geRam_Free(BSP->GFXFaces);
-	if (BSP->GFXLeafFaces)
-		geRam_Free(BSP->GFXLeafFaces);
-	if (BSP->GFXLeafSides)
-		geRam_Free(BSP->GFXLeafSides);
-	if (BSP->GFXVerts)
-		geRam_Free(BSP->GFXVerts);
-	if (BSP->GFXVertIndexList)
-		geRam_Free(BSP->GFXVertIndexList);
-	if (BSP->GFXRGBVerts)
-		geRam_Free(BSP->GFXRGBVerts);
-	if (BSP->GFXTextures)
-		geRam_Free(BSP->GFXTextures);
-	if (BSP->GFXTexInfo)
-		geRam_Free(BSP->GFXTexInfo);
-	if (BSP->GFXTexData)
-		geRam_Free(BSP->GFXTexData);
-	if (BSP->GFXPalettes)
-		geRam_Free(BSP->GFXPalettes);
-	if (BSP->GFXEntData)
-		geRam_Free(BSP->GFXEntData);
-	if (BSP->GFXLightData)
-		geRam_Free(BSP->GFXLightData);
-	if (BSP->GFXVisData)
-		geRam_Free(BSP->GFXVisData);
+	FreeChunkArray(BSP, BSP->GFXNodes);
+	FreeChunkArray(BSP, BSP->GFXBNodes);
+	FreeChunkArray(BSP, BSP->GFXLeafs);
+	FreeChunkArray(BSP, BSP->GFXClusters);
+	FreeChunkArray(BSP, BSP->GFXAreas);
+	FreeChunkArray(BSP, BSP->GFXAreaPortals);
+	FreeChunkArray(BSP, BSP->GFXPortals);
+	FreeChunkArray(BSP, BSP->GFXPlanes);
+	FreeChunkArray(BSP, BSP->GFXFaces);
+	FreeChunkArray(BSP, BSP->GFXLeafFaces);
+	FreeChunkArray(BSP, BSP->GFXLeafSides);
+	FreeChunkArray(BSP, BSP->GFXVerts);
+	FreeChunkArray(BSP, BSP->GFXVertIndexList);
+	FreeChunkArray(BSP, BSP->GFXRGBVerts);
+	FreeChunkArray(BSP, BSP->GFXTextures);
+	FreeChunkArray(BSP, BSP->GFXTexInfo);
+	FreeChunkArray(BSP, BSP->GFXTexData);
+	FreeChunkArray(BSP, BSP->GFXPalettes);
+	FreeChunkArray(BSP, BSP->GFXEntData);
+	FreeChunkArray(BSP, BSP->GFXLightData);
+	FreeChunkArray(BSP, BSP->GFXVisData);
+	GBSP_FreeDerivedData(BSP);
+	if (BSP->GFXTraceNodes)
+		geRam_Free(BSP->GFXTraceNodes);
+	if (BSP->GFXTraceRemap)
+		geRam_Free(BSP->GFXTraceRemap);
 
 	BSP->GFXModels = NULL;
 	BSP->GFXNodes = NULL;
@@ -587,6 +934,8 @@ BOOL GBSP_FreeGBSPFile(GBSP_BSPData *BSP)
 	BSP->GFXLightData = NULL;
 	BSP->GFXVisData = NULL;
 	BSP->GFXPortals = NULL;
+	BSP->GFXTraceNodes = NULL;
+	BSP->GFXTraceRemap = NULL;
 
 	BSP->NumGFXModels = 0;
 	BSP->NumGFXNodes = 0;
@@ -611,6 +960,15 @@ BOOL GBSP_FreeGBSPFile(GBSP_BSPData *BSP)
 	BSP->NumGFXLightData = 0;
 	BSP->NumGFXVisData = 0;
 	BSP->NumGFXPortals = 0;
+	BSP->NumGFXTraceNodes = 0;
+
+	// Only now that nothing points into it
+	if (BSP->Mapping)
+		geVFile_DestroyMapping(BSP->Mapping);
+
+	BSP->Mapping = NULL;
+	BSP->MapStart = NULL;
+	BSP->MapEnd = NULL;
 
 	return TRUE;
 }
@@ -33,7 +33,23 @@
 #include "WORLD.H"
 #include "TRACE.H"
 
+#if defined(_M_X64) || defined(__x86_64__) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#define LIGHT_SSE2
+	#include <emmintrin.h>
+#endif
+
 #define LIGHT_FRACT		8
+
+// Surfaces keep one bit per dlight
+typedef char Light_DLightMaskCheck[(MAX_DYNAMIC_LIGHTS <= SURF_DLIGHT_WORDS*32) ? 1 : -1];
+
+// Dlight positions in the space of the model being walked (see Light_SetupLights)
+typedef struct
+{
+	geVec3d		Pos;
+	float		Radius;
+	int32		LNum;
+} Light_DLightRef;
 //=====================================================================================
 //	Local Globals
 //=====================================================================================
@@ -51,6 +67,10 @@ static	int32			TempRGB32[MAX_LMAP_SIZE*MAX_LMAP_SIZE*3];
 static	DRV_RGB			TempRGBFog[MAX_LMAP_SIZE*MAX_LMAP_SIZE];
 static	int32			TempRGB32Fog[MAX_LMAP_SIZE*MAX_LMAP_SIZE*3];
 
+static	Light_DLightRef	DLightRefs[MAX_DYNAMIC_LIGHTS];
+
+static	uint32			DLightStamp;	// Last stamp handed out to a changed dlight
+
 // Fast sqrt stuff
 // MOST_SIG_OFFSET gives the (int *) offset from the address of the double
 // to the part of the number containing the sign and exponent.
@@ -87,7 +107,11 @@ int32 SqrtTab[SQRT_TAB_SIZE];
 //	Local Static Function prototypes
 //=====================================================================================
 static void UpdateLTypeTables(geWorld *World);
-static int32 FastDist(int32 dx, int32 dy, int32 dz);
+static int32 TexelDist(int32 x, int32 y);
+static int32 LowestBit(uint32 Bits);
+static void ClampLightmap(const int32 *Src, DRV_RGB *Dest, int32 NumTexels);
+static geBoolean BuildLMapKey(GFX_Face *Face, Surf_SurfInfo *SInfo, geBoolean HasDLight, Light_LMapCache *Key);
+static Light_LMapCache *GetLMapCache(int32 FaceNum, int32 LMapSize);
 static void SetupWavyColorLight1(DRV_RGB *light1, DRV_RGB *RGBM, int32 lw, int32 lh);
 static void SetupWavyColorLight2(DRV_RGB *light1, DRV_RGB *RGBM, int32 lw, int32 lh);
 static void SetupColorLight1(DRV_RGB *light1, DRV_RGB *RGBM, int32 lw, int32 lh, float intensity);
@@ -95,7 +119,7 @@ static void SetupColorLight2(DRV_RGB *light1, DRV_RGB *RGBM, int32 lw, int32 lh,
 static BOOL CombineDLightWithRGBMap(int32 *LightData, Light_DLight *Light, GFX_Face *Face, Surf_SurfInfo *SInfo);
 static BOOL CombineDLightWithRGBMapWithShadow(int32 *LightData, Light_DLight *Light, GFX_Face *Face, Surf_SurfInfo *SInfo);
 static void BuildLightLUTS(geEngine *Engine);
-static void SetupDynamicLight_r(Light_DLight *pLight, geVec3d *Pos, int32 LNum, int32 Node);
+static void SetupDynamicLights_r(const uint8 *List, int32 NumLights, int32 Node);
 
 static void AddLightType0(int32 *LightDest, uint8 *LightData, int32 lw, int32 lh);
 static void AddLightType(int32 *LightDest, uint8 *LightData, int32 lw, int32 lh, int32 Intensity);
@@ -163,6 +187,19 @@ void Light_WorldShutdown(geWorld *World)
 	if (!World->LightInfo)
 		return;
 
+	if (World->LightInfo->LMapCache)
+	{
+		int32		i;
+
+		for (i=0; i< World->LightInfo->NumLMapCache; i++)
+		{
+			if (World->LightInfo->LMapCache[i])
+				geRam_Free(World->LightInfo->LMapCache[i]);
+		}
+
+		geRam_Free(World->LightInfo->LMapCache);
+	}
+
 	geRam_Free(World->LightInfo);
 
 	World->LightInfo = NULL;
@@ -757,6 +794,7 @@ void Light_SetupLightmap(DRV_LInfo *LInfo, BOOL *Dynamic)
 	int32			lWidth, lHeight, LMapSize, MapNum, SIndex;
 	int32			*pRGB1;
 	DRV_RGB			*pRGB2;
+	Light_LMapCache	Key, *Cache;
 
 	assert (CBSP != NULL);
 	assert(BSPData != NULL);
@@ -794,6 +832,25 @@ void Light_SetupLightmap(DRV_LInfo *LInfo, BOOL *Dynamic)
 
 	CEngine->DebugInfo.LMap1++;
 
+	// Reuse the last combine if none of its inputs have changed
+	Cache = NULL;
+
+	if (BuildLMapKey(Face, SInfo, HasDLight, &Key))
+		Cache = GetLMapCache(LInfo->Face, LMapSize);
+
+	if (Cache)
+	{
+		if (Key.Stamp <= Cache->Stamp && 
+			!memcmp(Key.LTypeIntensities, Cache->LTypeIntensities, sizeof(Key.LTypeIntensities)) &&
+			!memcmp(Key.DLights, Cache->DLights, sizeof(Key.DLights)))
+		{
+			CEngine->DebugInfo.LMapCacheHits++;
+			goto Cached;
+		}
+	}
+
+	CEngine->DebugInfo.LMapRecomputes++;
+
 	// If there is light data
 	if (LightOffset >=0) 
 	{
@@ -845,14 +902,17 @@ void Light_SetupLightmap(DRV_LInfo *LInfo, BOOL *Dynamic)
 	// Tack on dynamic lights
 	if (HasDLight)
 	{
-		Light_DLight	*DLights = LightInfo->DynamicLights;
+		Light_DLight	*DLights;
+		uint32			Bits;
+		int32			Word;
 
-		for (Ln = 0; Ln <MAX_DYNAMIC_LIGHTS; Ln++, DLights++) 
+		for (Word = 0; Word < SURF_DLIGHT_WORDS; Word++)
+		for (Bits = SInfo->DLights[Word]; Bits; Bits &= Bits-1)
 		{
-			if (!DLights->Active) 
-				continue;
+			Ln = (Word<<5) + LowestBit(Bits);
+			DLights = &LightInfo->DynamicLights[Ln];
 
-			if (!(SInfo->DLights & (1<<Ln)))
+			if (!DLights->Active) 
 				continue;
 
 			CEngine->DebugInfo.NumDLights++;
@@ -870,37 +930,32 @@ void Light_SetupLightmap(DRV_LInfo *LInfo, BOOL *Dynamic)
 		}
 	}
 
-	// Put the light into a driver compatible pointer, and clamp it 
-	pRGB1 = TempRGB32;
-	pRGB2 = TempRGB;
-	for (i=0; i< LMapSize; i++)
+	if (!Cache)
 	{
-		Intensity = (*pRGB1++) >> LIGHT_FRACT;
-		if (Intensity > 255)
-			Intensity = 255;
-		else if (Intensity < 0 )
-			Intensity = 0;
-		pRGB2->r = (uint8)Intensity;
+		// Put the light into a driver compatible pointer, and clamp it 
+		ClampLightmap(TempRGB32, TempRGB, LMapSize);
+		
+		// Point the lightmap to the data
+		LInfo->RGBLight[0] = TempRGB;
+		goto FogOnly;
+	}
 
-		Intensity = (*pRGB1++) >> LIGHT_FRACT;
-		if (Intensity > 255)
-			Intensity = 255;
-		else if (Intensity < 0 )
-			Intensity = 0;
-		pRGB2->g = (uint8)Intensity;
+	ClampLightmap(TempRGB32, Cache->RGB, LMapSize);
 
-		Intensity = (*pRGB1++) >> LIGHT_FRACT;
-		if (Intensity > 255)
-			Intensity = 255;
-		else if (Intensity < 0 )
-			Intensity = 0;
-		pRGB2->b = (uint8)Intensity;
+	memcpy(Cache->LTypeIntensities, Key.LTypeIntensities, sizeof(Key.LTypeIntensities));
+	memcpy(Cache->DLights, Key.DLights, sizeof(Key.DLights));
+	Cache->Stamp = Key.Stamp;
+	Cache->Pending = GE_TRUE;
 
-		pRGB2++;
-	}
-	
-	// Point the lightmap to the data
-	LInfo->RGBLight[0] = TempRGB;
+	Cached:
+
+	// Only dynamic until the driver has been told about the change
+	IsDyn = Cache->Pending;
+
+	if (Dynamic)
+		Cache->Pending = GE_FALSE;
+
+	LInfo->RGBLight[0] = Cache->RGB;
 
 	FogOnly:		// Jump to here, for fog lightmap only...
 
@@ -971,6 +1026,9 @@ void Light_SetupLightmap(DRV_LInfo *LInfo, BOOL *Dynamic)
 	if (Dynamic)
 	{
 		*Dynamic = IsDyn;
+
+		if (IsDyn)
+			CEngine->DebugInfo.LMapUploadBytes += LMapSize*sizeof(DRV_RGB)*(LInfo->RGBLight[1] ? 2 : 1);
 	}
 }
 
@@ -1041,6 +1099,10 @@ static BOOL CombineDLightWithRGBMap(int32 *LightData, Light_DLight *Light, GFX_F
 	int32		Sx, Sy, x, y, u, v, Val;
 	int32		ColorR, ColorG, ColorB, Radius2, Dist2;
 	int32		FixedX, FixedY, XStep, YStep;
+#ifdef LIGHT_SSE2
+	__m128		Color0, Color1, Color2;
+	__m128i		Radius4, XStep4, Zero;
+#endif
 
 	assert(BSPData != NULL);
 	assert(BSPData->GFXTexInfo != NULL);
@@ -1086,26 +1148,80 @@ static BOOL CombineDLightWithRGBMap(int32 *LightData, Light_DLight *Light, GFX_F
 
 	FixedY = Sy;
 
+#ifdef LIGHT_SSE2
+	// Interleaved RGB, so 4 texels cover 3 registers: RGBR GBRG BRGB
+	Color0 = _mm_cvtepi32_ps(_mm_setr_epi32(ColorR, ColorG, ColorB, ColorR));
+	Color1 = _mm_cvtepi32_ps(_mm_setr_epi32(ColorG, ColorB, ColorR, ColorG));
+	Color2 = _mm_cvtepi32_ps(_mm_setr_epi32(ColorB, ColorR, ColorG, ColorB));
+	Radius4 = _mm_set1_epi32(Radius2);
+	XStep4 = _mm_set1_epi32(XStep*4);
+	Zero = _mm_setzero_si128();
+#endif
+
 	for (v=0; v< SInfo->LInfo.Height; v++)
 	{
 		y = FixedY >> 10;
 
-		if (y < 0)
-			y = -y;
-
 		FixedX = Sx;
+		u = 0;
+
+	#ifdef LIGHT_SSE2
+		{
+			__m128i		Fixed4, X4, Sign, Val4, Mask;
+			__m128		Y2, Dist2f, RSqrt;
+			__m128		One = _mm_set1_ps(1.0f), Half = _mm_set1_ps(0.5f), Three = _mm_set1_ps(3.0f);
+
+			Y2 = _mm_set1_ps((float)y*(float)y);
+			Fixed4 = _mm_setr_epi32(Sx, Sx-XStep, Sx-XStep*2, Sx-XStep*3);
+
+			for (; u+4 <= SInfo->LInfo.Width; u+=4, LightData+=12)
+			{
+				__m128		Val;
+				__m128i		*Dest;
+
+				X4 = _mm_srai_epi32(Fixed4, 10);
+				Fixed4 = _mm_sub_epi32(Fixed4, XStep4);
+
+				Sign = _mm_srai_epi32(X4, 31);
+				X4 = _mm_sub_epi32(_mm_xor_si128(X4, Sign), Sign);
+
+				// Dist = sqrt(x*x + y*y), as d2 * rsqrt(d2) with one newton step
+				Dist2f = _mm_cvtepi32_ps(X4);
+				Dist2f = _mm_add_ps(_mm_mul_ps(Dist2f, Dist2f), Y2);
+				RSqrt = _mm_rsqrt_ps(_mm_max_ps(Dist2f, One));
+				RSqrt = _mm_mul_ps(_mm_mul_ps(Half, RSqrt), _mm_sub_ps(Three, _mm_mul_ps(_mm_mul_ps(Dist2f, RSqrt), RSqrt)));
+				Dist2f = _mm_mul_ps(Dist2f, RSqrt);
+
+				Val4 = _mm_sub_epi32(Radius4, _mm_cvttps_epi32(Dist2f));
+				Mask = _mm_cmpgt_epi32(Val4, Zero);
+
+				if (_mm_movemask_epi8(Mask) == 0)
+					continue;
+
+				Val4 = _mm_and_si128(Val4, Mask);
+
+				Hit = TRUE;
+
+				Val = _mm_cvtepi32_ps(Val4);
+				Dest = (__m128i*)LightData;
+
+				_mm_storeu_si128(Dest+0, _mm_add_epi32(_mm_loadu_si128(Dest+0), 
+					_mm_cvttps_epi32(_mm_mul_ps(_mm_shuffle_ps(Val, Val, _MM_SHUFFLE(1,0,0,0)), Color0))));
+				_mm_storeu_si128(Dest+1, _mm_add_epi32(_mm_loadu_si128(Dest+1), 
+					_mm_cvttps_epi32(_mm_mul_ps(_mm_shuffle_ps(Val, Val, _MM_SHUFFLE(2,2,1,1)), Color1))));
+				_mm_storeu_si128(Dest+2, _mm_add_epi32(_mm_loadu_si128(Dest+2), 
+					_mm_cvttps_epi32(_mm_mul_ps(_mm_shuffle_ps(Val, Val, _MM_SHUFFLE(3,3,3,2)), Color2))));
+			}
+
+			FixedX -= XStep*u;
+		}
+	#endif
 		
-		for (u=0; u< SInfo->LInfo.Width; u++)
+		for (; u< SInfo->LInfo.Width; u++)
 		{
 			x = FixedX >> 10;
 
-			if (x<0)
-				x = -x;
-
-			if (x > y)
-				Dist2 = (x + (y>>1));
-			else
-				Dist2 = (y + (x>>1));
+			Dist2 = TexelDist(x, y);
 			
 			if (Dist2 < Radius2)
 			{
@@ -1142,6 +1258,7 @@ static BOOL CombineDLightWithRGBMapWithShadow(int32 *LightData, Light_DLight *Li
 	int32		Sx, Sy, x, y, u, v, Val;
 	int32		ColorR, ColorG, ColorB, Radius2, Dist2;
 	int32		FixedX, FixedY, XStep, YStep;
+	Trace_Context	TraceCtx;
 
 	assert(BSPData != NULL);
 	assert(BSPData->GFXTexInfo != NULL);
@@ -1191,32 +1308,23 @@ static BOOL CombineDLightWithRGBMapWithShadow(int32 *LightData, Light_DLight *Li
 	Right = SInfo->T2WVecs[0];
 	Down = SInfo->T2WVecs[1];
 
-	Trace_SetupIntersect(CWorld);		// Setup intersection test with current world...
+	Trace_SetupIntersect(CWorld, &TraceCtx);		// Setup intersection test with current world...
 
 	for (v=0; v< SInfo->LInfo.Height; v++)
 	{
 		y = FixedY >> 10;
 
-		if (y < 0)
-			y = -y;
-
 		FixedX = Sx;
 		
 		for (u=0; u< SInfo->LInfo.Width; u++)
 		{
 			x = FixedX >> 10;
 
-			if (x<0)
-				x = -x;
-
-			if (x > y)
-				Dist2 = (x + (y>>1));
-			else
-				Dist2 = (y + (x>>1));
+			Dist2 = TexelDist(x, y);
 			
 			if (Dist2 < Radius2)
 			{
-				if (Trace_IntersectWorldBSP(&LPos, &LMapPos, 0))
+				if (Trace_IntersectWorldBSP(&TraceCtx, &LPos, &LMapPos, 0))
 				{
 					LightData += 3;
 					FixedX -= XStep;
@@ -1255,8 +1363,9 @@ static BOOL CombineDLightWithRGBMapWithShadow(int32 *LightData, Light_DLight *Li
 //=====================================================================================
 geBoolean Light_SetupLights(geWorld *World)
 {
-	int32			i, Node;
+	int32			i, m;
 	Light_DLight	*DLights;
+	geWorld_Model	*Model;
 
 	assert(World != NULL);
 
@@ -1267,47 +1376,49 @@ geBoolean Light_SetupLights(geWorld *World)
 	// Update the intensity tables for dynamic ltyped lighting
 	UpdateLTypeTables(World);
 
-	DLights = LightInfo->DynamicLights;
-
-#if 0
-	Node = BSPData->GFXModels[0].RootNode[0];
+	if (LightInfo->NumDynamicLights <= 0)
+		return GE_TRUE;
 
-	for (i=0; i< MAX_DYNAMIC_LIGHTS; i++, DLights++)
-	{
-		if (!DLights->Active)
-			continue;
+	Model = CBSP->Models;
 
-		SetupDynamicLight_r(DLights, &DLights->Pos, i, Node);
-	}
-#else
-	for (i=0; i< MAX_DYNAMIC_LIGHTS; i++, DLights++)
+	// Walk each visible model once, classifying every light against it at the same time
+	for (m=0; m< BSPData->NumGFXModels; m++, Model++)
 	{
-		int32		m;
-		geVec3d		NewPos;
-		geWorld_Model *Model;
+		uint8		List[MAX_DYNAMIC_LIGHTS];
+		int32		NumLights;
 
-		if (!DLights->Active)
+		if (Model->VisFrame != World->CurFrameDynamic)
 			continue;
 
-		Model = CBSP->Models;
+		DLights = LightInfo->DynamicLights;
+		NumLights = 0;
 
-		for (m=0; m< BSPData->NumGFXModels; m++, Model++)
+		for (i=0; i< MAX_DYNAMIC_LIGHTS; i++, DLights++)
 		{
-			if (Model->VisFrame != World->CurFrameDynamic)
+			Light_DLightRef	*Ref;
+
+			if (!DLights->Active)
 				continue;
 
-			Node = BSPData->GFXModels[m].RootNode[0];
-			
-			geVec3d_Subtract(&DLights->Pos, &Model->Pivot, &NewPos);
+			Ref = &DLightRefs[NumLights];
+
+			geVec3d_Subtract(&DLights->Pos, &Model->Pivot, &Ref->Pos);
 			// InverseTransform the light about models center of rotation
-			geXForm3d_TransposeTransform(&Model->XForm, &NewPos, &NewPos);
-			
-			geVec3d_Add(&NewPos , &Model->Pivot, &NewPos);
+			geXForm3d_TransposeTransform(&Model->XForm, &Ref->Pos, &Ref->Pos);
+			geVec3d_Add(&Ref->Pos , &Model->Pivot, &Ref->Pos);
+
+			Ref->Radius = DLights->Radius;
+			Ref->LNum = i;
 
-			SetupDynamicLight_r(DLights, &NewPos, i, Node);
+			List[NumLights] = (uint8)NumLights;
+			NumLights++;
 		}
+
+		if (!NumLights)
+			break;
+
+		SetupDynamicLights_r(List, NumLights, BSPData->GFXModels[m].RootNode[0]);
 	}
-#endif
 
 	return GE_TRUE;
 }
@@ -1392,6 +1503,7 @@ Light_DLight *Light_WorldAddLight(geWorld *World)
 	memset(DLights, 0, sizeof(Light_DLight));
 
 	DLights->Active = GE_TRUE;
+	DLights->Stamp = ++DLightStamp;
 	LInfo->NumDynamicLights++;
 	
 
@@ -1425,6 +1537,11 @@ geBoolean Light_SetAttributes(	Light_DLight *Light,
 								geBoolean CastShadow)
 {
 	assert(Light != NULL);
+
+	// Lightmaps built with this light are stale now (unless nothing actually changed)
+	if (!geVec3d_Compare(&Light->Pos, Pos, 0.0f) || memcmp(&Light->Color, RGBA, sizeof(GE_RGBA)) ||
+		Light->Radius != Radius || Light->CastShadow != CastShadow)
+		Light->Stamp = ++DLightStamp;
 	
 	Light->Pos = *Pos;
 	Light->Color = *RGBA;
@@ -1466,29 +1583,174 @@ geBoolean Light_WorldSetLTypeTable(geWorld *World, int32 LType, const char *Tabl
 //=====================================================================================
 
 //=====================================================================================
-//	FastDist
-//	Quick sqrt routine
+//	BuildLMapKey
+//	Fills in what the combined lightmap of a face depends on, returns GE_FALSE if 
+//	it changes every frame regardless (wavy ltypes)
+//=====================================================================================
+static geBoolean BuildLMapKey(GFX_Face *Face, Surf_SurfInfo *SInfo, geBoolean HasDLight, Light_LMapCache *Key)
+{
+	int32		MapNum, SIndex, Word;
+	uint32		Bits;
+
+	memset(Key, 0, sizeof(*Key));
+
+	if (Face->LightOfs >= 0)
+	{
+		for (MapNum = 0; MapNum < 4; MapNum++) 
+		{
+			SIndex = Face->LTypes[MapNum];
+			
+			if (SIndex == 255)
+				break;
+
+			if (SIndex == 11)
+				return GE_FALSE;
+
+			Key->LTypeIntensities[MapNum] = LightInfo->LTypeIntensities[SIndex];
+		}
+	}
+
+	if (!HasDLight)
+		return GE_TRUE;
+
+	for (Word = 0; Word < SURF_DLIGHT_WORDS; Word++)
+	for (Bits = SInfo->DLights[Word]; Bits; Bits &= Bits-1)
+	{
+		int32			Ln;
+		Light_DLight	*DLight;
+
+		Ln = (Word<<5) + LowestBit(Bits);
+		DLight = &LightInfo->DynamicLights[Ln];
+
+		if (!DLight->Active)
+			continue;
+
+		Key->DLights[Word] |= 1<<(Ln&31);
+
+		if (DLight->Stamp > Key->Stamp)
+			Key->Stamp = DLight->Stamp;
+	}
+
+	return GE_TRUE;
+}
+
+//=====================================================================================
+//	GetLMapCache
+//	Returns NULL if there is no memory for it, the face is then just combined every time
 //=====================================================================================
-static int32 FastDist(int32 dx, int32 dy, int32 dz)
+static Light_LMapCache *GetLMapCache(int32 FaceNum, int32 LMapSize)
 {
-	int32		Max, Med, Min;	// biggest, smallest, and middle values
-	int32		Tmp;
+	Light_LMapCache	*Cache;
 
-	Max = (dx < 0) ? -dx : dx;
-	Med = (dz < 0) ? -dz : dz;
-	Min = (dy < 0) ? -dy : dy;
+	if (!LightInfo->LMapCache)
+	{
+		LightInfo->LMapCache = GE_RAM_ALLOCATE_ARRAY(Light_LMapCache*, BSPData->NumGFXFaces);
 
-	if (Max < Med) 
-	{ 
-		Tmp = Max; Max = Med; Med = Tmp;
+		if (!LightInfo->LMapCache)
+			return NULL;
+
+		memset(LightInfo->LMapCache, 0, sizeof(Light_LMapCache*)*BSPData->NumGFXFaces);
+		LightInfo->NumLMapCache = BSPData->NumGFXFaces;
 	}
-	if (Max < Min) 
-	{ 
-		Tmp = Max; Max = Min; Min = Tmp;
+
+	assert(FaceNum >= 0 && FaceNum < LightInfo->NumLMapCache);
+
+	Cache = LightInfo->LMapCache[FaceNum];
+
+	if (Cache)
+		return Cache;
+
+	Cache = (Light_LMapCache*)geRam_Allocate(sizeof(Light_LMapCache) + LMapSize*sizeof(DRV_RGB));
+
+	if (!Cache)
+		return NULL;
+
+	memset(Cache, 0, sizeof(Light_LMapCache));
+
+	Cache->Stamp = 0;
+	Cache->LTypeIntensities[0] = -1;		// Never matches, so the first use builds it
+	Cache->RGB = (DRV_RGB*)(Cache+1);
+
+	LightInfo->LMapCache[FaceNum] = Cache;
+
+	return Cache;
+}
+
+//=====================================================================================
+//	TexelDist
+//	Distance from the light to a lightmap texel, in the plane of the lightmap
+//=====================================================================================
+static int32 TexelDist(int32 x, int32 y)
+{
+	float		fx, fy;
+
+	fx = (float)x;
+	fy = (float)y;
+
+	return (int32)sqrtf(fx*fx + fy*fy);
+}
+
+//=====================================================================================
+//	LowestBit
+//	Index of the lowest set bit, Bits must not be 0
+//=====================================================================================
+static int32 LowestBit(uint32 Bits)
+{
+	assert(Bits != 0);
+
+#if defined(__GNUC__) || defined(__clang__)
+	return __builtin_ctz(Bits);
+#else
+	{
+		int32	Bit;
+
+		for (Bit = 0; !(Bits & 1); Bit++)
+			Bits >>= 1;
+
+		return Bit;
+	}
+#endif
+}
+
+//=====================================================================================
+//	ClampLightmap
+//	Shifts the fixed point light down, and clamps it into the driver rgb map
+//=====================================================================================
+static void ClampLightmap(const int32 *Src, DRV_RGB *Dest, int32 NumTexels)
+{
+	int32		i, Count, Intensity;
+	uint8		*pDest;
+
+	assert(sizeof(DRV_RGB) == 3);
+
+	Count = NumTexels*3;
+	pDest = (uint8*)Dest;
+	i = 0;
+
+#ifdef LIGHT_SSE2
+	// 16 components at a time, the saturating packs do the clamping
+	for (; i+16 <= Count; i+=16)
+	{
+		__m128i		a, b, c, d;
+
+		a = _mm_srai_epi32(_mm_loadu_si128((const __m128i*)(Src+i+0)), LIGHT_FRACT);
+		b = _mm_srai_epi32(_mm_loadu_si128((const __m128i*)(Src+i+4)), LIGHT_FRACT);
+		c = _mm_srai_epi32(_mm_loadu_si128((const __m128i*)(Src+i+8)), LIGHT_FRACT);
+		d = _mm_srai_epi32(_mm_loadu_si128((const __m128i*)(Src+i+12)), LIGHT_FRACT);
+
+		_mm_storeu_si128((__m128i*)(pDest+i), _mm_packus_epi16(_mm_packs_epi32(a, b), _mm_packs_epi32(c, d)));
+	}
+#endif
+
+	for (; i< Count; i++)
+	{
+		Intensity = Src[i] >> LIGHT_FRACT;
+		if (Intensity > 255)
+			Intensity = 255;
+		else if (Intensity < 0 )
+			Intensity = 0;
+		pDest[i] = (uint8)Intensity;
 	}
-	Max <<= 2;
-	Max += Med + Min;
-	return Max>>2;
 }
 
 #define A_MOD 7							// How much to modulus the anim too
@@ -1777,15 +2039,19 @@ static void BuildLightLUTS(geEngine *Engine)
 }
 
 //=====================================================================================
-//	SetupDynamicLight_r
+//	SetupDynamicLights_r
+//	Marks the faces touched by the lights in List (indexes into DLightRefs)
 //=====================================================================================
-static void SetupDynamicLight_r(Light_DLight *pLight, geVec3d *Pos, int32 LNum, int32 Node)
+static void SetupDynamicLights_r(const uint8 *List, int32 NumLights, int32 Node)
 {
+	uint8			Front[MAX_DYNAMIC_LIGHTS], Back[MAX_DYNAMIC_LIGHTS], Span[MAX_DYNAMIC_LIGHTS];
+	int32			NumFront, NumBack, NumSpan;
 	float			Dist;
 	GFX_Plane		*pPlane;
 	GFX_Node		*pNode;
 	Surf_SurfInfo	*pSInfo;
-	int32			i;
+	Light_DLightRef	*pRef;
+	int32			i, l;
 
 	if (Node < 0)	// Hit a leaf no more searching
 		return;
@@ -1793,40 +2059,57 @@ static void SetupDynamicLight_r(Light_DLight *pLight, geVec3d *Pos, int32 LNum,
 	pNode = &BSPData->GFXNodes[Node];
 	pPlane = &BSPData->GFXPlanes[pNode->PlaneNum];
 
-	Dist = Plane_PlaneDistanceFast(pPlane, Pos);
+	NumFront = NumBack = NumSpan = 0;
 
-	if (Dist > pLight->Radius)
-	{
-		SetupDynamicLight_r(pLight, Pos, LNum, BSPData->GFXNodes[Node].Children[0]);
-		return;
-	}
-	if (Dist <-pLight->Radius)
+	for (l=0; l< NumLights; l++)
 	{
-		SetupDynamicLight_r(pLight, Pos, LNum, BSPData->GFXNodes[Node].Children[1]);
-		return;
+		pRef = &DLightRefs[List[l]];
+
+		Dist = Plane_PlaneDistanceFast(pPlane, &pRef->Pos);
+
+		if (Dist > pRef->Radius)
+			Front[NumFront++] = List[l];
+		else if (Dist < -pRef->Radius)
+			Back[NumBack++] = List[l];
+		else
+		{
+			// The light is within range of this plane, mark it and go down both sides
+			Front[NumFront++] = List[l];
+			Back[NumBack++] = List[l];
+			Span[NumSpan++] = List[l];
+		}
 	}
 
-	// The light is within range of this plane, mark it and go down both sides
-	pSInfo = &CBSP->SurfInfo[pNode->FirstFace];
-	for (i=0; i< pNode->NumFaces; i++, pSInfo++)
+	if (NumSpan)
 	{
-		if (!Surf_InSurfBoundingBox(pSInfo, Pos, pLight->Radius) ) 
-			continue;
-		
-		if (pSInfo->DLightFrame != CWorld->CurFrameDynamic)
+		pSInfo = &CBSP->SurfInfo[pNode->FirstFace];
+		for (i=0; i< pNode->NumFaces; i++, pSInfo++)
 		{
-			pSInfo->DLightFrame = CWorld->CurFrameDynamic;
-			pSInfo->DLights = 0;
+			for (l=0; l< NumSpan; l++)
+			{
+				pRef = &DLightRefs[Span[l]];
+
+				if (!Surf_InSurfBoundingBox(pSInfo, &pRef->Pos, pRef->Radius) ) 
+					continue;
+				
+				if (pSInfo->DLightFrame != CWorld->CurFrameDynamic)
+				{
+					pSInfo->DLightFrame = CWorld->CurFrameDynamic;
+					memset(pSInfo->DLights, 0, sizeof(pSInfo->DLights));
+				}
+				
+				pSInfo->DLights[pRef->LNum>>5] |= 1<<(pRef->LNum&31);
+			}
 		}
-		
-		// We might need to go to a linked list, if more than 32 lights are needed
-		pSInfo->DLights |= 1<<LNum;
 	}
 
-	SetupDynamicLight_r(pLight, Pos, LNum, BSPData->GFXNodes[Node].Children[0]);
-	SetupDynamicLight_r(pLight, Pos, LNum, BSPData->GFXNodes[Node].Children[1]);
+	if (NumFront)
+		SetupDynamicLights_r(Front, NumFront, pNode->Children[0]);
+	if (NumBack)
+		SetupDynamicLights_r(Back, NumBack, pNode->Children[1]);
 }
 
+
 //=====================================================================================
 //	Light_GetLightmapRGB
 //	Takes a point, and a face , and gets the light map value it was projected on...
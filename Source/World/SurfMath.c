@@ -0,0 +1,202 @@
+/*******************************************************************************
+Copyright © 2024 Mark E. Sowden <hogsy@oldtimes-software.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************/
+
+
+#include <math.h>
+
+#include "SurfMath.h"
+
+//=====================================================================================
+//	SurfMath_FaceBounds
+//=====================================================================================
+void SurfMath_FaceBounds(const geVec3d *Verts, const int32 *VertIndex, int32 NumVerts, const geVec3d TexVecs[2], 
+						float Mins[2], float Maxs[2], geVec3d *VMins, geVec3d *VMaxs)
+{
+	int32			k, v;
+	float			U, V;
+	const geVec3d	*pVert;
+
+	for (k=0; k<2; k++)
+	{
+		Mins[k] = 99999.0f;
+		Maxs[k] =-99999.0f;
+	}
+	geVec3d_Set(VMins, 99999.0f, 99999.0f, 99999.0f);
+	geVec3d_Set(VMaxs,-99999.0f,-99999.0f,-99999.0f);
+
+	for (v= 0; v< NumVerts; v++)
+	{
+		pVert = &Verts[VertIndex[v]];
+
+		U = geVec3d_DotProduct(pVert, &TexVecs[0]);
+		V = geVec3d_DotProduct(pVert, &TexVecs[1]);
+
+		if (U < Mins[0])
+			Mins[0] = U;
+		if (U > Maxs[0])
+			Maxs[0] = U;
+		if (V < Mins[1])
+			Mins[1] = V;
+		if (V > Maxs[1])
+			Maxs[1] = V;
+
+		if (pVert->X < VMins->X)
+			VMins->X = pVert->X;
+		if (pVert->X > VMaxs->X)
+			VMaxs->X = pVert->X;
+		if (pVert->Y < VMins->Y)
+			VMins->Y = pVert->Y;
+		if (pVert->Y > VMaxs->Y)
+			VMaxs->Y = pVert->Y;
+		if (pVert->Z < VMins->Z)
+			VMins->Z = pVert->Z;
+		if (pVert->Z > VMaxs->Z)
+			VMaxs->Z = pVert->Z;
+	}
+}
+
+//=====================================================================================
+//	SurfMath_LightmapSteps
+//=====================================================================================
+void SurfMath_LightmapSteps(const geVec3d TexVecs[2], int32 *XStep, int32 *YStep, int32 *XScale, int32 *YScale)
+{
+	float	XLen, YLen;
+
+	XLen = geVec3d_Length(&TexVecs[0]);
+	YLen = geVec3d_Length(&TexVecs[1]);
+
+	*XStep = (int32)((16.0f / XLen) * (1<<10));
+	*YStep = (int32)((16.0f / YLen) * (1<<10));
+	*XScale = (int32)((1.0f/XLen) * (1<<10));
+	*YScale = (int32)((1.0f/YLen) * (1<<10));
+}
+
+//=====================================================================================
+//	SurfMath_TextureShift
+//=====================================================================================
+void SurfMath_TextureShift(const float Mins[2], const float Shift[2], const float DrawScale[2], int32 Width, int32 Height, 
+						float *ShiftU, float *ShiftV)
+{
+	float	au, av, ScaleU, ScaleV;
+
+	ScaleU = 1.0f/DrawScale[0];
+	ScaleV = 1.0f/DrawScale[1];
+
+	au = (float)(((int32)((Mins[0]*ScaleU+Shift[0])/Width ))*Width);
+	av = (float)(((int32)((Mins[1]*ScaleV+Shift[1])/Height))*Height);
+
+	*ShiftU = Shift[0] - au;
+	*ShiftV = Shift[1] - av;
+}
+
+//=====================================================================================
+//	SurfMath_LightmapExtents
+//=====================================================================================
+void SurfMath_LightmapExtents(const float Mins[2], const float Maxs[2], int32 Size[2], int32 *MinU, int32 *MinV)
+{
+	float	LMins[2], LMaxs[2];
+	int32	k;
+
+	for (k=0; k< 2; k++)
+	{
+		LMins[k] = (float)floor(Mins[k]/16);
+		LMaxs[k] = (float)ceil(Maxs[k]/16);
+
+		Size[k] = (int32)(LMaxs[k] - LMins[k]) + 1;
+	}
+
+	*MinU = (int32)(LMins[0] * 16);
+	*MinV = (int32)(LMins[1] * 16);
+}
+
+//=====================================================================================
+//	SurfMath_LightmapVectors
+//=====================================================================================
+void SurfMath_LightmapVectors(const geVec3d TexVecs[2], const geVec3d *PlaneNormal, float PlaneDist, geBoolean PlaneSide, 
+						int32 MinU, int32 MinV, geVec3d T2WVecs[2], geVec3d *TexOrg)
+{
+	geVec3d		TexNormal, FaceNormal, Ws[3];
+	float		DistScale, Dist, Len, UU, VV;
+	int32		k;
+
+	geVec3d_CrossProduct(&TexVecs[0], &TexVecs[1], &TexNormal);
+	geVec3d_Normalize(&TexNormal);
+
+	// flip it towards plane normal
+	FaceNormal = *PlaneNormal;
+
+	if (PlaneSide)
+	{
+		geVec3d_Inverse(&FaceNormal);
+		PlaneDist = -PlaneDist;
+	}
+
+	DistScale = geVec3d_DotProduct(&TexNormal, &FaceNormal);
+
+	if (DistScale < 0)
+	{
+		geVec3d_Inverse(&TexNormal);
+		DistScale = -DistScale;
+	}	
+
+	// distscale is the ratio of the distance along the texture normal to
+	// the distance along the plane normal
+	DistScale = 1/DistScale;
+
+	// Get the tex to world vectors
+	for (k=0 ; k<2 ; k++)
+	{
+		Len = geVec3d_Length(&TexVecs[k]);
+		Dist = geVec3d_DotProduct(&TexVecs[k], &FaceNormal);
+		Dist *= DistScale;
+		geVec3d_MA((geVec3d *)&TexVecs[k], -Dist, &TexNormal, &T2WVecs[k]);
+		geVec3d_Scale(&T2WVecs[k], (1/Len)*(1/Len), &T2WVecs[k]);
+	}
+
+	TexOrg->X = - TexVecs[0].Z * T2WVecs[0].X - TexVecs[1].Z * T2WVecs[1].X;
+	TexOrg->Y = - TexVecs[0].Z * T2WVecs[0].Y - TexVecs[1].Z * T2WVecs[1].Y;
+	TexOrg->Z = - TexVecs[0].Z * T2WVecs[0].Z - TexVecs[1].Z * T2WVecs[1].Z;
+
+	Dist = geVec3d_DotProduct(TexOrg, &FaceNormal) - PlaneDist - 1;
+	Dist *= DistScale;
+	geVec3d_MA (TexOrg, -Dist, &TexNormal, TexOrg);
+
+	// Scale them to one lightmap texel, starting at the lightmap mins
+	for (k=0; k<3; k++)
+	{
+		UU = (float)MinU;
+		VV = (float)MinV;
+
+		if (k == 1)
+			UU += 16.0f;
+		if (k == 2)
+			VV += 16.0f;
+
+		Ws[k].X = TexOrg->X + T2WVecs[0].X*UU + T2WVecs[1].X*VV;
+		Ws[k].Y = TexOrg->Y + T2WVecs[0].Y*UU + T2WVecs[1].Y*VV;
+		Ws[k].Z = TexOrg->Z + T2WVecs[0].Z*UU + T2WVecs[1].Z*VV;
+	}
+
+	geVec3d_Subtract(&Ws[1], &Ws[0], &T2WVecs[0]);
+	geVec3d_Subtract(&Ws[2], &Ws[0], &T2WVecs[1]);
+	*TexOrg = Ws[0];
+}
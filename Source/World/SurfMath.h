@@ -0,0 +1,65 @@
+/*******************************************************************************
+Copyright © 2024 Mark E. Sowden <hogsy@oldtimes-software.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************/
+
+
+#ifndef GE_SURFMATH_H
+#define GE_SURFMATH_H
+
+#include "BASETYPE.H"
+#include "VEC3D.H"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//=====================================================================================
+//	Per face surface math
+//
+//	Shared by the engine's Surf_WorldInit and GBSPLib, which bakes the results into
+//	GBSP_CHUNK_SURF_INFO.  Both sides build this file, so a baked face always comes
+//	out the same as one worked out at load.  Only takes plain values, so it doesn't
+//	care which GBSPFILE.H the caller has.
+//=====================================================================================
+
+// Texture space and world space bounds of a face
+void SurfMath_FaceBounds(const geVec3d *Verts, const int32 *VertIndex, int32 NumVerts, const geVec3d TexVecs[2], 
+						float Mins[2], float Maxs[2], geVec3d *VMins, geVec3d *VMaxs);
+
+// Lightmap step values for dlights (1:21:10 fixed)
+void SurfMath_LightmapSteps(const geVec3d TexVecs[2], int32 *XStep, int32 *YStep, int32 *XScale, int32 *YScale);
+
+// Texture shift, interpreting the uv's the same way the drivers will
+void SurfMath_TextureShift(const float Mins[2], const float Shift[2], const float DrawScale[2], int32 Width, int32 Height, 
+						float *ShiftU, float *ShiftV);
+
+// Lightmap size in texels, and its mins in texture space, from the face's texture space bounds
+void SurfMath_LightmapExtents(const float Mins[2], const float Maxs[2], int32 Size[2], int32 *MinU, int32 *MinV);
+
+// Lightmap to world space vectors (one lightmap texel each), and the world space position of texel 0,0
+void SurfMath_LightmapVectors(const geVec3d TexVecs[2], const geVec3d *PlaneNormal, float PlaneDist, geBoolean PlaneSide, 
+						int32 MinU, int32 MinV, geVec3d T2WVecs[2], geVec3d *TexOrg);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
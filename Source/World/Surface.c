@@ -30,6 +30,7 @@
 #include "WBitmap.h"	
 #include "VIS.H"
 #include "LIGHT.H"
+#include "SurfMath.h"
 
 //================================================================================
 //	local static globals
@@ -44,6 +45,7 @@ static	GBSP_BSPData	*BSPData;		// This is in globals, but is also kept here for
 //================================================================================
 static geBoolean GetTexVerts(World_BSP *BSP);
 static geBoolean GetSurfInfo(World_BSP *BSP);
+static geBoolean GetBakedSurfInfo(World_BSP *BSP);
 static geBoolean GetRGBVerts(World_BSP *BSP);
 
 
@@ -134,12 +136,18 @@ geBoolean Surf_WorldInit(geWorld *World)
 	if (!GetTexVerts(BSP))			// Calc texture uv's at vertices...
 		return GE_FALSE;
 
+	// The tools bake the surface info into the GBSP, so most worlds can skip working it out
+	if (GetBakedSurfInfo(BSP))
+	{
+		if (!GetRGBVerts(BSP))		// Calc RGB values at vertices
+			return GE_FALSE;
+
+		return GE_TRUE;
+	}
+
 	if (!GetSurfInfo(BSP))			// Get surface info
 		return GE_FALSE;
 
-	Light_SetWorld(World);
-	Light_SetGBSP(BSP);
-
 	if (!GetRGBVerts(BSP))			// Calc RGB values at vertices
 		return GE_FALSE;
 
@@ -233,157 +241,67 @@ static geBoolean GetTexVerts(World_BSP *BSP)
 
 //================================================================================
 //	GetSurfInfo
+//	The math is in SurfMath.c, which GBSPLib builds too, to bake it into the GBSP
 //================================================================================
 static geBoolean GetSurfInfo(World_BSP *BSP)
 {
 	int32			NumLTypes;
-	int32			i, k, v;
-	int32			vn, Index;
-	float			U, V;
+	int32			i, k;
 	float			Mins[2], Maxs[2];
-	geVec3d			VMins, VMaxs;
 	int32			Size[2];
 	Surf_SurfInfo	*SurfInfo;
-	Surf_TexVert	*TexVerts;
+	GFX_Face		*pFace;
 	GFX_Texture		*pTexture;
 	GFX_TexInfo		*pTexInfo;
 
 	SurfInfo = BSP->SurfInfo;
-	TexVerts = BSP->TexVerts;
 
 	assert(SurfInfo != NULL);
-	assert(TexVerts != NULL);
 
 	memset(SurfInfo, 0, sizeof(Surf_SurfInfo)*(BSP->BSPData.NumGFXFaces));
 
 	for (i=0; i< BSP->BSPData.NumGFXFaces; i++)
 	{
-		float	XScale, YScale;
+		pFace = &BSP->BSPData.GFXFaces[i];
 
 		// Find number of styles
-		NumLTypes = 0;
 		for (NumLTypes = 0; NumLTypes < 4; NumLTypes++) 
 		{
-			if (BSP->BSPData.GFXFaces[i].LTypes[NumLTypes]==255) 
+			if (pFace->LTypes[NumLTypes]==255) 
 				break;
 
-			if (BSP->BSPData.GFXFaces[i].LTypes[NumLTypes] != 0) 
+			if (pFace->LTypes[NumLTypes] != 0) 
 				SurfInfo[i].Flags |= SURFINFO_LTYPED;
 		}
 
 		SurfInfo[i].NumLTypes = NumLTypes;
 
-		SurfInfo[i].TexInfo = BSP->BSPData.GFXFaces[i].TexInfo;
+		SurfInfo[i].TexInfo = pFace->TexInfo;
 
-		pTexInfo = &BSP->BSPData.GFXTexInfo[BSP->BSPData.GFXFaces[i].TexInfo];
-		pTexture = &BSP->BSPData.GFXTextures[BSP->BSPData.GFXTexInfo[SurfInfo[i].TexInfo].Texture];
+		pTexInfo = &BSP->BSPData.GFXTexInfo[pFace->TexInfo];
+		pTexture = &BSP->BSPData.GFXTextures[pTexInfo->Texture];
 		
 		if (pTexInfo->Flags & TEXINFO_TRANS)
 			SurfInfo[i].Flags |= SURFINFO_TRANS;
 
 		// Set up lightmap scaling values for dlights
-		k = BSP->BSPData.GFXFaces[i].TexInfo;
+		SurfMath_LightmapSteps(pTexInfo->Vecs, &SurfInfo[i].XStep, &SurfInfo[i].YStep, &SurfInfo[i].XScale, &SurfInfo[i].YScale);
 
-		XScale = geVec3d_Length(&BSP->BSPData.GFXTexInfo[k].Vecs[0]);
-		YScale = geVec3d_Length(&BSP->BSPData.GFXTexInfo[k].Vecs[1]);
-
-		SurfInfo[i].XStep = (int32)((16.0f / XScale) * (1<<10));
-		SurfInfo[i].YStep = (int32)((16.0f / YScale) * (1<<10));
-		SurfInfo[i].XScale = (int32)((1.0f/XScale) * (1<<10));
-		SurfInfo[i].YScale = (int32)((1.0f/YScale) * (1<<10));
-	}
-
-	//
-	//	Find face/texvert min/max
-	//
-	for (i=0; i< BSP->BSPData.NumGFXFaces; i++)
-	{
-		pTexInfo = &BSP->BSPData.GFXTexInfo[BSP->BSPData.GFXFaces[i].TexInfo];
-		pTexture = &BSP->BSPData.GFXTextures[BSP->BSPData.GFXTexInfo[SurfInfo[i].TexInfo].Texture];
-
-		for (k=0; k<2; k++)
-		{
-			Mins[k] = 99999.0f;
-			Maxs[k] =-99999.0f;
-		}
-		for (k=0; k<3; k++)
-		{
-			VectorToSUB(VMins, k) = 99999.0f;
-			VectorToSUB(VMaxs, k) =-99999.0f;
-		}
-
-		for (v= 0; v< BSP->BSPData.GFXFaces[i].NumVerts; v++)
-		{
-			vn =  v + BSP->BSPData.GFXFaces[i].FirstVert;
-			U = TexVerts[vn].u;
-			V = TexVerts[vn].v;
-
-			if (U < Mins[0])
-				Mins[0] = U;
-			if (U > Maxs[0])
-				Maxs[0] = U;
-			if (V < Mins[1])
-				Mins[1] = V;
-			if (V > Maxs[1])
-				Maxs[1] = V;
-
-			Index = BSP->BSPData.GFXVertIndexList[vn];
-
-			for (k=0; k<3; k++)
-			{
-				if (VectorToSUB(BSP->BSPData.GFXVerts[Index], k) < VectorToSUB(VMins, k))
-					VectorToSUB(VMins, k) = VectorToSUB(BSP->BSPData.GFXVerts[Index], k);
-				if (VectorToSUB(BSP->BSPData.GFXVerts[Index], k) > VectorToSUB(VMaxs, k))
-					VectorToSUB(VMaxs, k) = VectorToSUB(BSP->BSPData.GFXVerts[Index], k);
-			}
-		}
+		// Find face/texvert min/max
+		SurfMath_FaceBounds(BSP->BSPData.GFXVerts, &BSP->BSPData.GFXVertIndexList[pFace->FirstVert], pFace->NumVerts, 
+							pTexInfo->Vecs, Mins, Maxs, &SurfInfo[i].VMins, &SurfInfo[i].VMaxs);
 
 		// Calculate Shift values
-		#if 1
-		{
-			int32			Width, Height;
-			float			au, av, ScaleU, ScaleV;
+		SurfMath_TextureShift(Mins, pTexInfo->Shift, pTexInfo->DrawScale, pTexture->Width, pTexture->Height, 
+							&SurfInfo[i].ShiftU, &SurfInfo[i].ShiftV);
 
-			#if 0
-				pTexInfo->DrawScale[0] = 1.0f;		// For testing
-				pTexInfo->DrawScale[1] = 1.0f;
-			#endif
-
-			ScaleU = 1.0f/pTexInfo->DrawScale[0];
-			ScaleV = 1.0f/pTexInfo->DrawScale[1];
-			
-			Width = pTexture->Width;
-			Height = pTexture->Height;
-
-			// Interpret the uv's the same way the drivers will
-			au = (float)(((int32)((Mins[0]*ScaleU+pTexInfo->Shift[0])/Width ))*Width);
-			av = (float)(((int32)((Mins[1]*ScaleV+pTexInfo->Shift[1])/Height))*Height);
-			//au = (float)(((int32)((Mins[0]*ScaleU)/Width ))*Width);
-			//av = (float)(((int32)((Mins[1]*ScaleV)/Height))*Height);
-
-			SurfInfo[i].ShiftU = pTexInfo->Shift[0] - au;
-			SurfInfo[i].ShiftV = pTexInfo->Shift[1] - av;
-		}
-		#else
-		{
-			SurfInfo[i].ShiftU = pTexInfo->Shift[0];
-			SurfInfo[i].ShiftV = pTexInfo->Shift[1];
-		}
-		#endif
-
-		SurfInfo[i].VMins = VMins;
-		SurfInfo[i].VMaxs = VMaxs;
-
-		if (BSP->BSPData.GFXTexInfo[BSP->BSPData.GFXFaces[i].TexInfo].Flags & TEXINFO_NO_LIGHTMAP)
+		if (pTexInfo->Flags & TEXINFO_NO_LIGHTMAP)
 			continue;
 		
+		SurfMath_LightmapExtents(Mins, Maxs, Size, &SurfInfo[i].LInfo.MinU, &SurfInfo[i].LInfo.MinV);
+
 		for (k=0; k< 2; k++)
 		{
-			Mins[k] = (float)floor(Mins[k]/16);
-			Maxs[k] = (float)ceil(Maxs[k]/16);
-			
-			Size[k] = (S32)(Maxs[k] - Mins[k]) + 1;
-			
 			if (Size[k] > MAX_LMAP_SIZE)
 			{
 				geErrorLog_Add(GE_ERR_BAD_LMAP_EXTENTS, NULL);
@@ -391,80 +309,75 @@ static geBoolean GetSurfInfo(World_BSP *BSP)
 			}
 		}
 
-		//if (Size[0] != BSP->BSPData.GFXFaces[i].LWidth)
-		//	return FALSE;
+		SurfInfo[i].LInfo.Width = (int16)pFace->LWidth;
+		SurfInfo[i].LInfo.Height = (int16)pFace->LHeight;
+		SurfInfo[i].LInfo.Face = i;
 
-		//if (Size[1] != BSP->BSPData.GFXFaces[i].LHeight)
-		//	return FALSE;
+		SurfInfo[i].Flags |= SURFINFO_LIGHTMAP;
+	}
 
-		Size[0] = BSP->BSPData.GFXFaces[i].LWidth;
-		Size[1] = BSP->BSPData.GFXFaces[i].LHeight;
+	if (!Vis_MarkWaterFaces(BSP))
+		return GE_FALSE;
+	
+	return GE_TRUE;
+}
 
-		SurfInfo[i].LInfo.Width = (int16)Size[0];
-		SurfInfo[i].LInfo.Height = (int16)Size[1];
+//================================================================================
+//	GetBakedSurfInfo
+//	Fills in the SurfInfo from GBSP_CHUNK_SURF_INFO, which holds what GetSurfInfo,
+//	Vis_MarkWaterFaces and CalcSurfVectors would have worked out.  Returns GE_FALSE
+//	if the file doesn't have (a usable) one.
+//================================================================================
+static geBoolean GetBakedSurfInfo(World_BSP *BSP)
+{
+	int32			i;
+	Surf_SurfInfo	*SurfInfo;
+	GFX_SurfInfo	*GFXSurfInfo;
+	GFX_Face		*pFace;
 
-		SurfInfo[i].LInfo.MinU = (S32)(Mins[0] * 16);
-		SurfInfo[i].LInfo.MinV = (S32)(Mins[1] * 16);
-		SurfInfo[i].LInfo.Face = i;
+	if (!BSP->BSPData.GFXSurfInfo || BSP->BSPData.NumGFXSurfInfo != BSP->BSPData.NumGFXFaces)
+		return GE_FALSE;
 
-		#if 0
-		{
-			int32		LightOffset, p;
-			uint8		*LightData;
+	SurfInfo = BSP->SurfInfo;
+	GFXSurfInfo = BSP->BSPData.GFXSurfInfo;
+	pFace = BSP->BSPData.GFXFaces;
 
-			LightOffset = BSP->BSPData.GFXFaces[i].LightOfs;
+	assert(SurfInfo != NULL);
 
-			if (LightOffset >= 0)
-			{
-				LightData = &BSP->BSPData.GFXLightData[LightOffset+1];
-
-				for (p=0; p< SurfInfo[i].LInfo.lWidth*SurfInfo[i].LInfo.lHeight; p++)
-				{
-					LightData++;
-					if (*LightData)
-						return GE_FALSE;
-					//*LightData = 0;
-					LightData++;
-					LightData++;
-				}
-			}
-		}
-		#endif
-		
-		#if 0
-		//
-		//	Make sure the lightmap u,v's are legit...
-		//
-		for (v= 0; v< BSP->BSPData.GFXFaces[i].NumVerts; v++)
-		{
-			vn =  v + BSP->BSPData.GFXFaces[i].FirstVert;
+	memset(SurfInfo, 0, sizeof(Surf_SurfInfo)*(BSP->BSPData.NumGFXFaces));
 
-			U = TexVerts[vn].u - SurfInfo[i].LInfo.MinU;
-			V = TexVerts[vn].v - SurfInfo[i].LInfo.MinV;
-			
-			if (U < 0 || V > 16*128)
-			{
-				SurfInfo[i].LInfo.Face = -1;
-				//geErrorLog_Add(GE_ERR_BAD_LMAP_EXTENTS, NULL);
-				//return GE_FALSE;
-			}	
-			if (V < 0 || V > 16*128)
-			{
-				SurfInfo[i].LInfo.Face = -1;
-				//geErrorLog_Add(GE_ERR_BAD_LMAP_EXTENTS, NULL);
-				//return GE_FALSE;
-			}
-			
-		}
-		#endif
+	for (i=0; i< BSP->BSPData.NumGFXFaces; i++, SurfInfo++, GFXSurfInfo++, pFace++)
+	{
+		SurfInfo->T2WVecs[0] = GFXSurfInfo->T2WVecs[0];
+		SurfInfo->T2WVecs[1] = GFXSurfInfo->T2WVecs[1];
+		SurfInfo->TexOrg = GFXSurfInfo->TexOrg;
+		SurfInfo->VMins = GFXSurfInfo->VMins;
+		SurfInfo->VMaxs = GFXSurfInfo->VMaxs;
 
-		SurfInfo[i].Flags |= SURFINFO_LIGHTMAP;
-		//CalcGFXFaceVectors(i);
+		SurfInfo->TexInfo = pFace->TexInfo;
+
+		SurfInfo->XStep = GFXSurfInfo->XStep;
+		SurfInfo->YStep = GFXSurfInfo->YStep;
+		SurfInfo->XScale = GFXSurfInfo->XScale;
+		SurfInfo->YScale = GFXSurfInfo->YScale;
+
+		SurfInfo->ShiftU = GFXSurfInfo->ShiftU;
+		SurfInfo->ShiftV = GFXSurfInfo->ShiftV;
+
+		SurfInfo->NumLTypes = GFXSurfInfo->NumLTypes;
+		SurfInfo->Flags = GFXSurfInfo->Flags;			// GFX_SURF_ and SURFINFO_ are the same bits
+
+		if (!(SurfInfo->Flags & SURFINFO_LIGHTMAP))
+			continue;
+
+		SurfInfo->LInfo.Width = (int16)pFace->LWidth;
+		SurfInfo->LInfo.Height = (int16)pFace->LHeight;
+
+		SurfInfo->LInfo.MinU = GFXSurfInfo->LMinU;
+		SurfInfo->LInfo.MinV = GFXSurfInfo->LMinV;
+		SurfInfo->LInfo.Face = i;
 	}
 
-	if (!Vis_MarkWaterFaces(BSP))
-		return GE_FALSE;
-	
 	return GE_TRUE;
 }
 
@@ -524,102 +437,18 @@ static geBoolean GetRGBVerts(World_BSP *BSP)
 //***************************************************************************************
 void CalcSurfVectors (World_BSP *BSP)
 {
-	Surf_SurfInfo	*pSurfInfo, *Si;
-	GFX_TexInfo		*Tex;
-	geVec3d			TexNormal;
-	geVec3d			FaceNormal;
-	float			DistScale, PlaneDist;
-	float			Dist, Len;
-	geVec3d			Ws[3];
-	int32			i, k;
-	GBSP_BSPData	*BSPData;
-	GFX_Plane		*GFXPlanes;
+	Surf_SurfInfo	*Si;
 	GFX_Face		*pFace;
-	int32			Startx, Starty;
-	float			UU, VV;
-
-	BSPData = &BSP->BSPData;
-	
-	pSurfInfo = BSP->SurfInfo;
-
-	GFXPlanes = BSPData->GFXPlanes;
+	GFX_Plane		*pPlane;
+	int32			i;
 
 	for (i=0; i< BSP->BSPData.NumGFXFaces; i++)
 	{
-		Si = &pSurfInfo[i];
-
-		pFace = &BSPData->GFXFaces[i];
-
-		Tex = &BSPData->GFXTexInfo[pFace->TexInfo];
-	
-		geVec3d_CrossProduct(&Tex->Vecs[0], &Tex->Vecs[1], &TexNormal);
-		geVec3d_Normalize(&TexNormal);
-
-		// flip it towards plane normal
-		FaceNormal = GFXPlanes[pFace->PlaneNum].Normal;
-		PlaneDist = GFXPlanes[pFace->PlaneNum].Dist;
-
-		if (pFace->PlaneSide)
-		{
-			geVec3d_Inverse(&FaceNormal);
-			PlaneDist = -PlaneDist;
-		}
-	
-		DistScale = geVec3d_DotProduct(&TexNormal, &FaceNormal);
-	
-		if (DistScale < 0)
-		{
-			geVec3d_Inverse(&TexNormal);
-			DistScale = -DistScale;
-		}	
-
-		// distscale is the ratio of the distance along the texture normal to
-		// the distance along the plane normal
-		DistScale = 1/DistScale;
-
-		// Get the tex to world vectors
-		for (k=0 ; k<2 ; k++)
-		{
-			Len = geVec3d_Length(&Tex->Vecs[k]);
-			Dist = geVec3d_DotProduct(&Tex->Vecs[k], &FaceNormal);
-			Dist *= DistScale;
-			geVec3d_MA(&Tex->Vecs[k], -Dist, &TexNormal, &Si->T2WVecs[k]);
-			geVec3d_Scale(&Si->T2WVecs[k], (1/Len)*(1/Len), &Si->T2WVecs[k]);
-		}
-
-
-		for (k=0 ; k<3 ; k++)
-			VectorToSUB(Si->TexOrg,k) = 
-				- Tex->Vecs[0].Z * VectorToSUB(Si->T2WVecs[0], k) 
-			    - Tex->Vecs[1].Z * VectorToSUB(Si->T2WVecs[1], k);
-
-		Dist = geVec3d_DotProduct(&Si->TexOrg, &FaceNormal) - PlaneDist - 1;
-		Dist *= DistScale;
-		geVec3d_MA (&Si->TexOrg, -Dist, &TexNormal, &Si->TexOrg);
+		Si = &BSP->SurfInfo[i];
+		pFace = &BSP->BSPData.GFXFaces[i];
+		pPlane = &BSP->BSPData.GFXPlanes[pFace->PlaneNum];
 
-		Startx = Si->LInfo.MinU;
-		Starty = Si->LInfo.MinV;
-	
-		UU = (float)Startx;
-		VV = (float)Starty;
-	
-		Ws[0].X = Si->TexOrg.X + Si->T2WVecs[0].X*UU + Si->T2WVecs[1].X*VV;
-		Ws[0].Y = Si->TexOrg.Y + Si->T2WVecs[0].Y*UU + Si->T2WVecs[1].Y*VV;
-		Ws[0].Z = Si->TexOrg.Z + Si->T2WVecs[0].Z*UU + Si->T2WVecs[1].Z*VV;
-		UU = (float)Startx+16.0f;
-		VV = (float)Starty;
-		Ws[1].X = Si->TexOrg.X + Si->T2WVecs[0].X*UU + Si->T2WVecs[1].X*VV;
-		Ws[1].Y = Si->TexOrg.Y + Si->T2WVecs[0].Y*UU + Si->T2WVecs[1].Y*VV;
-		Ws[1].Z = Si->TexOrg.Z + Si->T2WVecs[0].Z*UU + Si->T2WVecs[1].Z*VV;
-		UU = (float)Startx;
-		VV = (float)Starty+16.0f;
-		Ws[2].X = Si->TexOrg.X + Si->T2WVecs[0].X*UU + Si->T2WVecs[1].X*VV;
-		Ws[2].Y = Si->TexOrg.Y + Si->T2WVecs[0].Y*UU + Si->T2WVecs[1].Y*VV;
-		Ws[2].Z = Si->TexOrg.Z + Si->T2WVecs[0].Z*UU + Si->T2WVecs[1].Z*VV;
-
-		geVec3d_Subtract(&Ws[1], &Ws[0], &Si->T2WVecs[0]);
-		geVec3d_Subtract(&Ws[2], &Ws[0], &Si->T2WVecs[1]);
-		Si->TexOrg = Ws[0];
+		SurfMath_LightmapVectors(BSP->BSPData.GFXTexInfo[pFace->TexInfo].Vecs, &pPlane->Normal, pPlane->Dist, pFace->PlaneSide, 
+								Si->LInfo.MinU, Si->LInfo.MinV, Si->T2WVecs, &Si->TexOrg);
 	}
-   
 }
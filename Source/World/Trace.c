@@ -20,6 +20,8 @@
 /*                                                                                      */
 /****************************************************************************************/
 #include <assert.h>
+#include <stdlib.h>
+#include <string.h>
 
 #include "XFORM3D.H"
 #include "BASETYPE.H"
@@ -30,43 +32,210 @@
 #include "TRACE.H"
 #include "ExtBox.h"
 #include "actor.h"
+#include "ActorGrid.h"
+#include "RAM.H"
+#include "Errorlog.h"
+#include "geThread.h"
 
 #define ON_EPSILON	(0.1f)
 
 //=====================================================================================
 //	Local Static Globals
+//	All the per trace state lives in a Trace_Context, only the stats are shared
 //=====================================================================================
+static  int32			GlobalNNode[2]={0x696C6345,0x21657370};
 
-// Globals returned in the bsp subdivision code
-static	int32			GPlaneNum;
-static	GFX_Plane		GlobalPlane;
-static	int32			GlobalNode;
-static	int32			GlobalSide;
-static	geVec3d			GlobalI;
-static	float			GRatio;
-static	int32			GlobalLeaf;
-static	int32			GlobalLeaf;
+volatile int32	NumExactCast;
+volatile int32	NumBBoxCast;
+volatile int32	NumGetContents;
 
-static	GBSP_BSPData	*BSPData;
+//=====================================================================================
+//	Local Static Function Prototypes
+//=====================================================================================
+static geBoolean BSPIntersect(Trace_Context *Ctx, const geVec3d *Front, const geVec3d *Back, int32 Node, geBoolean RecordHit);
 
-// Globals passed to the bsp subdivision code
-static	uint32			gContents;			// Contents that we should collide with for the current collision tests...
+//=====================================================================================
+//	TraceNode_Distance
+//	Axial planes only need the one component
+//=====================================================================================
+static inline float TraceNode_Distance(const GFX_TraceNode *Node, const geVec3d *Point)
+{
+	switch (Node->Type)
+	{
+		case PLANE_X:
+			return Point->X - Node->Dist;
+		case PLANE_Y:
+			return Point->Y - Node->Dist;
+		case PLANE_Z:
+			return Point->Z - Node->Dist;
+		default:
+			return geVec3d_DotProduct(Point, &Node->Normal) - Node->Dist;
+	}
+}
 
-static	BOOL			UseMinsMaxs;		// If MiscCollision should use mins maxs...
+//=====================================================================================
+//	TraceNode_BoxOnPlaneSide
+//	Trace_BoxOnPlaneSide for packed nodes, returns PSIDE_FRONT, PSIDE_BACK, or PSIDE_BOTH
+//=====================================================================================
+static inline int32 TraceNode_BoxOnPlaneSide(const GFX_TraceNode *Node, const geVec3d *Mins, const geVec3d *Maxs)
+{
+	int32	Side;
+	float	Dist1, Dist2;
 
-static	BOOL			HitSet;
-static  int32			GlobalNNode[2]={0x696C6345,0x21657370};
+	// Axial planes are easy
+	if (Node->Type < PLANE_ANYX)
+	{
+		Side = 0;
+		if (VectorToSUB(*Maxs, Node->Type) >= Node->Dist)
+			Side |= PSIDE_FRONT;
+		if (VectorToSUB(*Mins, Node->Type) < Node->Dist)
+			Side |= PSIDE_BACK;
+		return Side;
+	}
 
-int32	NumExactCast;
-int32	NumBBoxCast;
-int32	NumGetContents;
+	// Leading and trailing corners of the box
+	Dist1 = Dist2 = -Node->Dist;
+
+	if (Node->Normal.X < 0)
+	{
+		Dist1 += Node->Normal.X * Mins->X;
+		Dist2 += Node->Normal.X * Maxs->X;
+	}
+	else
+	{
+		Dist1 += Node->Normal.X * Maxs->X;
+		Dist2 += Node->Normal.X * Mins->X;
+	}
+
+	if (Node->Normal.Y < 0)
+	{
+		Dist1 += Node->Normal.Y * Mins->Y;
+		Dist2 += Node->Normal.Y * Maxs->Y;
+	}
+	else
+	{
+		Dist1 += Node->Normal.Y * Maxs->Y;
+		Dist2 += Node->Normal.Y * Mins->Y;
+	}
+
+	if (Node->Normal.Z < 0)
+	{
+		Dist1 += Node->Normal.Z * Mins->Z;
+		Dist2 += Node->Normal.Z * Maxs->Z;
+	}
+	else
+	{
+		Dist1 += Node->Normal.Z * Maxs->Z;
+		Dist2 += Node->Normal.Z * Mins->Z;
+	}
+
+	Side = 0;
+	if (Dist1 >= 0)
+		Side = PSIDE_FRONT;
+	if (Dist2 < 0)
+		Side |= PSIDE_BACK;
+
+	return Side;
+}
 
 //=====================================================================================
-//	Local Static Function Prototypes
+//	Trace_RootNode
+//	GFXNodes index (or leaf) -> GFXTraceNodes index (or leaf)
 //=====================================================================================
-static geBoolean BSPIntersect(geVec3d *Front, geVec3d *Back, int32 Node);
+static inline int32 Trace_RootNode(const GBSP_BSPData *BSP, int32 Node)
+{
+	if (Node < 0)
+		return Node;			// Tree is a single leaf
 
+	assert(Node < BSP->NumGFXNodes);
+	assert(BSP->GFXTraceRemap[Node] >= 0);
 
+	return BSP->GFXTraceRemap[Node];
+}
+
+//=====================================================================================
+//	Trace_InitContext
+//=====================================================================================
+static void Trace_InitContext(Trace_Context *Ctx, const geWorld *World, uint32 Contents)
+{
+	memset(Ctx, 0, sizeof(*Ctx));
+
+	Ctx->BSPData = &World->CurrentBSP->BSPData;
+	Ctx->Contents = Contents;
+	Ctx->PlaneNum = -1;
+
+	Ctx->Planes = Ctx->BSPData->GFXPlanes;
+	Ctx->Leafs = Ctx->BSPData->GFXLeafs;
+	Ctx->Sides = Ctx->BSPData->GFXLeafSides;
+}
+
+
+
+typedef struct
+{
+	const geVec3d	*Mins, *Maxs;
+	const geVec3d	*Front, *Back;
+	geVec3d			RayDirection;
+	geFloat			RayLength;
+	uint32			UserFlags;
+	GE_CollisionCB	*CollisionCB;
+	void			*Context;
+
+	World_Actor		*BestWA;
+	geFloat			*BestD;
+	geVec3d			*CollisionPoint;
+	GFX_Plane		*BestPlane;
+} Trace_ActorCollideInfo;
+
+//=====================================================================================
+//	ActorCollide
+//	ActorGrid_Query callback for Trace_ActorCollide, the grid already checked the move box
+//=====================================================================================
+static geBoolean ActorCollide(World_Actor *WA, void *Context)
+{
+	Trace_ActorCollideInfo	*Info = (Trace_ActorCollideInfo*)Context;
+	geExtBox				B;
+	geVec3d					Normal;
+	geFloat					Dist;
+
+	// Reject if not active or if userflags don't accept...
+	if (!(WA->Flags & GE_ACTOR_COLLIDE) || !(WA->UserFlags & Info->UserFlags) )
+		return GE_TRUE;
+
+	if (Info->CollisionCB && !Info->CollisionCB(NULL, WA->Actor, Info->Context))
+		return GE_TRUE;
+
+	B = WA->Box;
+
+	geVec3d_Subtract(&B.Min, Info->Maxs, &B.Min);
+	geVec3d_Subtract(&B.Max, Info->Mins, &B.Max);
+						
+	if (!geExtBox_RayCollision( &B, Info->Front, Info->Back, &Dist, &Normal ))
+		return GE_TRUE;
+
+	//Dist -= 0.01f;
+	if (Dist < 0.0f)
+		Dist = 0.0f;
+	if (Dist > 1.0f)
+		Dist = 1.0f;
+
+	Dist *= Info->RayLength;
+
+	// The grid hands out actors in any order, so break ties on the array index like the old loop did
+	if (Dist < *Info->BestD || (Dist == *Info->BestD && Info->BestWA && WA < Info->BestWA))
+	{
+		Info->BestWA = WA;
+		*Info->BestD = Dist;
+		Info->BestPlane->Normal = Normal;
+										
+		geVec3d_AddScaled(Info->Front,&Info->RayDirection,Dist,Info->CollisionPoint);
+		Info->BestPlane->Dist = geVec3d_DotProduct(Info->CollisionPoint,&Normal);
+										
+		Info->BestPlane->Type = PLANE_ANY;
+	}
+
+	return GE_TRUE;
+}
 
 static geActor *Trace_ActorCollide(geWorld *World,
 								   const geVec3d *Mins, const geVec3d *Maxs,
@@ -74,15 +243,9 @@ static geActor *Trace_ActorCollide(geWorld *World,
 								   geVec3d *CollisionPoint,GFX_Plane *BestPlane,
 								   uint32 UserFlags, GE_CollisionCB *CollisionCB, void *Context, geFloat *BestD  )
 {
-	int i,Count;
-	World_Actor *WA;
-	geVec3d RayDirection;
-	geFloat RayLength;
-	geFloat Dist;
-	geActor *BestActor = NULL;
+	Trace_ActorCollideInfo	Info;
 	geVec3d	FakeMins = {-1.0f, -1.0f, -1.0f};
 	geVec3d	FakeMaxs = { 1.0f,  1.0f,  1.0f};
-	int32	k;
 	geVec3d	OMins, OMaxs;
 	
 	if (!Mins)
@@ -91,69 +254,28 @@ static geActor *Trace_ActorCollide(geWorld *World,
 	if (!Maxs)
 		Maxs = &FakeMaxs;
 
-	geVec3d_Subtract(Back,Front,&RayDirection);
-	RayLength = geVec3d_Normalize(&RayDirection);
-
-	Count = World->ActorCount;
-	WA = &(World->ActorArray[0]);
+	if (!World->ActorCount)
+		return NULL;
+
+	Info.Mins = Mins;
+	Info.Maxs = Maxs;
+	Info.Front = Front;
+	Info.Back = Back;
+	geVec3d_Subtract(Back,Front,&Info.RayDirection);
+	Info.RayLength = geVec3d_Normalize(&Info.RayDirection);
+	Info.UserFlags = UserFlags;
+	Info.CollisionCB = CollisionCB;
+	Info.Context = Context;
+	Info.BestWA = NULL;
+	Info.BestD = BestD;
+	Info.CollisionPoint = CollisionPoint;
+	Info.BestPlane = BestPlane;
 
 	Trace_GetMoveBox(Mins, Maxs, Front, Back, &OMins, &OMaxs);
 
-	for (i=0; i<Count; i++, WA++)
-	{
-		geExtBox B;
-		geVec3d Normal;
-		
-		// Reject if not active or if userflags don't accept...
-		if (!(WA->Flags & GE_ACTOR_COLLIDE) || !(WA->UserFlags & UserFlags) )
-			continue;
+	ActorGrid_Query(World, &OMins, &OMaxs, ActorCollide, &Info);
 
-		if (CollisionCB && !CollisionCB(NULL, WA->Actor, Context))
-			continue;
-
-		if (!geActor_GetExtBox(WA->Actor, &B))
-			continue;
-							
-		for (k=0; k<3; k++)
-		{
-			if (geVec3d_GetElement(&OMaxs, k) < geVec3d_GetElement(&B.Min, k))
-				break;
-
-			if (geVec3d_GetElement(&OMins, k) > geVec3d_GetElement(&B.Max, k))
-				break;
-		}
-		
-		if (k != 3)
-			continue;
-		
-		geVec3d_Subtract(&B.Min, Maxs, &B.Min);
-		geVec3d_Subtract(&B.Max, Mins, &B.Max);
-							
-		if (!geExtBox_RayCollision( &B, Front, Back, &Dist, &Normal ))
-			continue;
-
-		//Dist -= 0.01f;
-		if (Dist < 0.0f)
-			Dist = 0.0f;
-		if (Dist > 1.0f)
-			Dist = 1.0f;
-
-		Dist *= RayLength;
-
-		if (Dist < *BestD)
-		{
-			BestActor = WA->Actor;
-			*BestD = Dist;
-			BestPlane->Normal = Normal;
-											
-			geVec3d_AddScaled(Front,&RayDirection,Dist,CollisionPoint);
-			BestPlane->Dist = geVec3d_DotProduct(CollisionPoint,&Normal);
-											
-			BestPlane->Type = PLANE_ANY;
-		}
-	}
-
-	return BestActor;
+	return Info.BestWA ? Info.BestWA->Actor : NULL;
 }
 
 
@@ -169,6 +291,7 @@ geBoolean Trace_GEWorldCollision(geWorld *World, const geVec3d *Mins, const geVe
 	geWorld_Model	*Model;
 	Mesh_RenderQ	*Mesh;
 	geActor     *Actor;
+	Trace_Context	Ctx;
 
 	assert(World != NULL);
 	assert(World->CurrentBSP != NULL);
@@ -176,10 +299,8 @@ geBoolean Trace_GEWorldCollision(geWorld *World, const geVec3d *Mins, const geVe
 	assert(Back!= NULL);
 	assert(Contents);			// It does not make sense to collide with nothing!!!
 	
-	// Set the global contents to collide with
-	gContents = Contents;
-
-	BSPData = &World->CurrentBSP->BSPData;
+	// Set the contents to collide with
+	Trace_InitContext(&Ctx, World, Contents);
 
 	// Reset all the collision feedback pointers
 	Model = NULL;
@@ -190,8 +311,8 @@ geBoolean Trace_GEWorldCollision(geWorld *World, const geVec3d *Mins, const geVe
 
 	if (Mins && Maxs)
 	{
-		NumBBoxCast++;
-		if (Trace_WorldCollisionBBox(World, Mins, Maxs, Front, Back, CollideFlags, &I, &Plane, &Model, &Mesh, &Actor, UserFlags, CollisionCB, Context))
+		geAtomic_Add(&NumBBoxCast, 1);
+		if (Trace_WorldCollisionBBox(&Ctx, World, Mins, Maxs, Front, Back, CollideFlags, &I, &Plane, &Model, &Mesh, &Actor, UserFlags, CollisionCB, Context))
 		{
 			
 			Col->Impact = I;
@@ -202,15 +323,15 @@ geBoolean Trace_GEWorldCollision(geWorld *World, const geVec3d *Mins, const geVe
 			Col->Mesh = (geMesh*)Mesh;
 			Col->Actor = Actor;
 
-			Col->Ratio = GRatio;
+			Col->Ratio = Ctx.Ratio;
 			return GE_TRUE;
 		}
 	}
 	else 
 	{
-		NumExactCast++;
+		geAtomic_Add(&NumExactCast, 1);
 
-		if (Trace_WorldCollisionExact(World, Front, Back, CollideFlags, &I, &Plane, &Model, &Mesh, &Actor, UserFlags, CollisionCB, Context))
+		if (Trace_WorldCollisionExact(&Ctx, World, Front, Back, CollideFlags, &I, &Plane, &Model, &Mesh, &Actor, UserFlags, CollisionCB, Context))
 		{
 			Col->Impact = I;
 			Col->Plane.Normal = Plane.Normal;
@@ -220,7 +341,7 @@ geBoolean Trace_GEWorldCollision(geWorld *World, const geVec3d *Mins, const geVe
 			Col->Mesh = (geMesh*)Mesh;
 			Col->Actor = Actor;
 
-			Col->Ratio = GRatio;
+			Col->Ratio = Ctx.Ratio;
 
 			return GE_TRUE;
 		}
@@ -228,10 +349,235 @@ geBoolean Trace_GEWorldCollision(geWorld *World, const geVec3d *Mins, const geVe
 	return GE_FALSE;
 }
 
+//=====================================================================================
+//	Trace_CollisionBatch
+//	Runs Trace_GEWorldCollision for a batch of queries.  The queries are run sorted by
+//	the world leaf they start in (and then by position), so consecutive traces walk the
+//	same part of the tree.  Identical queries end up next to each other, and only the
+//	first one gets traced.  Big batches without a callback are split up in runs of
+//	sorted queries, and the runs are traced on worker threads.
+//=====================================================================================
+typedef struct
+{
+	int32					Leaf;
+	const GE_CollisionQuery	*Query;
+} Trace_BatchKey;
+
+static int Trace_BatchKeyCompare(const void *a, const void *b)
+{
+	const Trace_BatchKey	*Key1 = (const Trace_BatchKey*)a;
+	const Trace_BatchKey	*Key2 = (const Trace_BatchKey*)b;
+	const geVec3d			*V1[2], *V2[2];
+	int32					i;
+
+	if (Key1->Leaf != Key2->Leaf)
+		return (Key1->Leaf < Key2->Leaf) ? -1 : 1;
+
+	V1[0] = &Key1->Query->Front;
+	V1[1] = &Key1->Query->Back;
+	V2[0] = &Key2->Query->Front;
+	V2[1] = &Key2->Query->Back;
+
+	for (i=0; i< 2; i++)
+	{
+		if (V1[i]->X != V2[i]->X)
+			return (V1[i]->X < V2[i]->X) ? -1 : 1;
+		if (V1[i]->Y != V2[i]->Y)
+			return (V1[i]->Y < V2[i]->Y) ? -1 : 1;
+		if (V1[i]->Z != V2[i]->Z)
+			return (V1[i]->Z < V2[i]->Z) ? -1 : 1;
+	}
+
+	// Keep the order stable, qsort isn't
+	return (Key1->Query < Key2->Query) ? -1 : (Key1->Query > Key2->Query);
+}
+
+static int32 Trace_FindLeaf(const GBSP_BSPData *BSP, int32 Node, const geVec3d *Pos)
+{
+	const GFX_TraceNode	*TNode;
+
+	Node = Trace_RootNode(BSP, Node);
+
+	while (Node >= 0)
+	{
+		TNode = &BSP->GFXTraceNodes[Node];
+		Node = TNode->Children[TraceNode_Distance(TNode, Pos) < 0];
+	}
+
+	return -(Node+1);
+}
+
+static geBoolean Trace_SameBox(const geVec3d *V1, const geVec3d *V2)
+{
+	if (!V1 || !V2)
+		return V1 == V2;
+
+	return V1 == V2 || geVec3d_Compare(V1, V2, 0.0f);
+}
+
+static geBoolean Trace_SameQuery(const GE_CollisionQuery *Q1, const GE_CollisionQuery *Q2)
+{
+	if (!geVec3d_Compare(&Q1->Front, &Q2->Front, 0.0f) || !geVec3d_Compare(&Q1->Back, &Q2->Back, 0.0f))
+		return GE_FALSE;
+
+	return Trace_SameBox(Q1->Mins, Q2->Mins) && Trace_SameBox(Q1->Maxs, Q2->Maxs);
+}
+
+#define TRACE_BATCH_STACK_KEYS		64
+#define TRACE_BATCH_CHUNK			64		// Queries per work item when the batch is split across threads
+#define TRACE_BATCH_MIN_THREADED	256		// Smaller batches aren't worth starting threads for
+
+typedef struct
+{
+	geWorld				*World;
+	Trace_BatchKey		*Keys;
+	int32				NumQueries;
+	uint32				Contents;
+	uint32				CollideFlags;
+	uint32				UserFlags;
+	GE_CollisionCB		*CollisionCB;
+	void				*Context;
+} Trace_BatchInfo;
+
+//=====================================================================================
+//	Trace_RunBatchKeys
+//	Traces the sorted queries [Start, End).  Results are only shared inside the range,
+//	so ranges can run on different threads.
+//=====================================================================================
+static void Trace_RunBatchKeys(const Trace_BatchInfo *Info, int32 Start, int32 End)
+{
+	GE_CollisionQuery	*Query, *Prev;
+	int32				i;
+
+	Prev = NULL;
+
+	for (i=Start; i< End; i++)
+	{
+		Query = (GE_CollisionQuery*)Info->Keys[i].Query;
+
+		// The callback could be keeping track of what it was asked, so only share results without one
+		if (Prev && !Info->CollisionCB && Trace_SameQuery(Prev, Query))
+		{
+			Query->Hit = Prev->Hit;
+			Query->Collision = Prev->Collision;
+		}
+		else
+		{
+			Query->Hit = Trace_GEWorldCollision(Info->World, Query->Mins, Query->Maxs, &Query->Front, &Query->Back, Info->Contents, Info->CollideFlags, Info->UserFlags, Info->CollisionCB, Info->Context, &Query->Collision);
+
+			if (!Query->Hit)
+				memset(&Query->Collision, 0, sizeof(Query->Collision));
+
+			Prev = Query;
+		}
+	}
+}
+
+static geBoolean Trace_BatchWork(int32 ThreadNum, int32 WorkNum, void *Context)
+{
+	Trace_BatchInfo		*Info = (Trace_BatchInfo*)Context;
+	int32				Start, End;
+
+	Start = WorkNum * TRACE_BATCH_CHUNK;
+	End = Start + TRACE_BATCH_CHUNK;
+
+	if (End > Info->NumQueries)
+		End = Info->NumQueries;
+
+	Trace_RunBatchKeys(Info, Start, End);
+
+	return GE_TRUE;
+}
+
+geBoolean Trace_CollisionBatch(	geWorld *World, 
+								GE_CollisionQuery *Queries, 
+								int32 NumQueries, 
+								uint32 Contents, 
+								uint32 CollideFlags, 
+								uint32 UserFlags, 
+								GE_CollisionCB *CollisionCB, 
+								void *Context)
+{
+	Trace_BatchKey		StackKeys[TRACE_BATCH_STACK_KEYS], *Keys;
+	Trace_BatchInfo		Info;
+	GBSP_BSPData		*BSP;
+	geBoolean			AnyHit;
+	int32				i;
+
+	assert(World != NULL);
+	assert(World->CurrentBSP != NULL);
+	assert(Queries != NULL || NumQueries == 0);
+
+	if (NumQueries <= 0)
+		return GE_FALSE;
+
+	if (NumQueries <= TRACE_BATCH_STACK_KEYS)
+		Keys = StackKeys;
+	else
+	{
+		Keys = GE_RAM_ALLOCATE_ARRAY(Trace_BatchKey, NumQueries);
+
+		if (!Keys)
+		{
+			geErrorLog_Add(GE_ERR_OUT_OF_MEMORY, NULL);
+			return GE_FALSE;
+		}
+	}
+
+	BSP = &World->CurrentBSP->BSPData;
+
+	for (i=0; i< NumQueries; i++)
+	{
+		Keys[i].Query = &Queries[i];
+
+		if (BSP->NumGFXModels > 0 && BSP->NumGFXTraceNodes > 0)
+			Keys[i].Leaf = Trace_FindLeaf(BSP, BSP->GFXModels[0].RootNode[0], &Queries[i].Front);
+		else
+			Keys[i].Leaf = 0;
+	}
+
+	qsort(Keys, NumQueries, sizeof(Keys[0]), Trace_BatchKeyCompare);
+
+	Info.World = World;
+	Info.Keys = Keys;
+	Info.NumQueries = NumQueries;
+	Info.Contents = Contents;
+	Info.CollideFlags = CollideFlags;
+	Info.UserFlags = UserFlags;
+	Info.CollisionCB = CollisionCB;
+	Info.Context = Context;
+
+	// The callback may not expect to be called from other threads, so only split the batch without one
+	if (!CollisionCB && NumQueries >= TRACE_BATCH_MIN_THREADED)
+	{
+		// Get the actor grid up to date here, instead of having the threads wait on each other for it
+		if (CollideFlags & GE_COLLIDE_ACTORS)
+			ActorGrid_Refresh(World);
+
+		geThread_RunOnIndividual((NumQueries + TRACE_BATCH_CHUNK - 1) / TRACE_BATCH_CHUNK, 0, Trace_BatchWork, &Info);
+	}
+	else
+		Trace_RunBatchKeys(&Info, 0, NumQueries);
+
+	if (Keys != StackKeys)
+		geRam_Free(Keys);
+
+	AnyHit = GE_FALSE;
+
+	for (i=0; i< NumQueries; i++)
+	{
+		if (Queries[i].Hit)
+			AnyHit = GE_TRUE;
+	}
+
+	return AnyHit;
+}
+
 //=====================================================================================
 //	Trace_WorldCollisionExact
 //=====================================================================================
-geBoolean Trace_WorldCollisionExact(geWorld *World, 
+geBoolean Trace_WorldCollisionExact(Trace_Context *Ctx,
+									geWorld *World, 
 									const geVec3d *Front, 
 									const geVec3d *Back, 
 									uint32 Flags,
@@ -261,8 +607,8 @@ geBoolean Trace_WorldCollisionExact(geWorld *World,
 	assert(World->CurrentBSP != NULL);
 	assert(Front != NULL);
 	assert(Back!= NULL);
+	assert(Ctx->BSPData == &World->CurrentBSP->BSPData);
 	
-	BSPData = &World->CurrentBSP->BSPData;
 	Models = World->CurrentBSP->Models;
 	
 	// Clear mesh/model collision pointers
@@ -294,7 +640,7 @@ geBoolean Trace_WorldCollisionExact(geWorld *World,
 
 	Trace_GetMoveBox(&MMins, &MMaxs, Front, Back, &OMins, &OMaxs);
 
-	for (i = 0; i < BSPData->NumGFXModels; i++, Models++)
+	for (i = 0; i < Ctx->BSPData->NumGFXModels; i++, Models++)
 	{
 		// First, give the caller a chance to reject the model
 		if (CollisionCB && !CollisionCB(Models, NULL, Context))
@@ -323,31 +669,31 @@ geBoolean Trace_WorldCollisionExact(geWorld *World,
 		geVec3d_Add(&NewFront2, &Models->Pivot, &NewFront1);
 		geVec3d_Add(&NewBack2 , &Models->Pivot, &NewBack1);
 		
-		HitSet = FALSE;
+		Ctx->HitSet = FALSE;
 
-		if (BSPIntersect(&NewFront1, &NewBack1, BSPData->GFXModels[i].RootNode[0]))
+		if (BSPIntersect(Ctx, &NewFront1, &NewBack1, Trace_RootNode(Ctx->BSPData, Ctx->BSPData->GFXModels[i].RootNode[0]), GE_TRUE))
 		{
 			// Rotate the impact plane
-			geXForm3d_Rotate(&Models->XForm, &GlobalPlane.Normal, &GlobalPlane.Normal);
+			geXForm3d_Rotate(&Models->XForm, &Ctx->Plane.Normal, &Ctx->Plane.Normal);
 			
 			// Rotate the impact point
-			geVec3d_Subtract(&GlobalI, &Models->Pivot, &GlobalI);
-			geXForm3d_Transform(&Models->XForm, &GlobalI, &GlobalI);
-			geVec3d_Add(&GlobalI, &Models->Pivot, &GlobalI);
+			geVec3d_Subtract(&Ctx->I, &Models->Pivot, &Ctx->I);
+			geXForm3d_Transform(&Models->XForm, &Ctx->I, &Ctx->I);
+			geVec3d_Add(&Ctx->I, &Models->Pivot, &Ctx->I);
 			
 			// Find the new plane distance based on the new impact point with the new plane
-			GlobalPlane.Dist = geVec3d_DotProduct(&GlobalPlane.Normal, &GlobalI);
+			Ctx->Plane.Dist = geVec3d_DotProduct(&Ctx->Plane.Normal, &Ctx->I);
 
-			geVec3d_Subtract(&GlobalI, Front, &Vect);
+			geVec3d_Subtract(&Ctx->I, Front, &Vect);
 			Dist = geVec3d_Length(&Vect);
 
 			if (Dist < BestD)
 			{
 				BestD = Dist;
-				BestI = GlobalI;
+				BestI = Ctx->I;
 			
-				BestPlane = GlobalPlane;
-				if (GlobalSide)
+				BestPlane = Ctx->Plane;
+				if (Ctx->Side)
 				{
 					geVec3d_Inverse(&BestPlane.Normal);
 					BestPlane.Dist = -BestPlane.Dist;
@@ -403,18 +749,17 @@ geBoolean Trace_WorldCollisionExact2(	geWorld *World,
 	geVec3d			NewFront1, NewBack1;
 	geVec3d			NewFront2, NewBack2;
 	geWorld_Model		*Models;
+	Trace_Context		Ctx;
 
 	assert(World != NULL);
 	assert(World->CurrentBSP != NULL);
 	assert(Front != NULL);
 	assert(Back!= NULL);
 	
-	BSPData = &World->CurrentBSP->BSPData;
+	Trace_InitContext(&Ctx, World, GE_CONTENTS_SOLID_CLIP);
 	Models = World->CurrentBSP->Models;
-	
-	GPlaneNum = -1;
 
-	for (i = 0; i < BSPData->NumGFXModels; i++)
+	for (i = 0; i < Ctx.BSPData->NumGFXModels; i++)
 	{
 		
 		// Move to models center of rotation
@@ -429,17 +774,17 @@ geBoolean Trace_WorldCollisionExact2(	geWorld *World,
 		geVec3d_Add(&NewFront2, &Models[i].Pivot, &NewFront1);
 		geVec3d_Add(&NewBack2 , &Models[i].Pivot, &NewBack1);
 		
-		HitSet = FALSE;
+		Ctx.HitSet = FALSE;
 		
-		if (BSPIntersect(&NewFront1, &NewBack1, BSPData->GFXModels[i].RootNode[0]))
+		if (BSPIntersect(&Ctx, &NewFront1, &NewBack1, Trace_RootNode(Ctx.BSPData, Ctx.BSPData->GFXModels[i].RootNode[0]), GE_TRUE))
 		{
-			if (GPlaneNum == -1)
+			if (Ctx.PlaneNum == -1)
 				return FALSE;
 
-			if (Impact) *Impact = GlobalI;
-			if (Node) *Node = GlobalNode;
-			if (Plane) *Plane = GPlaneNum;
-			if (Side) *Side = GlobalSide;
+			if (Impact) *Impact = Ctx.I;
+			if (Node) *Node = Ctx.Node;
+			if (Plane) *Plane = Ctx.PlaneNum;
+			if (Side) *Side = Ctx.Side;
 
 			return GE_TRUE;
 		}
@@ -452,153 +797,292 @@ geBoolean Trace_WorldCollisionExact2(	geWorld *World,
 //	Local static support functions
 //=====================================================================================
 
+// Part of the ray that still has to be pushed through the tree
+typedef struct
+{
+	int32		Node;
+	geVec3d		Front, Back;
+	int32		EntryNode;			// Node whose plane Front was split on, -1 if Front is the start of the ray
+	int32		EntrySide;
+	float		EntryRatio;
+} Trace_RaySegment;
+
+// The far parts wait on a stack as deep as the tree.  It starts out on the C stack, and
+// moves to the heap for the rare tree that is deeper than that.
+typedef struct
+{
+	Trace_RaySegment	Local[GBSP_MAX_TRACE_DEPTH];
+	Trace_RaySegment	*Segs;
+	int32				Max;
+} Trace_RayStack;
+
+//=====================================================================================
+//	RayStack_Push
+//	Returns NULL if the stack had to grow, and there was no memory for it
+//=====================================================================================
+static Trace_RaySegment *RayStack_Push(Trace_RayStack *Stack, int32 *StackTop)
+{
+	if (*StackTop >= Stack->Max)
+	{
+		Trace_RaySegment	*Segs;
+
+		Segs = GE_RAM_ALLOCATE_ARRAY(Trace_RaySegment, Stack->Max*2);
+
+		if (!Segs)
+		{
+			geErrorLog_Add(GE_ERR_OUT_OF_MEMORY, NULL);
+			return NULL;
+		}
+
+		memcpy(Segs, Stack->Segs, sizeof(Trace_RaySegment)*Stack->Max);
+
+		if (Stack->Segs != Stack->Local)
+			geRam_Free(Stack->Segs);
+
+		Stack->Segs = Segs;
+		Stack->Max *= 2;
+	}
+
+	return &Stack->Segs[(*StackTop)++];
+}
+
 //=====================================================================================
 //	BSPIntersect
-//	Shoot a ray through the tree finding out what solid leafs it passed through
+//	Shoot a ray through the tree finding out what solid leafs it passed through.
+//	Node is an index into GFXTraceNodes.
+//
+//	The ray is walked front to back.  At each split the far part is pushed, and we keep
+//	going down the near part, so the first solid leaf we land in is the first impact.
+//	The impact is on the plane that started the segment that landed in it.  If the ray
+//	starts in solid, we return GE_TRUE without setting the hit, same as it always did.
 //=====================================================================================
-static geBoolean BSPIntersect(geVec3d *Front, geVec3d *Back, int32 Node)
+static geBoolean BSPIntersect(Trace_Context *Ctx, const geVec3d *Front, const geVec3d *Back, int32 Node, geBoolean RecordHit)
 {
-    float		Fd, Bd, Dist;
-    int32		Side;
-    geVec3d		I;
-	GFX_Plane	*Plane;
-	int32		Contents;
+	Trace_RayStack		Stack;
+	Trace_RaySegment	Seg;
+	int32				StackTop;
+	geBoolean			Hit;
+	const GFX_TraceNode	*Nodes;
+
+	Nodes = Ctx->BSPData->GFXTraceNodes;
+
+	Seg.Node = Node;
+	Seg.Front = *Front;
+	Seg.Back = *Back;
+	Seg.EntryNode = -1;
+	Stack.Segs = Stack.Local;
+	Stack.Max = GBSP_MAX_TRACE_DEPTH;
+	StackTop = 0;
+	Hit = GE_FALSE;
 
-	if (Node < 0)
+	while (1)
 	{
-		Contents = BSPData->GFXLeafs[-(Node+1)].Contents;
+		// Walk the segment down to a leaf
+		while (Seg.Node >= 0)
+		{
+			const GFX_TraceNode	*TNode;
+			Trace_RaySegment	*Far;
+			float				Fd, Bd, Dist;
+			int32				Side;
+			geVec3d				I;
 
-		if (Contents & gContents)
-		    return GE_TRUE;						// Ray collided with solid space
+			TNode = &Nodes[Seg.Node];
 
-		return GE_FALSE;
-	}
+			Fd = TraceNode_Distance(TNode, &Seg.Front);
+			Bd = TraceNode_Distance(TNode, &Seg.Back);
 
-	Plane = &BSPData->GFXPlanes[BSPData->GFXNodes[Node].PlaneNum];
+			if (Fd >= 0 && Bd >= 0)
+			{
+				Seg.Node = TNode->Children[0];
+				continue;
+			}
+			if (Fd < 0 && Bd < 0)
+			{
+				Seg.Node = TNode->Children[1];
+				continue;
+			}
 
-    Fd = Plane_PlaneDistanceFast(Plane, Front);
-    Bd = Plane_PlaneDistanceFast(Plane, Back);
+			Side = Fd < 0;
+			Dist = Fd / (Fd - Bd);
 
-    if (Fd >= 0 && Bd >= 0) 
-        return(BSPIntersect(Front, Back, BSPData->GFXNodes[Node].Children[0]));
-    if (Fd < 0 && Bd < 0)
-        return(BSPIntersect(Front, Back, BSPData->GFXNodes[Node].Children[1]));
+			I.X = Seg.Front.X + Dist * (Seg.Back.X - Seg.Front.X);
+			I.Y = Seg.Front.Y + Dist * (Seg.Back.Y - Seg.Front.Y);
+			I.Z = Seg.Front.Z + Dist * (Seg.Back.Z - Seg.Front.Z);
 
-    Side = Fd < 0;
-    Dist = Fd / (Fd - Bd);
+			// The far side only gets looked at if the near side turns out to be empty
+			Far = RayStack_Push(&Stack, &StackTop);
 
-    I.X = Front->X + Dist * (Back->X - Front->X);
-    I.Y = Front->Y + Dist * (Back->Y - Front->Y);
-    I.Z = Front->Z + Dist * (Back->Z - Front->Z);
+			if (!Far)
+				goto Done;
 
-    // Work our way to the front, from the back side.  As soon as there
-	// is no more collisions, we can assume that we have the front portion of the
-	// ray that is in empty space.  Once we find this, and see that the back half is in
-	// solid space, then we found the front intersection point...
-	if (BSPIntersect(Front, &I, BSPData->GFXNodes[Node].Children[Side]))
-        return GE_TRUE;
-    else if (BSPIntersect(&I, Back, BSPData->GFXNodes[Node].Children[!Side]))
-	{
-		if (!HitSet)
+			Far->Node = TNode->Children[!Side];
+			Far->Front = I;
+			Far->Back = Seg.Back;
+			Far->EntryNode = Seg.Node;
+			Far->EntrySide = Side;
+			Far->EntryRatio = Dist;
+
+			Seg.Node = TNode->Children[Side];
+			Seg.Back = I;
+		}
+
+		if (Ctx->BSPData->GFXLeafs[-(Seg.Node+1)].Contents & Ctx->Contents)
 		{
-			GPlaneNum = BSPData->GFXNodes[Node].PlaneNum;
-			GlobalPlane = BSPData->GFXPlanes[GPlaneNum];
-			GlobalSide = Side;
-			GlobalI = I;
-			GlobalNode = Node;
-			GRatio = Dist;
-			HitSet = TRUE;
+			// Ray collided with solid space
+			if (RecordHit && Seg.EntryNode >= 0 && !Ctx->HitSet)
+			{
+				Ctx->Node = Nodes[Seg.EntryNode].Node;
+				Ctx->PlaneNum = Ctx->BSPData->GFXNodes[Ctx->Node].PlaneNum;
+				Ctx->Plane = Ctx->BSPData->GFXPlanes[Ctx->PlaneNum];
+				Ctx->Side = Seg.EntrySide;
+				Ctx->I = Seg.Front;
+				Ctx->Ratio = Seg.EntryRatio;
+				Ctx->HitSet = TRUE;
+			}
+			Hit = GE_TRUE;
+			break;
 		}
-		return GE_TRUE;
+
+		if (!StackTop)
+			break;
+
+		Seg = Stack.Segs[--StackTop];
 	}
 
-	return GE_FALSE;
+	Done:
+
+	if (Stack.Segs != Stack.Local)
+		geRam_Free(Stack.Segs);
+
+	return Hit;
 }
 
 //=====================================================================================
-//	BSPIntersectMesh
+//	MiscPlane
+//	Plane of a misc BNode, optionally pushed out by Mins1/Maxs1
 //=====================================================================================
-static GFX_BNode		*MiscBNodes;
-static GFX_Node			*MiscNodes;
-static GFX_Plane		*MiscPlanes;
-static GFX_Leaf			*MiscLeafs;
-static GFX_LeafSide		*MiscSides;
-
-static geVec3d			GMins1, GMaxs1;
-static geVec3d			GMins2, GMaxs2;
-static geVec3d			GFront, GBack;
-static BOOL				LeafHit;
-static float			BestDist;
-
-static geBoolean BSPIntersectMisc(geVec3d *Front, geVec3d *Back, int32 Node)
+static void MiscPlane(const Trace_Context *Ctx, int32 Node, geBoolean UseMinsMaxs, GFX_Plane *Plane)
 {
-    float		Fd, Bd, Dist;
-    uint8		Side;
-	GFX_Plane	Plane;
-    geVec3d		I;
-
-	if (Node == BSP_CONTENTS_SOLID)
-        return GE_TRUE;					// Ray collided with solid space
-    if (Node < 0)						
-        return GE_FALSE;				// Ray collided with empty space
-
-	Plane = MiscPlanes[MiscBNodes[Node].PlaneNum];
-	Plane.Type = PLANE_ANY;
+	*Plane = Ctx->Planes[Ctx->BNodes[Node].PlaneNum];
+	Plane->Type = PLANE_ANY;
 	
 	if (UseMinsMaxs)
 	{
-		if (Plane.Normal.X > 0)
-			Plane.Dist -= Plane.Normal.X * GMins1.X;
+		if (Plane->Normal.X > 0)
+			Plane->Dist -= Plane->Normal.X * Ctx->Mins1.X;
 		else	 
-			Plane.Dist -= Plane.Normal.X * GMaxs1.X;
+			Plane->Dist -= Plane->Normal.X * Ctx->Maxs1.X;
 	
-		if (Plane.Normal.Y > 0)
-			Plane.Dist -= Plane.Normal.Y * GMins1.Y;
+		if (Plane->Normal.Y > 0)
+			Plane->Dist -= Plane->Normal.Y * Ctx->Mins1.Y;
 		else
-			Plane.Dist -= Plane.Normal.Y * GMaxs1.Y;
+			Plane->Dist -= Plane->Normal.Y * Ctx->Maxs1.Y;
 
-		if (Plane.Normal.Z > 0)
-			Plane.Dist -= Plane.Normal.Z * GMins1.Z;
+		if (Plane->Normal.Z > 0)
+			Plane->Dist -= Plane->Normal.Z * Ctx->Mins1.Z;
 		else							 
-			Plane.Dist -= Plane.Normal.Z * GMaxs1.Z;
+			Plane->Dist -= Plane->Normal.Z * Ctx->Maxs1.Z;
 	}
+}
 
-    Fd = Plane_PlaneDistanceFast(&Plane, Front);
-    Bd = Plane_PlaneDistanceFast(&Plane, Back);
+//=====================================================================================
+//	BSPIntersectMisc
+//	Same walk as BSPIntersect, but through a caller supplied BNode tree, where
+//	BSP_CONTENTS_SOLID is solid and any other negative child is empty
+//=====================================================================================
+static geBoolean BSPIntersectMisc(Trace_Context *Ctx, const geVec3d *Front, const geVec3d *Back, geBoolean UseMinsMaxs)
+{
+	Trace_RayStack		Stack;
+	Trace_RaySegment	Seg;
+	int32				StackTop;
+	geBoolean			Hit;
+
+	Seg.Node = 0;
+	Seg.Front = *Front;
+	Seg.Back = *Back;
+	Seg.EntryNode = -1;
+	Stack.Segs = Stack.Local;
+	Stack.Max = GBSP_MAX_TRACE_DEPTH;
+	StackTop = 0;
+	Hit = GE_FALSE;
 
-    if (Fd >= 0 && Bd >= 0) 
-        return(BSPIntersectMisc(Front, Back, MiscBNodes[Node].Children[0]));
-    if (Fd < 0 && Bd < 0)
-        return(BSPIntersectMisc(Front, Back, MiscBNodes[Node].Children[1]));
+	while (1)
+	{
+		while (Seg.Node >= 0)
+		{
+			GFX_Plane			Plane;
+			Trace_RaySegment	*Far;
+			float				Fd, Bd, Dist;
+			int32				Side;
+			geVec3d				I;
 
-    Side = Fd < 0;
-    Dist = Fd / (Fd - Bd);
+			MiscPlane(Ctx, Seg.Node, UseMinsMaxs, &Plane);
 
-    I.X = Front->X + Dist * (Back->X - Front->X);
-    I.Y = Front->Y + Dist * (Back->Y - Front->Y);
-    I.Z = Front->Z + Dist * (Back->Z - Front->Z);
+			Fd = Plane_PlaneDistanceFast(&Plane, &Seg.Front);
+			Bd = Plane_PlaneDistanceFast(&Plane, &Seg.Back);
 
-    // Work our way to the front, from the back side.  As soon as there
-	// is no more collisions, we can assume that we have the front portion of the
-	// ray that is in empty space.  Once we find this, and see that the back half is in
-	// solid space, then we found the front intersection point...
-	if (BSPIntersectMisc(Front, &I, MiscBNodes[Node].Children[Side]))
-        return TRUE;
-    else if (BSPIntersectMisc(&I, Back, MiscBNodes[Node].Children[!Side]))
-	{
-		if (!HitSet)
+			if (Fd >= 0 && Bd >= 0)
+			{
+				Seg.Node = Ctx->BNodes[Seg.Node].Children[0];
+				continue;
+			}
+			if (Fd < 0 && Bd < 0)
+			{
+				Seg.Node = Ctx->BNodes[Seg.Node].Children[1];
+				continue;
+			}
+
+			Side = Fd < 0;
+			Dist = Fd / (Fd - Bd);
+
+			I.X = Seg.Front.X + Dist * (Seg.Back.X - Seg.Front.X);
+			I.Y = Seg.Front.Y + Dist * (Seg.Back.Y - Seg.Front.Y);
+			I.Z = Seg.Front.Z + Dist * (Seg.Back.Z - Seg.Front.Z);
+
+			Far = RayStack_Push(&Stack, &StackTop);
+
+			if (!Far)
+				goto Done;
+
+			Far->Node = Ctx->BNodes[Seg.Node].Children[!Side];
+			Far->Front = I;
+			Far->Back = Seg.Back;
+			Far->EntryNode = Seg.Node;
+			Far->EntrySide = Side;
+			Far->EntryRatio = Dist;
+
+			Seg.Node = Ctx->BNodes[Seg.Node].Children[Side];
+			Seg.Back = I;
+		}
+
+		if (Seg.Node == BSP_CONTENTS_SOLID)
 		{
-			GPlaneNum = MiscBNodes[Node].PlaneNum;
-			GlobalPlane = Plane;
-			GlobalSide = Side;
-			GlobalI = I;
-			GRatio = Dist;
-			HitSet = TRUE;
+			// Ray collided with solid space
+			if (Seg.EntryNode >= 0 && !Ctx->HitSet)
+			{
+				Ctx->PlaneNum = Ctx->BNodes[Seg.EntryNode].PlaneNum;
+				MiscPlane(Ctx, Seg.EntryNode, UseMinsMaxs, &Ctx->Plane);
+				Ctx->Side = Seg.EntrySide;
+				Ctx->I = Seg.Front;
+				Ctx->Ratio = Seg.EntryRatio;
+				Ctx->HitSet = TRUE;
+			}
+			Hit = GE_TRUE;
+			break;
 		}
-		return GE_TRUE;
+
+		if (!StackTop)
+			break;
+
+		Seg = Stack.Segs[--StackTop];
 	}
 
-	return GE_FALSE;
+	Done:
+
+	if (Stack.Segs != Stack.Local)
+		geRam_Free(Stack.Segs);
+
+	return Hit;
 }
 
 //=====================================================================================
@@ -611,21 +1095,21 @@ geBoolean Trace_MiscCollision(GFX_BNode *BNodes, GFX_Plane *Planes, const geVec3
 {
 	geVec3d	NewFront, NewBack;
 	geVec3d	Trans;
+	Trace_Context	Ctx;
+
+	memset(&Ctx, 0, sizeof(Ctx));
 
-	GPlaneNum	=	-1;		//Safeguard to prevent a bad index 
+	Ctx.PlaneNum	=	-1;		//Safeguard to prevent a bad index 
 
-	// Set Global misc vars
-	MiscBNodes = BNodes;
-	MiscPlanes = Planes;
+	// Set misc vars
+	Ctx.BNodes = BNodes;
+	Ctx.Planes = Planes;
 
 	if (Mins && Maxs)
 	{
-		GMins1 = *Mins;
-		GMaxs1 = *Maxs;
-		UseMinsMaxs = TRUE;
+		Ctx.Mins1 = *Mins;
+		Ctx.Maxs1 = *Maxs;
 	}
-	else
-		UseMinsMaxs = FALSE;
 	
 	// Move ray into tree space
 	Trans.X = XForm->Translation.X;
@@ -635,19 +1119,19 @@ geBoolean Trace_MiscCollision(GFX_BNode *BNodes, GFX_Plane *Planes, const geVec3
 	geVec3d_Subtract(Front, &Trans, &NewFront);
 	geVec3d_Subtract(Back, &Trans, &NewBack);
 	
-	HitSet = FALSE;
+	Ctx.HitSet = FALSE;
 	
-	if (BSPIntersectMisc(&NewFront, &NewBack, 0))
+	if (BSPIntersectMisc(&Ctx, &NewFront, &NewBack, Mins && Maxs))
 	{
-		if (!HitSet)					// Was in solid, but did not cross any planes...
+		if (!Ctx.HitSet)					// Was in solid, but did not cross any planes...
 			return GE_FALSE;			// So just return false...
 
-		geVec3d_Add(&GlobalI, &Trans, &GlobalI);
+		geVec3d_Add(&Ctx.I, &Trans, &Ctx.I);
 
-		if (I) *I = GlobalI;			// Set the intersection point
+		if (I) *I = Ctx.I;			// Set the intersection point
 		if (P)
 		{ 
-			*P = GlobalPlane;
+			*P = Ctx.Plane;
 			// Adjust so plane is at impact point
 			P->Dist += geVec3d_DotProduct(&Trans, &P->Normal);
 		}
@@ -658,84 +1142,32 @@ geBoolean Trace_MiscCollision(GFX_BNode *BNodes, GFX_Plane *Planes, const geVec3
 	return GE_FALSE;
 }
 
-//=====================================================================================
-//	BSPIntersectMisc2
-//=====================================================================================
-static geBoolean BSPIntersectMisc2(const geVec3d *Front, const geVec3d *Back, int32 Node)
-{
-    float		Fd, Bd, Dist;
-    uint8		Side;
-	GFX_Plane	Plane;
-    geVec3d		I;
-
-	if (Node == BSP_CONTENTS_SOLID)
-        return GE_TRUE;					// Ray collided with solid space
-    if (Node < 0)						
-        return GE_FALSE;				// Ray collided with empty space
-
-	Plane = MiscPlanes[MiscBNodes[Node].PlaneNum];
-	Plane.Type = PLANE_ANY;
-	
-    Fd = Plane_PlaneDistanceFast(&Plane, Front);
-    Bd = Plane_PlaneDistanceFast(&Plane, Back);
-
-    if (Fd >= 0 && Bd >= 0) 
-        return(BSPIntersectMisc2(Front, Back, MiscBNodes[Node].Children[0]));
-    if (Fd < 0 && Bd < 0)
-        return(BSPIntersectMisc2(Front, Back, MiscBNodes[Node].Children[1]));
-
-    Side = Fd < 0;
-    Dist = Fd / (Fd - Bd);
-
-    I.X = Front->X + Dist * (Back->X - Front->X);
-    I.Y = Front->Y + Dist * (Back->Y - Front->Y);
-    I.Z = Front->Z + Dist * (Back->Z - Front->Z);
-
-    // Work our way to the front, from the back side.  As soon as there
-	// is no more collisions, we can assume that we have the front portion of the
-	// ray that is in empty space.  Once we find this, and see that the back half is in
-	// solid space, then we found the front intersection point...
-	if (BSPIntersectMisc2(Front, &I, MiscBNodes[Node].Children[Side]))
-        return TRUE;
-    else if (BSPIntersectMisc2(&I, Back, MiscBNodes[Node].Children[!Side]))
-	{
-		if (!HitSet)
-		{
-			GPlaneNum = MiscBNodes[Node].PlaneNum;
-			GlobalPlane = Plane;
-			GlobalSide = Side;
-			GlobalI = I;
-			GRatio = Dist;
-			HitSet = TRUE;
-		}
-		return GE_TRUE;
-	}
-
-	return GE_FALSE;
-}
-
 //=====================================================================================
 //	Trace_MiscCollision2
 //=====================================================================================
 geBoolean Trace_MiscCollision2(GFX_BNode *BNodes, GFX_Plane *Planes, const geVec3d *Front, const geVec3d *Back, geVec3d *I, int32 *P)
 {
-	GPlaneNum	=	-1;		//Safeguard to prevent a bad index 
+	Trace_Context	Ctx;
 
-	// Set Global misc vars
-	MiscBNodes = BNodes;
-	MiscPlanes = Planes;
+	memset(&Ctx, 0, sizeof(Ctx));
 
-	HitSet = FALSE;
+	Ctx.PlaneNum	=	-1;		//Safeguard to prevent a bad index 
+
+	// Set misc vars
+	Ctx.BNodes = BNodes;
+	Ctx.Planes = Planes;
+
+	Ctx.HitSet = FALSE;
 	
-	if (BSPIntersectMisc2(Front, Back, 0))
+	if (BSPIntersectMisc(&Ctx, Front, Back, GE_FALSE))
 	{
-		if (!HitSet || GPlaneNum == -1)	// Was in solid, but did not cross any planes...
+		if (!Ctx.HitSet || Ctx.PlaneNum == -1)	// Was in solid, but did not cross any planes...
 			return GE_FALSE;			// So just return false...
 
 		if (I) 
-			*I = GlobalI;				// Set the intersection point
+			*I = Ctx.I;				// Set the intersection point
 		if (P)
-			*P = GPlaneNum;
+			*P = Ctx.PlaneNum;
 
 		return GE_TRUE;
 	}
@@ -822,7 +1254,7 @@ void Trace_ExpandPlaneForBox(GFX_Plane *Plane, geVec3d *Mins, geVec3d *Maxs)
 //=====================================================================================
 //	IntersectLeafSides
 //=====================================================================================
-static geBoolean PointInLeafSides(const geVec3d *Pos, const GFX_Leaf *Leaf)
+static geBoolean PointInLeafSides(Trace_Context *Ctx, const geVec3d *Pos, const GFX_Leaf *Leaf)
 {
 	int32		i, f;
 	GFX_Plane	Plane;
@@ -832,17 +1264,17 @@ static geBoolean PointInLeafSides(const geVec3d *Pos, const GFX_Leaf *Leaf)
 
 	for (i=0; i< Leaf->NumSides; i++)
 	{
-		Plane = MiscPlanes[MiscSides[i+f].PlaneNum];
+		Plane = Ctx->Planes[Ctx->Sides[i+f].PlaneNum];
 		Plane.Type = PLANE_ANY;
 	
-		if (MiscSides[i+f].PlaneSide)
+		if (Ctx->Sides[i+f].PlaneSide)
 		{
 			geVec3d_Inverse(&Plane.Normal);
 			Plane.Dist = -Plane.Dist;
 		}
 
 		// Simulate the point having a box, by pushing the plane out by the box size
-		Trace_ExpandPlaneForBox(&Plane, &GMins1, &GMaxs1);
+		Trace_ExpandPlaneForBox(&Plane, &Ctx->Mins1, &Ctx->Maxs1);
 
 		Dist = Plane_PlaneDistanceFast(&Plane, Pos);
 		
@@ -856,7 +1288,7 @@ static geBoolean PointInLeafSides(const geVec3d *Pos, const GFX_Leaf *Leaf)
 //=====================================================================================
 //	IntersectLeafSides
 //=====================================================================================
-BOOL IntersectLeafSides_r(geVec3d *Front, geVec3d *Back, int32 Leaf, int32 Side, int32 PSide)
+static BOOL IntersectLeafSides_r(Trace_Context *Ctx, const geVec3d *Front, const geVec3d *Back, int32 Leaf, int32 Side, int32 PSide)
 {
 	float		Fd, Bd, Dist;
 	GFX_Plane	Plane;
@@ -866,38 +1298,38 @@ BOOL IntersectLeafSides_r(geVec3d *Front, geVec3d *Back, int32 Leaf, int32 Side,
 	if (!PSide)
 		return FALSE;
 
-	if (Side >= MiscLeafs[Leaf].NumSides)
+	if (Side >= Ctx->Leafs[Leaf].NumSides)
 		return TRUE;		// if it lands behind all planes, it is inside
 
-	RSide = MiscLeafs[Leaf].FirstSide + Side;
+	RSide = Ctx->Leafs[Leaf].FirstSide + Side;
 
-	Plane = MiscPlanes[MiscSides[RSide].PlaneNum];
+	Plane = Ctx->Planes[Ctx->Sides[RSide].PlaneNum];
 	Plane.Type = PLANE_ANY;
 	
-	if (MiscSides[RSide].PlaneSide)
+	if (Ctx->Sides[RSide].PlaneSide)
 	{
 		geVec3d_Inverse(&Plane.Normal);
 		Plane.Dist = -Plane.Dist;
 	}
 	
 	// Simulate the point having a box, by pushing the plane out by the box size
-	Trace_ExpandPlaneForBox(&Plane, &GMins1, &GMaxs1);
+	Trace_ExpandPlaneForBox(&Plane, &Ctx->Mins1, &Ctx->Maxs1);
 
 	Fd = Plane_PlaneDistanceFast(&Plane, Front);
 	Bd = Plane_PlaneDistanceFast(&Plane, Back);
 
 #if 1
 	if (Fd >= 0 && Bd >= 0)	// Leaf sides are convex hulls, so front side is totally outside
-		return IntersectLeafSides_r(Front, Back, Leaf, Side+1, 0);
+		return IntersectLeafSides_r(Ctx, Front, Back, Leaf, Side+1, 0);
 
 	if (Fd < 0 && Bd < 0)
-		return IntersectLeafSides_r(Front, Back, Leaf, Side+1, 1);
+		return IntersectLeafSides_r(Ctx, Front, Back, Leaf, Side+1, 1);
 #else
 	if ((Fd >= ON_EPSILON && Bd >= ON_EPSILON) || (Bd > Fd && Fd >= 0) )
-		return IntersectLeafSides_r(Front, Back, Leaf, Side+1, 0);
+		return IntersectLeafSides_r(Ctx, Front, Back, Leaf, Side+1, 0);
 
 	if ((Fd < -ON_EPSILON && Bd < -ON_EPSILON) || (Bd < Fd && Fd <= 0))
-		return IntersectLeafSides_r(Front, Back, Leaf, Side+1, 1);
+		return IntersectLeafSides_r(Ctx, Front, Back, Leaf, Side+1, 1);
 #endif
 
 	// We have an intersection
@@ -922,27 +1354,27 @@ BOOL IntersectLeafSides_r(geVec3d *Front, geVec3d *Back, int32 Leaf, int32 Side,
     I.Z = Front->Z + Dist * (Back->Z - Front->Z);
 
 	// Only go down the back side, since the front side is empty in a convex tree
-	if (IntersectLeafSides_r(Front, &I, Leaf, Side+1, Side2))
+	if (IntersectLeafSides_r(Ctx, Front, &I, Leaf, Side+1, Side2))
 	{
-		LeafHit = TRUE;
+		Ctx->LeafHit = TRUE;
 		return TRUE;
 	}
-	else if (IntersectLeafSides_r(&I, Back, Leaf, Side+1, !Side2))
+	else if (IntersectLeafSides_r(Ctx, &I, Back, Leaf, Side+1, !Side2))
 	{
-		geVec3d_Subtract(&I, &GFront, &Vec);
+		geVec3d_Subtract(&I, &Ctx->Front, &Vec);
 		Dist = geVec3d_Length(&Vec);
 
 		// Record the intersection closest to the start of ray
-		if (Dist < BestDist && !HitSet)
+		if (Dist < Ctx->BestDist && !Ctx->HitSet)
 		{
-			GlobalI = I;
-			GlobalLeaf = Leaf;
-			BestDist = Dist;
-			GlobalPlane = Plane;
-			GRatio = Dist;
-			HitSet = TRUE;
+			Ctx->I = I;
+			Ctx->Leaf = Leaf;
+			Ctx->BestDist = Dist;
+			Ctx->Plane = Plane;
+			Ctx->Ratio = Dist;
+			Ctx->HitSet = TRUE;
 		}
-		LeafHit = TRUE;
+		Ctx->LeafHit = TRUE;
 		return TRUE;
 	}
 	
@@ -952,17 +1384,17 @@ BOOL IntersectLeafSides_r(geVec3d *Front, geVec3d *Back, int32 Leaf, int32 Side,
 //=====================================================================================
 //	IntersectLeafSides2
 //=====================================================================================
-BOOL IntersectLeafSides2(geVec3d *Pos, int32 Leaf)
+BOOL IntersectLeafSides2(Trace_Context *Ctx, geVec3d *Pos, int32 Leaf)
 {
 	GFX_Plane	Plane;
 	int32		i;
 	float		Dist;
 
-	for (i=0; i< MiscLeafs[Leaf].NumSides; i++)
+	for (i=0; i< Ctx->Leafs[Leaf].NumSides; i++)
 	{
-		Plane = MiscPlanes[MiscSides[MiscLeafs[Leaf].FirstSide+i].PlaneNum];
+		Plane = Ctx->Planes[Ctx->Sides[Ctx->Leafs[Leaf].FirstSide+i].PlaneNum];
 		
-		if (!MiscSides[MiscLeafs[Leaf].FirstSide+i].PlaneSide)
+		if (!Ctx->Sides[Ctx->Leafs[Leaf].FirstSide+i].PlaneSide)
 		{
 			geVec3d_Inverse(&Plane.Normal);
 			Plane.Dist = -Plane.Dist;
@@ -974,45 +1406,91 @@ BOOL IntersectLeafSides2(geVec3d *Pos, int32 Leaf)
 			return FALSE;
 	}
 
-	LeafHit = TRUE;
+	Ctx->LeafHit = TRUE;
 	return TRUE;
 }
 
 //=====================================================================================
-//	FindClosestLeafIntersection_r
+//	Trace_BoxLeafs
+//	Calls LeafCB for every leaf the box lands in, front side first.  If LeafCB returns
+//	GE_FALSE the walk stops there, and GE_TRUE is returned.  Node is a GFXNodes index.
 //=====================================================================================
-static	void FindClosestLeafIntersection_r(int32 Node)
+typedef geBoolean Trace_LeafCB(int32 Leaf, void *Context);
+
+static geBoolean Trace_BoxLeafs(const GBSP_BSPData *BSP, int32 Node, const geVec3d *Mins, const geVec3d *Maxs, Trace_LeafCB *LeafCB, void *Context)
 {
-	int32		Leaf, Side, Contents;
+	int32				Stack[GBSP_MAX_TRACE_DEPTH];
+	int32				StackTop, Side;
+	const GFX_TraceNode	*TNode;
 
-	if (Node < 0)
+	Node = Trace_RootNode(BSP, Node);
+	StackTop = 0;
+
+	while (1)
 	{
-		Leaf = -(Node+1);
-		Contents = MiscLeafs[Leaf].Contents;
+		if (Node < 0)
+		{
+			if (!LeafCB(-(Node+1), Context))
+				return GE_TRUE;
+		}
+		else
+		{
+			TNode = &BSP->GFXTraceNodes[Node];
 
-		//if (Contents != BSP_CONTENTS_SOLID && Contents != BSP_CONTENTS_WINDOW)
-		if (!(Contents & gContents))
-			return;		// Only solid leafs contain side info...
+			Side = TraceNode_BoxOnPlaneSide(TNode, Mins, Maxs);
 
-		HitSet = FALSE;
-		
-		if (!MiscLeafs[Leaf].NumSides)
-			return;
+			// Go down the sides that the box lands in
+			if (Side == PSIDE_BOTH)
+			{
+				assert(StackTop < GBSP_MAX_TRACE_DEPTH);
+				Stack[StackTop++] = TNode->Children[1];
+				Node = TNode->Children[0];
+				continue;
+			}
+			if (Side & PSIDE_FRONT)
+			{
+				Node = TNode->Children[0];
+				continue;
+			}
+			if (Side & PSIDE_BACK)
+			{
+				Node = TNode->Children[1];
+				continue;
+			}
+		}
 
-		IntersectLeafSides_r(&GFront, &GBack, Leaf, 0, 1);
-		//IntersectLeafSides2(&GBack, Leaf);
+		if (!StackTop)
+			return GE_FALSE;
 
-		return;
+		Node = Stack[--StackTop];
 	}
+}
 
-	Side = Trace_BoxOnPlaneSide(&GMins2, &GMaxs2, &MiscPlanes[MiscNodes[Node].PlaneNum]);
+//=====================================================================================
+//	FindClosestLeafIntersection
+//=====================================================================================
+static geBoolean ClosestLeafIntersection(int32 Leaf, void *Context)
+{
+	Trace_Context	*Ctx = (Trace_Context*)Context;
 
-	// Go down the sides that the box lands in
-	if (Side & PSIDE_FRONT)
-		FindClosestLeafIntersection_r(MiscNodes[Node].Children[0]);
+	//if (Contents != BSP_CONTENTS_SOLID && Contents != BSP_CONTENTS_WINDOW)
+	if (!(Ctx->Leafs[Leaf].Contents & Ctx->Contents))
+		return GE_TRUE;		// Only solid leafs contain side info...
 
-	if (Side & PSIDE_BACK)
-		FindClosestLeafIntersection_r(MiscNodes[Node].Children[1]);
+	Ctx->HitSet = FALSE;
+	
+	if (!Ctx->Leafs[Leaf].NumSides)
+		return GE_TRUE;
+
+	IntersectLeafSides_r(Ctx, &Ctx->Front, &Ctx->Back, Leaf, 0, 1);
+	//IntersectLeafSides2(Ctx, &Ctx->Back, Leaf);
+
+	return GE_TRUE;
+}
+
+static void FindClosestLeafIntersection(Trace_Context *Ctx, int32 Node)
+{
+	Trace_BoxLeafs(Ctx->BSPData, Node, &Ctx->Mins2, &Ctx->Maxs2, ClosestLeafIntersection, Ctx);
 }
 
 #define SIDE_SPACE		0.1f
@@ -1021,7 +1499,8 @@ static	void FindClosestLeafIntersection_r(int32 Node)
 //	Shoots a ray through the world, using the expandable leaf hull
 //  The hull is expanded by the input BBox to simulate the points having volume...
 //=====================================================================================
-geBoolean Trace_WorldCollisionBBox(	geWorld	*World,
+geBoolean Trace_WorldCollisionBBox(	Trace_Context *Ctx,
+									geWorld	*World,
 									const	geVec3d *Mins, const geVec3d *Maxs, 
 									const	geVec3d *Front, const geVec3d *Back,
 									uint32	Flags,
@@ -1093,25 +1572,19 @@ geBoolean Trace_WorldCollisionBBox(	geWorld	*World,
 		}
 
 	
-	// GMins1/GMaxs1 is what is used to exapand the plane out with
-	GMins1 = *Mins;
-	GMaxs1 = *Maxs;
+	// Mins1/Maxs1 is what is used to exapand the plane out with
+	Ctx->Mins1 = *Mins;
+	Ctx->Maxs1 = *Maxs;
 	
-	GFront = *Front;
-	GBack = *Back;
+	Ctx->Front = *Front;
+	Ctx->Back = *Back;
 
-	BSPData = &World->CurrentBSP->BSPData;
+	assert(Ctx->BSPData == &World->CurrentBSP->BSPData);
 	Models = World->CurrentBSP->Models;
 
-	MiscNodes = BSPData->GFXNodes;
-	MiscPlanes = BSPData->GFXPlanes;
-	MiscLeafs = BSPData->GFXLeafs;
-	MiscSides = BSPData->GFXLeafSides;
-
-	assert(MiscNodes != NULL);
-	assert(MiscPlanes != NULL);
-	assert(MiscLeafs != NULL);
-	assert(MiscSides != NULL);
+	assert(Ctx->Planes != NULL);
+	assert(Ctx->Leafs != NULL);
+	assert(Ctx->Sides != NULL);
 
 	if (!(Flags & GE_COLLIDE_MODELS))
 		goto NoModels;
@@ -1120,7 +1593,7 @@ geBoolean Trace_WorldCollisionBBox(	geWorld	*World,
 
 	// Then test the world bsp(all models are the world bsp)
 	// Go through each model, and find out what leafs we hit, keeping the closest intersection
-	for (i = 0; i < BSPData->NumGFXModels; i++, Models++)
+	for (i = 0; i < Ctx->BSPData->NumGFXModels; i++, Models++)
 	{
 		
 		// First, see if the user wants to reject it...
@@ -1140,47 +1613,47 @@ geBoolean Trace_WorldCollisionBBox(	geWorld	*World,
 		
 
 		// Reset flags
-		BestDist = 9999.0f;
-		LeafHit = FALSE;
+		Ctx->BestDist = 9999.0f;
+		Ctx->LeafHit = FALSE;
 		
-		geVec3d_Subtract(Front, &Models->Pivot, &GFront);
-		geVec3d_Subtract(Back , &Models->Pivot, &GBack);
+		geVec3d_Subtract(Front, &Models->Pivot, &Ctx->Front);
+		geVec3d_Subtract(Back , &Models->Pivot, &Ctx->Back);
 
 		// InverseTransform the point about models center of rotation
-		geXForm3d_TransposeTransform(&Models->XForm, &GFront, &NewFront);
-		geXForm3d_TransposeTransform(&Models->XForm, &GBack , &NewBack);
+		geXForm3d_TransposeTransform(&Models->XForm, &Ctx->Front, &NewFront);
+		geXForm3d_TransposeTransform(&Models->XForm, &Ctx->Back , &NewBack);
 
 		// push back into world
-		geVec3d_Add(&NewFront, &Models->Pivot, &GFront);
-		geVec3d_Add(&NewBack , &Models->Pivot, &GBack);
+		geVec3d_Add(&NewFront, &Models->Pivot, &Ctx->Front);
+		geVec3d_Add(&NewBack , &Models->Pivot, &Ctx->Back);
 		
 		// Make out box out of this move so we only check the leafs it intersected with...
-		Trace_GetMoveBox(Mins, Maxs, &GFront, &GBack, &GMins2, &GMaxs2);
+		Trace_GetMoveBox(Mins, Maxs, &Ctx->Front, &Ctx->Back, &Ctx->Mins2, &Ctx->Maxs2);
 
-		FindClosestLeafIntersection_r(BSPData->GFXModels[i].RootNode[0]);
+		FindClosestLeafIntersection(Ctx, Ctx->BSPData->GFXModels[i].RootNode[0]);
 
-		if (LeafHit)
+		if (Ctx->LeafHit)
 		{
 			
 			// Rotate the impact plane
-			geXForm3d_Rotate(&Models->XForm, &GlobalPlane.Normal, &GlobalPlane.Normal);
+			geXForm3d_Rotate(&Models->XForm, &Ctx->Plane.Normal, &Ctx->Plane.Normal);
 			
 			// Rotate the impact point
-			geVec3d_Subtract(&GlobalI, &Models->Pivot, &GlobalI);
-			geXForm3d_Transform(&Models->XForm, &GlobalI, &NewFront);
-			//geXForm3d_Rotate(&Models->XForm, &GlobalI, &NewFront);
-			geVec3d_Add(&NewFront, &Models->Pivot, &GlobalI);
+			geVec3d_Subtract(&Ctx->I, &Models->Pivot, &Ctx->I);
+			geXForm3d_Transform(&Models->XForm, &Ctx->I, &NewFront);
+			//geXForm3d_Rotate(&Models->XForm, &Ctx->I, &NewFront);
+			geVec3d_Add(&NewFront, &Models->Pivot, &Ctx->I);
 			
 			// Find the new plane distance based on the new impact point with the new plane
-			GlobalPlane.Dist = geVec3d_DotProduct(&GlobalPlane.Normal, &GlobalI);
+			Ctx->Plane.Dist = geVec3d_DotProduct(&Ctx->Plane.Normal, &Ctx->I);
 
-			geVec3d_Subtract(&GlobalI, Front, &Vect);
+			geVec3d_Subtract(&Ctx->I, Front, &Vect);
 			Dist = geVec3d_Length(&Vect);
 			if (Dist < BestD)
 			{
 				BestD = Dist;
-				BestI = GlobalI;
-				BestPlane = GlobalPlane;
+				BestI = Ctx->I;
+				BestPlane = Ctx->Plane;
 				BestModel = Models;
 				BestMesh = NULL;			// Reset the mesh flag...
 				BestActor = NULL;
@@ -1223,74 +1696,69 @@ geBoolean Trace_TestModelMove(	geWorld			*World,
 								const geVec3d	*In, geVec3d *Out)
 {
 	geVec3d		NewFront, NewBack, Original;
+	Trace_Context	Ctx;
 
 	assert(World != NULL);
 	assert(Model != NULL);
 
-	BSPData = &World->CurrentBSP->BSPData;
-
-	MiscNodes = BSPData->GFXNodes;
-	MiscPlanes = BSPData->GFXPlanes;
-	MiscLeafs = BSPData->GFXLeafs;
-	MiscSides = BSPData->GFXLeafSides;
+	Trace_InitContext(&Ctx, World, GE_CONTENTS_SOLID_CLIP);
 
-	assert(MiscNodes != NULL);
-	assert(MiscPlanes != NULL);
-	assert(MiscLeafs != NULL);
-	assert(MiscSides != NULL);
+	assert(Ctx.Planes != NULL);
+	assert(Ctx.Leafs != NULL);
+	assert(Ctx.Sides != NULL);
 
 	Original = *In;		// Save original
 
-	GMins1 = *Mins;
-	GMaxs1 = *Maxs;
+	Ctx.Mins1 = *Mins;
+	Ctx.Maxs1 = *Maxs;
 	
 	// Put point about models origin
-	geVec3d_Subtract(In, &Model->Pivot, &GFront);
-	GBack = GFront;
+	geVec3d_Subtract(In, &Model->Pivot, &Ctx.Front);
+	Ctx.Back = Ctx.Front;
 
 	// InverseTransform the points about models center of rotation
-	geXForm3d_TransposeTransform(&Model->XForm, &GFront, &NewFront);
+	geXForm3d_TransposeTransform(&Model->XForm, &Ctx.Front, &NewFront);
 	// The back gets applied by the dest XForm
-	geXForm3d_TransposeTransform(DXForm, &GBack, &NewBack);
+	geXForm3d_TransposeTransform(DXForm, &Ctx.Back, &NewBack);
 
 	// push back into world
-	geVec3d_Add(&NewFront, &Model->Pivot, &GFront);
-	geVec3d_Add(&NewBack , &Model->Pivot, &GBack);
+	geVec3d_Add(&NewFront, &Model->Pivot, &Ctx.Front);
+	geVec3d_Add(&NewBack , &Model->Pivot, &Ctx.Back);
 
 	// Make out box out of this move so we only check the leafs it intersected with...
-	Trace_GetMoveBox(Mins, Maxs, &GFront, &GBack, &GMins2, &GMaxs2);
+	Trace_GetMoveBox(Mins, Maxs, &Ctx.Front, &Ctx.Back, &Ctx.Mins2, &Ctx.Maxs2);
 	
-	BestDist = 9999.0f;
-	LeafHit = FALSE;
+	Ctx.BestDist = 9999.0f;
+	Ctx.LeafHit = FALSE;
 
-	FindClosestLeafIntersection_r(BSPData->GFXModels[Model->GFXModelNum].RootNode[0]);
+	FindClosestLeafIntersection(&Ctx, Ctx.BSPData->GFXModels[Model->GFXModelNum].RootNode[0]);
 
-	if (LeafHit)
+	if (Ctx.LeafHit)
 	{
 		GE_Collision	Collision;
 
 		// Rotate the impact plane
-		geXForm3d_Rotate(DXForm, &GlobalPlane.Normal, &GlobalPlane.Normal);
+		geXForm3d_Rotate(DXForm, &Ctx.Plane.Normal, &Ctx.Plane.Normal);
 			
 		// Rotate the impact point
-		geVec3d_Subtract(&GlobalI, &Model->Pivot, &NewFront);
-		geXForm3d_Transform(DXForm, &NewFront, &GlobalI);
-		geVec3d_Add(&GlobalI, &Model->Pivot, &NewFront);
-		GlobalI = NewFront;
+		geVec3d_Subtract(&Ctx.I, &Model->Pivot, &NewFront);
+		geXForm3d_Transform(DXForm, &NewFront, &Ctx.I);
+		geVec3d_Add(&Ctx.I, &Model->Pivot, &NewFront);
+		Ctx.I = NewFront;
 
 		// Find the new plane distance based on the new impact point with the new plane
-		GlobalPlane.Dist = geVec3d_DotProduct(&GlobalPlane.Normal, &GlobalI);
+		Ctx.Plane.Dist = geVec3d_DotProduct(&Ctx.Plane.Normal, &Ctx.I);
 
-		geVec3d_MA(&GlobalI, ON_EPSILON, &GlobalPlane.Normal, &GlobalI);
+		geVec3d_MA(&Ctx.I, ON_EPSILON, &Ctx.Plane.Normal, &Ctx.I);
 		
 		// If the point gets pushed into the world as a result of the move, then cancel it out...
-		if (Trace_GEWorldCollision(World, Mins, Maxs, In, &GlobalI, GE_CONTENTS_SOLID_CLIP, GE_COLLIDE_ALL, 0xffffffff, NULL, NULL, &Collision))
+		if (Trace_GEWorldCollision(World, Mins, Maxs, In, &Ctx.I, GE_CONTENTS_SOLID_CLIP, GE_COLLIDE_ALL, 0xffffffff, NULL, NULL, &Collision))
 		{
 			*Out = Original;
 			return GE_FALSE;
 		}
 
-		*Out = GlobalI;
+		*Out = Ctx.I;
 
 		return GE_TRUE;
 	}
@@ -1304,7 +1772,8 @@ geBoolean Trace_TestModelMove(	geWorld			*World,
 //	Trace_ModelCollisionBBox
 //=====================================================================================
 static
-geBoolean Trace_ModelCollisionBBox(geWorld			*World, 
+geBoolean Trace_ModelCollisionBBox(Trace_Context	*Ctx,
+									geWorld			*World, 
 									geWorld_Model		*Model, 
 									const geXForm3d	*DXForm, 
 									const geVec3d	*Mins, const geVec3d *Maxs,
@@ -1316,58 +1785,52 @@ geBoolean Trace_ModelCollisionBBox(geWorld			*World,
 	assert(World != NULL);
 	assert(Model != NULL);
 
-	BSPData = &World->CurrentBSP->BSPData;
+	Trace_InitContext(Ctx, World, GE_CONTENTS_SOLID_CLIP);
 
-	MiscNodes = BSPData->GFXNodes;
-	MiscPlanes = BSPData->GFXPlanes;
-	MiscLeafs = BSPData->GFXLeafs;
-	MiscSides = BSPData->GFXLeafSides;
+	assert(Ctx->Planes != NULL);
+	assert(Ctx->Leafs != NULL);
+	assert(Ctx->Sides != NULL);
 
-	assert(MiscNodes != NULL);
-	assert(MiscPlanes != NULL);
-	assert(MiscLeafs != NULL);
-	assert(MiscSides != NULL);
-
-	GMins1 = *Mins;
-	GMaxs1 = *Maxs;
+	Ctx->Mins1 = *Mins;
+	Ctx->Maxs1 = *Maxs;
 	
 	// Put point about models origin
-	geVec3d_Subtract(In, &Model->Pivot, &GFront);
-	GBack = GFront;
+	geVec3d_Subtract(In, &Model->Pivot, &Ctx->Front);
+	Ctx->Back = Ctx->Front;
 
 	// InverseTransform the points about models center of rotation
-	geXForm3d_TransposeTransform(&Model->XForm, &GFront, &NewFront);
+	geXForm3d_TransposeTransform(&Model->XForm, &Ctx->Front, &NewFront);
 	// The back gets applied by the dest XForm
-	geXForm3d_TransposeTransform(DXForm, &GBack, &NewBack);
+	geXForm3d_TransposeTransform(DXForm, &Ctx->Back, &NewBack);
 
 	// push back into world
-	geVec3d_Add(&NewFront, &Model->Pivot, &GFront);
-	geVec3d_Add(&NewBack , &Model->Pivot, &GBack);
+	geVec3d_Add(&NewFront, &Model->Pivot, &Ctx->Front);
+	geVec3d_Add(&NewBack , &Model->Pivot, &Ctx->Back);
 
 	// Make out box out of this move so we only check the leafs it intersected with...
-	Trace_GetMoveBox(Mins, Maxs, &GFront, &GBack, &GMins2, &GMaxs2);
+	Trace_GetMoveBox(Mins, Maxs, &Ctx->Front, &Ctx->Back, &Ctx->Mins2, &Ctx->Maxs2);
 	
-	BestDist = 9999.0f;
-	LeafHit = FALSE;
+	Ctx->BestDist = 9999.0f;
+	Ctx->LeafHit = FALSE;
 
-	FindClosestLeafIntersection_r(BSPData->GFXModels[Model->GFXModelNum].RootNode[0]);
+	FindClosestLeafIntersection(Ctx, Ctx->BSPData->GFXModels[Model->GFXModelNum].RootNode[0]);
 
-	if (LeafHit)
+	if (Ctx->LeafHit)
 	{
 		// Rotate the impact plane
-		geXForm3d_Rotate(DXForm, &GlobalPlane.Normal, &GlobalPlane.Normal);
+		geXForm3d_Rotate(DXForm, &Ctx->Plane.Normal, &Ctx->Plane.Normal);
 			
 		// Rotate the impact point
-		geVec3d_Subtract(&GlobalI, &Model->Pivot, &GlobalI);
-		geXForm3d_Transform(DXForm, &GlobalI, &NewFront);
-		geVec3d_Add(&NewFront, &Model->Pivot, &GlobalI);
+		geVec3d_Subtract(&Ctx->I, &Model->Pivot, &Ctx->I);
+		geXForm3d_Transform(DXForm, &Ctx->I, &NewFront);
+		geVec3d_Add(&NewFront, &Model->Pivot, &Ctx->I);
 
 		// Find the new plane distance based on the new impact point with the new plane
-		GlobalPlane.Dist = geVec3d_DotProduct(&GlobalPlane.Normal, &GlobalI);
+		Ctx->Plane.Dist = geVec3d_DotProduct(&Ctx->Plane.Normal, &Ctx->I);
 
-		geVec3d_MA(&GlobalI, ON_EPSILON, &GlobalPlane.Normal, &GlobalI);
+		geVec3d_MA(&Ctx->I, ON_EPSILON, &Ctx->Plane.Normal, &Ctx->I);
 
-		*ImpactPoint = GlobalI;
+		*ImpactPoint = Ctx->I;
 
 		return GE_TRUE;
 	}
@@ -1384,9 +1847,9 @@ geBoolean Trace_ModelCollision( geWorld         *World,
                                 GE_Collision    *Collision,
                                 geVec3d         *ImpactPoint )
 {
-	geExtBox ExtBox;
-	geVec3d  Pos;
+	Trace_Context Ctx;
 #ifdef MESHES
+	geVec3d                     Pos;
 	Mesh_RenderQ               *CollidableMesh;
 	Mesh_CollidableMeshIterator Iter;
 #endif
@@ -1399,7 +1862,7 @@ geBoolean Trace_ModelCollision( geWorld         *World,
 	{
 		Mesh_MeshGetBox( World, CollidableMesh->MeshDef, &Mins, &Maxs );
 		Mesh_MeshGetPosition( CollidableMesh, &Pos );
-		if ( Trace_ModelCollisionBBox( World, Model, DXForm, &Mins, &Maxs, &Pos, ImpactPoint ) )
+		if ( Trace_ModelCollisionBBox( &Ctx, World, Model, DXForm, &Mins, &Maxs, &Pos, ImpactPoint ) )
 		{
 			Collision->Mesh = ( geMesh * ) CollidableMesh;
 			return GE_TRUE;
@@ -1418,25 +1881,26 @@ geBoolean Trace_ModelCollision( geWorld         *World,
 		BestActor = NULL;
 		BestActorDist = 9999.0f;
 
+		// Use the boxes cached by the grid, so this doesn't pose actors other threads may be using
+		ActorGrid_Refresh( World );
+
 		Count = World->ActorCount;
 		WA = &( World->ActorArray[ 0 ] );
 
 		for ( i = 0; i < Count; i++, WA++ )
 		{
 			// if it's active	(ignore userflags?)
-			if ( ( WA->Flags & GE_ACTOR_COLLIDE ) )
+			if ( ( WA->Flags & GE_ACTOR_COLLIDE ) && WA->BoxValid )
 			{
-				geActor_GetNonWorldExtBox( WA->Actor, &ExtBox );
-				geActor_GetPosition( WA->Actor, &Pos );
-				if ( Trace_ModelCollisionBBox( World, Model, DXForm, &( ExtBox.Min ), &( ExtBox.Max ), &Pos, &PossibleImpactPoint ) )
+				if ( Trace_ModelCollisionBBox( &Ctx, World, Model, DXForm, &( WA->LocalBox.Min ), &( WA->LocalBox.Max ), &WA->Pos, &PossibleImpactPoint ) )
 				{
-					if ( GlobalPlane.Dist < BestActorDist )
+					if ( Ctx.Plane.Dist < BestActorDist )
 					{
-						BestActorDist = GlobalPlane.Dist;
+						BestActorDist = Ctx.Plane.Dist;
 						BestActor = WA->Actor;
 						( *ImpactPoint ) = PossibleImpactPoint;
-						Collision->Plane.Normal = GlobalPlane.Normal;
-						Collision->Plane.Dist = GlobalPlane.Dist;
+						Collision->Plane.Normal = Ctx.Plane.Normal;
+						Collision->Plane.Dist = Ctx.Plane.Dist;
 						Collision->Ratio = geVec3d_DistanceBetween( &DXForm->Translation, &Model->XForm.Translation );
 					}
 				}
@@ -1482,47 +1946,20 @@ void Trace_GetMoveBox(const geVec3d *Mins, const geVec3d *Maxs, const geVec3d *F
 }
 
 
-static geBoolean	VisibleLeaf;
 //=====================================================================================
-//	BBoxInVisibleLeaf_r
+//	Trace_BBoxInVisibleLeaf
 //=====================================================================================
-static void BBoxInVisibleLeaf_r(geWorld *World, geVec3d *Mins, geVec3d *Maxs, int32 Node)
+static geBoolean LeafNotVisible(int32 Leaf, void *Context)
 {
-	int32		Leaf, Side;
-
-	if (VisibleLeaf)
-		return;
-	
-	if (Node < 0)		// At a leaf, see if it's visible
-	{
-		Leaf = -(Node+1);
+	geWorld		*World = (geWorld*)Context;
 
-		if (World->CurrentBSP->LeafData[Leaf].VisFrame == World->CurFrameStatic)
-			VisibleLeaf = TRUE;
-		
-		return;
-	}
-
-	Side = Trace_BoxOnPlaneSide(Mins, Maxs, &MiscPlanes[MiscNodes[Node].PlaneNum]);
-
-	// Go down the sides that the box lands in
-	if (Side & PSIDE_FRONT)
-		BBoxInVisibleLeaf_r(World, Mins, Maxs, MiscNodes[Node].Children[0]);
-
-	if (Side & PSIDE_BACK)
-		BBoxInVisibleLeaf_r(World, Mins, Maxs, MiscNodes[Node].Children[1]);
+	// Stop as soon as one is visible
+	return World->CurrentBSP->LeafData[Leaf].VisFrame != World->CurFrameStatic;
 }
 
 geBoolean Trace_BBoxInVisibleLeaf(geWorld *World, geVec3d *Mins, geVec3d *Maxs)
 {
-	VisibleLeaf = FALSE;
-
-	MiscNodes = World->CurrentBSP->BSPData.GFXNodes;
-	MiscPlanes = World->CurrentBSP->BSPData.GFXPlanes;
-	
-	BBoxInVisibleLeaf_r(World, Mins, Maxs, 0);
-
-	return VisibleLeaf;
+	return Trace_BoxLeafs(&World->CurrentBSP->BSPData, 0, Mins, Maxs, LeafNotVisible, World);
 }
 
 //===================================================================================
@@ -1608,31 +2045,71 @@ int32 Plane_FindBNodeContents(	const GFX_BNode *Nodes,
 }
 
 //=====================================================================================
-//	FillContents_r
+//	FillContents
 //	Traverses the leafs and or's all the contents together
 //=====================================================================================
-static void FillContents_r(int32 Node, const geVec3d *Pos, uint32 *Contents)
+typedef struct
 {
-	int32		Side;
+	Trace_Context	*Ctx;
+	const geVec3d	*Pos;
+	uint32			Contents;
+} Trace_FillContentsInfo;
 
-	if (Node < 0)		// At a leaf, fill contens and return
-	{
-		int32		Leaf;
+static geBoolean FillLeafContents(int32 Leaf, void *Context)
+{
+	Trace_FillContentsInfo	*Info = (Trace_FillContentsInfo*)Context;
+	Trace_Context			*Ctx = Info->Ctx;
 
-		Leaf = -(Node+1);
-		if (PointInLeafSides(Pos, &MiscLeafs[Leaf]))
-			*Contents |= MiscLeafs[Leaf].Contents;
-		return;
-	}
+	if (PointInLeafSides(Ctx, Info->Pos, &Ctx->Leafs[Leaf]))
+		Info->Contents |= Ctx->Leafs[Leaf].Contents;
+
+	return GE_TRUE;
+}
+
+static void FillContents(Trace_Context *Ctx, int32 Node, const geVec3d *Pos, uint32 *Contents)
+{
+	Trace_FillContentsInfo	Info;
+
+	Info.Ctx = Ctx;
+	Info.Pos = Pos;
+	Info.Contents = *Contents;
+
+	Trace_BoxLeafs(Ctx->BSPData, Node, &Ctx->Mins2, &Ctx->Maxs2, FillLeafContents, &Info);
+
+	*Contents = Info.Contents;
+}
 
-	Side = Trace_BoxOnPlaneSide(&GMins2, &GMaxs2, &MiscPlanes[MiscNodes[Node].PlaneNum]);
+typedef struct
+{
+	uint32			UserFlags;
+	GE_CollisionCB	*CollisionCB;
+	void			*Context;
+
+	World_Actor		*FirstWA;
+} Trace_ActorContentsInfo;
+
+//===================================================================================
+//	ActorContents
+//	ActorGrid_Query callback for Trace_GetContents, keeps the actor with the lowest
+//	index so the result is the same as walking the actor array
+//===================================================================================
+static geBoolean ActorContents(World_Actor *WA, void *Context)
+{
+	Trace_ActorContentsInfo	*Info = (Trace_ActorContentsInfo*)Context;
+
+	if (Info->FirstWA && Info->FirstWA < WA)
+		return GE_TRUE;
+
+	// Reject if not active or if userflags don't accept...
+	if (!(WA->Flags & GE_ACTOR_COLLIDE) || !(WA->UserFlags & Info->UserFlags) )
+		return GE_TRUE;
 
-	// Go down the sides that the box lands in
-	if (Side & PSIDE_FRONT)
-		FillContents_r(MiscNodes[Node].Children[0], Pos, Contents);
+	if (Info->CollisionCB && !Info->CollisionCB(NULL, WA->Actor, Info->Context))
+		return GE_TRUE;
 
-	if (Side & PSIDE_BACK)
-		FillContents_r(MiscNodes[Node].Children[1], Pos, Contents);
+	Info->FirstWA = WA;
+
+	return GE_TRUE;
 }
 
 //===================================================================================
@@ -1644,87 +2121,67 @@ geBoolean Trace_GetContents(geWorld *World, const geVec3d *Pos, const geVec3d *M
 {
 	Mesh_RenderQ				*MeshHit;
 	geActor						*ActorHit;
-	geExtBox					MeshExtBox;
 	geVec3d						TMins, TMaxs;
 	geBoolean					Hit;
 	int32						i, k;
 	uint32						NewContents, FinalContents;
 	geWorld_Model				*Models, *ModelHit;
 	GFX_Model					*GFXModels;
+	Trace_Context				Ctx;
 
 	assert(World);
 	assert(Contents);
 	
 	MeshHit = NULL;
 	ModelHit = NULL;
+	ActorHit = NULL;
 	FinalContents = 0;
 	Hit = GE_FALSE;
 
-	BSPData = &World->CurrentBSP->BSPData;
+	Trace_InitContext(&Ctx, World, 0);
 
 	// Get the translated box from the input pos...
 	geVec3d_Add(Mins, Pos, &TMins);
 	geVec3d_Add(Maxs, Pos, &TMaxs);
 
-	NumGetContents++;
+	geAtomic_Add(&NumGetContents, 1);
 
 	if (Flags & GE_COLLIDE_ACTORS)
 	{
-		int32 Count;
-		World_Actor *WA;
-			
-		Count = World->ActorCount;
-		WA = &(World->ActorArray[0]);
+		Trace_ActorContentsInfo	Info;
+		geVec3d					QMins, QMaxs;
 
-		for (i=0; i<Count; i++, WA++)
-		{
-				
-			// Reject if not active or if userflags don't accept...
-			if (!(WA->Flags & GE_ACTOR_COLLIDE) || !(WA->UserFlags & UserFlags) )
-				continue;
+		// Actors touching the box within 1 unit count
+		geVec3d_Set(&QMins, TMins.X-1.0f, TMins.Y-1.0f, TMins.Z-1.0f);
+		geVec3d_Set(&QMaxs, TMaxs.X+1.0f, TMaxs.Y+1.0f, TMaxs.Z+1.0f);
 
-			if (CollisionCB && !CollisionCB(NULL, WA->Actor, Context))
-				continue;
-
-				
-			if (geActor_GetExtBox(WA->Actor,&MeshExtBox)==GE_FALSE)
-				continue;
+		Info.UserFlags = UserFlags;
+		Info.CollisionCB = CollisionCB;
+		Info.Context = Context;
+		Info.FirstWA = NULL;
 
-			for (k=0; k<3; k++)
-			{
-				if (geVec3d_GetElement(&TMaxs,k) < geVec3d_GetElement(&(MeshExtBox.Min),k)-1)
-					break;
-				if (geVec3d_GetElement(&TMins,k) > geVec3d_GetElement(&(MeshExtBox.Max),k)+1)
-					break;
-			}
-				
-			if (k != 3)
-				continue;
+		ActorGrid_Query(World, &QMins, &QMaxs, ActorContents, &Info);
 
-			ActorHit = WA->Actor;
+		if (Info.FirstWA)
+		{
+			ActorHit = Info.FirstWA->Actor;
 			Hit = GE_TRUE;
-			break;				// Just return the first actor
 		}
 	}
 
 	if (!(Flags & GE_COLLIDE_MODELS))
 		goto NoModels;
 	
-	MiscNodes = World->CurrentBSP->BSPData.GFXNodes;
-	MiscPlanes = World->CurrentBSP->BSPData.GFXPlanes;
-	MiscLeafs = World->CurrentBSP->BSPData.GFXLeafs;
-	MiscSides = BSPData->GFXLeafSides;
-
 	Models = World->CurrentBSP->Models;
 	GFXModels = World->CurrentBSP->BSPData.GFXModels;
 
-	GMins1 = *Mins;
-	GMaxs1 = *Maxs;
+	Ctx.Mins1 = *Mins;
+	Ctx.Maxs1 = *Maxs;
 
-	GMins2 = TMins;
-	GMaxs2 = TMaxs;
+	Ctx.Mins2 = TMins;
+	Ctx.Maxs2 = TMaxs;
 
-	for (i = 0; i < BSPData->NumGFXModels; i++, Models++, GFXModels++)
+	for (i = 0; i < Ctx.BSPData->NumGFXModels; i++, Models++, GFXModels++)
 	{
 		geVec3d	TPos;
 
@@ -1756,7 +2213,7 @@ geBoolean Trace_GetContents(geWorld *World, const geVec3d *Pos, const geVec3d *M
 		// Reset contents
 		NewContents = 0;
 
-		FillContents_r(GFXModels->RootNode[0], &TPos, &NewContents);
+		FillContents(&Ctx, GFXModels->RootNode[0], &TPos, &NewContents);
 
 		if (NewContents && !ModelHit)
 		{
@@ -1798,77 +2255,22 @@ geBoolean Trace_GetContents(geWorld *World, const geVec3d *Pos, const geVec3d *M
 //=====================================================================================
 //	Trace_SetupIntersect
 //=====================================================================================
-static	GFX_Plane	*TreePlanes;
-static	GFX_Node	*TreeNodes;
-static	GFX_Leaf	*TreeLeafs;
-
-void Trace_SetupIntersect(geWorld *World)
+void Trace_SetupIntersect(geWorld *World, Trace_Context *Ctx)
 {
-	BSPData = &World->CurrentBSP->BSPData;
-
-	TreePlanes = BSPData->GFXPlanes;
-	TreeNodes = BSPData->GFXNodes;
-	TreeLeafs = BSPData->GFXLeafs;
+	Trace_InitContext(Ctx, World, GE_CONTENTS_SOLID_CLIP);
 }
 
 //=====================================================================================
 //	Trace_IntersectWorldBSP
 //	Shoot a ray through the tree finding out what solid leafs it passed through
+//	Node is a GFXNodes index.  Only tells if something was hit, the hit info is left alone.
 //=====================================================================================
-geBoolean Trace_IntersectWorldBSP(geVec3d *Front, geVec3d *Back, int32 Node)
+geBoolean Trace_IntersectWorldBSP(Trace_Context *Ctx, const geVec3d *Front, const geVec3d *Back, int32 Node)
 {
-    float		Fd, Bd, Dist;
-    int32		Side;
-    geVec3d		I;
-	GFX_Plane	*Plane;
-	int32		Contents;
-
-	gContents = GE_CONTENTS_SOLID_CLIP;
-
-	if (Node < 0)
-	{
-		Contents = TreeLeafs[-(Node+1)].Contents;
-
-		if (Contents & gContents)
-		    return GE_TRUE;						// Ray collided with solid space
-		return GE_FALSE;
-	}
-
-	Plane = &TreePlanes[TreeNodes[Node].PlaneNum];
-
-    Fd = Plane_PlaneDistanceFast(Plane, Front);
-    Bd = Plane_PlaneDistanceFast(Plane, Back);
-
-    if (Fd >= 0 && Bd >= 0) 
-        return(BSPIntersect(Front, Back, TreeNodes[Node].Children[0]));
-    if (Fd < 0 && Bd < 0)
-        return(BSPIntersect(Front, Back, TreeNodes[Node].Children[1]));
-
-    Side = Fd < 0;
-    Dist = Fd / (Fd - Bd);
-
-    I.X = Front->X + Dist * (Back->X - Front->X);
-    I.Y = Front->Y + Dist * (Back->Y - Front->Y);
-    I.Z = Front->Z + Dist * (Back->Z - Front->Z);
-
-    // Work our way to the front, from the back side.  As soon as there
-	// is no more collisions, we can assume that we have the front portion of the
-	// ray that is in empty space.  Once we find this, and see that the back half is in
-	// solid space, then we found the front intersection point...
-	if (BSPIntersect(Front, &I, TreeNodes[Node].Children[Side]))
-        return GE_TRUE;
-    else if (BSPIntersect(&I, Back, TreeNodes[Node].Children[!Side]))
-	{
-		return GE_TRUE;
-	}
-
-	return GE_FALSE;
+	return BSPIntersect(Ctx, Front, Back, Trace_RootNode(Ctx->BSPData, Node), GE_FALSE);
 }
 
-static	geVec3d		gStart, gEnd;
-static	GFX_Plane	gPlane;
-
-geBoolean Trace_CollideBeam(int32 Node, geVec3d *s, geVec3d *e, geFloat Radius)
+geBoolean Trace_CollideBeam(Trace_Context *Ctx, int32 Node, geVec3d *s, geVec3d *e, geFloat Radius)
 {
 	float		dd, sDist, eDist;
 	geVec3d		tempVec, tempVec2;
@@ -1878,9 +2280,9 @@ geBoolean Trace_CollideBeam(int32 Node, geVec3d *s, geVec3d *e, geFloat Radius)
 	if(Node < 0)
 	{
 		//leaf found, check contents
-		return	!(!(BSPData->GFXLeafs[-(Node+1)].Contents & gContents));
+		return	!(!(Ctx->BSPData->GFXLeafs[-(Node+1)].Contents & Ctx->Contents));
 	}
-	Plane	=&BSPData->GFXPlanes[BSPData->GFXNodes[Node].PlaneNum];
+	Plane	=&Ctx->BSPData->GFXPlanes[Ctx->BSPData->GFXNodes[Node].PlaneNum];
 
 	//startpoint and endpoint plane distances
 	sDist	=Plane_PlaneDistanceFast(Plane, s);
@@ -1896,7 +2298,7 @@ geBoolean Trace_CollideBeam(int32 Node, geVec3d *s, geVec3d *e, geFloat Radius)
 				if(eDist < -Radius)
 				{
 					//nothing to front, all to back
-					BackLeaf	=Trace_CollideBeam(BSPData->GFXNodes[Node].Children[1], s, e, Radius);
+					BackLeaf	=Trace_CollideBeam(Ctx, Ctx->BSPData->GFXNodes[Node].Children[1], s, e, Radius);
 				}
 				else
 				{
@@ -1916,8 +2318,8 @@ geBoolean Trace_CollideBeam(int32 Node, geVec3d *s, geVec3d *e, geFloat Radius)
 					geVec3d_Add(s, &tempVec2, &tempVec);
 
 					//send new piece to front
-					FrontLeaf	=Trace_CollideBeam(BSPData->GFXNodes[Node].Children[0], &tempVec, e, Radius);
-					BackLeaf	=Trace_CollideBeam(BSPData->GFXNodes[Node].Children[1], s, e, Radius);
+					FrontLeaf	=Trace_CollideBeam(Ctx, Ctx->BSPData->GFXNodes[Node].Children[0], &tempVec, e, Radius);
+					BackLeaf	=Trace_CollideBeam(Ctx, Ctx->BSPData->GFXNodes[Node].Children[1], s, e, Radius);
 				}
 			}
 			else
@@ -1934,7 +2336,7 @@ geBoolean Trace_CollideBeam(int32 Node, geVec3d *s, geVec3d *e, geFloat Radius)
 					geVec3d_Add(s, &tempVec2, &tempVec);
 
 					//send new piece to front
-					FrontLeaf	=Trace_CollideBeam(BSPData->GFXNodes[Node].Children[0], &tempVec, e, Radius);
+					FrontLeaf	=Trace_CollideBeam(Ctx, Ctx->BSPData->GFXNodes[Node].Children[0], &tempVec, e, Radius);
 
 					//find spot where dist==Radius along motionVec
 					//make this the back e
@@ -1951,7 +2353,7 @@ geBoolean Trace_CollideBeam(int32 Node, geVec3d *s, geVec3d *e, geFloat Radius)
 					geVec3d_Add(e, &tempVec2, &tempVec);
 
 					//send new piece to back
-					BackLeaf	=Trace_CollideBeam(BSPData->GFXNodes[Node].Children[1], s, &tempVec, Radius);
+					BackLeaf	=Trace_CollideBeam(Ctx, Ctx->BSPData->GFXNodes[Node].Children[1], s, &tempVec, Radius);
 				}
 				else
 				{
@@ -1971,8 +2373,8 @@ geBoolean Trace_CollideBeam(int32 Node, geVec3d *s, geVec3d *e, geFloat Radius)
 					geVec3d_Add(s, &tempVec2, &tempVec);
 
 					//send new piece to front
-					FrontLeaf	=Trace_CollideBeam(BSPData->GFXNodes[Node].Children[0], &tempVec, e, Radius);
-					BackLeaf	=Trace_CollideBeam(BSPData->GFXNodes[Node].Children[1], s, e, Radius);
+					FrontLeaf	=Trace_CollideBeam(Ctx, Ctx->BSPData->GFXNodes[Node].Children[0], &tempVec, e, Radius);
+					BackLeaf	=Trace_CollideBeam(Ctx, Ctx->BSPData->GFXNodes[Node].Children[1], s, e, Radius);
 				}
 			}
 		}
@@ -1998,14 +2400,14 @@ geBoolean Trace_CollideBeam(int32 Node, geVec3d *s, geVec3d *e, geFloat Radius)
 					geVec3d_Add(e, &tempVec2, &tempVec);
 
 					//send new piece to front
-					FrontLeaf	=Trace_CollideBeam(BSPData->GFXNodes[Node].Children[0], s, &tempVec, Radius);
-					BackLeaf	=Trace_CollideBeam(BSPData->GFXNodes[Node].Children[1], s, e, Radius);
+					FrontLeaf	=Trace_CollideBeam(Ctx, Ctx->BSPData->GFXNodes[Node].Children[0], s, &tempVec, Radius);
+					BackLeaf	=Trace_CollideBeam(Ctx, Ctx->BSPData->GFXNodes[Node].Children[1], s, e, Radius);
 				}
 				else
 				{
 					//all to front, all to back
-					FrontLeaf	=Trace_CollideBeam(BSPData->GFXNodes[Node].Children[0], s, e, Radius);
-					BackLeaf	=Trace_CollideBeam(BSPData->GFXNodes[Node].Children[1], s, e, Radius);
+					FrontLeaf	=Trace_CollideBeam(Ctx, Ctx->BSPData->GFXNodes[Node].Children[0], s, e, Radius);
+					BackLeaf	=Trace_CollideBeam(Ctx, Ctx->BSPData->GFXNodes[Node].Children[1], s, e, Radius);
 				}
 			}
 			else
@@ -2013,7 +2415,7 @@ geBoolean Trace_CollideBeam(int32 Node, geVec3d *s, geVec3d *e, geFloat Radius)
 				if(eDist > Radius)
 				{
 					//all to front, sdist to impact to back
-					FrontLeaf	=Trace_CollideBeam(BSPData->GFXNodes[Node].Children[0], s, e, Radius);
+					FrontLeaf	=Trace_CollideBeam(Ctx, Ctx->BSPData->GFXNodes[Node].Children[0], s, e, Radius);
 
 					//find the spot where dist==Radius along motionVec
 					//make this the back e
@@ -2030,13 +2432,13 @@ geBoolean Trace_CollideBeam(int32 Node, geVec3d *s, geVec3d *e, geFloat Radius)
 					geVec3d_Add(e, &tempVec2, &tempVec);
 
 					//send new piece to back
-					BackLeaf	=Trace_CollideBeam(BSPData->GFXNodes[Node].Children[1], s, &tempVec, Radius);
+					BackLeaf	=Trace_CollideBeam(Ctx, Ctx->BSPData->GFXNodes[Node].Children[1], s, &tempVec, Radius);
 				}
 				else
 				{
 					//all to front, all to back
-					FrontLeaf	=Trace_CollideBeam(BSPData->GFXNodes[Node].Children[0], s, e, Radius);
-					BackLeaf	=Trace_CollideBeam(BSPData->GFXNodes[Node].Children[1], s, e, Radius);
+					FrontLeaf	=Trace_CollideBeam(Ctx, Ctx->BSPData->GFXNodes[Node].Children[0], s, e, Radius);
+					BackLeaf	=Trace_CollideBeam(Ctx, Ctx->BSPData->GFXNodes[Node].Children[1], s, e, Radius);
 				}
 			}
 		}
@@ -2050,12 +2452,12 @@ geBoolean Trace_CollideBeam(int32 Node, geVec3d *s, geVec3d *e, geFloat Radius)
 				if(eDist > Radius)
 				{
 					//all to front, none to back
-					FrontLeaf	=Trace_CollideBeam(BSPData->GFXNodes[Node].Children[0], s, e, Radius);
+					FrontLeaf	=Trace_CollideBeam(Ctx, Ctx->BSPData->GFXNodes[Node].Children[0], s, e, Radius);
 				}
 				else
 				{
 					//all to front, impact to edist to back
-					FrontLeaf	=Trace_CollideBeam(BSPData->GFXNodes[Node].Children[0], s, e, Radius);
+					FrontLeaf	=Trace_CollideBeam(Ctx, Ctx->BSPData->GFXNodes[Node].Children[0], s, e, Radius);
 
 					//find spot where dist==Radius along motionVec
 					//make this the back s
@@ -2072,7 +2474,7 @@ geBoolean Trace_CollideBeam(int32 Node, geVec3d *s, geVec3d *e, geFloat Radius)
 					geVec3d_Add(e, &tempVec2, &tempVec);
 
 					//send new piece to back
-					BackLeaf	=Trace_CollideBeam(BSPData->GFXNodes[Node].Children[1], &tempVec, e, Radius);
+					BackLeaf	=Trace_CollideBeam(Ctx, Ctx->BSPData->GFXNodes[Node].Children[1], &tempVec, e, Radius);
 				}
 			}
 			else
@@ -2089,7 +2491,7 @@ geBoolean Trace_CollideBeam(int32 Node, geVec3d *s, geVec3d *e, geFloat Radius)
 					geVec3d_Add(e, &tempVec2, &tempVec);
 
 					//send new piece to front
-					FrontLeaf	=Trace_CollideBeam(BSPData->GFXNodes[Node].Children[0], s, &tempVec, Radius);
+					FrontLeaf	=Trace_CollideBeam(Ctx, Ctx->BSPData->GFXNodes[Node].Children[0], s, &tempVec, Radius);
 
 					//find spot where dist==Radius along motionVec
 					//make this the back s
@@ -2106,12 +2508,12 @@ geBoolean Trace_CollideBeam(int32 Node, geVec3d *s, geVec3d *e, geFloat Radius)
 					geVec3d_Add(s, &tempVec2, &tempVec);
 
 					//send new piece to back
-					BackLeaf	=Trace_CollideBeam(BSPData->GFXNodes[Node].Children[1], &tempVec, e, Radius);
+					BackLeaf	=Trace_CollideBeam(Ctx, Ctx->BSPData->GFXNodes[Node].Children[1], &tempVec, e, Radius);
 				}
 				else
 				{
 					//all to front, impact to edist to back
-					FrontLeaf	=Trace_CollideBeam(BSPData->GFXNodes[Node].Children[0], s, e, Radius);
+					FrontLeaf	=Trace_CollideBeam(Ctx, Ctx->BSPData->GFXNodes[Node].Children[0], s, e, Radius);
 
 					//find spot where dist==Radius along motionVec
 					//make this the back s
@@ -2128,7 +2530,7 @@ geBoolean Trace_CollideBeam(int32 Node, geVec3d *s, geVec3d *e, geFloat Radius)
 					geVec3d_Add(s, &tempVec2, &tempVec);
 
 					//send new piece to back
-					BackLeaf	=Trace_CollideBeam(BSPData->GFXNodes[Node].Children[1], &tempVec, e, Radius);
+					BackLeaf	=Trace_CollideBeam(Ctx, Ctx->BSPData->GFXNodes[Node].Children[1], &tempVec, e, Radius);
 				}
 			}
 		}
@@ -2139,7 +2541,7 @@ geBoolean Trace_CollideBeam(int32 Node, geVec3d *s, geVec3d *e, geFloat Radius)
 				if(eDist > Radius)
 				{
 					//all to front, sdist to impact to back
-					FrontLeaf	=Trace_CollideBeam(BSPData->GFXNodes[Node].Children[0], s, e, Radius);
+					FrontLeaf	=Trace_CollideBeam(Ctx, Ctx->BSPData->GFXNodes[Node].Children[0], s, e, Radius);
 
 					//find the spot where dist==Radius along motionVec
 					//make this the back e
@@ -2156,13 +2558,13 @@ geBoolean Trace_CollideBeam(int32 Node, geVec3d *s, geVec3d *e, geFloat Radius)
 					geVec3d_Add(e, &tempVec2, &tempVec);
 
 					//send new piece to back
-					BackLeaf	=Trace_CollideBeam(BSPData->GFXNodes[Node].Children[1], s, &tempVec, Radius);
+					BackLeaf	=Trace_CollideBeam(Ctx, Ctx->BSPData->GFXNodes[Node].Children[1], s, &tempVec, Radius);
 				}
 				else
 				{
 					//all to front, all to back
-					FrontLeaf	=Trace_CollideBeam(BSPData->GFXNodes[Node].Children[0], s, e, Radius);
-					BackLeaf	=Trace_CollideBeam(BSPData->GFXNodes[Node].Children[1], s, e, Radius);
+					FrontLeaf	=Trace_CollideBeam(Ctx, Ctx->BSPData->GFXNodes[Node].Children[0], s, e, Radius);
+					BackLeaf	=Trace_CollideBeam(Ctx, Ctx->BSPData->GFXNodes[Node].Children[1], s, e, Radius);
 				}
 			}
 			else
@@ -2185,14 +2587,14 @@ geBoolean Trace_CollideBeam(int32 Node, geVec3d *s, geVec3d *e, geFloat Radius)
 					geVec3d_Add(e, &tempVec2, &tempVec);
 
 					//send new piece to front
-					FrontLeaf	=Trace_CollideBeam(BSPData->GFXNodes[Node].Children[0], s, &tempVec, Radius);
-					BackLeaf	=Trace_CollideBeam(BSPData->GFXNodes[Node].Children[1], s, e, Radius);
+					FrontLeaf	=Trace_CollideBeam(Ctx, Ctx->BSPData->GFXNodes[Node].Children[0], s, &tempVec, Radius);
+					BackLeaf	=Trace_CollideBeam(Ctx, Ctx->BSPData->GFXNodes[Node].Children[1], s, e, Radius);
 				}
 				else
 				{
 					//all to front, all to back
-					FrontLeaf	=Trace_CollideBeam(BSPData->GFXNodes[Node].Children[0], s, e, Radius);
-					BackLeaf	=Trace_CollideBeam(BSPData->GFXNodes[Node].Children[1], s, e, Radius);
+					FrontLeaf	=Trace_CollideBeam(Ctx, Ctx->BSPData->GFXNodes[Node].Children[0], s, e, Radius);
+					BackLeaf	=Trace_CollideBeam(Ctx, Ctx->BSPData->GFXNodes[Node].Children[1], s, e, Radius);
 				}
 			}
 		}
@@ -2202,9 +2604,9 @@ geBoolean Trace_CollideBeam(int32 Node, geVec3d *s, geVec3d *e, geFloat Radius)
 	//stack based can early out methinks, but it's way too ugly
 	if(BackLeaf && !FrontLeaf)
 	{
-		gStart	=*s;
-		gEnd	=*e;
-		gPlane	=*Plane;
+		Ctx->BeamStart	=*s;
+		Ctx->BeamEnd	=*e;
+		Ctx->BeamPlane	=*Plane;
 	}
 
 	//this will nullify farther collisions
@@ -26,6 +26,7 @@
 #include "SURFACE.H"
 #include "FRUSTUM.H"
 #include "PLANE.H"
+#include "DrvBatch.h"
 
 #include "bitmap._h"
 
@@ -549,7 +550,7 @@ static geBoolean RenderTexturedPoint(DRV_Driver *RDriver, gePoly *Poly, Frustum_
 		assert(geWorld_HasBitmap(gWorld, Bitmap));
 		assert(geBitmap_GetTHandle(Bitmap));
 
-		RDriver->RenderMiscTexturePoly((DRV_TLVertex*)ScreenPnts, 4, geBitmap_GetTHandle(Bitmap), RenderFlags);
+		DrvBatch_MiscTexturePoly(RDriver, (DRV_TLVertex*)ScreenPnts, 4, geBitmap_GetTHandle(Bitmap), RenderFlags);
 	}
 
 	return GE_TRUE;
@@ -658,7 +659,7 @@ static void RenderTexturedPoly(DRV_Driver *RDriver, gePoly *Poly, Frustum_Info *
 	assert(geWorld_HasBitmap(gWorld, pBitmap));
 	assert(geBitmap_GetTHandle(pBitmap));
 
-	RDriver->RenderMiscTexturePoly(Clipped1, Length1, geBitmap_GetTHandle(pBitmap), RenderFlags);
+	DrvBatch_MiscTexturePoly(RDriver, Clipped1, Length1, geBitmap_GetTHandle(pBitmap), RenderFlags);
 
 }
 
@@ -746,9 +747,9 @@ static void RenderGouraudPoly(DRV_Driver *RDriver, gePoly *Poly, Frustum_Info *F
 
 	// Render it...
 	if (Clipped1[0].a != 255.0f)
-		RDriver->RenderGouraudPoly(Clipped1, Length1, DRV_RENDER_ALPHA);
+		DrvBatch_GouraudPoly(RDriver, Clipped1, Length1, DRV_RENDER_ALPHA);
 	else
-		RDriver->RenderGouraudPoly(Clipped1, Length1, 0);
+		DrvBatch_GouraudPoly(RDriver, Clipped1, Length1, 0);
 
 }
 
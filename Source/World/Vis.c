@@ -86,9 +86,24 @@ geBoolean Vis_WorldInit(geWorld *World)
 	memset(BSP->ClusterVisFrame, 0, sizeof(int32)*BSP->BSPData.NumGFXClusters);
 	memset(BSP->AreaVisFrame, 0, sizeof(int32)*BSP->BSPData.NumGFXAreas);
 
-	memset(BSP->NodeParents, 0, sizeof(int32)*BSP->BSPData.NumGFXNodes);
+	if (BSP->BSPData.GFXNodeParents && BSP->BSPData.NumGFXNodeParents == BSP->BSPData.NumGFXNodes + BSP->BSPData.NumGFXLeafs)
+	{
+		const int32		*LeafParents;
+
+		// Baked by the tools
+		memcpy(BSP->NodeParents, BSP->BSPData.GFXNodeParents, sizeof(int32)*BSP->BSPData.NumGFXNodes);
+
+		LeafParents = BSP->BSPData.GFXNodeParents + BSP->BSPData.NumGFXNodes;
+
+		for (i=0; i< BSP->BSPData.NumGFXLeafs; i++)
+			BSP->LeafData[i].Parent = LeafParents[i];
+	}
+	else
+	{
+		memset(BSP->NodeParents, 0, sizeof(int32)*BSP->BSPData.NumGFXNodes);
 	
-	FindParents(World->CurrentBSP);
+		FindParents(World->CurrentBSP);
+	}
 
 	// Set the identity on the AreaMatrix
 	for (i=0; i<256; i++)
@@ -385,42 +400,34 @@ geBoolean Vis_MarkWaterFaces(World_BSP *WBSP)
 	return GE_TRUE;
 }
 
-static GFX_Node		*GFXNodes;
-static int32		*NodeParents;
-static geWorld_Leaf	*LeafData;
-
 //=====================================================================================
 // FindParents_r
 //=====================================================================================
-static void FindParents_r(int32 Node, int32 Parent)
+static void FindParents_r(World_BSP *Bsp, int32 Node, int32 Parent)
 {
 	if (Node < 0)		// At a leaf, mark leaf parent and return
 	{
-		LeafData[-(Node+1)].Parent = Parent;
+		Bsp->LeafData[-(Node+1)].Parent = Parent;
 		return;
 	}
 
 	// At a node, mark node parent, and keep going till hitting a leaf
-	NodeParents[Node] = Parent;
+	Bsp->NodeParents[Node] = Parent;
 
 	// Go down front and back markinf parents on the way down...
-	FindParents_r(GFXNodes[Node].Children[0], Node);
-	FindParents_r(GFXNodes[Node].Children[1], Node);
+	FindParents_r(Bsp, Bsp->BSPData.GFXNodes[Node].Children[0], Node);
+	FindParents_r(Bsp, Bsp->BSPData.GFXNodes[Node].Children[1], Node);
 }
 
 //=====================================================================================
 //	Vis_FindParents
+//	Worlds can load on other threads, so everything goes through Bsp instead of statics
 //=====================================================================================
 static void FindParents(World_BSP *Bsp)
 {
 	assert(Bsp != NULL);
-	
-	// Assign some static globals so they don't flood the stack...
-	GFXNodes = Bsp->BSPData.GFXNodes;
-	LeafData = Bsp->LeafData;
-	NodeParents = Bsp->NodeParents;
 
-	FindParents_r(Bsp->BSPData.GFXModels[0].RootNode[0], -1);
+	FindParents_r(Bsp, Bsp->BSPData.GFXModels[0].RootNode[0], -1);
 }
 
 //=====================================================================================
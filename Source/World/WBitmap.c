@@ -29,6 +29,7 @@
 #include "bitmap.h"
 #include "Errorlog.h"
 #include "bitmap._h"
+#include "geNameIndex.h"
 
 //	NOTES -
 //	WBitmap is the original owner of all the bitmaps in the .BSP file.  They are kind of a hack right now.
@@ -55,6 +56,7 @@ typedef struct geWBitmap_Pool
 	int32			NumWBitmaps;
 
 	geWBitmap		*WBitmaps;				// Linear array of WBitmaps created when the Pool was created
+	geNameIndex		*NameIndex;				// WBitmaps by name, NULL to search the array
 } geWBitmap_Pool;
 
 //=====================================================================================
@@ -176,6 +178,12 @@ geBitmap *geWBitmap_Pool_GetBitmapByName(geWBitmap_Pool *Pool, const char *Bitma
 	assert(Pool);
 	assert(BitmapName);
 
+	if (Pool->NameIndex)
+	{
+		pWBitmap = (geWBitmap*)geNameIndex_Find(Pool->NameIndex, BitmapName);
+		return pWBitmap ? pWBitmap->Bitmap : NULL;
+	}
+
 	pWBitmap = Pool->WBitmaps;
 	for (i=0; i< Pool->NumWBitmaps; i++, pWBitmap++)
 	{
@@ -424,7 +432,15 @@ geBoolean geWBitmap_Pool_CreateAllWBitmaps(geWBitmap_Pool *Pool, GBSP_BSPData *B
 
 	}
 
-	
+	// Index the names, first one wins like the search.  Not fatal if it fails, names just get searched.
+	Pool->NameIndex = geNameIndex_Create(Pool->NumWBitmaps, GE_FALSE);
+
+	pWBitmap = Pool->WBitmaps;
+	for (i=0; i< Pool->NumWBitmaps && Pool->NameIndex; i++, pWBitmap++)
+	{
+		if (!geNameIndex_Add(Pool->NameIndex, pWBitmap->Name, pWBitmap))
+			geNameIndex_Destroy(&Pool->NameIndex);
+	}
 
 	return GE_TRUE;
 
@@ -475,6 +491,8 @@ void geWBitmap_Pool_DestroyAllWBitmaps(geWBitmap_Pool *Pool)
 	}
 
 	Pool->WBitmaps = NULL;	// Just to be sure
+
+	geNameIndex_Destroy(&Pool->NameIndex);
 }
 
 //=====================================================================================
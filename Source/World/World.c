@@ -22,6 +22,9 @@
 #include <assert.h>
 
 #include "WORLD.H"
+#include "ActorGrid.h"
+#include "ActorJobs.h"
+#include "DrvBatch.h"
 #include "GBSPFILE.H"
 #include "PLANE.H"
 #include "SURFACE.H"
@@ -36,6 +39,7 @@
 #include "USER.H"
 #include "list.h"
 #include "bitmap._h"
+#include "geThread.h"
 
 //#define BSP_BACK_TO_FRONT
 
@@ -109,6 +113,15 @@ S32					FirstTransPolys[MAX_MIRROR_RECURSION+1];
 
 static void RenderTransPoly(geCamera *Camera, World_TransPoly *pPoly);
 
+// Static faces found visible in the current model, handed to RDriver->World_Render in one go
+static	S32					*DrvWorldVisible;
+static	int32				NumDrvWorldVisible;
+static	int32				MaxDrvWorldVisible;
+
+static geBoolean CreateDrvWorld(geWorld *World, DRV_Driver *Driver);
+static void DestroyDrvWorld(geWorld *World);
+static geBoolean RenderDrvWorldFaces(geCamera *Camera);
+
 // GList.c
 #define GLIST_MAX_OPERATIONS		1024
 
@@ -227,6 +240,15 @@ geBoolean World_EngineInit(geEngine *Engine)
 //=====================================================================================
 void World_EngineShutdown(geEngine *Engine)
 {
+	DrvBatch_Shutdown();
+
+	if (DrvWorldVisible)
+		geRam_Free(DrvWorldVisible);
+
+	DrvWorldVisible = NULL;
+	NumDrvWorldVisible = 0;
+	MaxDrvWorldVisible = 0;
+
 	CEngine = NULL;
 	CWorld = NULL;
 	BSPData = NULL;
@@ -337,13 +359,12 @@ World_BSP *World_CreateBSPFromBox(const geVec3d *Mins, const geVec3d *Maxs)
 }
 
 //=====================================================================================
-//	geWorld_Create
+//	World_LoadBegin
+//	Allocates an empty world for the load stages to fill in
 //=====================================================================================
-GENESISAPI geWorld *geWorld_Create(geVFile *File)
+static geWorld *World_LoadBegin(void)
 {
 	geWorld			*NewWorld;
-	int32			i;
-	geWorld_Model	*Models;
 
 	NewWorld = GE_RAM_ALLOCATE_STRUCT(geWorld);
 
@@ -359,105 +380,166 @@ GENESISAPI geWorld *geWorld_Create(geVFile *File)
 	geWorld_CreateRef(NewWorld);
 
 	if ( ! List_Start() )
-		goto Error;
-
-	if (!File)
 	{
-		geVec3d	TMins = {-1000.0f, -1000.0f, -1000.0f};
-		geVec3d	TMaxs = { 1000.0f,  1000.0f,  1000.0f};
-
-		NewWorld->CurrentBSP = World_CreateBSPFromBox(&TMins, &TMaxs);
+		geWorld_Free(NewWorld);
+		return NULL;
 	}
-	else
-	{
-		assert(File != NULL);
 
-		NewWorld->CurrentBSP = CreateGBSP(File);
-	}
+	return NewWorld;
+}
 
-	// The world has changed
-	NewWorld->Changed = GE_TRUE;
+//=====================================================================================
+//	World_LoadStage
+//	Stages up to GE_WORLD_LOAD_BITMAPS only touch NewWorld, so they can run on a loader
+//	thread.  The bitmap stage goes through the global bitmap pool, so it and everything
+//	after it must run on the main thread.
+//=====================================================================================
+static geBoolean World_LoadStage(geWorld *NewWorld, geVFile *File, geWorld_LoadStage Stage)
+{
+	int32			i;
+	geWorld_Model	*Models;
 
-	if (!NewWorld->CurrentBSP)
-		goto Error;
+	switch (Stage)
+	{
+		case GE_WORLD_LOAD_BSP:
+		{
+			if (!File)
+			{
+				geVec3d	TMins = {-1000.0f, -1000.0f, -1000.0f};
+				geVec3d	TMaxs = { 1000.0f,  1000.0f,  1000.0f};
 
-	assert(NewWorld->CurrentBSP->BSPData.NumGFXLeafs > 0);
+				NewWorld->CurrentBSP = World_CreateBSPFromBox(&TMins, &TMaxs);
+			}
+			else
+			{
+				NewWorld->CurrentBSP = CreateGBSP(File);
+			}
 
-	// Create the leafdata array
-	NewWorld->CurrentBSP->LeafData = GE_RAM_ALLOCATE_ARRAY(geWorld_Leaf, NewWorld->CurrentBSP->BSPData.NumGFXLeafs);
+			// The world has changed
+			NewWorld->Changed = GE_TRUE;
 
-	if (!NewWorld->CurrentBSP->LeafData)
-		goto Error;
+			if (!NewWorld->CurrentBSP)
+				return GE_FALSE;
 
-	memset(NewWorld->CurrentBSP->LeafData, 0, sizeof(geWorld_Leaf)*NewWorld->CurrentBSP->BSPData.NumGFXLeafs);
+			assert(NewWorld->CurrentBSP->BSPData.NumGFXLeafs > 0);
 
-	if (!Light_WorldInit(NewWorld))
-		goto Error;
+			// Create the leafdata array
+			NewWorld->CurrentBSP->LeafData = GE_RAM_ALLOCATE_ARRAY(geWorld_Leaf, NewWorld->CurrentBSP->BSPData.NumGFXLeafs);
 
-	if (!Ent_WorldInit(NewWorld))
-		goto Error;
+			if (!NewWorld->CurrentBSP->LeafData)
+				return GE_FALSE;
 
-	if (!Vis_WorldInit(NewWorld))
-		goto Error;
+			memset(NewWorld->CurrentBSP->LeafData, 0, sizeof(geWorld_Leaf)*NewWorld->CurrentBSP->BSPData.NumGFXLeafs);
+			return GE_TRUE;
+		}
 
-	if (!Surf_WorldInit(NewWorld))
-		goto Error;
+		case GE_WORLD_LOAD_LIGHT:
+			return Light_WorldInit(NewWorld);
 
-	// Create the wbitmaps out of the GFXTexData
-	NewWorld->CurrentBSP->WBitmapPool = geWBitmap_Pool_Create(&NewWorld->CurrentBSP->BSPData);
+		case GE_WORLD_LOAD_ENTITIES:
+			return Ent_WorldInit(NewWorld);
 
-	if (!NewWorld->CurrentBSP->WBitmapPool)
-		goto Error;
+		case GE_WORLD_LOAD_VIS:
+			return Vis_WorldInit(NewWorld);
 
-	#if 1
-		// HACK
-		// We can now free the texturedata in the BSP that was loaded off disk.
-		// Eventually, the BSP disk format will be bitmaps, and no conversion will be needed, JP.
-		if (NewWorld->CurrentBSP->BSPData.GFXTexData)	// Not all worlds have tex data!!!
+		case GE_WORLD_LOAD_SURFACES:
 		{
-			geRam_Free(NewWorld->CurrentBSP->BSPData.GFXTexData);
-			NewWorld->CurrentBSP->BSPData.GFXTexData = NULL;	// This is to assure that FreeGBSPFile does not touch this again
-			NewWorld->CurrentBSP->BSPData.NumGFXTexData = 0;
+			if (!Surf_WorldInit(NewWorld))
+				return GE_FALSE;
+
+			// Vis and surfaces were the only users of the precomputed chunks
+			GBSP_FreeDerivedData(&NewWorld->CurrentBSP->BSPData);
+			return GE_TRUE;
 		}
-	#endif
 
-	// Add all the bitmaps in the WBitmapPool to the world
-	if (!geWorld_BitmapListInit(NewWorld))
-	{
-		geErrorLog_AddString(-1, "geWorld_WorldCreate:  geWorld_BitmapListInit failed.", NULL);
-		return GE_FALSE;
-	}
+		case GE_WORLD_LOAD_BITMAPS:
+		{
+			// Create the wbitmaps out of the GFXTexData
+			NewWorld->CurrentBSP->WBitmapPool = geWBitmap_Pool_Create(&NewWorld->CurrentBSP->BSPData);
+
+			if (!NewWorld->CurrentBSP->WBitmapPool)
+				return GE_FALSE;
+
+			#if 1
+				// HACK
+				// We can now free the texturedata in the BSP that was loaded off disk.
+				// Eventually, the BSP disk format will be bitmaps, and no conversion will be needed, JP.
+				// Not all worlds have tex data, and a mapped file keeps its own (the pages just go cold)
+				GBSP_FreeTexData(&NewWorld->CurrentBSP->BSPData);
+			#endif
 
-	// Init user stuff
-	if (!User_WorldInit(NewWorld))
-		goto Error;
+			// Add all the bitmaps in the WBitmapPool to the world
+			if (!geWorld_BitmapListInit(NewWorld))
+			{
+				geErrorLog_AddString(-1, "geWorld_WorldCreate:  geWorld_BitmapListInit failed.", NULL);
+				return GE_FALSE;
+			}
+
+			return GE_TRUE;
+		}
+
+		case GE_WORLD_LOAD_FINISH:
+		{
+			// Init user stuff
+			if (!User_WorldInit(NewWorld))
+				return GE_FALSE;
 	
-	Models = NewWorld->CurrentBSP->Models;
+			Models = NewWorld->CurrentBSP->Models;
 
-	//#pragma message ("Fixed number of models supported")
-	for (i=0; i< MAX_MODELS; i++)
-	{
-		memset(&Models[i], 0, sizeof(geWorld_Model));
+			//#pragma message ("Fixed number of models supported")
+			for (i=0; i< MAX_MODELS; i++)
+			{
+				memset(&Models[i], 0, sizeof(geWorld_Model));
 
-		Models[i].VisFrame = -1;
+				Models[i].VisFrame = -1;
 		
-		geXForm3d_SetIdentity(&Models[i].XForm);
-	}
+				geXForm3d_SetIdentity(&Models[i].XForm);
+			}
 	
-	CalcBSPModelInfo(NewWorld->CurrentBSP);
+			CalcBSPModelInfo(NewWorld->CurrentBSP);
+
+			if (!BuildSkyBox(&NewWorld->SkyBox, &NewWorld->CurrentBSP->BSPData.GFXSkyData))
+				return GE_FALSE;
 
-	if (!BuildSkyBox(&NewWorld->SkyBox, &NewWorld->CurrentBSP->BSPData.GFXSkyData))
-		goto Error;
+			NewWorld->CurrentLeaf = -1;			// Make sure the level gets vised for the first time...
 
-	NewWorld->CurrentLeaf = -1;			// Make sure the level gets vised for the first time...
+			NewWorld->ActorCount = 0;
+			NewWorld->ActorArray = NULL;
+			ActorGrid_Init(NewWorld);
+			ActorJobs_Init(NewWorld);
 
-	NewWorld->ActorCount = 0;
-	NewWorld->ActorArray = NULL;
+			if (!CreateStaticFogList(NewWorld))
+			{
+				geErrorLog_AddString(-1,"Failed to create static FogList", NULL);
+				return GE_FALSE;
+			}
 
-	if (!CreateStaticFogList(NewWorld))
+			return GE_TRUE;
+		}
+
+		default:
+			assert(0);
+			return GE_FALSE;
+	}
+}
+
+//=====================================================================================
+//	geWorld_Create
+//=====================================================================================
+GENESISAPI geWorld *geWorld_Create(geVFile *File)
+{
+	geWorld			*NewWorld;
+	int32			Stage;
+
+	NewWorld = World_LoadBegin();
+
+	if (!NewWorld)
+		return NULL;
+
+	for (Stage = GE_WORLD_LOAD_BSP; Stage < GE_WORLD_LOAD_NUM_STAGES; Stage++)
 	{
-		geErrorLog_AddString(-1,"Failed to create static FogList", NULL);
-		goto Error;
+		if (!World_LoadStage(NewWorld, File, (geWorld_LoadStage)Stage))
+			goto Error;
 	}
 
 	return NewWorld;
@@ -468,6 +550,200 @@ GENESISAPI geWorld *geWorld_Create(geVFile *File)
 	return NULL;
 }
 
+//=====================================================================================
+//	Background world loading
+//=====================================================================================
+struct geWorld_Loader
+{
+	geWorld					*World;
+	geVFile					*File;
+
+	geWorld_LoadProgressCB	*ProgressCB;
+	void					*Context;
+
+	geThread				*Thread;
+
+	volatile int32			Stage;			// Stage being run
+	volatile int32			Ready;			// Loader thread is done
+	volatile int32			Cancel;
+	geBoolean				Failed;			// Only looked at once Ready is set
+};
+
+//=====================================================================================
+//	World_LoaderRunStage
+//=====================================================================================
+static geBoolean World_LoaderRunStage(geWorld_Loader *Loader, geWorld_LoadStage Stage)
+{
+	geAtomic_Set(&Loader->Stage, Stage);
+
+	if (Loader->ProgressCB)
+		Loader->ProgressCB(Stage, (geFloat)Stage / (geFloat)GE_WORLD_LOAD_NUM_STAGES, Loader->Context);
+
+	if (Stage == GE_WORLD_LOAD_NUM_STAGES)
+		return GE_TRUE;
+
+	return World_LoadStage(Loader->World, Loader->File, Stage);
+}
+
+//=====================================================================================
+//	World_LoaderThread
+//=====================================================================================
+static void World_LoaderThread(void *Context)
+{
+	geWorld_Loader	*Loader;
+	int32			Stage;
+
+	Loader = (geWorld_Loader*)Context;
+
+	for (Stage = GE_WORLD_LOAD_BSP; Stage < GE_WORLD_LOAD_BITMAPS; Stage++)
+	{
+		if (geAtomic_Get(&Loader->Cancel) || !World_LoaderRunStage(Loader, (geWorld_LoadStage)Stage))
+		{
+			Loader->Failed = GE_TRUE;
+			break;
+		}
+	}
+
+	geAtomic_Set(&Loader->Ready, 1);
+}
+
+//=====================================================================================
+//	World_LoaderFree
+//=====================================================================================
+static void World_LoaderFree(geWorld_Loader *Loader)
+{
+	if (Loader->Thread)
+		geThread_Join(Loader->Thread);
+
+	if (Loader->World)
+		geWorld_Free(Loader->World);
+
+	geRam_Free(Loader);
+}
+
+//=====================================================================================
+//	geWorld_LoaderCreate
+//=====================================================================================
+GENESISAPI geWorld_Loader *geWorld_LoaderCreate(geVFile *File, geWorld_LoadProgressCB *ProgressCB, void *Context)
+{
+	geWorld_Loader	*Loader;
+
+	Loader = GE_RAM_ALLOCATE_STRUCT(geWorld_Loader);
+
+	if (!Loader)
+	{
+		geErrorLog_Add(GE_ERR_OUT_OF_MEMORY, NULL);
+		return NULL;
+	}
+
+	memset(Loader, 0, sizeof(geWorld_Loader));
+
+	Loader->File = File;
+	Loader->ProgressCB = ProgressCB;
+	Loader->Context = Context;
+
+	// List_Start and the world ref have to happen on this thread
+	Loader->World = World_LoadBegin();
+
+	if (!Loader->World)
+		goto ExitWithError;
+
+	Loader->Thread = geThread_Start(World_LoaderThread, Loader);
+
+	if (!Loader->Thread)
+	{
+		geErrorLog_AddString(-1, "geWorld_LoaderCreate:  Could not start the loader thread.", NULL);
+		goto ExitWithError;
+	}
+
+	return Loader;
+
+	ExitWithError:
+	{
+		World_LoaderFree(Loader);
+		return NULL;
+	}
+}
+
+//=====================================================================================
+//	geWorld_LoaderIsReady
+//=====================================================================================
+GENESISAPI geBoolean geWorld_LoaderIsReady(const geWorld_Loader *Loader)
+{
+	assert(Loader);
+
+	return geAtomic_Get((volatile int32*)&Loader->Ready) ? GE_TRUE : GE_FALSE;
+}
+
+//=====================================================================================
+//	geWorld_LoaderGetStage
+//=====================================================================================
+GENESISAPI geWorld_LoadStage geWorld_LoaderGetStage(const geWorld_Loader *Loader, geFloat *Fraction)
+{
+	int32		Stage;
+
+	assert(Loader);
+
+	Stage = geAtomic_Get((volatile int32*)&Loader->Stage);
+
+	if (Fraction)
+		*Fraction = (geFloat)Stage / (geFloat)GE_WORLD_LOAD_NUM_STAGES;
+
+	return (geWorld_LoadStage)Stage;
+}
+
+//=====================================================================================
+//	geWorld_LoaderFinish
+//=====================================================================================
+GENESISAPI geWorld *geWorld_LoaderFinish(geWorld_Loader *Loader)
+{
+	geWorld		*World;
+	int32		Stage;
+
+	assert(Loader);
+
+	geThread_Join(Loader->Thread);
+	Loader->Thread = NULL;
+
+	if (!Loader->Failed)
+	{
+		for (Stage = GE_WORLD_LOAD_BITMAPS; Stage <= GE_WORLD_LOAD_NUM_STAGES; Stage++)
+		{
+			if (!World_LoaderRunStage(Loader, (geWorld_LoadStage)Stage))
+			{
+				Loader->Failed = GE_TRUE;
+				break;
+			}
+		}
+	}
+
+	if (Loader->Failed)
+	{
+		World_LoaderFree(Loader);
+		return NULL;
+	}
+
+	World = Loader->World;
+	Loader->World = NULL;
+
+	World_LoaderFree(Loader);
+
+	return World;
+}
+
+//=====================================================================================
+//	geWorld_LoaderDestroy
+//=====================================================================================
+GENESISAPI void geWorld_LoaderDestroy(geWorld_Loader *Loader)
+{
+	assert(Loader);
+
+	// Stops the loader thread at the next stage boundary
+	geAtomic_Set(&Loader->Cancel, 1);
+
+	World_LoaderFree(Loader);
+}
+
 //=====================================================================================
 //	geWorld_Free
 //=====================================================================================
@@ -503,6 +779,9 @@ if (World->CurrentBSP)
 		}
 	
 	assert( World->ActorArray == NULL );
+
+	ActorGrid_Shutdown(World);
+	ActorJobs_Shutdown(World);
 	
 	// Call other modules to release info from the world that they created...
 #ifdef	MESHES
@@ -559,6 +838,11 @@ if (World->CurrentBSP)
 		World->CurrentBSP->LeafData = NULL;
 	}
 
+	assert(!World->CurrentBSP->DrvWorld);		// geWorld_DetachAll should have been called
+
+	if (World->CurrentBSP->DrvWorldFaces)
+		geRam_Free(World->CurrentBSP->DrvWorldFaces);
+
 	GBSP_FreeGBSPFile(&World->CurrentBSP->BSPData);
 	geRam_Free(World->CurrentBSP);
 
@@ -666,6 +950,7 @@ geBoolean World_WorldRenderQ(geEngine *Engine, geWorld *World, geCamera *Camera)
 	Frustum_Info		FrustumInfo;
 	geFloat				Rpm;
 	World_SkyBox		*pSkyBox;
+	int32				NumCmds, NumRuns;
 
 	assert(Engine != NULL);
 	assert(World != NULL);
@@ -711,9 +996,22 @@ geBoolean World_WorldRenderQ(geEngine *Engine, geWorld *World, geCamera *Camera)
 
 	g_HackFrustum = FrustumInfo;
 
+	// Record the polys, and hand them to the driver sorted by state
+	DrvBatch_Begin(RDriver);
+
 	// Render the entire scene through the DEFAULT FRUSTUM
 	if (!RenderScene(Engine, World, Camera, &FrustumInfo))
+	{
+		DrvBatch_End();
 		return GE_FALSE;
+	}
+
+	if (!DrvBatch_End())
+		return GE_FALSE;
+
+	DrvBatch_GetStats(&NumCmds, &NumRuns);
+	Engine->DebugInfo.BatchCmds += NumCmds;
+	Engine->DebugInfo.BatchRuns += NumRuns;
 
 	// Adjust current sky angle 
 	pSkyBox = &World->SkyBox;
@@ -879,6 +1177,11 @@ static geBoolean RenderScene(geEngine *Engine, geWorld *World, geCamera *Camera,
 		// Make the frustum go to world space for actors
 		Frustum_TransformToWorldSpace(FrustumInfo, Camera, &ActorFrustum);
 
+		if (!ActorJobs_Begin(World))
+			return GE_FALSE;
+
+		DrvBatch_Flush();
+
 		// Tell the driver we want to render meshes
 		if (!Engine->DriverInfo.RDriver->BeginMeshes())
 		{
@@ -915,6 +1218,17 @@ static geBoolean RenderScene(geEngine *Engine, geWorld *World, geCamera *Camera,
 						}
 				}
 
+				ActorJobs_Add(World, WActor);
+			}
+
+		// Pose and skin all the visible actors at once, geActor_Render picks up the result
+		if (MirrorRecursion == 0)
+			ActorJobs_Prepare(World, Camera);
+
+		for (i=0; i< World->ActorJobs.NumJobs; i++)
+			{
+				WActor = World->ActorJobs.Jobs[i].WActor;
+
 				if (MirrorRecursion == 0)
 				{
 					geActor_Render( WActor->Actor, Engine, World, Camera);
@@ -930,6 +1244,8 @@ static geBoolean RenderScene(geEngine *Engine, geWorld *World, geCamera *Camera,
 
 			}
 
+		DrvBatch_Flush();
+
 		if (!Engine->DriverInfo.RDriver->EndMeshes())
 		{
 			geErrorLog_Add(GE_ERR_END_MESHES_FAILED, NULL);
@@ -948,6 +1264,10 @@ static geBoolean RenderScene(geEngine *Engine, geWorld *World, geCamera *Camera,
 	if (!GList_RenderOperations(Camera))
 		return GE_FALSE;
 
+	// The mirror poly that started this scene has to land on top of it
+	if (!DrvBatch_Flush())
+		return GE_FALSE;
+
 	return GE_TRUE;
 }
 
@@ -1223,6 +1543,23 @@ static void RenderFace(int32 Face, const geWorld_RenderInfo *RenderInfo, int32 C
 	if (pSurfInfo[Face].LInfo.Face == -1)
 		return;
 
+	// Static faces are already on the driver, it transforms, clips and projects them itself.
+	//	Mirrors still need the CPU path, since the scene behind them is clipped to the mirror poly
+	if (CBSP->DrvWorld && MirrorRecursion == 0 && CBSP->DrvWorldFaces[Face] >= 0)
+	{
+		pTexInfo = &BSPData->GFXTexInfo[BSPData->GFXFaces[Face].TexInfo];
+
+		pWBitmap = geWBitmap_Pool_GetWBitmapByIndex(CBSP->WBitmapPool, pTexInfo->Texture);
+		assert(pWBitmap);
+		geWBitmap_SetVisFrame(pWBitmap, CWorld->CurFrameDynamic);
+
+		assert(NumDrvWorldVisible < MaxDrvWorldVisible);
+		DrvWorldVisible[NumDrvWorldVisible++] = CBSP->DrvWorldFaces[Face];
+
+		CEngine->DebugInfo.SentPolys++;
+		return;
+	}
+
 	pFace = &BSPData->GFXFaces[Face];
 	pGFXVerts = BSPData->GFXVerts;
 
@@ -1521,7 +1858,7 @@ static void RenderFace(int32 Face, const geWorld_RenderInfo *RenderInfo, int32 C
 
 	if (pTexInfo->Flags & TEXINFO_NO_LIGHTMAP)
 	{
-		RDriver->RenderWorldPoly(Clipped1, Length1, THandle, &DrvTexInfo, NULL, RenderFlags);
+		DrvBatch_WorldPoly(RDriver, Clipped1, Length1, THandle, &DrvTexInfo, NULL, RenderFlags);
 	}
 	else
 	{
@@ -1533,7 +1870,7 @@ static void RenderFace(int32 Face, const geWorld_RenderInfo *RenderInfo, int32 C
 		GlobalInfo.TexWidth = pLInfo->Width<<4;
 		GlobalInfo.TexHeight = pLInfo->Height<<4;
 
-		RDriver->RenderWorldPoly(Clipped1, Length1, THandle, &DrvTexInfo, &pSurfInfo[Face].LInfo, RenderFlags);
+		DrvBatch_WorldPoly(RDriver, Clipped1, Length1, THandle, &DrvTexInfo, &pSurfInfo[Face].LInfo, RenderFlags);
 	}
 }
 
@@ -1556,6 +1893,8 @@ static geBoolean RenderWorldModel(geCamera *Camera, Frustum_Info *FrustumInfo, g
 
 	g_CurrentModel = Models;
 
+	DrvBatch_Flush();
+
 	if (!RDriver->BeginWorld())
 	{
 		geErrorLog_Add(GE_ERR_BEGIN_WORLD_FAILED, NULL);
@@ -1601,9 +1940,18 @@ static geBoolean RenderWorldModel(geCamera *Camera, Frustum_Info *FrustumInfo, g
 							&RenderInfo,
 							StartClipFlags);
 
+	// Draw the static faces that were found, while the camera is still about the model
+	if (!RenderDrvWorldFaces(Camera))
+	{
+		geCamera_SetWorldSpaceXForm(Camera, &OldXForm);
+		return GE_FALSE;
+	}
+
 	// Restore the camera
 	geCamera_SetWorldSpaceXForm(Camera, &OldXForm);
 	
+	DrvBatch_Flush();
+
 	if (!RDriver->EndWorld())
 	{
 		geErrorLog_Add(GE_ERR_END_WORLD_FAILED, NULL);
@@ -1627,6 +1975,8 @@ static geBoolean RenderSubModels(geCamera *Camera, Frustum_Info *FrustumInfo, ge
 	geWorld_RenderInfo	RenderInfo;
 
 
+	DrvBatch_Flush();
+
 	if (!RDriver->BeginModels())
 	{
 		geErrorLog_Add(GE_ERR_BEGIN_MODELS_FAILED, NULL);
@@ -1693,12 +2043,21 @@ static geBoolean RenderSubModels(geCamera *Camera, Frustum_Info *FrustumInfo, ge
 								&RenderInfo,
 								StartClipFlags);
 
+		if (!RenderDrvWorldFaces(Camera))
+		{
+			geCamera_SetWorldSpaceXForm(Camera, &OldXForm);
+			CWorld->VisInfo = OldVis;
+			return GE_FALSE;
+		}
+
 		// Restore the camera
 		geCamera_SetWorldSpaceXForm(Camera, &OldXForm);
 	}
 
 	CWorld->VisInfo = OldVis;		// Restore original vis info
 	
+	DrvBatch_Flush();
+
 	if (!RDriver->EndModels())
 	{
 		geErrorLog_Add(GE_ERR_END_MODELS_FAILED, NULL);
@@ -1707,6 +2066,245 @@ static geBoolean RenderSubModels(geCamera *Camera, Frustum_Info *FrustumInfo, ge
 	return GE_TRUE;
 }
 
+//=====================================================================================
+//	CreateDrvWorld
+//	Hands all the faces that never change (relative to their model) over to the driver,
+//	so RenderFace only has to tell it which ones are visible
+//=====================================================================================
+static geBoolean CreateDrvWorld(geWorld *World, DRV_Driver *Driver)
+{
+	World_BSP		*BSP;
+	GBSP_BSPData	*BSP2;
+	Surf_SurfInfo	*pSurf;
+	DRV_WorldFace	*Faces, *pDrvFace;
+	DRV_WorldVertex	*Verts, *pVert;
+	int32			i, v, NumFaces, NumVerts;
+
+	assert(World);
+	assert(Driver);
+
+	BSP = World->CurrentBSP;
+
+	if (!BSP || !Driver->World_Create || !Driver->World_Destroy || !Driver->World_Render)
+		return GE_TRUE;			// Everything goes through RenderWorldPoly
+
+	assert(!BSP->DrvWorld);
+
+	BSP2 = &BSP->BSPData;
+
+	if (!BSP->DrvWorldFaces)
+	{
+		BSP->DrvWorldFaces = GE_RAM_ALLOCATE_ARRAY(int32, BSP2->NumGFXFaces+1);
+
+		if (!BSP->DrvWorldFaces)
+			return GE_FALSE;
+	}
+
+	// Find the static faces, and how much room they need
+	NumFaces = NumVerts = 0;
+
+	for (i=0, pSurf = BSP->SurfInfo; i< BSP2->NumGFXFaces; i++, pSurf++)
+	{
+		GFX_Face		*pFace = &BSP2->GFXFaces[i];
+		GFX_TexInfo		*pTexInfo = &BSP2->GFXTexInfo[pFace->TexInfo];
+		geWBitmap		*pWBitmap;
+
+		BSP->DrvWorldFaces[i] = -1;
+
+		if (pSurf->LInfo.Face == -1 || pFace->NumVerts < 3)
+			continue;
+		if (pSurf->Flags & (SURFINFO_WAVY | SURFINFO_TRANS))
+			continue;
+		if (pTexInfo->Flags & (TEXINFO_SKY | TEXINFO_MIRROR))
+			continue;
+
+		pWBitmap = geWBitmap_Pool_GetWBitmapByIndex(BSP->WBitmapPool, pTexInfo->Texture);
+
+		if (!pWBitmap || !geBitmap_GetTHandle(geWBitmap_GetBitmap(pWBitmap)))
+			continue;
+
+		BSP->DrvWorldFaces[i] = NumFaces++;
+		NumVerts += pFace->NumVerts;
+	}
+
+	if (!NumFaces)
+		return GE_TRUE;
+
+	Faces = GE_RAM_ALLOCATE_ARRAY(DRV_WorldFace, NumFaces);
+	Verts = GE_RAM_ALLOCATE_ARRAY(DRV_WorldVertex, NumVerts);
+
+	if (!Faces || !Verts)
+	{
+		if (Faces)
+			geRam_Free(Faces);
+		if (Verts)
+			geRam_Free(Verts);
+		return GE_FALSE;
+	}
+
+	pDrvFace = Faces;
+	pVert = Verts;
+
+	for (i=0, pSurf = BSP->SurfInfo; i< BSP2->NumGFXFaces; i++, pSurf++)
+	{
+		GFX_Face		*pFace;
+		GFX_TexInfo		*pTexInfo;
+		Surf_TexVert	*pTex;
+		int32			*pIndex;
+
+		if (BSP->DrvWorldFaces[i] < 0)
+			continue;
+
+		pFace = &BSP2->GFXFaces[i];
+		pTexInfo = &BSP2->GFXTexInfo[pFace->TexInfo];
+
+		// Same as what RenderFace hands to RenderWorldPoly
+		pDrvFace->FirstVert = (S32)(pVert - Verts);
+		pDrvFace->NumVerts = pFace->NumVerts;
+		pDrvFace->THandle = geBitmap_GetTHandle(geWBitmap_GetBitmap(geWBitmap_Pool_GetWBitmapByIndex(BSP->WBitmapPool, pTexInfo->Texture)));
+		pDrvFace->TexInfo.ShiftU = pSurf->ShiftU;
+		pDrvFace->TexInfo.ShiftV = pSurf->ShiftV;
+		pDrvFace->TexInfo.DrawScaleU = pTexInfo->DrawScale[0];
+		pDrvFace->TexInfo.DrawScaleV = pTexInfo->DrawScale[1];
+		pDrvFace->LInfo = (pTexInfo->Flags & TEXINFO_NO_LIGHTMAP) ? NULL : &pSurf->LInfo;
+		pDrvFace->Flags = 0;
+
+		pIndex = &BSP2->GFXVertIndexList[pFace->FirstVert];
+		pTex = &BSP->TexVerts[pFace->FirstVert];
+
+		for (v=0; v< pFace->NumVerts; v++, pVert++, pIndex++, pTex++)
+		{
+			pVert->x = BSP2->GFXVerts[*pIndex].X;
+			pVert->y = BSP2->GFXVerts[*pIndex].Y;
+			pVert->z = BSP2->GFXVerts[*pIndex].Z;
+			pVert->u = pTex->u;
+			pVert->v = pTex->v;
+
+			if (pTexInfo->Flags & TEXINFO_GOURAUD)
+			{
+				pVert->r = pTex->r;
+				pVert->g = pTex->g;
+				pVert->b = pTex->b;
+			}
+			else
+			{
+				pVert->r = 255.0f;
+				pVert->g = 255.0f;
+				pVert->b = 255.0f;
+			}
+		}
+
+		pDrvFace++;
+	}
+
+	BSP->DrvWorld = Driver->World_Create(Faces, NumFaces, Verts, NumVerts);
+
+	// The driver keeps its own copy
+	geRam_Free(Faces);
+	geRam_Free(Verts);
+
+	if (!BSP->DrvWorld)
+	{
+		geErrorLog_AddString(-1, Driver->LastErrorStr, NULL);
+		return GE_FALSE;
+	}
+
+	BSP->DrvWorldDriver = Driver;
+
+	// Every static face can be visible at once
+	if (NumFaces > MaxDrvWorldVisible)
+	{
+		S32		*Visible;
+
+		Visible = GE_RAM_REALLOC_ARRAY(DrvWorldVisible, S32, NumFaces);
+
+		if (!Visible)
+		{
+			DestroyDrvWorld(World);
+			return GE_FALSE;
+		}
+
+		DrvWorldVisible = Visible;
+		MaxDrvWorldVisible = NumFaces;
+	}
+
+	return GE_TRUE;
+}
+
+//=====================================================================================
+//	DestroyDrvWorld
+//=====================================================================================
+static void DestroyDrvWorld(geWorld *World)
+{
+	World_BSP		*BSP;
+
+	BSP = World->CurrentBSP;
+
+	if (!BSP || !BSP->DrvWorld)
+		return;
+
+	assert(BSP->DrvWorldDriver);
+
+	BSP->DrvWorldDriver->World_Destroy(BSP->DrvWorld);
+
+	BSP->DrvWorld = NULL;
+	BSP->DrvWorldDriver = NULL;
+
+	// Everything goes back through RenderFace until the world is attached again
+	if (BSP->DrvWorldFaces)
+	{
+		geRam_Free(BSP->DrvWorldFaces);
+		BSP->DrvWorldFaces = NULL;
+	}
+}
+
+//=====================================================================================
+//	RenderDrvWorldFaces
+//	Draws the static faces RenderFace found for the current model.  The camera must
+//	still be about the model (as set up by RenderWorldModel/RenderSubModels)
+//=====================================================================================
+static geBoolean RenderDrvWorldFaces(geCamera *Camera)
+{
+	DRV_WorldView			View;
+	geCamera_Projection		Projection;
+	geRect					Rect;
+	geBoolean				Ret;
+
+	// Faces seen through a mirror went through RenderFace, and must not touch the list
+	//	of the model that holds the mirror
+	if (MirrorRecursion > 0 || !NumDrvWorldVisible)
+		return GE_TRUE;
+
+	assert(CBSP->DrvWorld);
+
+	geCamera_GetProjection(Camera, &Projection);
+	geCamera_GetClippingRect(Camera, &Rect);
+
+	View.XForm = *geCamera_GetCameraSpaceXForm(Camera);
+	View.Scale = Projection.Scale;
+	View.XCenter = Projection.XCenter;
+	View.YCenter = Projection.YCenter;
+	View.ZScale = Projection.ZScale;
+	View.Left = (float)Rect.Left;
+	View.Top = (float)Rect.Top;
+	View.Right = (float)Rect.Right;
+	View.Bottom = (float)Rect.Bottom;
+
+	// These go out before the polys recorded for the model, so mirrors and
+	//	ordered polys still land on top of them
+	Ret = RDriver->World_Render(CBSP->DrvWorld, DrvWorldVisible, NumDrvWorldVisible, &View);
+
+	NumDrvWorldVisible = 0;
+
+	if (!Ret)
+	{
+		geErrorLog_AddString(-1, "RenderDrvWorldFaces:  World_Render failed.", RDriver->LastErrorStr);
+		return GE_FALSE;
+	}
+
+	return GE_TRUE;
+}
+
 //========================================================================================
 //	CreateGBSP
 //========================================================================================
@@ -1794,7 +2392,7 @@ static void RenderTransPoly(geCamera *Camera, World_TransPoly *pPoly)
 
 		assert(THandle);
 
-		RDriver->RenderWorldPoly(pTLVerts, NumVerts, THandle, &DrvTexInfo, NULL, DRV_RENDER_ALPHA | DRV_RENDER_FLUSH);
+		DrvBatch_WorldPoly(RDriver, pTLVerts, NumVerts, THandle, &DrvTexInfo, NULL, DRV_RENDER_ALPHA | DRV_RENDER_FLUSH);
 	}
 	else
 	{
@@ -1810,7 +2408,7 @@ static void RenderTransPoly(geCamera *Camera, World_TransPoly *pPoly)
 
 		assert(THandle);
 
-		RDriver->RenderWorldPoly(pTLVerts, NumVerts, THandle, &DrvTexInfo, pLInfo, DRV_RENDER_ALPHA | DRV_RENDER_FLUSH);
+		DrvBatch_WorldPoly(RDriver, pTLVerts, NumVerts, THandle, &DrvTexInfo, pLInfo, DRV_RENDER_ALPHA | DRV_RENDER_FLUSH);
 	}
 }
 
@@ -2172,6 +2770,7 @@ GENESISAPI geBoolean geWorld_AddActor( geWorld *World, geActor *Actor, uint32 Fl
 			return GE_FALSE;
 		}
 	World->ActorCount++;
+	ActorGrid_AddActor(World, World->ActorCount-1);
 	geActor_CreateRef(Actor);
 
 	#ifdef DO_ADDREMOVE_MESSAGES	
@@ -2210,7 +2809,9 @@ GENESISAPI geBoolean geWorld_RemoveActor(geWorld *World, geActor *Actor)
 			if (World->ActorArray[i].Actor == Actor)
 				{
 					geActor_Destroy( &Actor );
+					ActorGrid_RemoveActor(World, i);
 					World->ActorArray[i] = World->ActorArray[Count-1];
+					ActorGrid_MoveActor(World, Count-1, i);
 					World->ActorArray[Count-1].Actor = NULL;
 					World->ActorArray[Count-1].Flags = 0;
 					World->ActorCount--;
@@ -2334,9 +2935,6 @@ GENESISAPI geBoolean geWorld_LeafMightSeeLeaf(const geWorld *World, int32 Leaf1,
 //========================================================================================
 GENESISAPI geEntity_EntitySet *geWorld_GetEntitySet(geWorld *World, const char *ClassName)
 {
-	geWorld_EntClassSet		*WSets;
-	int32					i;
-
 	assert(World);
 
 	// No classname, just return the main set of all entities
@@ -2347,17 +2945,7 @@ GENESISAPI geEntity_EntitySet *geWorld_GetEntitySet(geWorld *World, const char *
 		return World->EntClassSets[0].Set;
 	}
 
-	WSets = World->EntClassSets;
-	
-	for (i=1; i< World->NumEntClassSets; i++)
-	{
-		assert(WSets[i].Set);
-
-		if (!stricmp(WSets[i].ClassName, ClassName))
-			return WSets[i].Set;
-	}
-
-	return NULL;
+	return Ent_WorldFindClassSet(World, ClassName);
 }
 
 //====================================================================================
@@ -2850,10 +3438,10 @@ static void RenderSkyThroughFrustum(World_SkyBox *SkyBox, geWorld_SkyBoxTData *S
 			TexInfo.DrawScaleU = 1.0f;
 			TexInfo.DrawScaleV = 1.0f;
 
-			RDriver->RenderWorldPoly(Clipped1, Length1, THandle, &TexInfo, NULL, SkyFlags);
+			DrvBatch_WorldPoly(RDriver, Clipped1, Length1, THandle, &TexInfo, NULL, SkyFlags);
 		}
 	#else
-		RDriver->RenderMiscTexturePoly(Clipped1, Length1, THandle, SkyFlags);
+		DrvBatch_MiscTexturePoly(RDriver, Clipped1, Length1, THandle, SkyFlags);
 	#endif
 
 	}
@@ -3179,6 +3767,13 @@ geBoolean geWorld_AttachAll(geWorld *World, DRV_Driver *Driver, geFloat Gamma)
 		geErrorLog_AddString(-1, "geWorld_AttachAll:  BitmapList_AttachAll failed.", NULL);
 		return GE_FALSE;
 	}
+
+	// Now that the textures have THandles, hand the static faces over (if the driver wants them)
+	if (!CreateDrvWorld(World, Driver))
+	{
+		geErrorLog_AddString(-1, "geWorld_AttachAll:  CreateDrvWorld failed.", NULL);
+		return GE_FALSE;
+	}
 	
 	return GE_TRUE;
 }
@@ -3191,6 +3786,9 @@ geBoolean geWorld_DetachAll(geWorld *World)
 	assert(World);
 	assert(World->AttachedBitmaps);
 
+	// The driver's copy of the faces points at the THandles, so it has to go first
+	DestroyDrvWorld(World);
+
 	if (!BitmapList_DetachAll(World->AttachedBitmaps))
 	{
 		geErrorLog_AddString(-1, "geWorld_DetachAll:  BitmapList_DetachAll failed.", NULL);
@@ -58,7 +58,7 @@ static void print_callback( const char *string, ... )
 	printf( "%s", buf );
 }
 
-static GBSP_RETVAL process_bsp( GBSP_FuncHook *hookFunction, const std::string &filename, bool verbose, bool light, bool vis, bool entitiesOnly )
+static GBSP_RETVAL process_bsp( GBSP_FuncHook *hookFunction, const std::string &filename, bool verbose, bool light, bool vis, bool entitiesOnly, int threads, bool noCache )
 {
 	std::string bspFilename = filename.substr( 0, filename.find_last_of( '.' ) ) + ".bsp";
 
@@ -72,6 +72,7 @@ static GBSP_RETVAL process_bsp( GBSP_FuncHook *hookFunction, const std::string &
 		BspParms bspParms      = {};
 		bspParms.EntityVerbose = verbose;
 		bspParms.Verbose       = verbose;
+		bspParms.NoCache       = noCache;
 
 		result = hookFunction->GBSP_CreateBSP( filename.c_str(), &bspParms );
 		if ( result != GBSP_OK )
@@ -92,6 +93,8 @@ static GBSP_RETVAL process_bsp( GBSP_FuncHook *hookFunction, const std::string &
 			VisParms visParms    = {};
 			visParms.FullVis     = true;
 			visParms.SortPortals = true;
+			visParms.NumThreads  = threads;
+			visParms.NoCache     = noCache;
 
 			result = hookFunction->GBSP_VisGBSPFile( bspFilename.c_str(), &visParms );
 			if ( result != GBSP_OK )
@@ -105,6 +108,8 @@ static GBSP_RETVAL process_bsp( GBSP_FuncHook *hookFunction, const std::string &
 			LightParms lightParms = {};
 			lightParms.Radiosity  = true;
 			lightParms.Verbose    = verbose;
+			lightParms.NumThreads = threads;
+			lightParms.NoCache    = noCache;
 
 			result = hookFunction->GBSP_LightGBSPFile( bspFilename.c_str(), &lightParms );
 			if ( result != GBSP_OK )
@@ -131,6 +136,8 @@ int main( int argc, char **argv )
 	bool verbose      = false;
 	bool vis          = false;
 	bool light        = false;
+	int  threads      = 0;// one per core
+	bool noCache      = false;
 	for ( unsigned int i = 2; i < argc; ++i )
 	{
 		if ( strcmp( argv[ i ], "/ent" ) == 0 )
@@ -153,6 +160,21 @@ int main( int argc, char **argv )
 			light = true;
 			continue;
 		}
+		else if ( strcmp( argv[ i ], "/nocache" ) == 0 )
+		{
+			noCache = true;
+			continue;
+		}
+		else if ( strcmp( argv[ i ], "/threads" ) == 0 )
+		{
+			if ( i + 1 >= argc )
+			{
+				printf( "Invalid number of arguments for /threads!\n" );
+				return EXIT_FAILURE;
+			}
+			threads = atoi( argv[ ++i ] );
+			continue;
+		}
 		else if ( strcmp( argv[ i ], "/minlight" ) == 0 )
 		{
 			if ( i + 3 >= argc )
@@ -202,7 +224,7 @@ int main( int argc, char **argv )
 
 	std::string filename = argv[ 1 ];
 
-	GBSP_RETVAL result = process_bsp( hookFunction, argv[ 1 ], verbose, light, vis, entitiesOnly );
+	GBSP_RETVAL result = process_bsp( hookFunction, argv[ 1 ], verbose, light, vis, entitiesOnly, threads, noCache );
 	switch ( result )
 	{
 		default:
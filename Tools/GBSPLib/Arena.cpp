@@ -0,0 +1,333 @@
+/*******************************************************************************
+Copyright © 2024 Mark E. Sowden <hogsy@oldtimes-software.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************/
+
+
+#include <string.h>
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+#include "Gbsplib.h"
+#include "Arena.h"
+
+#include "mempool.h"
+#include "RAM.H"
+
+#define ARENA_NUM_CLASSES	15
+#define ARENA_POOL_GROW		( 64 * 1024 )	// Roughly how many bytes a pool grows by at a time
+#define ARENA_HEADER_SIZE	16				// Keeps what comes after it 16 byte aligned
+
+// Hunk sizes, header included
+static const uint32 ArenaClassSize[ ARENA_NUM_CLASSES ] = {
+        32, 48, 64, 96, 128, 192, 256, 384, 512, 768, 1024, 1536, 2048, 3072, 4096 };
+
+struct Arena;
+
+// In front of every block
+typedef struct
+{
+	Arena	*Owner;			// NULL if the block came from the heap
+	int32	Class;
+	uint32	Size;
+} Arena_Header;
+
+static_assert( sizeof( Arena_Header ) <= ARENA_HEADER_SIZE, "Arena_Header does not fit" );
+
+typedef struct
+{
+	int32	NumAllocs;
+	int32	NumFrees;
+	int64_t	Bytes;			// What was asked for
+	int64_t	PeakBytes;
+	int64_t	PoolBytes;		// What the hunks take up
+	int64_t	PeakPoolBytes;
+} Arena_Stats;
+
+// One per thread.  Everything in here is guarded by Mutex, which only another
+// thread freeing one of our blocks will ever contend for.
+struct Arena
+{
+	std::mutex	Mutex;
+	MemPool		*Pools[ ARENA_NUM_CLASSES ];
+	int32		NumLive;
+	Arena_Stats	Stats;
+	geBoolean	InUse;			// Owned by a running thread
+};
+
+// Hands the arena back when its thread exits, so the next thread can have it
+struct Arena_ThreadRef
+{
+	Arena *pArena = nullptr;
+
+	~Arena_ThreadRef();
+};
+
+static std::mutex				ArenaListMutex;
+static std::vector< Arena * >	ArenaList;
+static std::atomic< int >		ArenaStageActive;
+static std::atomic< int >		ArenaNumHeap;		// Blocks that were too big for a pool
+static char						ArenaStageName[ 32 ];
+
+static thread_local Arena_ThreadRef	ThreadArena;
+
+Arena_ThreadRef::~Arena_ThreadRef()
+{
+	if ( !pArena )
+		return;
+
+	std::lock_guard< std::mutex >	Lock( ArenaListMutex );
+
+	pArena->InUse = GE_FALSE;
+}
+
+//====================================================================================
+//	Arena_GetThreadArena
+//====================================================================================
+static Arena *Arena_GetThreadArena( void )
+{
+	if ( ThreadArena.pArena )
+		return ThreadArena.pArena;
+
+	std::lock_guard< std::mutex >	Lock( ArenaListMutex );
+
+	for ( Arena *pArena : ArenaList )
+	{
+		if ( !pArena->InUse )
+		{
+			pArena->InUse = GE_TRUE;
+			ThreadArena.pArena = pArena;
+			return pArena;
+		}
+	}
+
+	Arena *pArena = new Arena;
+
+	memset( pArena->Pools, 0, sizeof( pArena->Pools ) );
+	memset( &pArena->Stats, 0, sizeof( pArena->Stats ) );
+	pArena->NumLive = 0;
+	pArena->InUse = GE_TRUE;
+
+	ArenaList.push_back( pArena );
+	ThreadArena.pArena = pArena;
+
+	return pArena;
+}
+
+//====================================================================================
+//	Arena_SizeClass
+//====================================================================================
+static int32 Arena_SizeClass( uint32 Size )
+{
+	int32	i;
+
+	for ( i = 0; i < ARENA_NUM_CLASSES; i++ )
+	{
+		if ( Size <= ArenaClassSize[ i ] )
+			return i;
+	}
+
+	return -1;
+}
+
+//====================================================================================
+//	Arena_Allocate
+//====================================================================================
+void *Arena_Allocate( uint32 Size )
+{
+	Arena_Header	*Header;
+	int32			Class;
+
+	Class = ArenaStageActive.load() ? Arena_SizeClass( Size + ARENA_HEADER_SIZE ) : -1;
+
+	if ( Class < 0 )
+	{
+		Header = ( Arena_Header * ) geRam_AllocateClear( Size + ARENA_HEADER_SIZE );
+
+		if ( !Header )
+			return NULL;
+
+		Header->Owner = NULL;
+		Header->Class = -1;
+		Header->Size = Size;
+
+		if ( ArenaStageActive.load() )
+			ArenaNumHeap++;
+
+		return ( uint8 * ) Header + ARENA_HEADER_SIZE;
+	}
+
+	Arena	*pArena = Arena_GetThreadArena();
+
+	std::lock_guard< std::mutex >	Lock( pArena->Mutex );
+
+	if ( !pArena->Pools[ Class ] )
+	{
+		int32	NumHunks = ARENA_POOL_GROW / ArenaClassSize[ Class ];
+
+		pArena->Pools[ Class ] = MemPool_Create( ArenaClassSize[ Class ], NumHunks, NumHunks );
+
+		if ( !pArena->Pools[ Class ] )
+			return NULL;
+	}
+
+	// Hunks always come back cleared
+	Header = ( Arena_Header * ) MemPool_GetHunk( pArena->Pools[ Class ] );
+
+	if ( !Header )
+		return NULL;
+
+	Header->Owner = pArena;
+	Header->Class = Class;
+	Header->Size = Size;
+
+	Arena_Stats	*Stats = &pArena->Stats;
+
+	pArena->NumLive++;
+
+	Stats->NumAllocs++;
+	Stats->Bytes += Size;
+	Stats->PoolBytes += ArenaClassSize[ Class ];
+
+	if ( Stats->Bytes > Stats->PeakBytes )
+		Stats->PeakBytes = Stats->Bytes;
+	if ( Stats->PoolBytes > Stats->PeakPoolBytes )
+		Stats->PeakPoolBytes = Stats->PoolBytes;
+
+	return ( uint8 * ) Header + ARENA_HEADER_SIZE;
+}
+
+//====================================================================================
+//	Arena_Free
+//====================================================================================
+void Arena_Free( void *Mem )
+{
+	Arena_Header	*Header;
+
+	if ( !Mem )
+		return;
+
+	Header = ( Arena_Header * ) ( ( uint8 * ) Mem - ARENA_HEADER_SIZE );
+
+	if ( !Header->Owner )
+	{
+		geRam_Free( Header );
+		return;
+	}
+
+	Arena	*pArena = Header->Owner;
+
+	std::lock_guard< std::mutex >	Lock( pArena->Mutex );
+
+	pArena->NumLive--;
+
+	pArena->Stats.NumFrees++;
+	pArena->Stats.Bytes -= Header->Size;
+	pArena->Stats.PoolBytes -= ArenaClassSize[ Header->Class ];
+
+	MemPool_FreeHunk( pArena->Pools[ Header->Class ], Header );
+}
+
+//====================================================================================
+//	Arena_BeginStage
+//====================================================================================
+void Arena_BeginStage( const char *Name )
+{
+	Arena_EndStage();
+
+	strncpy( ArenaStageName, Name, sizeof( ArenaStageName ) - 1 );
+
+	ArenaNumHeap.store( 0 );
+	ArenaStageActive.store( 1 );
+}
+
+//====================================================================================
+//	Arena_EndStage
+//	Must not be called while worker threads are running.  Peaks are per thread, and
+//	added up, so with several threads they are an upper bound.
+//====================================================================================
+void Arena_EndStage( void )
+{
+	Arena_Stats	Total;
+	int32		NumLive, i;
+
+	if ( !ArenaStageActive.load() )
+		return;
+
+	ArenaStageActive.store( 0 );
+
+	std::lock_guard< std::mutex >	Lock( ArenaListMutex );
+
+	memset( &Total, 0, sizeof( Total ) );
+	NumLive = 0;
+
+	for ( Arena *pArena : ArenaList )
+	{
+		Total.NumAllocs += pArena->Stats.NumAllocs;
+		Total.NumFrees += pArena->Stats.NumFrees;
+		Total.PeakBytes += pArena->Stats.PeakBytes;
+		Total.PeakPoolBytes += pArena->Stats.PeakPoolBytes;
+
+		NumLive += pArena->NumLive;
+	}
+
+	GHook.Printf( "Arena %-8s       : %8i allocs, %8i frees, %5i from heap\n",
+	              ArenaStageName, Total.NumAllocs, Total.NumFrees, ArenaNumHeap.load() );
+	GHook.Printf( "Arena peak           : %2.2f Megs used, %2.2f Megs in pools\n",
+	              ( double ) Total.PeakBytes / ( 1024 * 1024 ), ( double ) Total.PeakPoolBytes / ( 1024 * 1024 ) );
+
+	// Anything still alive would point into the pools, so they have to stay
+	if ( NumLive )
+		GHook.Printf( "*WARNING* Arena_EndStage:  %i blocks still in use, keeping the pools.\n", NumLive );
+
+	for ( Arena *pArena : ArenaList )
+	{
+		if ( !NumLive )
+		{
+			for ( i = 0; i < ARENA_NUM_CLASSES; i++ )
+				MemPool_Destroy( &pArena->Pools[ i ] );
+		}
+
+		// Live bytes carry over, so the next stage still balances
+		pArena->Stats.NumAllocs = 0;
+		pArena->Stats.NumFrees = 0;
+		pArena->Stats.PeakBytes = pArena->Stats.Bytes;
+		pArena->Stats.PeakPoolBytes = pArena->Stats.PoolBytes;
+	}
+
+	if ( NumLive )
+		return;
+
+	// The threads that owned these are gone
+	for ( i = 0; i < ( int32 ) ArenaList.size(); )
+	{
+		if ( ArenaList[ i ]->InUse )
+		{
+			i++;
+			continue;
+		}
+
+		delete ArenaList[ i ];
+		ArenaList[ i ] = ArenaList.back();
+		ArenaList.pop_back();
+	}
+}
@@ -0,0 +1,51 @@
+/*******************************************************************************
+Copyright © 2024 Mark E. Sowden <hogsy@oldtimes-software.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************/
+
+
+#ifndef ARENA_H
+#define ARENA_H
+
+#include "BASETYPE.H"
+
+//====================================================================================
+//	Stage arenas
+//
+//	The compile stages make and throw away huge numbers of small polys, brushes,
+//	nodes, portals and patches.  Those come from size class pools (MemPool) here
+//	instead of the heap.  Every thread gets its own set of pools, so the workers
+//	don't fight over them, and a block can still be freed from any thread.
+//
+//	Arena_BeginStage / Arena_EndStage bracket a stage.  When the stage ends with
+//	nothing left alive, all of its pools are dropped at once, and what it used
+//	is printed.  Outside of a stage, and for big blocks, the heap is used.
+//====================================================================================
+
+void	*Arena_Allocate( uint32 Size );		// Memory comes back cleared
+void	Arena_Free( void *Mem );
+
+void	Arena_BeginStage( const char *Name );
+void	Arena_EndStage( void );
+
+#define ARENA_ALLOCATE_STRUCT( type )			( type * ) Arena_Allocate( sizeof( type ) )
+#define ARENA_ALLOCATE_ARRAY( type, count )		( type * ) Arena_Allocate( sizeof( type ) * ( count ) )
+
+#endif
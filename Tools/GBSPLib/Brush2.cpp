@@ -30,6 +30,7 @@
 #include "vfile.h"
 #include "VEC3D.H"
 #include "RAM.H"
+#include "Arena.h"
 
 #define BSP_BRUSH_SIZE(s) ((sizeof(GBSP_Brush)-sizeof(GBSP_Side[NUM_BRUSH_DEFAULT_SIDES]))+(sizeof(GBSP_Side)*(s)));
 #define MAP_BRUSH_SIZE(s) ((sizeof(MAP_Brush)-sizeof(GBSP_Side[NUM_BRUSH_DEFAULT_SIDES]))+(sizeof(GBSP_Side)*(s)));
@@ -431,13 +432,11 @@ GBSP_Brush *AllocBrush(int32 NumSides)
 
 	Size = BSP_BRUSH_SIZE(NumSides);
 
-	Brush = (GBSP_Brush*)geRam_Allocate(Size);
+	Brush = (GBSP_Brush*)Arena_Allocate(Size);
 
 	if (!Brush)
 		return NULL;
 
-	memset(Brush, 0, Size);
-
 #ifdef SHOW_DEBUG_STATS
 	gTotalBrushes++;
 
@@ -463,7 +462,7 @@ void FreeBrush(GBSP_Brush *Brush)
 	gTotalBrushes--;
 #endif
 
-	geRam_Free(Brush);
+	Arena_Free(Brush);
 }
 
 //=======================================================================================
@@ -0,0 +1,400 @@
+/*******************************************************************************
+Copyright © 2024 Mark E. Sowden <hogsy@oldtimes-software.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************/
+
+
+#include <stdio.h>
+#include <string.h>
+
+#include <algorithm>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Gbsplib.h"
+#include "Cache.h"
+#include "crc32.h"
+
+#define BCACHE_TAG			"GBCH"
+#define BCACHE_VERSION		1
+
+#define FNV_OFFSET			0x811c9dc5
+#define FNV_PRIME			0x01000193
+
+typedef struct
+{
+	char		Tag[ 4 ];
+	int32		Version;
+	char		Stage[ 8 ];
+	BCache_Key	StageKey;
+	int32		NumEntries;
+} BCache_Header;
+
+typedef struct
+{
+	std::vector< uint8 >	Data;
+	geBoolean				Used;				// Found or added this run, so it gets saved
+} BCache_Entry;
+
+struct BCache
+{
+	std::string											FileName;
+	BCache_Header										Header;
+	std::unordered_map< uint64_t, BCache_Entry >		Entries;
+	std::mutex											Mutex;
+	std::vector< std::vector< uint8 > >					Retired;	// Replaced data, kept until destroy so Find results stay valid
+
+	int32												NumHits;
+	int32												NumMisses;
+	int32												HitBytes;
+};
+
+static uint64_t BCache_KeyValue( const BCache_Key *Key )
+{
+	return ( ( uint64_t ) Key->Crc << 32 ) | Key->Fnv;
+}
+
+//====================================================================================
+//	BCache_KeyStart
+//====================================================================================
+void BCache_KeyStart( BCache_Key *Key )
+{
+	Key->Crc = CRC32_Start();
+	Key->Fnv = FNV_OFFSET;
+}
+
+//====================================================================================
+//	BCache_KeyAddData
+//====================================================================================
+void BCache_KeyAddData( BCache_Key *Key, const void *Data, int32 Size )
+{
+	const uint8	*pData = ( const uint8 * ) Data;
+	int32		i;
+
+	for ( i = 0; i < Size; i++ )
+	{
+		Key->Crc = CRC32_AddByte( Key->Crc, pData[ i ] );
+		Key->Fnv = ( Key->Fnv ^ pData[ i ] ) * FNV_PRIME;
+	}
+}
+
+//====================================================================================
+//	BCache_KeyAddLong
+//====================================================================================
+void BCache_KeyAddLong( BCache_Key *Key, uint32 Value )
+{
+	BCache_KeyAddData( Key, &Value, sizeof( uint32 ) );
+}
+
+//====================================================================================
+//	BCache_KeyAddFloat
+//	-0 and 0 hash the same, everything else by its bits
+//====================================================================================
+void BCache_KeyAddFloat( BCache_Key *Key, geFloat Value )
+{
+	if ( Value == 0.0f )
+		Value = 0.0f;
+
+	BCache_KeyAddData( Key, &Value, sizeof( geFloat ) );
+}
+
+//====================================================================================
+//	BCache_KeyAddVec
+//====================================================================================
+void BCache_KeyAddVec( BCache_Key *Key, const geVec3d *Vec )
+{
+	BCache_KeyAddFloat( Key, Vec->X );
+	BCache_KeyAddFloat( Key, Vec->Y );
+	BCache_KeyAddFloat( Key, Vec->Z );
+}
+
+//====================================================================================
+//	BCache_KeyAddString
+//====================================================================================
+void BCache_KeyAddString( BCache_Key *Key, const char *String )
+{
+	int32	Len;
+
+	Len = String ? ( int32 ) strlen( String ) : 0;
+
+	BCache_KeyAddLong( Key, ( uint32 ) Len );
+	BCache_KeyAddData( Key, String, Len );
+}
+
+//====================================================================================
+//	BCache_KeyAddKey
+//====================================================================================
+void BCache_KeyAddKey( BCache_Key *Key, const BCache_Key *Other )
+{
+	BCache_KeyAddLong( Key, Other->Crc );
+	BCache_KeyAddLong( Key, Other->Fnv );
+}
+
+//====================================================================================
+//	BCache_KeyAddSet
+//	Hashes a set of keys the same, whatever order they come in
+//====================================================================================
+void BCache_KeyAddSet( BCache_Key *Key, BCache_Key *Set, int32 NumKeys )
+{
+	int32	i;
+
+	std::sort( Set, Set + NumKeys, []( const BCache_Key &Key1, const BCache_Key &Key2 ) { return BCache_KeyValue( &Key1 ) < BCache_KeyValue( &Key2 ); } );
+
+	BCache_KeyAddLong( Key, ( uint32 ) NumKeys );
+
+	for ( i = 0; i < NumKeys; i++ )
+		BCache_KeyAddKey( Key, &Set[ i ] );
+}
+
+//====================================================================================
+//	BCache_KeyFinish
+//====================================================================================
+void BCache_KeyFinish( BCache_Key *Key )
+{
+	Key->Crc = CRC32_Finish( Key->Crc );
+}
+
+//====================================================================================
+//	BCache_KeyLess / BCache_KeyEqual
+//	For sorting sets of keys, so they hash the same in any order
+//====================================================================================
+geBoolean BCache_KeyLess( const BCache_Key *Key1, const BCache_Key *Key2 )
+{
+	return BCache_KeyValue( Key1 ) < BCache_KeyValue( Key2 );
+}
+
+geBoolean BCache_KeyEqual( const BCache_Key *Key1, const BCache_Key *Key2 )
+{
+	return Key1->Crc == Key2->Crc && Key1->Fnv == Key2->Fnv;
+}
+
+//====================================================================================
+//	BCache_Load
+//====================================================================================
+static void BCache_Load( BCache *Cache )
+{
+	FILE			*f;
+	BCache_Header	Header;
+	int32			i;
+
+	f = fopen( Cache->FileName.c_str(), "rb" );
+
+	if ( !f )
+		return;
+
+	if ( fread( &Header, sizeof( BCache_Header ), 1, f ) != 1 ||
+	     memcmp( Header.Tag, Cache->Header.Tag, sizeof( Header.Tag ) ) ||
+	     Header.Version != Cache->Header.Version ||
+	     memcmp( Header.Stage, Cache->Header.Stage, sizeof( Header.Stage ) ) )
+	{
+		GHook.Printf( "*WARNING* BCache_Load:  %s is not a valid cache file, skipping...\n", Cache->FileName.c_str() );
+		fclose( f );
+		return;
+	}
+
+	if ( !BCache_KeyEqual( &Header.StageKey, &Cache->Header.StageKey ) )
+	{
+		GHook.Printf( "Build cache          : parameters changed, rebuilding\n" );
+		fclose( f );
+		return;
+	}
+
+	for ( i = 0; i < Header.NumEntries; i++ )
+	{
+		BCache_Key		Key;
+		int32			Size;
+		BCache_Entry	Entry;
+
+		if ( fread( &Key, sizeof( BCache_Key ), 1, f ) != 1 || fread( &Size, sizeof( int32 ), 1, f ) != 1 || Size < 0 )
+			break;
+
+		Entry.Data.resize( Size );
+		Entry.Used = GE_FALSE;
+
+		if ( Size && fread( Entry.Data.data(), Size, 1, f ) != 1 )
+			break;
+
+		Cache->Entries[ BCache_KeyValue( &Key ) ] = std::move( Entry );
+	}
+
+	if ( i != Header.NumEntries )
+	{
+		GHook.Printf( "*WARNING* BCache_Load:  %s is truncated, skipping...\n", Cache->FileName.c_str() );
+		Cache->Entries.clear();
+	}
+
+	fclose( f );
+}
+
+//====================================================================================
+//	BCache_Create
+//====================================================================================
+BCache *BCache_Create( const char *FileName, const char *Stage, const BCache_Key *StageKey )
+{
+	BCache	*Cache;
+
+	Cache = new BCache;
+
+	Cache->FileName = FileName;
+
+	memset( &Cache->Header, 0, sizeof( BCache_Header ) );
+	memcpy( Cache->Header.Tag, BCACHE_TAG, sizeof( Cache->Header.Tag ) );
+	Cache->Header.Version = BCACHE_VERSION;
+	strncpy( Cache->Header.Stage, Stage, sizeof( Cache->Header.Stage ) );
+	Cache->Header.StageKey = *StageKey;
+
+	Cache->NumHits = 0;
+	Cache->NumMisses = 0;
+	Cache->HitBytes = 0;
+
+	BCache_Load( Cache );
+
+	return Cache;
+}
+
+//====================================================================================
+//	BCache_Destroy
+//====================================================================================
+void BCache_Destroy( BCache **Cache )
+{
+	delete *Cache;
+	*Cache = NULL;
+}
+
+//====================================================================================
+//	BCache_Find
+//====================================================================================
+geBoolean BCache_Find( BCache *Cache, const BCache_Key *Key, const void **Data, int32 *Size )
+{
+	std::lock_guard< std::mutex >	Lock( Cache->Mutex );
+
+	auto Entry = Cache->Entries.find( BCache_KeyValue( Key ) );
+
+	if ( Entry == Cache->Entries.end() )
+	{
+		Cache->NumMisses++;
+		return GE_FALSE;
+	}
+
+	Entry->second.Used = GE_TRUE;
+
+	*Data = Entry->second.Data.data();
+	*Size = ( int32 ) Entry->second.Data.size();
+
+	Cache->NumHits++;
+	Cache->HitBytes += *Size;
+
+	return GE_TRUE;
+}
+
+//====================================================================================
+//	BCache_Add
+//====================================================================================
+geBoolean BCache_Add( BCache *Cache, const BCache_Key *Key, const void *Data, int32 Size )
+{
+	std::lock_guard< std::mutex >	Lock( Cache->Mutex );
+
+	BCache_Entry &Entry = Cache->Entries[ BCache_KeyValue( Key ) ];
+
+	if ( Entry.Data.size() != ( size_t ) Size || memcmp( Entry.Data.data(), Data, Size ) )
+	{
+		// Another thread may still be reading what BCache_Find gave it, so retire the old data
+		// rather than freeing it
+		if ( !Entry.Data.empty() )
+			Cache->Retired.push_back( std::move( Entry.Data ) );
+
+		Entry.Data.assign( ( const uint8 * ) Data, ( const uint8 * ) Data + Size );
+	}
+	Entry.Used = GE_TRUE;
+
+	return GE_TRUE;
+}
+
+//====================================================================================
+//	BCache_Save
+//	Only what was used this run is written, so the file does not grow forever
+//====================================================================================
+geBoolean BCache_Save( BCache *Cache )
+{
+	FILE			*f;
+	BCache_Header	Header;
+
+	f = fopen( Cache->FileName.c_str(), "wb" );
+
+	if ( !f )
+	{
+		GHook.Printf( "*WARNING* BCache_Save:  Could not open %s for writing...\n", Cache->FileName.c_str() );
+		return GE_FALSE;
+	}
+
+	Header = Cache->Header;
+	Header.NumEntries = 0;
+
+	for ( auto &Entry : Cache->Entries )
+	{
+		if ( Entry.second.Used )
+			Header.NumEntries++;
+	}
+
+	if ( fwrite( &Header, sizeof( BCache_Header ), 1, f ) != 1 )
+		goto WriteError;
+
+	for ( auto &Entry : Cache->Entries )
+	{
+		BCache_Key	Key;
+		int32		Size;
+
+		if ( !Entry.second.Used )
+			continue;
+
+		Key.Crc = ( uint32 ) ( Entry.first >> 32 );
+		Key.Fnv = ( uint32 ) Entry.first;
+		Size = ( int32 ) Entry.second.Data.size();
+
+		if ( fwrite( &Key, sizeof( BCache_Key ), 1, f ) != 1 || fwrite( &Size, sizeof( int32 ), 1, f ) != 1 )
+			goto WriteError;
+
+		if ( Size && fwrite( Entry.second.Data.data(), Size, 1, f ) != 1 )
+			goto WriteError;
+	}
+
+	fclose( f );
+
+	return GE_TRUE;
+
+	WriteError:
+	{
+		GHook.Printf( "*WARNING* BCache_Save:  Could not write %s...\n", Cache->FileName.c_str() );
+		fclose( f );
+		remove( Cache->FileName.c_str() );
+		return GE_FALSE;
+	}
+}
+
+//====================================================================================
+//	BCache_PrintStats
+//====================================================================================
+void BCache_PrintStats( BCache *Cache )
+{
+	GHook.Printf( "Build cache          : %5i hits, %5i misses, %2.2f Megs reused\n",
+	              Cache->NumHits, Cache->NumMisses, ( float ) Cache->HitBytes / ( 1024 * 1024 ) );
+}
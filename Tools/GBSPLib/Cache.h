@@ -0,0 +1,74 @@
+/*******************************************************************************
+Copyright © 2024 Mark E. Sowden <hogsy@oldtimes-software.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************/
+
+
+#ifndef CACHE_H
+#define CACHE_H
+
+#include "BASETYPE.H"
+#include "VEC3D.H"
+
+//====================================================================================
+//	Build cache
+//
+//	A content hashed store of compile stage results, kept in a file next to the map.
+//	Each stage hashes everything that goes into a result, and if that key is in the
+//	cache, takes the result from there instead of working it out again.  Entries that
+//	are not found or added during a run are dropped when the cache is saved.
+//====================================================================================
+
+// 64 bit content key.  CRC32 plus an FNV-1a of the same bytes, so one weak spot in
+// either does not make a collision.
+typedef struct
+{
+	uint32		Crc;
+	uint32		Fnv;
+} BCache_Key;
+
+void		BCache_KeyStart( BCache_Key *Key );
+void		BCache_KeyAddData( BCache_Key *Key, const void *Data, int32 Size );
+void		BCache_KeyAddLong( BCache_Key *Key, uint32 Value );
+void		BCache_KeyAddFloat( BCache_Key *Key, geFloat Value );
+void		BCache_KeyAddVec( BCache_Key *Key, const geVec3d *Vec );
+void		BCache_KeyAddString( BCache_Key *Key, const char *String );
+void		BCache_KeyAddKey( BCache_Key *Key, const BCache_Key *Other );
+void		BCache_KeyAddSet( BCache_Key *Key, BCache_Key *Set, int32 NumKeys );	// Sorts Set
+void		BCache_KeyFinish( BCache_Key *Key );
+geBoolean	BCache_KeyLess( const BCache_Key *Key1, const BCache_Key *Key2 );
+geBoolean	BCache_KeyEqual( const BCache_Key *Key1, const BCache_Key *Key2 );
+
+typedef struct BCache BCache;
+
+// StageKey covers the stage version and parameters, if it differs from the one in the
+// file, every entry in there is thrown away
+BCache		*BCache_Create( const char *FileName, const char *Stage, const BCache_Key *StageKey );
+void		BCache_Destroy( BCache **Cache );
+
+// Find and Add can be called from several threads at once.  The data returned by Find
+// stays valid until the cache is destroyed.
+geBoolean	BCache_Find( BCache *Cache, const BCache_Key *Key, const void **Data, int32 *Size );
+geBoolean	BCache_Add( BCache *Cache, const BCache_Key *Key, const void *Data, int32 Size );
+
+geBoolean	BCache_Save( BCache *Cache );
+void		BCache_PrintStats( BCache *Cache );
+
+#endif
@@ -25,6 +25,7 @@
 #include "VIS.H"
 #include "LIGHT.H"
 #include "MAP.H"
+#include "Arena.h"
 
 #define HANDLE_EXCEPTIONS
 
@@ -150,6 +151,7 @@ void GBSP_FreeBSP(void)
 {
 	FreeAllGBSPData();
 	FreeAllEntities();
+	Arena_EndStage();
 
 #ifdef SHOW_DEBUG_STATS
 	GHook.Printf("------------------------\n");
@@ -51,6 +51,7 @@ typedef struct
 {
 	geBoolean	Verbose;
 	geBoolean	EntityVerbose;
+	geBoolean	NoCache;			// Don't use or update the build cache
 
 } BspParms;
 
@@ -67,6 +68,9 @@ typedef struct
 
 	geVec3d	MinLight;			// R,G,B (XYZ) min color for each faces lightmap
 
+	int32		NumThreads;			// 0 = one per core, 1 = single threaded
+	geBoolean	NoCache;			// Don't use or update the build cache
+
 } LightParms;
 
 typedef struct
@@ -74,6 +78,8 @@ typedef struct
 	geBoolean	Verbose;
 	geBoolean	FullVis;
 	geBoolean	SortPortals;
+	int32		NumThreads;			// 0 = one per core, 1 = single threaded
+	geBoolean	NoCache;			// Don't use or update the build cache
 
 } VisParms;
 
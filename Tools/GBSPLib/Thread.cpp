@@ -0,0 +1,141 @@
+/*******************************************************************************
+Copyright © 2024 Mark E. Sowden <hogsy@oldtimes-software.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************/
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+
+#include "Gbsplib.h"
+#include "Thread.h"
+#include "geThread.h"
+
+static std::mutex       ThreadMutex;
+static std::atomic<int> ThreadAbort;
+
+typedef struct
+{
+	THREAD_WORK_CB *Func;
+	void           *Context;
+} THREAD_Run;
+
+//====================================================================================
+//	ThreadResolveCount
+//	<= 0 means one thread per hardware thread
+//====================================================================================
+int32 ThreadResolveCount( int32 NumThreads )
+{
+	return geThread_ResolveCount( NumThreads );
+}
+
+//====================================================================================
+//	ThreadWork
+//	Stops the run on a cancel request, and lets waiting workers see a failure
+//====================================================================================
+static geBoolean ThreadWork( int32 ThreadNum, int32 WorkNum, void *Context )
+{
+	THREAD_Run *Run = ( THREAD_Run * ) Context;
+
+	if ( CancelRequest || !Run->Func( ThreadNum, WorkNum, Run->Context ) )
+	{
+		ThreadAbort.store( 1 );
+		return GE_FALSE;
+	}
+
+	return GE_TRUE;
+}
+
+//====================================================================================
+//	RunThreadsOnIndividual
+//	Calls Func once for every WorkNum in [0, NumWork), spread across NumThreads
+//	The work is done by the engine's geThread_RunOnIndividual, on the pool started
+//	by ThreadStartStage when there is one
+//====================================================================================
+geBoolean RunThreadsOnIndividual( int32 NumWork, int32 NumThreads, THREAD_WORK_CB *Func, void *Context )
+{
+	THREAD_Run Run;
+
+	Run.Func = Func;
+	Run.Context = Context;
+
+	ThreadAbort.store( 0 );
+
+	if ( NumWork <= 0 )
+		return GE_TRUE;
+
+	// Work the single threaded case on the calling thread, so there is no difference to the old path
+	if ( !geThread_RunOnIndividual( NumWork, NumThreads > 1 ? NumThreads : 1, ThreadWork, &Run ) )
+		ThreadAbort.store( 1 );
+
+	return !ThreadAbort.load();
+}
+
+//====================================================================================
+//	ThreadStartStage / ThreadEndStage
+//	Keep NumThreads workers waiting for the runs of a stage
+//====================================================================================
+geBoolean ThreadStartStage( int32 NumThreads )
+{
+	NumThreads = ThreadResolveCount( NumThreads );
+
+	// Without a pool, every run starts threads of its own
+	if ( NumThreads <= 1 )
+		return GE_FALSE;
+
+	return geThread_PoolStart( NumThreads );
+}
+
+void ThreadEndStage( geBoolean Started )
+{
+	if ( Started )
+		geThread_PoolStop();
+}
+
+//====================================================================================
+//	ThreadAborted
+//	So workers waiting on each other can bail out when another one fails
+//====================================================================================
+geBoolean ThreadAborted( void )
+{
+	return ThreadAbort.load() || CancelRequest;
+}
+
+//====================================================================================
+//	ThreadLock / ThreadUnlock
+//====================================================================================
+void ThreadLock( void )
+{
+	ThreadMutex.lock();
+}
+
+void ThreadUnlock( void )
+{
+	ThreadMutex.unlock();
+}
+
+//====================================================================================
+//	ThreadGetTime
+//	Seconds, for timing the compile stages
+//====================================================================================
+double ThreadGetTime( void )
+{
+	return std::chrono::duration< double >( std::chrono::steady_clock::now().time_since_epoch() ).count();
+}
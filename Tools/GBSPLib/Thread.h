@@ -0,0 +1,53 @@
+/*******************************************************************************
+Copyright © 2024 Mark E. Sowden <hogsy@oldtimes-software.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************/
+
+#ifndef THREAD_H
+#define THREAD_H
+
+#include "BASETYPE.H"
+
+//====================================================================================
+//	Worker threads for the compile stages
+//
+//	The runs go through the engine's geThread_RunOnIndividual.  Work items are
+//	handed out in index order from a shared cursor, so a thread that finishes
+//	early simply grabs the next item.  Callers that need a deterministic result
+//	must only rely on items with a lower index.
+//====================================================================================
+
+// Return GE_FALSE to abort the whole run
+typedef geBoolean THREAD_WORK_CB( int32 ThreadNum, int32 WorkNum, void *Context );
+
+int32     ThreadResolveCount( int32 NumThreads );
+geBoolean RunThreadsOnIndividual( int32 NumWork, int32 NumThreads, THREAD_WORK_CB *Func, void *Context );
+geBoolean ThreadAborted( void );
+
+// Returns GE_TRUE if a pool was started, pass that on to ThreadEndStage
+geBoolean ThreadStartStage( int32 NumThreads );
+void      ThreadEndStage( geBoolean Started );
+
+void ThreadLock( void );
+void ThreadUnlock( void );
+
+double ThreadGetTime( void );
+
+#endif
@@ -33,6 +33,7 @@
 #include "genesis.h"
 #include "mkutil.h"
 #include "motion.h"
+#include "motclip.h"
 #include "ram.h"
 #include "pop.h"
 #include "log.h"
@@ -49,6 +50,7 @@ typedef struct MopShell_Options
 	char SourceMotionFile[_MAX_PATH];
 	char LogFile[_MAX_PATH];
 	int OptimizationLevel;
+	geFloat PackRate;					// 0 = leave paths unpacked
 } MopShell_Options;
 
 
@@ -61,6 +63,7 @@ const static MopShell_Options DefaultOptions =
 	"",
 	"",
 	-1,
+	0.0f,
 };
 	
 	
@@ -315,6 +318,19 @@ ReturnCode MopShell_DoMake(MopShell_Options* options,MkUtil_Printf Printf)
 			return retValue;
 		}
 
+	if (options->PackRate > 0.0f)
+		{
+			if (geMotion_Pack(M,options->PackRate)==GE_FALSE)
+				{
+					Printf("ERROR: unable to pack motion '%s'.\n", options->SourceMotionFile);
+					geMotion_Destroy(&M);
+					MkUtil_AdjustReturnCode(&retValue, RETURN_ERROR);
+					return retValue;
+				}
+			options->TextOutput = MK_FALSE;		// packed clips have no text format
+			Printf("Packed motion at %g samples per second.\n", options->PackRate);
+		}
+
 	if (options->TextOutput)
 		{
 			df = geVFile_OpenNewSystem(NULL,GE_VFILE_TYPE_DOS,options->DestinationMotionFile,NULL,GE_VFILE_OPEN_CREATE);
@@ -366,7 +382,7 @@ void MopShell_OutputUsage(MkUtil_Printf Printf)
 	Printf("Optimizes a motion file.  Default output format is text,\n");
 	Printf("with optimization level 0.\n");
 	Printf("\n");
-	Printf("MOP [options] [/B][/T] [/On] /S<source motion file> \n");
+	Printf("MOP [options] [/B][/T] [/On] [/P[rate]] /S<source motion file> \n");
 	Printf("         /D<destination motion file> /L<log file>\n");
 	Printf("\n");
 	Printf("/S<motionfile>   Specifies source motion file (Required).\n");
@@ -375,6 +391,8 @@ void MopShell_OutputUsage(MkUtil_Printf Printf)
 	Printf("/T               Specifies text destination motion file (default).\n");
 	Printf("/B               Specifies binary destination motion file.\n");
 	Printf("/L               Specifies optional log file for optimization stats.\n");
+	Printf("/P[rate]         Packs the motion into a quantized clip sampled at rate\n");
+	Printf("                 frames per second (default 30).  Implies /B.\n");
 	Printf("\n");
 	Printf("Destination motion file will be overwritten.\n");
 	
@@ -508,6 +526,24 @@ ReturnCode MopShell_ParseOptionString(MopShell_Options* options,
 			}
 			break;
 
+		case 'p':
+		case 'P':
+			if(string[2] == 0)
+			{
+				options->PackRate = (geFloat)GE_MOTIONCLIP_DEFAULT_RATE;
+			}
+			else
+			{
+				options->PackRate = (geFloat)atof(string + 2);
+				if (options->PackRate <= 0.0f)
+				{
+					Printf("WARNING: Invalid pack rate '%s'.\n", string);
+					options->PackRate = (geFloat)GE_MOTIONCLIP_DEFAULT_RATE;
+					retValue = RETURN_WARNING;
+				}
+			}
+			break;
+
 		case 'o':
 		case 'O':
 			if(string[2] == 0)